@@ -42,11 +42,13 @@
 
 #include "contiki.h"
 #include "dev/xmem.h"
+#include "dev/xmem-emu.h"
 
-#define COFFEE_SECTOR_SIZE		65536UL
+/* Coffee erases the sectors of the emulated flash. */
+#define COFFEE_SECTOR_SIZE		XMEM_SECTOR_SIZE
 #define COFFEE_PAGE_SIZE		256UL
 #define COFFEE_START			0
-#define COFFEE_SIZE			((1024UL * 1024UL) - COFFEE_START)
+#define COFFEE_SIZE			(XMEM_SIZE - COFFEE_START)
 #define COFFEE_NAME_LENGTH		16
 #define COFFEE_DYN_SIZE			16384
 #define COFFEE_MAX_OPEN_FILES		6
@@ -54,7 +56,9 @@
 #define COFFEE_LOG_DIVISOR		4
 #define COFFEE_LOG_SIZE			8192
 #define COFFEE_LOG_TABLE_LIMIT		256
+#ifndef COFFEE_MICRO_LOGS
 #define COFFEE_MICRO_LOGS		0
+#endif
 
 #define COFFEE_WRITE(buf, size, offset)				\
 		xmem_pwrite((char *)(buf), (size), COFFEE_START + (offset))
@@ -0,0 +1,234 @@
+/*
+ * Copyright (c) 2026, RISE Research Institutes of Sweden.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ *         Flash emulator behind the XMem API of the native platform.
+ *
+ *         The emulated flash keeps its content in RAM. It has a page
+ *         and sector geometry, charges a simulated latency for each
+ *         read, program and erase, and counts the erases of each
+ *         sector. XMEM_CONF_MODEL selects the geometry and the latencies
+ *         of a NOR or a NAND part; each parameter can also be set by
+ *         itself. Without a model, the flash has 256-byte pages, 64 KiB
+ *         sectors, and no latency.
+ *
+ *         As with the XMem drivers of the other platforms, the erased
+ *         state seen through the API is 0, and programming can only set
+ *         bits until the next erase.
+ */
+
+#ifndef XMEM_EMU_H_
+#define XMEM_EMU_H_
+
+#include "contiki.h"
+
+#include <stdint.h>
+
+/* The models of XMEM_CONF_MODEL */
+#define XMEM_MODEL_NONE 0
+#define XMEM_MODEL_NOR  1
+#define XMEM_MODEL_NAND 2
+
+#ifdef XMEM_CONF_MODEL
+#define XMEM_MODEL XMEM_CONF_MODEL
+#else
+#define XMEM_MODEL XMEM_MODEL_NONE
+#endif
+
+#if XMEM_MODEL == XMEM_MODEL_NOR
+/*
+ * A serial NOR flash such as the M25P80 of the Sky mote: 256-byte
+ * pages, 64 KiB sectors, and a 20 MHz SPI bus. Reads are continuous
+ * across the pages.
+ */
+#define XMEM_MODEL_PAGE_SIZE         256UL
+#define XMEM_MODEL_SECTOR_SIZE       65536UL
+#define XMEM_MODEL_READ_PAGED        0
+#define XMEM_MODEL_READ_NS           1600
+#define XMEM_MODEL_READ_BYTE_NS      400
+#define XMEM_MODEL_PROGRAM_NS        1400000
+#define XMEM_MODEL_PROGRAM_BYTE_NS   400
+#define XMEM_MODEL_ERASE_NS          650000000
+#define XMEM_MODEL_PAGE_NOP          0
+#elif XMEM_MODEL == XMEM_MODEL_NAND
+/*
+ * A 1 Gbit SLC NAND flash such as the MT29F1G08: 2 KiB pages, 128 KiB
+ * blocks, a page read into the cache register for each page, and at
+ * most four partial programs of a page between erases.
+ */
+#define XMEM_MODEL_PAGE_SIZE         2048UL
+#define XMEM_MODEL_SECTOR_SIZE       131072UL
+#define XMEM_MODEL_READ_PAGED        1
+#define XMEM_MODEL_READ_NS           25000
+#define XMEM_MODEL_READ_BYTE_NS      25
+#define XMEM_MODEL_PROGRAM_NS        200000
+#define XMEM_MODEL_PROGRAM_BYTE_NS   25
+#define XMEM_MODEL_ERASE_NS          700000
+#define XMEM_MODEL_PAGE_NOP          4
+#else
+#define XMEM_MODEL_PAGE_SIZE         256UL
+#define XMEM_MODEL_SECTOR_SIZE       65536UL
+#define XMEM_MODEL_READ_PAGED        0
+#define XMEM_MODEL_READ_NS           0
+#define XMEM_MODEL_READ_BYTE_NS      0
+#define XMEM_MODEL_PROGRAM_NS        0
+#define XMEM_MODEL_PROGRAM_BYTE_NS   0
+#define XMEM_MODEL_ERASE_NS          0
+#define XMEM_MODEL_PAGE_NOP          0
+#endif
+
+/* The size of the flash in bytes */
+#ifdef XMEM_CONF_SIZE
+#define XMEM_SIZE XMEM_CONF_SIZE
+#else
+#define XMEM_SIZE (1024UL * 1024UL)
+#endif
+
+/* The unit of a program operation */
+#ifdef XMEM_CONF_PAGE_SIZE
+#define XMEM_PAGE_SIZE XMEM_CONF_PAGE_SIZE
+#else
+#define XMEM_PAGE_SIZE XMEM_MODEL_PAGE_SIZE
+#endif
+
+/* The unit of an erase operation */
+#ifdef XMEM_CONF_SECTOR_SIZE
+#define XMEM_SECTOR_SIZE XMEM_CONF_SECTOR_SIZE
+#else
+#define XMEM_SECTOR_SIZE XMEM_MODEL_SECTOR_SIZE
+#endif
+
+#define XMEM_PAGES   (XMEM_SIZE / XMEM_PAGE_SIZE)
+#define XMEM_SECTORS (XMEM_SIZE / XMEM_SECTOR_SIZE)
+
+/* Whether the read access time is charged for each page touched */
+#ifdef XMEM_CONF_READ_PAGED
+#define XMEM_READ_PAGED XMEM_CONF_READ_PAGED
+#else
+#define XMEM_READ_PAGED XMEM_MODEL_READ_PAGED
+#endif
+
+/* The latencies in nanoseconds: per access, page or sector, and per byte */
+#ifdef XMEM_CONF_READ_NS
+#define XMEM_READ_NS XMEM_CONF_READ_NS
+#else
+#define XMEM_READ_NS XMEM_MODEL_READ_NS
+#endif
+
+#ifdef XMEM_CONF_READ_BYTE_NS
+#define XMEM_READ_BYTE_NS XMEM_CONF_READ_BYTE_NS
+#else
+#define XMEM_READ_BYTE_NS XMEM_MODEL_READ_BYTE_NS
+#endif
+
+#ifdef XMEM_CONF_PROGRAM_NS
+#define XMEM_PROGRAM_NS XMEM_CONF_PROGRAM_NS
+#else
+#define XMEM_PROGRAM_NS XMEM_MODEL_PROGRAM_NS
+#endif
+
+#ifdef XMEM_CONF_PROGRAM_BYTE_NS
+#define XMEM_PROGRAM_BYTE_NS XMEM_CONF_PROGRAM_BYTE_NS
+#else
+#define XMEM_PROGRAM_BYTE_NS XMEM_MODEL_PROGRAM_BYTE_NS
+#endif
+
+#ifdef XMEM_CONF_ERASE_NS
+#define XMEM_ERASE_NS XMEM_CONF_ERASE_NS
+#else
+#define XMEM_ERASE_NS XMEM_MODEL_ERASE_NS
+#endif
+
+/* The number of programs of a page between erases, or 0 for no limit */
+#ifdef XMEM_CONF_PAGE_NOP
+#define XMEM_PAGE_NOP XMEM_CONF_PAGE_NOP
+#else
+#define XMEM_PAGE_NOP XMEM_MODEL_PAGE_NOP
+#endif
+
+/*
+ * With XMEM_CONF_STRICT, a program only sets bits, as on a real flash.
+ * Otherwise, it overwrites the bytes, and the attempts to clear bits
+ * are only counted.
+ */
+#ifdef XMEM_CONF_STRICT
+#define XMEM_STRICT XMEM_CONF_STRICT
+#else
+#define XMEM_STRICT 0
+#endif
+
+/*
+ * With XMEM_CONF_DELAY, each operation busy-waits for its simulated
+ * latency, so that the host clock includes the time of the flash.
+ */
+#ifdef XMEM_CONF_DELAY
+#define XMEM_DELAY XMEM_CONF_DELAY
+#else
+#define XMEM_DELAY 0
+#endif
+
+struct xmem_stats {
+  /* Read operations, and the bytes read */
+  unsigned long reads;
+  unsigned long long read_bytes;
+  /* Page programs, and the bytes programmed */
+  unsigned long programs;
+  unsigned long long program_bytes;
+  /* Sector erases */
+  unsigned long erases;
+  /* Programs that tried to clear bits of a page */
+  unsigned long clear_attempts;
+  /* Programs of a page beyond XMEM_PAGE_NOP */
+  unsigned long nop_exceeded;
+  /* The simulated time the flash was busy */
+  uint64_t busy_ns;
+};
+
+/**
+ * \brief      Gets the statistics of the emulated flash.
+ * \param stats Filled with the counters since the last reset.
+ */
+void xmem_emu_get_stats(struct xmem_stats *stats);
+
+/**
+ * \brief      Resets the statistics and the erase counters.
+ *
+ *             The content of the flash is kept.
+ */
+void xmem_emu_reset_stats(void);
+
+/**
+ * \brief      Gets the number of erases of a sector.
+ * \param sector The sector, below XMEM_SECTORS.
+ * \return     The erases of the sector since the last reset.
+ */
+unsigned long xmem_emu_erase_count(unsigned sector);
+
+#endif /* XMEM_EMU_H_ */
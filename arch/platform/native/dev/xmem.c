@@ -34,20 +34,87 @@
 
 #include "contiki.h"
 #include "dev/xmem.h"
+#include "dev/xmem-emu.h"
 
 #include <stdio.h>
 #include <fcntl.h>
 #include <unistd.h>
 #include <stdio.h>
 #include <string.h>
-
-#define XMEM_SIZE 1024 * 1024
+#include <time.h>
 
 static unsigned char xmem[XMEM_SIZE];
+
+static struct xmem_stats stats;
+static unsigned long erase_counts[XMEM_SECTORS];
+#if XMEM_PAGE_NOP
+/* The programs of each page since its last erase */
+static uint8_t page_programs[XMEM_PAGES];
+#endif /* XMEM_PAGE_NOP */
+/*---------------------------------------------------------------------------*/
+#if XMEM_DELAY
+static uint64_t
+now_ns(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+#endif /* XMEM_DELAY */
+/*---------------------------------------------------------------------------*/
+static void
+charge(uint64_t ns)
+{
+#if XMEM_DELAY
+  uint64_t end;
+
+  end = now_ns() + ns;
+  while(now_ns() < end);
+#endif /* XMEM_DELAY */
+  stats.busy_ns += ns;
+}
+/*---------------------------------------------------------------------------*/
+/* Programs a part of a page */
+static void
+program(const unsigned char *buf, unsigned long size, unsigned long offset)
+{
+  unsigned long i;
+
+  for(i = 0; i < size; i++) {
+    if(xmem[offset + i] & ~buf[i]) {
+      stats.clear_attempts++;
+      break;
+    }
+  }
+
+#if XMEM_STRICT
+  for(i = 0; i < size; i++) {
+    xmem[offset + i] |= buf[i];
+  }
+#else
+  memcpy(&xmem[offset], buf, size);
+#endif /* XMEM_STRICT */
+
+#if XMEM_PAGE_NOP
+  if(page_programs[offset / XMEM_PAGE_SIZE] == XMEM_PAGE_NOP) {
+    stats.nop_exceeded++;
+  } else {
+    page_programs[offset / XMEM_PAGE_SIZE]++;
+  }
+#endif /* XMEM_PAGE_NOP */
+
+  stats.programs++;
+  stats.program_bytes += size;
+  charge(XMEM_PROGRAM_NS + (uint64_t)XMEM_PROGRAM_BYTE_NS * size);
+}
 /*---------------------------------------------------------------------------*/
 int
 xmem_pwrite(const void *buf, int size, unsigned long offset)
 {
+  const unsigned char *p;
+  unsigned long end;
+  unsigned long chunk;
+
   /*  int f;
   char name[400];
 
@@ -59,23 +126,70 @@ xmem_pwrite(const void *buf, int size, unsigned long offset)
 
   /*  printf("xmem_write(offset 0x%02x, buf %p, size %l);\n", offset, buf, size);*/
 
-  memcpy(&xmem[offset], buf, size);
+  if(size <= 0 || offset + size > XMEM_SIZE) {
+    return size == 0 ? 0 : -1;
+  }
+
+  /* A program operation does not cross a page boundary. */
+  p = buf;
+  for(end = offset + size; offset < end; offset += chunk, p += chunk) {
+    chunk = XMEM_PAGE_SIZE - offset % XMEM_PAGE_SIZE;
+    if(chunk > end - offset) {
+      chunk = end - offset;
+    }
+    program(p, chunk, offset);
+  }
   return size;
 }
 /*---------------------------------------------------------------------------*/
 int
 xmem_pread(void *buf, int size, unsigned long offset)
 {
+  unsigned long accesses;
+
   /*  printf("xmem_read(addr 0x%02x, buf %p, size %d);\n", addr, buf, size);*/
+  if(size <= 0 || offset + size > XMEM_SIZE) {
+    return size == 0 ? 0 : -1;
+  }
+
   memcpy(buf, &xmem[offset], size);
+
+#if XMEM_READ_PAGED
+  accesses = (offset + size - 1) / XMEM_PAGE_SIZE - offset / XMEM_PAGE_SIZE + 1;
+#else
+  accesses = 1;
+#endif /* XMEM_READ_PAGED */
+  stats.reads++;
+  stats.read_bytes += size;
+  charge((uint64_t)XMEM_READ_NS * accesses +
+         (uint64_t)XMEM_READ_BYTE_NS * size);
   return size;
 }
 /*---------------------------------------------------------------------------*/
 int
 xmem_erase(long nbytes, unsigned long offset)
 {
+  unsigned long sector;
+
   /*  printf("xmem_read(addr 0x%02x, buf %p, size %d);\n", addr, buf, size);*/
+  if(nbytes <= 0 || offset + nbytes > XMEM_SIZE) {
+    return nbytes == 0 ? 0 : -1;
+  }
+
   memset(&xmem[offset], 0, nbytes);
+
+#if XMEM_PAGE_NOP
+  memset(&page_programs[offset / XMEM_PAGE_SIZE], 0,
+         (offset + nbytes - 1) / XMEM_PAGE_SIZE - offset / XMEM_PAGE_SIZE + 1);
+#endif /* XMEM_PAGE_NOP */
+
+  for(sector = offset / XMEM_SECTOR_SIZE;
+      sector <= (offset + nbytes - 1) / XMEM_SECTOR_SIZE;
+      sector++) {
+    erase_counts[sector]++;
+    stats.erases++;
+    charge(XMEM_ERASE_NS);
+  }
   return nbytes;
 }
 /*---------------------------------------------------------------------------*/
@@ -85,3 +199,22 @@ xmem_init(void)
 
 }
 /*---------------------------------------------------------------------------*/
+void
+xmem_emu_get_stats(struct xmem_stats *s)
+{
+  *s = stats;
+}
+/*---------------------------------------------------------------------------*/
+void
+xmem_emu_reset_stats(void)
+{
+  memset(&stats, 0, sizeof(stats));
+  memset(erase_counts, 0, sizeof(erase_counts));
+}
+/*---------------------------------------------------------------------------*/
+unsigned long
+xmem_emu_erase_count(unsigned sector)
+{
+  return sector < XMEM_SECTORS ? erase_counts[sector] : 0;
+}
+/*---------------------------------------------------------------------------*/
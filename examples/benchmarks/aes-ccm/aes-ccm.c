@@ -0,0 +1,151 @@
+/*
+ * Copyright (c) 2026, RISE Research Institutes of Sweden.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ *         Benchmark: measure the cost of AES-128 and of CCM* on a typical
+ *         IEEE 802.15.4 frame, in nanoseconds and in CPU cycles per byte.
+ *         Build with WITH_TTABLE=1 to use the table-driven AES-128.
+ */
+
+#include "contiki.h"
+#include "lib/aes-128.h"
+#include "lib/ccm-star.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define HAVE_RDTSC 1
+#endif
+/*---------------------------------------------------------------------------*/
+/* Number of AES blocks encrypted at each run */
+#define BLOCKS           1000000
+/* Number of frames secured at each run */
+#define FRAMES            100000
+/* Number of runs */
+#define RUNS                   3
+/* Frame layout: authenticated header, encrypted payload and MIC */
+#define HDR_LEN               21
+#define PAYLOAD_LEN           80
+#define MIC_LEN                8
+/*---------------------------------------------------------------------------*/
+PROCESS(aes_ccm_process, "AES-128 and CCM* benchmark");
+AUTOSTART_PROCESSES(&aes_ccm_process);
+
+static const uint8_t key[AES_128_KEY_LENGTH] = {
+  0xc0, 0xc1, 0xc2, 0xc3, 0xc4, 0xc5, 0xc6, 0xc7,
+  0xc8, 0xc9, 0xca, 0xcb, 0xcc, 0xcd, 0xce, 0xcf
+};
+static uint8_t nonce[CCM_STAR_NONCE_LENGTH];
+static uint8_t frame[HDR_LEN + PAYLOAD_LEN + MIC_LEN];
+/*---------------------------------------------------------------------------*/
+struct sample {
+  uint64_t ns;
+  uint64_t cycles;
+};
+
+static void
+sample(struct sample *s)
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  s->ns = (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+#if HAVE_RDTSC
+  s->cycles = __rdtsc();
+#else /* HAVE_RDTSC */
+  s->cycles = 0;
+#endif /* HAVE_RDTSC */
+}
+/*---------------------------------------------------------------------------*/
+static void
+report(const char *what, const struct sample *start, uint64_t bytes)
+{
+  struct sample end;
+
+  sample(&end);
+  printf("  %-16s %6.2f ns/byte", what,
+         (double)(end.ns - start->ns) / bytes);
+#if HAVE_RDTSC
+  printf(" %7.2f cycles/byte", (double)(end.cycles - start->cycles) / bytes);
+#endif /* HAVE_RDTSC */
+  printf("\n");
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(aes_ccm_process, ev, data)
+{
+  static uint8_t block[AES_128_BLOCK_SIZE];
+  static uint8_t mic[MIC_LEN];
+  struct sample start;
+  uint32_t i;
+  int run;
+
+  PROCESS_BEGIN();
+
+  printf("AES-128: %u blocks, CCM*: %u frames with a %u-byte header, "
+         "%u-byte payload and %u-byte MIC\n",
+         BLOCKS, FRAMES, HDR_LEN, PAYLOAD_LEN, MIC_LEN);
+
+  for(run = 0; run < RUNS; run++) {
+    printf("Run %d:\n", run + 1);
+
+    AES_128.set_key(key);
+    sample(&start);
+    for(i = 0; i < BLOCKS; i++) {
+      AES_128.encrypt(block);
+    }
+    report("AES-128", &start, (uint64_t)BLOCKS * AES_128_BLOCK_SIZE);
+
+    CCM_STAR.set_key(key);
+    sample(&start);
+    for(i = 0; i < FRAMES; i++) {
+      nonce[12] = i;
+      CCM_STAR.aead(nonce, frame + HDR_LEN, PAYLOAD_LEN, frame, HDR_LEN,
+                    frame + HDR_LEN + PAYLOAD_LEN, MIC_LEN, 1);
+    }
+    report("CCM* encrypt", &start, (uint64_t)FRAMES * sizeof(frame));
+
+    sample(&start);
+    for(i = 0; i < FRAMES; i++) {
+      nonce[12] = i;
+      CCM_STAR.aead(nonce, frame + HDR_LEN, PAYLOAD_LEN, frame, HDR_LEN,
+                    mic, MIC_LEN, 0);
+    }
+    report("CCM* decrypt", &start, (uint64_t)FRAMES * sizeof(frame));
+  }
+
+  /* Keep the results alive */
+  printf("Done (%02x%02x)\n", block[0], mic[0]);
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
@@ -0,0 +1,182 @@
+/*
+ * Copyright (c) 2026, RISE Research Institutes of Sweden.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ *         Benchmark: measure the time, the tuple reads and the CFS
+ *         writes of aggregate queries in Antelope.
+ */
+
+#include "contiki.h"
+#include "antelope.h"
+#include "storage.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <time.h>
+/*---------------------------------------------------------------------------*/
+/* Number of tuples in the relation */
+#define ROWS                 5000
+/* Number of executions of each query */
+#define RUNS                   20
+/*---------------------------------------------------------------------------*/
+PROCESS(antelope_aggregate_process, "Antelope aggregate benchmark");
+AUTOSTART_PROCESSES(&antelope_aggregate_process);
+
+static const char *queries[] = {
+  "SELECT COUNT(id), MIN(id), MAX(id) FROM samples;",
+  "SELECT MIN(id) FROM samples WHERE id > 2500;",
+  "SELECT SUM(id) FROM samples WHERE id >= 1000 AND id < 2000;",
+  "SELECT MAX(value) FROM samples WHERE id >= 1000 AND id < 2000;",
+  "SELECT MAX(value) FROM samples;"
+};
+
+static db_handle_t handle;
+static unsigned long reads;
+static unsigned long writes;
+/*---------------------------------------------------------------------------*/
+db_result_t __real_storage_get_row(relation_t *, tuple_id_t *, storage_row_t);
+
+db_result_t
+__wrap_storage_get_row(relation_t *rel, tuple_id_t *tuple_id,
+                       storage_row_t row)
+{
+  reads++;
+  return __real_storage_get_row(rel, tuple_id, row);
+}
+/*---------------------------------------------------------------------------*/
+int __real_cfs_write(int fd, const void *buf, unsigned len);
+
+int
+__wrap_cfs_write(int fd, const void *buf, unsigned len)
+{
+  writes++;
+  return __real_cfs_write(fd, buf, len);
+}
+/*---------------------------------------------------------------------------*/
+static uint64_t
+now_ns(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+/*---------------------------------------------------------------------------*/
+static int
+create_relation(void)
+{
+  int i;
+
+  /* Remove the host files of a previous run. */
+  db_query(NULL, "REMOVE RELATION samples;");
+
+  if(DB_ERROR(db_query(NULL, "CREATE RELATION samples;")) ||
+     DB_ERROR(db_query(NULL, "CREATE ATTRIBUTE id DOMAIN INT IN samples;")) ||
+     DB_ERROR(db_query(NULL,
+                       "CREATE ATTRIBUTE value DOMAIN LONG IN samples;")) ||
+     DB_ERROR(db_query(NULL, "CREATE INDEX samples.id TYPE BTREE;"))) {
+    return 0;
+  }
+
+  for(i = 0; i < ROWS; i++) {
+    if(DB_ERROR(db_query(NULL, "INSERT (%d, %ld) INTO samples;",
+                         (int)((i * 7919L) % ROWS), 100000L + i))) {
+      return 0;
+    }
+  }
+  return 1;
+}
+/*---------------------------------------------------------------------------*/
+/* Executes an aggregate query, and returns the first aggregated value */
+static long
+aggregate(const char *query)
+{
+  attribute_value_t value;
+  db_result_t result;
+  long first;
+
+  first = -1;
+  if(DB_ERROR(db_query(&handle, query))) {
+    return first;
+  }
+
+  while(db_processing(&handle)) {
+    result = db_process(&handle);
+    if(result == DB_GOT_ROW) {
+      if(DB_SUCCESS(db_get_value(&value, &handle, 0))) {
+        first = db_value_to_long(&value);
+      }
+    } else if(result == DB_FINISHED || DB_ERROR(result)) {
+      break;
+    }
+  }
+  db_free(&handle);
+  return first;
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(antelope_aggregate_process, ev, data)
+{
+  static unsigned q;
+  int run;
+  uint64_t start;
+  double usecs;
+  long first;
+
+  PROCESS_BEGIN();
+
+  db_init();
+
+  printf("Antelope: aggregates over %d tuples, %s\n", ROWS,
+         DB_FEATURE_AGGREGATE ? "index keys" : "tuple scans");
+
+  if(!create_relation()) {
+    printf("Failed to create the relation\n");
+    PROCESS_EXIT();
+  }
+
+  for(q = 0; q < sizeof(queries) / sizeof(queries[0]); q++) {
+    first = 0;
+    reads = writes = 0;
+    start = now_ns();
+    for(run = 0; run < RUNS; run++) {
+      first = aggregate(queries[q]);
+    }
+    usecs = (double)(now_ns() - start) / 1e3 / RUNS;
+    printf("%s\n  result %ld, %.0f us, %lu tuple reads, %lu CFS writes\n",
+           queries[q], first, usecs, reads / RUNS, writes / RUNS);
+    PROCESS_PAUSE();
+  }
+
+  db_query(NULL, "REMOVE RELATION samples;");
+
+  printf("Done\n");
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
@@ -0,0 +1,153 @@
+/*
+ * Copyright (c) 2026, RISE Research Institutes of Sweden.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ *         Benchmark: compare the insertion throughput of Antelope when
+ *         each tuple is written by itself and when the tuples are
+ *         inserted in batches.
+ */
+
+#include "contiki.h"
+#include "antelope.h"
+#include "cfs/cfs-coffee.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <time.h>
+/*---------------------------------------------------------------------------*/
+/* Number of tuples inserted into each relation */
+#define ROWS                 5000
+/* Number of runs of each method */
+#define RUNS                    5
+/*---------------------------------------------------------------------------*/
+PROCESS(antelope_batch_process, "Antelope batch benchmark");
+AUTOSTART_PROCESSES(&antelope_batch_process);
+
+static unsigned long writes;
+/*---------------------------------------------------------------------------*/
+int __real_cfs_write(int fd, const void *buf, unsigned len);
+
+int
+__wrap_cfs_write(int fd, const void *buf, unsigned len)
+{
+  writes++;
+  return __real_cfs_write(fd, buf, len);
+}
+/*---------------------------------------------------------------------------*/
+static uint64_t
+now_ns(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+/*---------------------------------------------------------------------------*/
+static int
+create_relation(const char *relation)
+{
+  /* Remove the host files of a previous run. */
+  db_query(NULL, "REMOVE RELATION %s;", relation);
+
+  return DB_SUCCESS(db_query(NULL, "CREATE RELATION %s;", relation)) &&
+    DB_SUCCESS(db_query(NULL, "CREATE ATTRIBUTE time DOMAIN LONG IN %s;",
+                        relation)) &&
+    DB_SUCCESS(db_query(NULL, "CREATE ATTRIBUTE value DOMAIN INT IN %s;",
+                        relation)) &&
+    DB_SUCCESS(db_query(NULL, "CREATE INDEX %s.time TYPE INLINE;",
+                        relation));
+}
+/*---------------------------------------------------------------------------*/
+/* Inserts sensor readings, and returns the number of successful inserts */
+static int
+insert_rows(const char *relation, int batched)
+{
+  int i;
+
+  if(batched && DB_ERROR(db_batch_begin(relation))) {
+    return 0;
+  }
+
+  for(i = 0; i < ROWS; i++) {
+    if(DB_ERROR(db_query(NULL, "INSERT (%ld, %d) INTO %s;",
+                         100000L + i * 60, i % 1000, relation))) {
+      break;
+    }
+  }
+
+  if(batched && DB_ERROR(db_batch_end())) {
+    return 0;
+  }
+  return i;
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(antelope_batch_process, ev, data)
+{
+  static int run;
+  const char *name;
+  int batched;
+  uint64_t start;
+  double seconds;
+  int count;
+
+  PROCESS_BEGIN();
+
+#if DB_FEATURE_COFFEE
+  cfs_coffee_format();
+#endif
+  db_init();
+
+  printf("Antelope: %d inserts, batch buffer of %d bytes, %s\n",
+         ROWS, DB_BATCH_BUFFER_SIZE, DB_FEATURE_COFFEE ? "Coffee" : "files");
+
+  /* The methods take turns, so that they run under similar conditions. */
+  for(run = 0; run < 2 * RUNS; run++) {
+    batched = run & 1;
+    name = batched ? "batch" : "single";
+    if(!create_relation(name)) {
+      printf("%s: failed to create the relation\n", name);
+      continue;
+    }
+
+    writes = 0;
+    start = now_ns();
+    count = insert_rows(name, batched);
+    seconds = (double)(now_ns() - start) / 1e9;
+    printf("%s: %d of %d inserts, %.0f rows/s, %.2f CFS writes per row\n",
+           name, count, ROWS, count / seconds, (double)writes / ROWS);
+
+    db_query(NULL, "REMOVE RELATION %s;", name);
+    PROCESS_PAUSE();
+  }
+
+  printf("Done\n");
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
@@ -0,0 +1,196 @@
+/*
+ * Copyright (c) 2026, RISE Research Institutes of Sweden.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ *         Benchmark: compare the insertion and range query throughput of
+ *         Antelope without an index, with a MaxHeap index and, if built
+ *         with WITH_BTREE=1, with a B+-tree index.
+ */
+
+#include "contiki.h"
+#include "antelope.h"
+#include "cfs/cfs-coffee.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <time.h>
+/*---------------------------------------------------------------------------*/
+/* Number of tuples inserted into each relation */
+#define ROWS                 2000
+/* Range of the indexed keys */
+#define KEY_RANGE           30000
+/* Number of range queries, and the width of each range */
+#define QUERIES                50
+#define QUERY_WIDTH           300
+/*---------------------------------------------------------------------------*/
+PROCESS(antelope_index_process, "Antelope index benchmark");
+AUTOSTART_PROCESSES(&antelope_index_process);
+
+static const struct {
+  const char *name;
+  const char *type;
+} indexes[] = {
+  { "none", NULL },
+  { "maxheap", "MAXHEAP" },
+#if DB_FEATURE_BTREE
+  { "btree", "BTREE" },
+#endif
+};
+
+static unsigned long writes;
+static unsigned long random_state;
+static db_handle_t handle;
+/*---------------------------------------------------------------------------*/
+int __real_xmem_pwrite(const void *buf, int nbytes, unsigned long offset);
+
+int
+__wrap_xmem_pwrite(const void *buf, int nbytes, unsigned long offset)
+{
+  writes++;
+  return __real_xmem_pwrite(buf, nbytes, offset);
+}
+/*---------------------------------------------------------------------------*/
+static uint64_t
+now_ns(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+/*---------------------------------------------------------------------------*/
+static unsigned
+random_key(void)
+{
+  random_state = random_state * 1103515245 + 12345;
+  return (random_state >> 16) % KEY_RANGE;
+}
+/*---------------------------------------------------------------------------*/
+/* Creates a relation, and returns the number of tuples inserted */
+static int
+insert_rows(const char *relation, const char *type)
+{
+  int i;
+
+  if(DB_ERROR(db_query(NULL, "CREATE RELATION %s;", relation)) ||
+     DB_ERROR(db_query(NULL, "CREATE ATTRIBUTE key DOMAIN INT IN %s;",
+                       relation)) ||
+     DB_ERROR(db_query(NULL, "CREATE ATTRIBUTE value DOMAIN INT IN %s;",
+                       relation))) {
+    return 0;
+  }
+  if(type != NULL &&
+     DB_ERROR(db_query(NULL, "CREATE INDEX %s.key TYPE %s;",
+                       relation, type))) {
+    return 0;
+  }
+
+  /* Each relation gets the same keys. */
+  random_state = 1;
+  for(i = 0; i < ROWS; i++) {
+    if(DB_ERROR(db_query(NULL, "INSERT (%u, %d) INTO %s;",
+                         random_key(), i, relation))) {
+      break;
+    }
+  }
+  return i;
+}
+/*---------------------------------------------------------------------------*/
+/* Runs the range queries, and returns the number of tuples found */
+static long
+query_ranges(const char *relation)
+{
+  db_result_t result;
+  unsigned min;
+  long found;
+  int i;
+
+  random_state = 2;
+  found = 0;
+  for(i = 0; i < QUERIES; i++) {
+    min = random_key();
+    if(DB_ERROR(db_query(&handle,
+                         "SELECT value FROM %s WHERE key >= %u AND "
+                         "key < %u;", relation, min, min + QUERY_WIDTH))) {
+      return -1;
+    }
+    while(db_processing(&handle)) {
+      result = db_process(&handle);
+      if(result == DB_GOT_ROW) {
+        found++;
+      } else if(result == DB_FINISHED || DB_ERROR(result)) {
+        break;
+      }
+    }
+    db_free(&handle);
+  }
+  return found;
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(antelope_index_process, ev, data)
+{
+  static int i;
+  char relation[8];
+  uint64_t start;
+  int count;
+  long found;
+
+  PROCESS_BEGIN();
+
+  cfs_coffee_format();
+  db_init();
+
+  printf("Antelope: %d tuples, %d queries over %d of %d keys\n",
+         ROWS, QUERIES, QUERY_WIDTH, KEY_RANGE);
+
+  for(i = 0; i < sizeof(indexes) / sizeof(indexes[0]); i++) {
+    snprintf(relation, sizeof(relation), "rel%d", i);
+
+    writes = 0;
+    start = now_ns();
+    count = insert_rows(relation, indexes[i].type);
+    printf("%s: %d of %d inserts, %.2f us and %.2f writes per insert\n",
+           indexes[i].name, count, ROWS,
+           (double)(now_ns() - start) / 1e3 / ROWS, (double)writes / ROWS);
+
+    start = now_ns();
+    found = query_ranges(relation);
+    printf("%s: %ld tuples found, %.2f us per query\n",
+           indexes[i].name, found,
+           (double)(now_ns() - start) / 1e3 / QUERIES);
+
+    /* Let the index loader process run, if there is one. */
+    PROCESS_PAUSE();
+  }
+
+  printf("Done\n");
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
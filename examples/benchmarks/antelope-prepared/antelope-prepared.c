@@ -0,0 +1,190 @@
+/*
+ * Copyright (c) 2026, RISE Research Institutes of Sweden.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ *         Benchmark: compare the time per INSERT and per SELECT in
+ *         Antelope when each query is parsed by db_query() and when
+ *         it is prepared once and executed with bound parameters.
+ */
+
+#include "contiki.h"
+#include "antelope.h"
+#include "cfs/cfs-coffee.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <time.h>
+/*---------------------------------------------------------------------------*/
+/* Number of tuples inserted into each relation */
+#define ROWS                 2000
+/* Number of lookups of single keys */
+#define QUERIES              1000
+/*---------------------------------------------------------------------------*/
+PROCESS(antelope_prepared_process, "Antelope prepared statement benchmark");
+AUTOSTART_PROCESSES(&antelope_prepared_process);
+
+static db_handle_t handle;
+static db_statement_t insert;
+static db_statement_t lookup;
+/*---------------------------------------------------------------------------*/
+static uint64_t
+now_ns(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+/*---------------------------------------------------------------------------*/
+static int
+create_relation(void)
+{
+  return DB_SUCCESS(db_query(NULL, "CREATE RELATION samples;")) &&
+    DB_SUCCESS(db_query(NULL,
+                        "CREATE ATTRIBUTE time DOMAIN LONG IN samples;")) &&
+    DB_SUCCESS(db_query(NULL,
+                        "CREATE ATTRIBUTE value DOMAIN INT IN samples;")) &&
+    DB_SUCCESS(db_query(NULL, "CREATE INDEX samples.time TYPE MAXHEAP;"));
+}
+/*---------------------------------------------------------------------------*/
+/*
+ * Inserts the tuples with time stamps starting at base, and returns
+ * the number of successful inserts.
+ */
+static int
+insert_rows(long base, int prepared)
+{
+  int i;
+
+  if(prepared &&
+     DB_ERROR(db_prepare(&insert, "INSERT (?, ?) INTO samples;"))) {
+    return 0;
+  }
+
+  for(i = 0; i < ROWS; i++) {
+    if(prepared) {
+      db_bind(&insert, 0, base + i);
+      db_bind(&insert, 1, i);
+      if(DB_ERROR(db_execute(NULL, &insert))) {
+        break;
+      }
+    } else if(DB_ERROR(db_query(NULL, "INSERT (%ld, %d) INTO samples;",
+                                base + i, i))) {
+      break;
+    }
+  }
+  return i;
+}
+/*---------------------------------------------------------------------------*/
+/* Looks up single keys, and returns the number of tuples found */
+static long
+lookup_keys(long base, int prepared)
+{
+  db_result_t result;
+  long found;
+  long key;
+  int i;
+
+  if(prepared &&
+     DB_ERROR(db_prepare(&lookup,
+                         "SELECT value FROM samples WHERE time = ?;"))) {
+    return -1;
+  }
+
+  found = 0;
+  for(i = 0; i < QUERIES; i++) {
+    key = base + (i * 7L) % ROWS;
+    if(prepared) {
+      db_bind(&lookup, 0, key);
+      result = db_execute(&handle, &lookup);
+    } else {
+      result = db_query(&handle,
+                        "SELECT value FROM samples WHERE time = %ld;", key);
+    }
+    if(DB_ERROR(result)) {
+      return -1;
+    }
+    while(db_processing(&handle)) {
+      result = db_process(&handle);
+      if(result == DB_GOT_ROW) {
+        found++;
+      } else if(result == DB_FINISHED || DB_ERROR(result)) {
+        break;
+      }
+    }
+    db_free(&handle);
+  }
+  return found;
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(antelope_prepared_process, ev, data)
+{
+  static int prepared;
+  const char *name;
+  long base;
+  uint64_t start;
+  int count;
+  long found;
+
+  PROCESS_BEGIN();
+
+  cfs_coffee_format();
+  db_init();
+
+  printf("Antelope: %d inserts and %d lookups\n", ROWS, QUERIES);
+
+  if(!create_relation()) {
+    printf("Failed to create the relation\n");
+    PROCESS_EXIT();
+  }
+
+  /* Both methods use the same relation, but different time stamps. */
+  for(prepared = 0; prepared <= 1; prepared++) {
+    name = prepared ? "prepared" : "db_query";
+    base = (prepared + 1) * 100000L;
+
+    start = now_ns();
+    count = insert_rows(base, prepared);
+    printf("%s: %d of %d inserts, %.2f us per insert\n",
+           name, count, ROWS, (double)(now_ns() - start) / 1e3 / ROWS);
+
+    start = now_ns();
+    found = lookup_keys(base, prepared);
+    printf("%s: %ld tuples found, %.2f us per lookup\n",
+           name, found, (double)(now_ns() - start) / 1e3 / QUERIES);
+
+    /* Let the index loader process run. */
+    PROCESS_PAUSE();
+  }
+
+  printf("Done\n");
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
@@ -0,0 +1,225 @@
+/*
+ * Copyright (c) 2026, RISE Research Institutes of Sweden.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+/**
+ * \file
+ *         Benchmark: measure the footprint and the range queries of a
+ *         time series in Antelope.
+ */
+
+#include "contiki.h"
+#include "antelope.h"
+#include "relation.h"
+#include "storage.h"
+#include "cfs/cfs.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+/*---------------------------------------------------------------------------*/
+/* Number of tuples in the relation */
+#define ROWS                 5000
+/* Number of executions of each query */
+#define RUNS                   20
+/*---------------------------------------------------------------------------*/
+PROCESS(antelope_timeseries_process, "Antelope time-series benchmark");
+AUTOSTART_PROCESSES(&antelope_timeseries_process);
+
+static const char *queries[] = {
+  "SELECT value FROM readings WHERE time >= 20000 AND time < 21000;",
+  "SELECT value FROM readings WHERE time > 48000;",
+  "SELECT value FROM readings WHERE time >= 10000 AND time < 40000;",
+  "SELECT time FROM readings WHERE value > 290;"
+};
+
+static db_handle_t handle;
+static unsigned long reads;
+/*---------------------------------------------------------------------------*/
+db_result_t __real_storage_get_row(relation_t *, tuple_id_t *, storage_row_t);
+
+db_result_t
+__wrap_storage_get_row(relation_t *rel, tuple_id_t *tuple_id,
+                       storage_row_t row)
+{
+  reads++;
+  return __real_storage_get_row(rel, tuple_id, row);
+}
+/*---------------------------------------------------------------------------*/
+static uint64_t
+now_ns(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+/*---------------------------------------------------------------------------*/
+static long
+file_size(const char *filename)
+{
+  int fd;
+  long size;
+
+  fd = cfs_open(filename, CFS_READ);
+  if(fd < 0) {
+    return 0;
+  }
+  size = cfs_seek(fd, 0, CFS_SEEK_END);
+  cfs_close(fd);
+  return size;
+}
+/*---------------------------------------------------------------------------*/
+/* Returns the size of the files that hold the tuples of the relation */
+static long
+relation_size(void)
+{
+  relation_t *rel;
+  char filename[RELATION_NAME_LENGTH + 1];
+  long size;
+
+  rel = relation_load("readings");
+  if(rel == NULL) {
+    return -1;
+  }
+  strcpy(filename, rel->tuple_filename);
+  size = file_size(filename);
+#if DB_FEATURE_TIMESERIES
+  if(storage_is_timeseries(rel)) {
+    /* The tail file is named after the tuple file. */
+    filename[1] = 'l';
+    size += file_size(filename);
+  }
+#endif /* DB_FEATURE_TIMESERIES */
+  relation_release(rel);
+  return size;
+}
+/*---------------------------------------------------------------------------*/
+static int
+create_relation(void)
+{
+  int i;
+
+  /* Remove the host files of a previous run. */
+  db_query(NULL, "REMOVE RELATION readings;");
+
+  if(DB_ERROR(db_query(NULL, "CREATE RELATION readings;")) ||
+     DB_ERROR(db_query(NULL,
+                       "CREATE ATTRIBUTE time DOMAIN LONG IN readings;")) ||
+     DB_ERROR(db_query(NULL,
+                       "CREATE ATTRIBUTE sensor DOMAIN INT IN readings;")) ||
+     DB_ERROR(db_query(NULL,
+                       "CREATE ATTRIBUTE value DOMAIN INT IN readings;"))) {
+    return 0;
+  }
+
+#if DB_FEATURE_TIMESERIES
+  if(DB_ERROR(db_set_timeseries("readings"))) {
+    return 0;
+  }
+#endif /* DB_FEATURE_TIMESERIES */
+
+  /* Periodic samples of a slowly changing value. */
+  for(i = 0; i < ROWS; i++) {
+    if(DB_ERROR(db_query(NULL, "INSERT (%ld, %d, %d) INTO readings;",
+                         10000L + i * 10, i % 4,
+                         200 + (i / 10) % 100))) {
+      return 0;
+    }
+  }
+  return 1;
+}
+/*---------------------------------------------------------------------------*/
+/* Executes a selection, and returns the number of tuples */
+static long
+select_rows(const char *query)
+{
+  db_result_t result;
+  long count;
+
+  count = -1;
+  if(DB_ERROR(db_query(&handle, query))) {
+    return count;
+  }
+
+  count = 0;
+  while(db_processing(&handle)) {
+    result = db_process(&handle);
+    if(result == DB_GOT_ROW) {
+      count++;
+    } else if(result == DB_FINISHED || DB_ERROR(result)) {
+      break;
+    }
+  }
+  db_free(&handle);
+  return count;
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(antelope_timeseries_process, ev, data)
+{
+  static unsigned q;
+  int run;
+  uint64_t start;
+  double usecs;
+  long count;
+
+  PROCESS_BEGIN();
+
+  db_init();
+
+  printf("Antelope: %d tuples in a %s relation\n", ROWS,
+         DB_FEATURE_TIMESERIES ? "time-series" : "plain");
+
+  start = now_ns();
+  if(!create_relation()) {
+    printf("Failed to create the relation\n");
+    PROCESS_EXIT();
+  }
+  usecs = (double)(now_ns() - start) / 1e3 / ROWS;
+  printf("Insert: %.1f us per tuple, %ld bytes stored\n",
+         usecs, relation_size());
+
+  for(q = 0; q < sizeof(queries) / sizeof(queries[0]); q++) {
+    count = 0;
+    reads = 0;
+    start = now_ns();
+    for(run = 0; run < RUNS; run++) {
+      count = select_rows(queries[q]);
+    }
+    usecs = (double)(now_ns() - start) / 1e3 / RUNS;
+    printf("%s\n  %ld tuples, %.0f us, %lu tuple reads\n",
+           queries[q], count, usecs, reads / RUNS);
+    PROCESS_PAUSE();
+  }
+
+  db_query(NULL, "REMOVE RELATION readings;");
+
+  printf("Done\n");
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
@@ -0,0 +1,137 @@
+/*
+ * Copyright (c) 2026, RISE Research Institutes of Sweden.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ *         Benchmark: measure how fast requests are dispatched to CoAP
+ *         resources as the number of activated resources grows, with
+ *         paths laid out like the objects of an LwM2M gateway.
+ *         Build with WITH_INDEX=1 to compare with the resource index.
+ */
+
+#include "contiki.h"
+#include "coap-engine.h"
+#include "lib/random.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+/*---------------------------------------------------------------------------*/
+/* Number of resources after each step of the benchmark */
+static const unsigned steps[] = { 8, 32, 128, 512 };
+#define MAX_RESOURCES          512
+/* Number of instances of each object and resources of each instance */
+#define INSTANCES                4
+#define RESOURCES                8
+/* Number of lookups measured at each step */
+#define LOOKUPS             200000
+#define PATH_LEN                24
+/*---------------------------------------------------------------------------*/
+PROCESS(coap_dispatch_process, "CoAP dispatch benchmark");
+AUTOSTART_PROCESSES(&coap_dispatch_process);
+/*---------------------------------------------------------------------------*/
+/* A parent resource, which handles all the paths below "fw" */
+PARENT_RESOURCE(res_firmware, "title=\"Firmware\"", NULL, NULL, NULL, NULL);
+
+static coap_resource_t resources[MAX_RESOURCES];
+static char paths[MAX_RESOURCES][PATH_LEN];
+/*---------------------------------------------------------------------------*/
+static uint64_t
+now_ns(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+/*---------------------------------------------------------------------------*/
+static void
+activate(unsigned i)
+{
+  unsigned resource = i % RESOURCES;
+  unsigned instance = (i / RESOURCES) % INSTANCES;
+  unsigned object = 3300 + i / (RESOURCES * INSTANCES);
+
+  snprintf(paths[i], PATH_LEN, "%u/%u/%u", object, instance, 5700 + resource);
+  resources[i].flags = METHOD_GET;
+  coap_activate_resource(&resources[i], paths[i]);
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(coap_dispatch_process, ev, data)
+{
+  static unsigned activated;
+  static char request[PATH_LEN];
+  uint64_t start, elapsed;
+  unsigned errors;
+
+  PROCESS_BEGIN();
+
+  random_init(1);
+  printf("CoAP dispatch: %u lookups per step, resource index %s\n",
+         LOOKUPS, COAP_RESOURCE_INDEX_SIZE ? "enabled" : "disabled");
+
+  coap_activate_resource(&res_firmware, "fw");
+
+  for(unsigned step = 0; step < sizeof(steps) / sizeof(steps[0]); step++) {
+    while(activated < steps[step]) {
+      activate(activated++);
+    }
+
+    errors = 0;
+    start = now_ns();
+    for(unsigned i = 0; i < LOOKUPS; i++) {
+      coap_resource_t *expected;
+      const char *path;
+
+      /* One request out of eight goes to a sub-resource of the parent. */
+      if(i % 8 == 0) {
+        path = "fw/package/0";
+        expected = &res_firmware;
+      } else {
+        unsigned index = random_rand() % activated;
+        path = paths[index];
+        expected = &resources[index];
+      }
+
+      strcpy(request, path);
+      if(coap_find_resource(request, strlen(request)) != expected) {
+        errors++;
+      }
+    }
+    elapsed = now_ns() - start;
+
+    printf("Resources: %u, lookups/s: %lu, mean %lu ns, errors %u\n",
+           activated + 2,
+           (unsigned long)(LOOKUPS * 1000000000ULL / (elapsed ? elapsed : 1)),
+           (unsigned long)(elapsed / LOOKUPS), errors);
+  }
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
@@ -0,0 +1,161 @@
+/*
+ * Copyright (c) 2026, RISE Research Institutes of Sweden.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ *         Benchmark: count the writes to the storage when Coffee appends
+ *         small records to a file, with and without the write cache.
+ */
+
+#include "contiki.h"
+#include "cfs/cfs.h"
+#include "cfs/cfs-coffee.h"
+#include "cfs-coffee-arch.h"
+#include "dev/xmem.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+/*---------------------------------------------------------------------------*/
+/* Number of records appended to the file */
+#define RECORDS              4096
+
+#ifndef COFFEE_WRITE_CACHES
+#define COFFEE_WRITE_CACHES 0
+#endif
+/*---------------------------------------------------------------------------*/
+PROCESS(coffee_append_process, "Coffee append benchmark");
+AUTOSTART_PROCESSES(&coffee_append_process);
+
+/* A sensor sample. The last byte is nonzero, so that Coffee finds it. */
+struct record {
+  uint32_t time;
+  int16_t values[5];
+  uint8_t flags;
+  uint8_t marker;
+};
+
+static unsigned long writes;
+static unsigned long written;
+static uint64_t elapsed;
+/*---------------------------------------------------------------------------*/
+int __real_xmem_pwrite(const void *buf, int nbytes, unsigned long offset);
+
+int
+__wrap_xmem_pwrite(const void *buf, int nbytes, unsigned long offset)
+{
+  writes++;
+  written += nbytes;
+  return __real_xmem_pwrite(buf, nbytes, offset);
+}
+/*---------------------------------------------------------------------------*/
+static uint64_t
+now_ns(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+/*---------------------------------------------------------------------------*/
+/*
+ * Writes a header record, updates it in place, and appends the records.
+ * Returns the number of records appended.
+ */
+static int
+append_records(int io_flags)
+{
+  struct record record;
+  int fd;
+  int i;
+
+  cfs_coffee_format();
+  if(cfs_coffee_reserve("samples", (RECORDS + 1) * sizeof(record)) < 0) {
+    return 0;
+  }
+  fd = cfs_open("samples", CFS_WRITE);
+  if(fd < 0) {
+    return 0;
+  }
+
+  memset(&record, 0, sizeof(record));
+  record.marker = 0xff;
+  cfs_write(fd, &record, sizeof(record));
+  if(io_flags == 0) {
+    record.flags = 1;
+    cfs_seek(fd, 0, CFS_SEEK_SET);
+    cfs_write(fd, &record, sizeof(record));
+  }
+  cfs_coffee_set_io_semantics(fd, io_flags);
+
+  writes = 0;
+  written = 0;
+  elapsed = now_ns();
+  for(i = 0; i < RECORDS; i++) {
+    record.time = i;
+    record.values[0] = i & 0xff;
+    if(cfs_write(fd, &record, sizeof(record)) != sizeof(record)) {
+      break;
+    }
+  }
+  cfs_close(fd);
+  elapsed = now_ns() - elapsed;
+  return i;
+}
+/*---------------------------------------------------------------------------*/
+static void
+run(const char *name, int io_flags)
+{
+  int count;
+
+  count = append_records(io_flags);
+  printf("%s: %d of %d records, %.3f writes and %.1f bytes per record, "
+         "%.2f us per record\n",
+         name, count, RECORDS,
+         (double)writes / RECORDS, (double)written / RECORDS,
+         (double)elapsed / 1e3 / RECORDS);
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(coffee_append_process, ev, data)
+{
+  PROCESS_BEGIN();
+
+  printf("Coffee: write cache %s, micro logs %s, %u-byte records\n",
+         COFFEE_WRITE_CACHES ? "on" : "off",
+         COFFEE_MICRO_LOGS ? "on" : "off",
+         (unsigned)sizeof(struct record));
+
+  run("Updated header", 0);
+  run("Append-only", CFS_COFFEE_IO_APPEND_ONLY);
+
+  printf("Done\n");
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
@@ -0,0 +1,141 @@
+/*
+ * Copyright (c) 2026, RISE Research Institutes of Sweden.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ *         Benchmark: measure the time it takes Coffee to open a file that
+ *         is not in its file cache, for a growing number of files on the
+ *         storage. Build with WITH_DIRECTORY=1 to compare.
+ */
+
+#include "contiki.h"
+#include "cfs/cfs.h"
+#include "cfs/cfs-coffee.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <time.h>
+/*---------------------------------------------------------------------------*/
+/* Number of times each file is opened */
+#define ROUNDS                  4
+/* Reserved size of each file */
+#define FILE_SIZE             200
+
+#ifndef COFFEE_DIRECTORY
+#define COFFEE_DIRECTORY 0
+#endif
+/*---------------------------------------------------------------------------*/
+PROCESS(coffee_open_process, "Coffee open benchmark");
+AUTOSTART_PROCESSES(&coffee_open_process);
+
+static const int file_counts[] = { 100, 200, 400, 800 };
+/*---------------------------------------------------------------------------*/
+static uint64_t
+now_ns(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+/*---------------------------------------------------------------------------*/
+static void
+file_name(char *name, int i)
+{
+  snprintf(name, 16, "log-%d", i);
+}
+/*---------------------------------------------------------------------------*/
+/* Creates the files, and returns the number of files created */
+static int
+create_files(int count)
+{
+  char name[16];
+  int i;
+
+  cfs_coffee_format();
+  for(i = 0; i < count; i++) {
+    file_name(name, i);
+    if(cfs_coffee_reserve(name, FILE_SIZE) < 0) {
+      break;
+    }
+  }
+  return i;
+}
+/*---------------------------------------------------------------------------*/
+/*
+ * Opens the files in turn, so that the file cache of Coffee always
+ * misses, and returns the number of files opened.
+ */
+static int
+open_files(int count)
+{
+  char name[16];
+  int opened;
+  int round;
+  int fd;
+  int i;
+
+  opened = 0;
+  for(round = 0; round < ROUNDS; round++) {
+    for(i = 0; i < count; i++) {
+      file_name(name, i);
+      fd = cfs_open(name, CFS_READ);
+      if(fd >= 0) {
+        cfs_close(fd);
+        opened++;
+      }
+    }
+  }
+  return opened;
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(coffee_open_process, ev, data)
+{
+  int i;
+  int count;
+  int opened;
+  uint64_t start;
+
+  PROCESS_BEGIN();
+
+  printf("Coffee: directory %s\n", COFFEE_DIRECTORY ? "on" : "off");
+
+  for(i = 0; i < sizeof(file_counts) / sizeof(file_counts[0]); i++) {
+    count = create_files(file_counts[i]);
+    start = now_ns();
+    opened = open_files(count);
+    printf("%d files: %d of %d opens, %.2f us per open\n",
+           count, opened, ROUNDS * count,
+           (double)(now_ns() - start) / 1e3 / (ROUNDS * count));
+  }
+
+  printf("Done\n");
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
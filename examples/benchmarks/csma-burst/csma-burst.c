@@ -0,0 +1,251 @@
+/*
+ * Copyright (c) 2026, RISE Research Institutes of Sweden.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ *         Benchmark: measure the number of frames per second that CSMA
+ *         sends when its neighbor queues are kept full. Build with
+ *         WITH_BURST=1, WITH_SHARED_TIMER=1 or WITH_HASH=1 to compare.
+ */
+
+#include "contiki.h"
+#include "net/netstack.h"
+#include "net/packetbuf.h"
+#include "net/mac/mac.h"
+#include "dev/radio.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+/*---------------------------------------------------------------------------*/
+/* Number of neighbors that frames are sent to. With a single neighbor the
+   backoff between frames is not hidden behind other neighbors' airtime */
+#define NEIGHBORS                1
+/* Number of frames queued for each neighbor at any time */
+#define FRAMES_IN_QUEUE          4
+/* Number of frames sent at each run */
+#define FRAMES                1000
+/* Number of runs */
+#define RUNS                     3
+/* Frame payload length, and air time per byte as at 250 kbit/s */
+#define PAYLOAD_LEN             80
+#define BYTE_AIR_TIME_NS     32000
+/*---------------------------------------------------------------------------*/
+PROCESS(csma_burst_process, "CSMA burst benchmark");
+AUTOSTART_PROCESSES(&csma_burst_process);
+/*---------------------------------------------------------------------------*/
+static linkaddr_t neighbors[NEIGHBORS];
+static unsigned queued;
+static unsigned sent;
+static unsigned failed;
+/*---------------------------------------------------------------------------*/
+static uint64_t
+now_ns(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+/*---------------------------------------------------------------------------*/
+/* The radio: every frame occupies the channel for its air time, and every
+ * unicast frame is acknowledged */
+static uint8_t last_dsn;
+static int ack_pending;
+
+static int
+radio_init(void)
+{
+  return 0;
+}
+static int
+radio_prepare(const void *payload, unsigned short payload_len)
+{
+  last_dsn = ((const uint8_t *)payload)[2];
+  return 0;
+}
+static int
+radio_transmit(unsigned short transmit_len)
+{
+  uint64_t end = now_ns() + (uint64_t)transmit_len * BYTE_AIR_TIME_NS;
+  while(now_ns() < end);
+  ack_pending = 1;
+  return RADIO_TX_OK;
+}
+static int
+radio_send(const void *payload, unsigned short payload_len)
+{
+  radio_prepare(payload, payload_len);
+  return radio_transmit(payload_len);
+}
+static int
+radio_read(void *buf, unsigned short buf_len)
+{
+  uint8_t *ack = buf;
+  if(!ack_pending || buf_len < 3) {
+    return 0;
+  }
+  ack_pending = 0;
+  ack[0] = FRAME802154_ACKFRAME;
+  ack[1] = 0;
+  ack[2] = last_dsn;
+  return 3;
+}
+static int
+radio_channel_clear(void)
+{
+  return 1;
+}
+static int
+radio_receiving_packet(void)
+{
+  return 0;
+}
+static int
+radio_pending_packet(void)
+{
+  return ack_pending;
+}
+static int
+radio_on(void)
+{
+  return 0;
+}
+static int
+radio_off(void)
+{
+  return 0;
+}
+static radio_result_t
+radio_get_value(radio_param_t param, radio_value_t *value)
+{
+  if(param == RADIO_CONST_MAX_PAYLOAD_LEN) {
+    *value = 127;
+    return RADIO_RESULT_OK;
+  }
+  return RADIO_RESULT_NOT_SUPPORTED;
+}
+static radio_result_t
+radio_set_value(radio_param_t param, radio_value_t value)
+{
+  return RADIO_RESULT_NOT_SUPPORTED;
+}
+static radio_result_t
+radio_get_object(radio_param_t param, void *dest, size_t size)
+{
+  return RADIO_RESULT_NOT_SUPPORTED;
+}
+static radio_result_t
+radio_set_object(radio_param_t param, const void *src, size_t size)
+{
+  return RADIO_RESULT_NOT_SUPPORTED;
+}
+const struct radio_driver bench_radio_driver = {
+  radio_init,
+  radio_prepare,
+  radio_transmit,
+  radio_send,
+  radio_read,
+  radio_channel_clear,
+  radio_receiving_packet,
+  radio_pending_packet,
+  radio_on,
+  radio_off,
+  radio_get_value,
+  radio_set_value,
+  radio_get_object,
+  radio_set_object
+};
+/*---------------------------------------------------------------------------*/
+static void send_frame(int neighbor);
+
+static void
+frame_sent(void *ptr, int status, int transmissions)
+{
+  if(status == MAC_TX_OK) {
+    sent++;
+  } else {
+    failed++;
+  }
+  if(sent + failed == FRAMES) {
+    process_poll(&csma_burst_process);
+  }
+  /* Keep the queue of this neighbor full */
+  send_frame((int)(intptr_t)ptr);
+}
+/*---------------------------------------------------------------------------*/
+static void
+send_frame(int neighbor)
+{
+  static uint8_t payload[PAYLOAD_LEN];
+
+  if(queued == FRAMES) {
+    return;
+  }
+  queued++;
+  packetbuf_clear();
+  packetbuf_copyfrom(payload, sizeof(payload));
+  packetbuf_set_addr(PACKETBUF_ADDR_RECEIVER, &neighbors[neighbor]);
+  NETSTACK_MAC.send(frame_sent, (void *)(intptr_t)neighbor);
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(csma_burst_process, ev, data)
+{
+  static int run;
+  static uint64_t start;
+  int i;
+
+  PROCESS_BEGIN();
+
+  for(i = 0; i < NEIGHBORS; i++) {
+    neighbors[i].u8[0] = 0x02;
+    neighbors[i].u8[LINKADDR_SIZE - 1] = i + 1;
+  }
+
+  printf("CSMA: %u neighbors, %u frames in queue each, %u-byte payload\n",
+         NEIGHBORS, FRAMES_IN_QUEUE, PAYLOAD_LEN);
+
+  for(run = 0; run < RUNS; run++) {
+    queued = 0;
+    sent = 0;
+    failed = 0;
+    start = now_ns();
+    for(i = 0; i < NEIGHBORS * FRAMES_IN_QUEUE; i++) {
+      send_frame(i % NEIGHBORS);
+    }
+    PROCESS_WAIT_EVENT_UNTIL(ev == PROCESS_EVENT_POLL);
+    printf("Run %d: %u frames sent, %u failed, %.0f frames/s\n",
+           run + 1, sent, failed,
+           (double)(sent + failed) * 1e9 / (now_ns() - start));
+  }
+
+  printf("Done\n");
+
+  PROCESS_END();
+}
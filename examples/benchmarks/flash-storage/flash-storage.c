@@ -0,0 +1,309 @@
+/*
+ * Copyright (c) 2026, RISE Research Institutes of Sweden.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+/**
+ * \file
+ *         Benchmark: run Coffee and Antelope workloads on the flash
+ *         emulator of the native platform, and report the throughput,
+ *         the write amplification and the wear of the flash.
+ */
+
+#include "contiki.h"
+#include "antelope.h"
+#include "cfs/cfs.h"
+#include "cfs/cfs-coffee.h"
+#include "dev/xmem-emu.h"
+#include "lib/random.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+/*---------------------------------------------------------------------------*/
+/* Number of records appended to the log */
+#define RECORDS              4096
+/* Number of times the log is removed and written again */
+#define ROUNDS                 16
+/* Number of random reads of a record */
+#define READS                4096
+/* Number of tuples inserted into the relation */
+#define ROWS                 2000
+/* Number of range queries, and the tuples selected by each */
+#define QUERIES                50
+#define QUERY_ROWS            100
+/* The bytes of a tuple: a LONG and an INT */
+#define TUPLE_SIZE              6
+/* Erase cycles of a sector, as rated for both the NOR and the NAND part */
+#define ENDURANCE          100000UL
+/*---------------------------------------------------------------------------*/
+PROCESS(flash_storage_process, "Flash storage benchmark");
+AUTOSTART_PROCESSES(&flash_storage_process);
+
+/* A log record. The last byte is nonzero, so that Coffee finds it. */
+struct record {
+  uint32_t time;
+  int16_t values[5];
+  uint8_t flags;
+  uint8_t marker;
+};
+
+static const char *models[] = { "none", "NOR", "NAND" };
+
+static db_handle_t handle;
+static uint64_t start;
+/*---------------------------------------------------------------------------*/
+static uint64_t
+now_ns(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+/*---------------------------------------------------------------------------*/
+static void
+begin(void)
+{
+  xmem_emu_reset_stats();
+  start = now_ns();
+}
+/*---------------------------------------------------------------------------*/
+/*
+ * Prints the results of a workload of ops operations that wrote and
+ * read the given number of bytes through the CFS or Antelope API.
+ */
+static void
+report(const char *name, unsigned long ops,
+       unsigned long written, unsigned long read)
+{
+  struct xmem_stats stats;
+  uint64_t elapsed;
+  unsigned long erases;
+  unsigned long max_erases;
+  unsigned sector;
+
+  elapsed = now_ns() - start;
+  xmem_emu_get_stats(&stats);
+  if(!XMEM_DELAY) {
+    /* The host clock does not include the latency of the flash. */
+    elapsed += stats.busy_ns;
+  }
+
+  max_erases = 0;
+  for(sector = 0; sector < XMEM_SECTORS; sector++) {
+    erases = xmem_emu_erase_count(sector);
+    if(erases > max_erases) {
+      max_erases = erases;
+    }
+  }
+
+  printf("%s: %lu ops, %.0f ops/s, flash busy %.1f ms\n",
+         name, ops, ops / ((double)elapsed / 1e9),
+         (double)stats.busy_ns / 1e6);
+  printf("  %llu bytes programmed in %lu programs, %llu bytes read in "
+         "%lu reads\n",
+         stats.program_bytes, stats.programs, stats.read_bytes, stats.reads);
+  if(written > 0) {
+    printf("  write amplification %.2f\n",
+           (double)stats.program_bytes / written);
+  }
+  if(read > 0) {
+    printf("  read amplification %.2f\n", (double)stats.read_bytes / read);
+  }
+  printf("  %lu erases, %lu max and %.2f mean per sector",
+         stats.erases, max_erases, (double)stats.erases / XMEM_SECTORS);
+  if(max_erases > 0) {
+    /* The workload repeats until the most erased sector wears out. */
+    printf(", %.3g ops to wear out", (double)ops * ENDURANCE / max_erases);
+  }
+  printf("\n");
+  if(stats.clear_attempts > 0 || stats.nop_exceeded > 0) {
+    printf("  %lu programs clear bits, %lu exceed the partial programs\n",
+           stats.clear_attempts, stats.nop_exceeded);
+  }
+}
+/*---------------------------------------------------------------------------*/
+/*
+ * Writes a log file of records several times over, so that Coffee has
+ * to collect garbage, and returns the number of records appended.
+ */
+static unsigned long
+append_log(void)
+{
+  struct record record;
+  unsigned long count;
+  int round;
+  int fd;
+  int i;
+
+  memset(&record, 0, sizeof(record));
+  record.marker = 0xff;
+  count = 0;
+  for(round = 0; round < ROUNDS; round++) {
+    cfs_remove("log");
+    fd = cfs_open("log", CFS_WRITE | CFS_APPEND);
+    if(fd < 0) {
+      break;
+    }
+    for(i = 0; i < RECORDS; i++) {
+      record.time = count;
+      record.values[0] = i & 0xff;
+      if(cfs_write(fd, &record, sizeof(record)) != sizeof(record)) {
+        break;
+      }
+      count++;
+    }
+    cfs_close(fd);
+  }
+  return count;
+}
+/*---------------------------------------------------------------------------*/
+/* Reads random records of the log, and returns the number read */
+static unsigned long
+read_log(void)
+{
+  struct record record;
+  unsigned long i;
+  int fd;
+
+  fd = cfs_open("log", CFS_READ);
+  if(fd < 0) {
+    return 0;
+  }
+
+  random_init(1);
+  for(i = 0; i < READS; i++) {
+    if(cfs_seek(fd, (random_rand() % RECORDS) * sizeof(record),
+                CFS_SEEK_SET) < 0 ||
+       cfs_read(fd, &record, sizeof(record)) != sizeof(record)) {
+      break;
+    }
+  }
+  cfs_close(fd);
+  return i;
+}
+/*---------------------------------------------------------------------------*/
+static int
+create_relation(void)
+{
+  return DB_SUCCESS(db_query(NULL, "CREATE RELATION samples;")) &&
+    DB_SUCCESS(db_query(NULL,
+                        "CREATE ATTRIBUTE time DOMAIN LONG IN samples;")) &&
+    DB_SUCCESS(db_query(NULL,
+                        "CREATE ATTRIBUTE value DOMAIN INT IN samples;")) &&
+    DB_SUCCESS(db_query(NULL, "CREATE INDEX samples.time TYPE INLINE;"));
+}
+/*---------------------------------------------------------------------------*/
+/* Inserts tuples into the relation, and returns the number inserted */
+static unsigned long
+insert_rows(void)
+{
+  unsigned long i;
+
+  for(i = 0; i < ROWS; i++) {
+    if(DB_ERROR(db_query(NULL, "INSERT (%ld, %d) INTO samples;",
+                         100000L + i * 60, (int)(i % 1000)))) {
+      break;
+    }
+  }
+  return i;
+}
+/*---------------------------------------------------------------------------*/
+/* Executes range queries, and returns the number of tuples selected */
+static unsigned long
+select_rows(void)
+{
+  db_result_t result;
+  unsigned long count;
+  long first;
+  int i;
+
+  random_init(2);
+  count = 0;
+  for(i = 0; i < QUERIES; i++) {
+    first = 100000L + (random_rand() % (ROWS - QUERY_ROWS)) * 60;
+    if(DB_ERROR(db_query(&handle, "SELECT value FROM samples "
+                         "WHERE time >= %ld AND time < %ld;",
+                         first, first + QUERY_ROWS * 60))) {
+      break;
+    }
+    while(db_processing(&handle)) {
+      result = db_process(&handle);
+      if(result == DB_GOT_ROW) {
+        count++;
+      } else if(result == DB_FINISHED || DB_ERROR(result)) {
+        break;
+      }
+    }
+    db_free(&handle);
+  }
+  return count;
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(flash_storage_process, ev, data)
+{
+  unsigned long count;
+
+  PROCESS_BEGIN();
+
+  printf("Flash: model %s, %lu KiB, %lu-byte pages, %lu KiB sectors%s\n",
+         models[XMEM_MODEL], XMEM_SIZE / 1024, XMEM_PAGE_SIZE,
+         XMEM_SECTOR_SIZE / 1024, XMEM_DELAY ? ", delayed" : "");
+
+  cfs_coffee_format();
+
+  begin();
+  count = append_log();
+  report("Append log", count, count * sizeof(struct record), 0);
+  PROCESS_PAUSE();
+
+  begin();
+  count = read_log();
+  report("Random read", count, 0, count * sizeof(struct record));
+  PROCESS_PAUSE();
+
+  cfs_coffee_format();
+  db_init();
+  if(!create_relation()) {
+    printf("Failed to create the relation\n");
+    PROCESS_EXIT();
+  }
+
+  begin();
+  count = insert_rows();
+  report("Relation insert", count, count * TUPLE_SIZE, 0);
+  PROCESS_PAUSE();
+
+  begin();
+  count = select_rows();
+  report("Relation select", QUERIES, 0, count * TUPLE_SIZE);
+
+  printf("Done\n");
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
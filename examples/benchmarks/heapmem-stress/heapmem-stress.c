@@ -0,0 +1,159 @@
+/*
+ * Copyright (c) 2026, RISE Research Institutes of Sweden.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ *         Benchmark: stress the heapmem allocator with a mix of small,
+ *         short-lived objects and larger, longer-lived ones, and report
+ *         the allocation latency and the fragmentation of the heap.
+ *         Build with WITH_SLAB=1 to compare with the slab front-end.
+ */
+
+#include "contiki.h"
+#include "lib/heapmem.h"
+#include "lib/random.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+/*---------------------------------------------------------------------------*/
+/* Total number of allocations */
+#define OPERATIONS          200000
+/* Maximum number of objects allocated at the same time */
+#define CONCURRENT             400
+/* Sizes of the small objects (e.g., CoAP and LwM2M messages) */
+#define SMALL_MAX_SIZE         128
+/* Sizes of the large objects (e.g., Antelope result buffers) */
+#define LARGE_MIN_SIZE         256
+#define LARGE_MAX_SIZE        1024
+/* One allocation out of LARGE_RATIO is large */
+#define LARGE_RATIO             16
+/*---------------------------------------------------------------------------*/
+PROCESS(heapmem_stress_process, "Heapmem stress benchmark");
+AUTOSTART_PROCESSES(&heapmem_stress_process);
+/*---------------------------------------------------------------------------*/
+static uint64_t
+now_ns(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+/*---------------------------------------------------------------------------*/
+static void
+print_fragmentation(const char *when)
+{
+  heapmem_stats_t stats;
+  heapmem_stats(&stats);
+
+  /* The share of the footprint that is neither allocated nor overhead */
+  unsigned frag = stats.footprint == 0 ? 0 :
+    (unsigned)(100 * (stats.footprint - stats.allocated - stats.overhead) /
+               stats.footprint);
+
+  printf("%s: allocated %zu overhead %zu footprint %zu chunks %zu "
+         "fragmentation %u%%\n", when, stats.allocated, stats.overhead,
+         stats.footprint, stats.chunks, frag);
+}
+/*---------------------------------------------------------------------------*/
+static void *ptrs[CONCURRENT];
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(heapmem_stress_process, ev, data)
+{
+  static uint64_t total_ns;
+  static uint64_t max_ns;
+  static unsigned failures;
+  heapmem_slab_stats_t slab_stats;
+
+  PROCESS_BEGIN();
+
+  random_init(1);
+  printf("Heapmem stress: %u operations, slab front-end %s\n",
+         OPERATIONS, HEAPMEM_CONF_SLAB ? "enabled" : "disabled");
+
+  for(unsigned i = 0; i < OPERATIONS; i++) {
+    unsigned index = random_rand() % CONCURRENT;
+    size_t size;
+    uint64_t start, elapsed;
+
+    if(random_rand() % LARGE_RATIO == 0) {
+      size = LARGE_MIN_SIZE +
+        random_rand() % (LARGE_MAX_SIZE - LARGE_MIN_SIZE + 1);
+    } else {
+      size = 1 + random_rand() % SMALL_MAX_SIZE;
+    }
+
+    start = now_ns();
+    if(ptrs[index] != NULL) {
+      heapmem_free(ptrs[index]);
+    }
+    ptrs[index] = heapmem_alloc(size);
+    elapsed = now_ns() - start;
+
+    total_ns += elapsed;
+    if(elapsed > max_ns) {
+      max_ns = elapsed;
+    }
+    if(ptrs[index] == NULL) {
+      failures++;
+    } else {
+      memset(ptrs[index], 0, size);
+    }
+
+    if(i == OPERATIONS / 2) {
+      print_fragmentation("Midway");
+    }
+  }
+
+  print_fragmentation("End");
+
+  printf("Free+alloc pairs: %u, failed allocations: %u\n",
+         OPERATIONS, failures);
+  printf("Latency: mean %lu ns, max %lu ns\n",
+         (unsigned long)(total_ns / OPERATIONS), (unsigned long)max_ns);
+  printf("Throughput: %lu pairs/s\n",
+         (unsigned long)(OPERATIONS * 1000000000ULL / (total_ns ? total_ns : 1)));
+
+  for(unsigned i = 0; heapmem_slab_stats(i, &slab_stats); i++) {
+    printf("Class %u: size %zu cached %zu hits %zu misses %zu\n",
+           i, slab_stats.size, slab_stats.cached,
+           slab_stats.hits, slab_stats.misses);
+  }
+
+  for(unsigned i = 0; i < CONCURRENT; i++) {
+    if(ptrs[i] != NULL) {
+      heapmem_free(ptrs[i]);
+      ptrs[i] = NULL;
+    }
+  }
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
@@ -0,0 +1,144 @@
+/*
+ * Copyright (c) 2026, RISE Research Institutes of Sweden.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ *         Benchmark: measure the number of frames per second that CSMA
+ *         link-layer security creates and parses. Build with
+ *         WITH_SECURITY=1 to secure the frames, and with WITH_KEY_CACHE=1,
+ *         WITH_TTABLE=1 or WITH_ANTI_REPLAY=1 to compare.
+ */
+
+#include "contiki.h"
+#include "net/linkaddr.h"
+#include "net/packetbuf.h"
+#include "net/mac/llsec802154.h"
+#include "net/mac/csma/csma.h"
+#include "net/mac/csma/csma-security.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+/*---------------------------------------------------------------------------*/
+/* Number of frames created and parsed at each run */
+#define FRAMES             100000
+/* Number of runs */
+#define RUNS                    3
+/* Frame payload length */
+#define PAYLOAD_LEN            80
+/*---------------------------------------------------------------------------*/
+PROCESS(llsec_frames_process, "LLSEC frames benchmark");
+AUTOSTART_PROCESSES(&llsec_frames_process);
+
+static linkaddr_t sender_addr;
+static linkaddr_t receiver_addr;
+static uint8_t frame[PACKETBUF_SIZE];
+static uint16_t frame_len;
+/*---------------------------------------------------------------------------*/
+static uint64_t
+now_ns(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+/*---------------------------------------------------------------------------*/
+/* Creates a frame as the sender, and keeps a copy of it in frame[] */
+static int
+create_frame(void)
+{
+  static uint8_t payload[PAYLOAD_LEN];
+
+  linkaddr_copy(&linkaddr_node_addr, &sender_addr);
+  packetbuf_clear();
+  packetbuf_copyfrom(payload, sizeof(payload));
+  packetbuf_set_addr(PACKETBUF_ADDR_SENDER, &sender_addr);
+  packetbuf_set_addr(PACKETBUF_ADDR_RECEIVER, &receiver_addr);
+  packetbuf_set_attr(PACKETBUF_ATTR_MAC_ACK, 1);
+#if LLSEC802154_ENABLED
+  packetbuf_set_attr(PACKETBUF_ATTR_SECURITY_LEVEL, CSMA_LLSEC_SECURITY_LEVEL);
+  packetbuf_set_attr(PACKETBUF_ATTR_KEY_ID_MODE, CSMA_LLSEC_KEY_ID_MODE);
+#endif /* LLSEC802154_ENABLED */
+  if(csma_security_create_frame() < 0) {
+    return 0;
+  }
+  frame_len = packetbuf_totlen();
+  memcpy(frame, packetbuf_hdrptr(), frame_len);
+  return 1;
+}
+/*---------------------------------------------------------------------------*/
+/* Parses the frame in frame[] as the receiver */
+static int
+parse_frame(void)
+{
+  linkaddr_copy(&linkaddr_node_addr, &receiver_addr);
+  packetbuf_clear();
+  packetbuf_copyfrom(frame, frame_len);
+  return csma_security_parse_frame() >= 0;
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(llsec_frames_process, ev, data)
+{
+  static int run;
+  uint32_t parsed;
+  uint32_t replays;
+  uint64_t start;
+  uint32_t i;
+
+  PROCESS_BEGIN();
+
+  sender_addr.u8[0] = 0x01;
+  receiver_addr.u8[0] = 0x02;
+
+  printf("LLSEC: security %s, %u-byte payload\n",
+         LLSEC802154_ENABLED ? "on" : "off", PAYLOAD_LEN);
+
+  for(run = 0; run < RUNS; run++) {
+    parsed = 0;
+    start = now_ns();
+    for(i = 0; i < FRAMES; i++) {
+      if(create_frame() && parse_frame()) {
+        parsed++;
+      }
+    }
+    printf("Run %d: %lu of %u frames created and parsed, %.0f frames/s\n",
+           run + 1, (unsigned long)parsed, FRAMES,
+           (double)FRAMES * 1e9 / (now_ns() - start));
+  }
+
+  /* Parse the last frame again: it is a replay */
+  replays = !parse_frame();
+  printf("Replayed frame %s\n", replays ? "rejected" : "accepted");
+
+  printf("Done\n");
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
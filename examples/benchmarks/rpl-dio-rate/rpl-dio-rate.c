@@ -0,0 +1,176 @@
+/*
+ * Copyright (c) 2026, RISE Research Institutes of Sweden.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ *         Benchmark: measure how many DIOs per second RPL Lite processes,
+ *         including the parent selection that follows each of them, as
+ *         the number of neighbors grows. Build with WITH_PSET=1 to compare
+ *         with the incremental parent set.
+ */
+
+#include "contiki.h"
+#include "net/routing/rpl-lite/rpl.h"
+#include "net/link-stats.h"
+#include "net/packetbuf.h"
+#include "net/mac/mac.h"
+#include "lib/random.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+/*---------------------------------------------------------------------------*/
+/* Number of neighbors after each step of the benchmark */
+static const unsigned steps[] = { 8, 16, 32, 48, 60 };
+#define MAX_NEIGHBORS           60
+/* Number of DIOs processed at each step */
+#define DIOS                 10000
+/* One DIO out of LINK_UPDATE_RATIO is followed by a link-stats update */
+#define LINK_UPDATE_RATIO        4
+/*---------------------------------------------------------------------------*/
+PROCESS(rpl_dio_rate_process, "RPL DIO rate benchmark");
+AUTOSTART_PROCESSES(&rpl_dio_rate_process);
+/*---------------------------------------------------------------------------*/
+static linkaddr_t lladdrs[MAX_NEIGHBORS];
+static uip_ipaddr_t ipaddrs[MAX_NEIGHBORS];
+static rpl_dio_t dio;
+/*---------------------------------------------------------------------------*/
+static uint64_t
+now_ns(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+/*---------------------------------------------------------------------------*/
+static void
+init_dio(void)
+{
+  uip_ip6addr(&dio.dag_id, 0xfd00, 0, 0, 0, 0, 0, 0, 1);
+  dio.ocp = RPL_OCP_MRHOF;
+  dio.mop = RPL_MOP_NON_STORING;
+  dio.version = RPL_LOLLIPOP_INIT;
+  dio.instance_id = RPL_DEFAULT_INSTANCE;
+  dio.dtsn = RPL_LOLLIPOP_INIT;
+  dio.dag_intdoubl = RPL_DIO_INTERVAL_DOUBLINGS;
+  dio.dag_intmin = RPL_DIO_INTERVAL_MIN;
+  dio.dag_redund = RPL_DIO_REDUNDANCY;
+  dio.default_lifetime = RPL_INFINITE_LIFETIME;
+  dio.lifetime_unit = RPL_DEFAULT_LIFETIME_UNIT;
+  dio.dag_max_rankinc = RPL_MAX_RANKINC;
+  dio.dag_min_hoprankinc = RPL_MIN_HOPRANKINC;
+  uip_ip6addr(&dio.prefix_info.prefix, 0xfd00, 0, 0, 0, 0, 0, 0, 0);
+  dio.prefix_info.length = 64;
+  dio.prefix_info.flags = UIP_ND6_RA_FLAG_AUTONOMOUS;
+  dio.prefix_info.lifetime = RPL_ROUTE_INFINITE_LIFETIME;
+}
+/*---------------------------------------------------------------------------*/
+/* Processes a DIO from neighbor i, as if it had been received over the air */
+static void
+dio_input(unsigned i, rpl_rank_t rank)
+{
+  packetbuf_set_addr(PACKETBUF_ADDR_SENDER, &lladdrs[i]);
+  link_stats_input_callback(&lladdrs[i]);
+  dio.rank = rank;
+  rpl_process_dio(&ipaddrs[i], &dio);
+}
+/*---------------------------------------------------------------------------*/
+/* Reports a unicast transmission to neighbor i, as the MAC layer would */
+static void
+link_update(unsigned i, int numtx)
+{
+  link_stats_packet_sent(&lladdrs[i], MAC_TX_OK, numtx);
+  rpl_link_callback(&lladdrs[i], MAC_TX_OK, numtx);
+  rpl_dag_update_state();
+}
+/*---------------------------------------------------------------------------*/
+/* Neighbors advertise ranks of one to four hops from the root, with jitter */
+static rpl_rank_t
+random_rank(void)
+{
+  return ROOT_RANK + (1 + random_rand() % 4) * RPL_MIN_HOPRANKINC
+    + random_rand() % (RPL_MIN_HOPRANKINC / 2);
+}
+/*---------------------------------------------------------------------------*/
+static void
+add_neighbor(unsigned i)
+{
+  lladdrs[i].u8[0] = 0x02;
+  lladdrs[i].u8[LINKADDR_SIZE - 2] = (i + 1) >> 8;
+  lladdrs[i].u8[LINKADDR_SIZE - 1] = (i + 1) & 0xff;
+  uip_ip6addr(&ipaddrs[i], 0xfe80, 0, 0, 0, 0, 0, 0, 0);
+  uip_ds6_set_addr_iid(&ipaddrs[i], (uip_lladdr_t *)&lladdrs[i]);
+
+  /* Neighbor 0 is the root */
+  dio_input(i, i == 0 ? RPL_MIN_HOPRANKINC : random_rank());
+  /* Make the link fresh, as after a few transmissions */
+  for(int tx = 0; tx < 4; tx++) {
+    link_update(i, 1 + random_rand() % 2);
+  }
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(rpl_dio_rate_process, ev, data)
+{
+  static unsigned neighbors;
+  uint64_t start, elapsed;
+
+  PROCESS_BEGIN();
+
+  random_init(1);
+  init_dio();
+  printf("RPL DIO rate: %u DIOs per step, incremental parent set %s\n",
+         DIOS, RPL_INCREMENTAL_PARENT_SET ? "enabled" : "disabled");
+
+  for(unsigned step = 0; step < sizeof(steps) / sizeof(steps[0]); step++) {
+    while(neighbors < steps[step]) {
+      add_neighbor(neighbors++);
+    }
+
+    start = now_ns();
+    for(unsigned i = 0; i < DIOS; i++) {
+      /* The root (neighbor 0) keeps its rank, the others move around */
+      unsigned nbr = 1 + random_rand() % (neighbors - 1);
+      dio_input(nbr, random_rank());
+      if(i % LINK_UPDATE_RATIO == 0) {
+        link_update(random_rand() % neighbors, 1 + random_rand() % 3);
+      }
+    }
+    elapsed = now_ns() - start;
+
+    printf("Neighbors: %u (rpl %u), DIOs/s: %lu, mean %lu ns, rank %u\n",
+           neighbors, rpl_neighbor_count(),
+           (unsigned long)(DIOS * 1000000000ULL / (elapsed ? elapsed : 1)),
+           (unsigned long)(elapsed / DIOS),
+           curr_instance.dag.rank);
+  }
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
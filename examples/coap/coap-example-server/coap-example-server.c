@@ -65,6 +65,9 @@ extern coap_resource_t
   res_event,
   res_sub,
   res_b1_sep_b2;
+#if COAP_WITH_QBLOCK
+extern coap_resource_t res_qblock;
+#endif /* COAP_WITH_QBLOCK */
 #if PLATFORM_HAS_LEDS
 extern coap_resource_t res_leds, res_toggle;
 #endif
@@ -107,6 +110,9 @@ PROCESS_THREAD(er_example_server, ev, data)
 #endif /* PLATFORM_HAS_BUTTON */
   coap_activate_resource(&res_sub, "test/sub");
   coap_activate_resource(&res_b1_sep_b2, "test/b1sepb2");
+#if COAP_WITH_QBLOCK
+  coap_activate_resource(&res_qblock, "test/qblock");
+#endif /* COAP_WITH_QBLOCK */
 #if PLATFORM_HAS_LEDS
 /*  coap_activate_resource(&res_leds, "actuators/leds"); */
   coap_activate_resource(&res_toggle, "actuators/toggle");
@@ -0,0 +1,113 @@
+/*
+ * Copyright (c) 2026, RISE Research Institutes of Sweden.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ *      Example resource that stores a body received with Q-Block1 in
+ *      CFS and streams it back with Q-Block2, without buffering it.
+ */
+
+#include "coap-engine.h"
+#include "coap-qblock.h"
+#include "cfs/cfs.h"
+
+#if COAP_WITH_QBLOCK
+
+#define FILENAME "qblock"
+
+static void res_get_handler(coap_message_t *request, coap_message_t *response, uint8_t *buffer, uint16_t preferred_size, int32_t *offset);
+static void res_put_handler(coap_message_t *request, coap_message_t *response, uint8_t *buffer, uint16_t preferred_size, int32_t *offset);
+
+RESOURCE(res_qblock,
+         "title=\"Q-Block1 + Q-Block2 demo\"",
+         res_get_handler,
+         NULL,
+         res_put_handler,
+         NULL);
+
+static coap_qblock1_receiver_t receiver;
+static int fd = -1;
+
+static int read_body(void *user, uint32_t offset, uint8_t *data, uint16_t len);
+
+static coap_qblock2_source_t source = {
+  .read = read_body,
+  .content_format = APPLICATION_OCTET_STREAM
+};
+/*---------------------------------------------------------------------------*/
+static int
+write_body(void *user, uint32_t offset, const uint8_t *data, uint16_t len)
+{
+  if(fd < 0) {
+    fd = cfs_open(FILENAME, CFS_READ | CFS_WRITE);
+    if(fd < 0) {
+      return -1;
+    }
+  }
+  if(cfs_seek(fd, offset, CFS_SEEK_SET) != offset
+     || cfs_write(fd, data, len) != len) {
+    return -1;
+  }
+  return 0;
+}
+/*---------------------------------------------------------------------------*/
+static int
+read_body(void *user, uint32_t offset, uint8_t *data, uint16_t len)
+{
+  int read_fd;
+  int ret = -1;
+
+  read_fd = cfs_open(FILENAME, CFS_READ);
+  if(read_fd >= 0) {
+    if(cfs_seek(read_fd, offset, CFS_SEEK_SET) == offset) {
+      ret = cfs_read(read_fd, data, len);
+    }
+    cfs_close(read_fd);
+  }
+  return ret;
+}
+/*---------------------------------------------------------------------------*/
+static void
+res_put_handler(coap_message_t *request, coap_message_t *response, uint8_t *buffer, uint16_t preferred_size, int32_t *offset)
+{
+  coap_set_status_code(response, CHANGED_2_04);
+  if(coap_qblock1_handler(&receiver, request, response, write_body, NULL) == 0) {
+    cfs_close(fd);
+    fd = -1;
+    source.length = receiver.length;
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+res_get_handler(coap_message_t *request, coap_message_t *response, uint8_t *buffer, uint16_t preferred_size, int32_t *offset)
+{
+  coap_qblock2_handler(&source, request, response, buffer, preferred_size, offset);
+}
+/*---------------------------------------------------------------------------*/
+#endif /* COAP_WITH_QBLOCK */
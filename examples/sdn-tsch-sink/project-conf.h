@@ -63,6 +63,8 @@
 #define NETSTACK_CONF_NETWORK sdn_net_driver
 #undef NETSTACK_CONF_ROUTING
 #define NETSTACK_CONF_ROUTING sdn_routing_driver
+/* Compress the SDN IP header (must match on all nodes) */
+#define SDN_NET_CONF_COMPRESSION 1
 
 /* Set to enable TSCH security */
 #ifndef WITH_SECURITY
@@ -113,6 +115,8 @@
 
 /* Enable printing of packet counters */
 #define LINK_STATS_CONF_PACKET_COUNTERS 0
+/* Apply link statistics updates in batches, outside of the MAC callbacks */
+#define LINK_STATS_CONF_DEFERRED_UPDATES 8
 
 /* Logs */
 /* Logging */
@@ -64,7 +64,18 @@ static const uint8_t sbox[256] =   {
 0xe1, 0xf8, 0x98, 0x11, 0x69, 0xd9, 0x8e, 0x94, 0x9b, 0x1e, 0x87, 0xe9, 0xce, 0x55, 0x28, 0xdf,
 0x8c, 0xa1, 0x89, 0x0d, 0xbf, 0xe6, 0x42, 0x68, 0x41, 0x99, 0x2d, 0x0f, 0xb0, 0x54, 0xbb, 0x16 };
 
+#if AES_128_KEY_CACHE_SIZE
+/* Recently used keys and their expansions, replaced in FIFO order */
+static struct {
+  uint8_t key[AES_128_KEY_LENGTH];
+  uint8_t round_keys[11][AES_128_KEY_LENGTH];
+} key_cache[AES_128_KEY_CACHE_SIZE];
+static uint8_t key_cache_len;
+static uint8_t key_cache_next;
+static uint8_t (*round_keys)[AES_128_KEY_LENGTH] = key_cache[0].round_keys;
+#else /* AES_128_KEY_CACHE_SIZE */
 static uint8_t round_keys[11][AES_128_KEY_LENGTH];
+#endif /* AES_128_KEY_CACHE_SIZE */
 
 /*---------------------------------------------------------------------------*/
 /* multiplies by 2 in GF(2) */
@@ -81,7 +92,23 @@ set_key(const uint8_t *key)
   uint8_t i;
   uint8_t j;
   uint8_t rcon;
-  
+
+#if AES_128_KEY_CACHE_SIZE
+  for(i = 0; i < key_cache_len; i++) {
+    if(memcmp(key_cache[i].key, key, AES_128_KEY_LENGTH) == 0) {
+      round_keys = key_cache[i].round_keys;
+      return;
+    }
+  }
+  i = key_cache_next;
+  key_cache_next = (key_cache_next + 1) % AES_128_KEY_CACHE_SIZE;
+  if(key_cache_len < AES_128_KEY_CACHE_SIZE) {
+    key_cache_len++;
+  }
+  memcpy(key_cache[i].key, key, AES_128_KEY_LENGTH);
+  round_keys = key_cache[i].round_keys;
+#endif /* AES_128_KEY_CACHE_SIZE */
+
   rcon = 0x01;
   memcpy(round_keys[0], key, AES_128_KEY_LENGTH);
   for(i = 1; i <= 10; i++) {
@@ -45,6 +45,15 @@
 #define AES_128_BLOCK_SIZE 16
 #define AES_128_KEY_LENGTH 16
 
+/* Number of expanded keys kept by the software AES-128 drivers. Setting a
+   key that is in the cache selects its expanded key instead of expanding
+   it again. Set to 0 to expand the key at every call to set_key() */
+#ifdef AES_128_CONF_KEY_CACHE_SIZE
+#define AES_128_KEY_CACHE_SIZE AES_128_CONF_KEY_CACHE_SIZE
+#else /* AES_128_CONF_KEY_CACHE_SIZE */
+#define AES_128_KEY_CACHE_SIZE 0
+#endif /* AES_128_CONF_KEY_CACHE_SIZE */
+
 #ifdef AES_128_CONF
 #define AES_128            AES_128_CONF
 #else /* AES_128_CONF */
@@ -69,4 +78,9 @@ struct aes_128_driver {
 
 extern const struct aes_128_driver AES_128;
 
+/* Software drivers: byte-oriented (aes-128.c) and table-driven
+   (aes-128-ttable.c) */
+extern const struct aes_128_driver aes_128_driver;
+extern const struct aes_128_driver aes_128_ttable_driver;
+
 #endif /* AES_128_H_ */
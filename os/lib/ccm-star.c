@@ -64,34 +64,15 @@ set_iv(uint8_t *iv,
   iv[15] = counter;
 }
 /*---------------------------------------------------------------------------*/
-/* XORs the block m[pos] ... m[pos + 15] with K_{counter} */
+/* Starts the CBC-MAC in x with B_0 and the additional authenticated data */
 static void
-ctr_step(const uint8_t *nonce,
-    uint16_t pos,
-    uint8_t *m_and_result,
+mic_start(const uint8_t *nonce,
     uint16_t m_len,
-    uint16_t counter)
-{
-  uint8_t a[AES_128_BLOCK_SIZE];
-  uint8_t i;
-
-  set_iv(a, CCM_STAR_ENCRYPTION_FLAGS, nonce, counter);
-  AES_128.encrypt(a);
-
-  for(i = 0; (pos + i < m_len) && (i < AES_128_BLOCK_SIZE); i++) {
-    m_and_result[pos + i] ^= a[i];
-  }
-}
-/*---------------------------------------------------------------------------*/
-static void
-mic(const uint8_t *nonce,
-    const uint8_t *m, uint16_t m_len,
     const uint8_t *a, uint16_t a_len,
-    uint8_t *result,
+    uint8_t *x,
     uint8_t mic_len)
 {
-  uint8_t x[AES_128_BLOCK_SIZE];
-  uint32_t pos; /* 32-bits as can need to exceed m_len to reach end of loop */
+  uint32_t pos; /* 32-bits as can need to exceed a_len to reach end of loop */
   uint8_t i;
 
   set_iv(x, CCM_STAR_AUTH_FLAGS(a_len > 0, mic_len), nonce, m_len);
@@ -115,35 +96,6 @@ mic(const uint8_t *nonce,
       AES_128.encrypt(x);
     }
   }
-
-  if(m_len) {
-    pos = 0;
-    while(pos < m_len) {
-      for(i = 0; (pos + i < m_len) && (i < AES_128_BLOCK_SIZE); i++) {
-        x[i] ^= m[pos + i];
-      }
-      pos += AES_128_BLOCK_SIZE;
-      AES_128.encrypt(x);
-    }
-  }
-
-  ctr_step(nonce, 0, x, AES_128_BLOCK_SIZE, 0);
-
-  memcpy(result, x, mic_len);
-}
-/*---------------------------------------------------------------------------*/
-static void
-ctr(const uint8_t *nonce, uint8_t *m, uint16_t m_len)
-{
-  uint32_t pos; /* 32-bits as can need to exceed m_len to reach end of loop */
-  uint16_t counter;
-
-  pos = 0;
-  counter = 1;
-  while(pos < m_len) {
-    ctr_step(nonce, pos, m, m_len, counter++);
-    pos += AES_128_BLOCK_SIZE;
-  }
 }
 /*---------------------------------------------------------------------------*/
 static void
@@ -159,24 +111,51 @@ aead(const uint8_t* nonce,
     uint8_t *result, uint8_t mic_len,
     int forward)
 {
+  uint8_t x[AES_128_BLOCK_SIZE]; /* CBC-MAC */
+  uint8_t ctr[AES_128_BLOCK_SIZE]; /* A_i */
+  uint8_t s[AES_128_BLOCK_SIZE]; /* S_i = E(K, A_i) */
+  uint32_t pos; /* 32-bits as can need to exceed m_len to reach end of loop */
+  uint16_t counter;
+  uint8_t len;
+  uint8_t i;
+
   if(a_len > MAX_A_LEN || !MIC_LEN_VALID(mic_len)) {
     return;
   }
 
-  if(!forward) {
-    /* decrypt */
-    ctr(nonce, m, m_len);
-  }
+  mic_start(nonce, m_len, a, a_len, x, mic_len);
 
-  mic(nonce,
-    m, m_len,
-    a, a_len,
-    result,
-    mic_len);
+  /* Authenticate and encrypt, or decrypt and authenticate, in one pass:
+     the CBC-MAC is always computed over the plaintext */
+  set_iv(ctr, CCM_STAR_ENCRYPTION_FLAGS, nonce, 0);
+  counter = 1;
+  for(pos = 0; pos < m_len; pos += AES_128_BLOCK_SIZE) {
+    len = MIN(m_len - pos, AES_128_BLOCK_SIZE);
+    ctr[14] = counter >> 8;
+    ctr[15] = counter;
+    counter++;
+    memcpy(s, ctr, AES_128_BLOCK_SIZE);
+    AES_128.encrypt(s);
+    if(forward) {
+      for(i = 0; i < len; i++) {
+        x[i] ^= m[pos + i];
+        m[pos + i] ^= s[i];
+      }
+    } else {
+      for(i = 0; i < len; i++) {
+        m[pos + i] ^= s[i];
+        x[i] ^= m[pos + i];
+      }
+    }
+    AES_128.encrypt(x);
+  }
 
-  if(forward) {
-    /* encrypt */
-    ctr(nonce, m, m_len);
+  /* Encrypt the MIC with S_0 */
+  ctr[14] = 0;
+  ctr[15] = 0;
+  AES_128.encrypt(ctr);
+  for(i = 0; i < mic_len; i++) {
+    result[i] = x[i] ^ ctr[i];
   }
 }
 /*---------------------------------------------------------------------------*/
@@ -105,6 +105,52 @@
 #define ALIGN(size)						\
   (((size) + (HEAPMEM_ALIGNMENT - 1)) & ~(HEAPMEM_ALIGNMENT - 1))
 
+/*
+ * The HEAPMEM_CONF_SLAB parameter enables a front-end of segregated
+ * size classes. Chunks of a class size are not returned to the heap
+ * when deallocated, but kept on a free list for their class, from
+ * which later allocations of the same class are served in constant
+ * time. The cached chunks are returned to the heap when an allocation
+ * cannot otherwise be satisfied.
+ */
+#ifdef HEAPMEM_CONF_SLAB
+#define HEAPMEM_SLAB HEAPMEM_CONF_SLAB
+#else
+#define HEAPMEM_SLAB 0
+#endif /* HEAPMEM_CONF_SLAB */
+
+/*
+ * The size classes are HEAPMEM_SLAB_MIN_SIZE bytes (rounded up to the
+ * alignment) and the HEAPMEM_SLAB_CLASSES - 1 following powers of two.
+ */
+#ifdef HEAPMEM_CONF_SLAB_MIN_SIZE
+#define HEAPMEM_SLAB_MIN_SIZE ALIGN(HEAPMEM_CONF_SLAB_MIN_SIZE)
+#else
+#define HEAPMEM_SLAB_MIN_SIZE ALIGN(16)
+#endif /* HEAPMEM_CONF_SLAB_MIN_SIZE */
+
+#ifdef HEAPMEM_CONF_SLAB_CLASSES
+#define HEAPMEM_SLAB_CLASSES HEAPMEM_CONF_SLAB_CLASSES
+#else
+#define HEAPMEM_SLAB_CLASSES 4
+#endif /* HEAPMEM_CONF_SLAB_CLASSES */
+
+#define SLAB_CLASS_SIZE(index) (HEAPMEM_SLAB_MIN_SIZE << (index))
+
+/*
+ * The HEAPMEM_CONF_MAX_ZONES parameter sets the maximum number of
+ * zones, including the general zone.
+ */
+#ifdef HEAPMEM_CONF_MAX_ZONES
+#define HEAPMEM_MAX_ZONES HEAPMEM_CONF_MAX_ZONES
+#else
+#define HEAPMEM_MAX_ZONES 1
+#endif /* HEAPMEM_CONF_MAX_ZONES */
+
+#if HEAPMEM_MAX_ZONES < 1 || HEAPMEM_MAX_ZONES >= HEAPMEM_ZONE_INVALID
+#error "HEAPMEM_CONF_MAX_ZONES is out of range"
+#endif
+
 /* Macros for chunk iteration. */
 #define NEXT_CHUNK(chunk)						\
   ((chunk_t *)((char *)(chunk) + sizeof(chunk_t) + (chunk)->size))
@@ -120,11 +166,14 @@
 
 /* Macros for determining the status of a chunk. */
 #define CHUNK_FLAG_ALLOCATED		0x1
+#define CHUNK_FLAG_CACHED		0x2
 
 #define CHUNK_ALLOCATED(chunk)			\
   ((chunk)->flags & CHUNK_FLAG_ALLOCATED)
+#define CHUNK_CACHED(chunk)			\
+  ((chunk)->flags & CHUNK_FLAG_CACHED)
 #define CHUNK_FREE(chunk)			\
-  (~(chunk)->flags & CHUNK_FLAG_ALLOCATED)
+  (!((chunk)->flags & (CHUNK_FLAG_ALLOCATED | CHUNK_FLAG_CACHED)))
 
 /*
  * We use a double-linked list of chunks, with a slight space overhead compared
@@ -136,6 +185,7 @@ typedef struct chunk {
   struct chunk *next;
   size_t size;
   uint8_t flags;
+  heapmem_zone_t zone;
 #if HEAPMEM_DEBUG
   const char *file;
   unsigned line;
@@ -150,6 +200,22 @@ static size_t heap_usage;
 static chunk_t *first_chunk = (chunk_t *)heap_base;
 static chunk_t *free_list;
 
+#if HEAPMEM_SLAB
+/* The free list and statistics of each size class. */
+static struct {
+  chunk_t *free_list;
+  size_t cached;
+  size_t hits;
+  size_t misses;
+} slab_classes[HEAPMEM_SLAB_CLASSES];
+#endif /* HEAPMEM_SLAB */
+
+/* The zones, of which the general zone initially spans the whole heap. */
+static heapmem_zone_stats_t zones[HEAPMEM_MAX_ZONES] = {
+  { .name = "GENERAL", .capacity = HEAPMEM_ARENA_SIZE }
+};
+static heapmem_zone_t zone_count = 1;
+
 #define IN_HEAP(ptr) ((char *)(ptr) >= (char *)heap_base) && \
                      ((char *)(ptr) < (char *)heap_base + heap_usage)
 
@@ -297,9 +363,88 @@ get_free_chunk(const size_t size)
   return best;
 }
 
+#if HEAPMEM_SLAB
+/* slab_class: Return the index of the smallest size class that can hold
+   an object of the specified size, or -1 if the size is too large. */
+static int
+slab_class(const size_t size)
+{
+  for(int i = 0; i < HEAPMEM_SLAB_CLASSES; i++) {
+    if(size <= SLAB_CLASS_SIZE(i)) {
+      return i;
+    }
+  }
+  return -1;
+}
+
+/* slab_release: Return all cached chunks to the heap. Returns true if
+   any chunk was released. */
+static bool
+slab_release(void)
+{
+  bool released = false;
+
+  for(int i = 0; i < HEAPMEM_SLAB_CLASSES; i++) {
+    while(slab_classes[i].free_list != NULL) {
+      chunk_t *chunk = slab_classes[i].free_list;
+      slab_classes[i].free_list = chunk->next;
+      slab_classes[i].cached--;
+      chunk->flags = 0;
+      free_chunk(chunk);
+      released = true;
+    }
+  }
+
+  return released;
+}
+#endif /* HEAPMEM_SLAB */
+
+/* zone_fits: Check whether a zone has room for the specified number of
+   additional bytes. */
+static bool
+zone_fits(const heapmem_zone_t zone, const size_t size)
+{
+  return zones[zone].allocated + size <= zones[zone].capacity;
+}
+
+/* zone_charge: Account for an allocated chunk in its zone. */
+static void
+zone_charge(const chunk_t * const chunk)
+{
+  heapmem_zone_stats_t *zone = &zones[chunk->zone];
+
+  zone->allocated += chunk->size;
+  if(zone->allocated > zone->high_water) {
+    zone->high_water = zone->allocated;
+  }
+}
+
+/* zone_refund: Remove an allocated chunk from the accounting of its zone. */
+static void
+zone_refund(const chunk_t * const chunk)
+{
+  zones[chunk->zone].allocated -= chunk->size;
+}
+
+/* allocate_chunk: Obtain a chunk from the free list or, failing that,
+   by extending the heap space. */
+static chunk_t *
+allocate_chunk(const size_t size)
+{
+  chunk_t *chunk = get_free_chunk(size);
+  if(chunk == NULL) {
+    chunk = extend_space(sizeof(chunk_t) + size);
+    if(chunk != NULL) {
+      chunk->size = size;
+    }
+  }
+  return chunk;
+}
+
 /*
- * heapmem_alloc: Allocate an object of the specified size, returning
- * a pointer to it in case of success, and NULL in case of failure.
+ * heapmem_zone_alloc: Allocate an object of the specified size in a
+ * zone, returning a pointer to it in case of success, and NULL in
+ * case of failure.
  *
  * When allocating memory, heapmem_alloc() will first try to find a
  * free chunk of the same size and the requested one. If none can be
@@ -310,31 +455,79 @@ get_free_chunk(const size_t size)
  *
  * As a last resort, heapmem_alloc() will try to extend the heap
  * space, and thereby create a new chunk available for use.
+ *
+ * If the slab front-end is enabled, requests of up to the largest
+ * class size are rounded up to their class size and served from the
+ * free list of the class when it is not empty.
+ *
+ * The allocation fails without touching the heap if the zone does
+ * not have enough remaining capacity.
  */
 void *
 #if HEAPMEM_DEBUG
-heapmem_alloc_debug(size_t size, const char *file, const unsigned line)
+heapmem_zone_alloc_debug(heapmem_zone_t zone, size_t size,
+			 const char *file, const unsigned line)
 #else
-heapmem_alloc(size_t size)
+heapmem_zone_alloc(heapmem_zone_t zone, size_t size)
 #endif
 {
+  if(zone >= zone_count) {
+    LOG_WARN("%s: invalid zone %u\n", __func__, (unsigned)zone);
+    return NULL;
+  }
+
   /* Fail early on too large allocation requests to prevent wrapping values. */
   if(size > HEAPMEM_ARENA_SIZE) {
+    zones[zone].failures++;
     return NULL;
   }
 
   size = ALIGN(size);
 
-  chunk_t *chunk = get_free_chunk(size);
+#if HEAPMEM_SLAB
+  int class = slab_class(size);
+  if(class >= 0) {
+    size = SLAB_CLASS_SIZE(class);
+  }
+#endif /* HEAPMEM_SLAB */
+
+  if(!zone_fits(zone, size)) {
+    LOG_DBG("%s: zone %s is full\n", __func__, zones[zone].name);
+    zones[zone].failures++;
+    return NULL;
+  }
+
+  chunk_t *chunk = NULL;
+#if HEAPMEM_SLAB
+  if(class >= 0) {
+    chunk = slab_classes[class].free_list;
+    if(chunk != NULL) {
+      slab_classes[class].free_list = chunk->next;
+      slab_classes[class].cached--;
+      slab_classes[class].hits++;
+    } else {
+      slab_classes[class].misses++;
+    }
+  }
+#endif /* HEAPMEM_SLAB */
+
   if(chunk == NULL) {
-    chunk = extend_space(sizeof(chunk_t) + size);
+    chunk = allocate_chunk(size);
+#if HEAPMEM_SLAB
+    if(chunk == NULL && slab_release()) {
+      /* Retry after giving the cached chunks back to the heap. */
+      chunk = allocate_chunk(size);
+    }
+#endif /* HEAPMEM_SLAB */
     if(chunk == NULL) {
+      zones[zone].failures++;
       return NULL;
     }
-    chunk->size = size;
   }
 
   chunk->flags = CHUNK_FLAG_ALLOCATED;
+  chunk->zone = zone;
+  zone_charge(chunk);
 
 #if HEAPMEM_DEBUG
   chunk->file = file;
@@ -356,7 +549,8 @@ heapmem_alloc(size_t size)
  * When performing a deallocation of a chunk, the chunk will be put on
  * a list of free chunks internally. All free chunks that are adjacent
  * in memory will be merged into a single chunk in order to mitigate
- * fragmentation.
+ * fragmentation. With the slab front-end, chunks of a class size are
+ * instead put on the free list of their class.
  */
 bool
 #if HEAPMEM_DEBUG
@@ -381,6 +575,19 @@ heapmem_free(void *ptr)
          chunk->file, chunk->line);
 #endif
 
+  zone_refund(chunk);
+
+#if HEAPMEM_SLAB
+  int class = slab_class(chunk->size);
+  if(class >= 0 && chunk->size == SLAB_CLASS_SIZE(class)) {
+    chunk->flags = CHUNK_FLAG_CACHED;
+    chunk->next = slab_classes[class].free_list;
+    slab_classes[class].free_list = chunk;
+    slab_classes[class].cached++;
+    return true;
+  }
+#endif /* HEAPMEM_SLAB */
+
   free_chunk(chunk);
   return true;
 }
@@ -401,6 +608,9 @@ heapmem_free(void *ptr)
  * If the size of the new chunk is smaller than the allocated one, we
  * split the allocated chunk if the remaining chunk would be large
  * enough to justify the overhead of creating a new chunk.
+ *
+ * The object stays in its zone, whose capacity must allow the
+ * increase in size.
  */
 void *
 #if HEAPMEM_DEBUG
@@ -452,11 +662,22 @@ heapmem_realloc(void *ptr, size_t size)
   if(size_adj <= 0) {
     /* Request to make the object smaller or to keep its size.
        In the former case, the chunk will be split if possible. */
+    zone_refund(chunk);
     split_chunk(chunk, size);
+    zone_charge(chunk);
     return ptr;
   }
 
   /* Request to make the object larger. (size_adj > 0) */
+  if(!zone_fits(chunk->zone, size_adj)) {
+    LOG_DBG("%s: zone %s is full\n", __func__, zones[chunk->zone].name);
+    zones[chunk->zone].failures++;
+    return NULL;
+  }
+
+  /* The chunk is charged again to its zone with its final size. */
+  zone_refund(chunk);
+
   if(IS_LAST_CHUNK(chunk)) {
     /*
      * If the object is within the last allocated chunk (i.e., the
@@ -465,6 +686,7 @@ heapmem_realloc(void *ptr, size_t size)
      */
     if(extend_space(size_adj) != NULL) {
       chunk->size = size;
+      zone_charge(chunk);
       return ptr;
     }
   } else {
@@ -478,6 +700,7 @@ heapmem_realloc(void *ptr, size_t size)
       /* There was enough free adjacent space to extend the chunk in
 	 its current place. */
       split_chunk(chunk, size);
+      zone_charge(chunk);
       return ptr;
     }
   }
@@ -488,8 +711,9 @@ heapmem_realloc(void *ptr, size_t size)
    * object elsewhere in the heap, and remove the old chunk that was
    * holding it.
    */
-  void *newptr = heapmem_alloc(size);
+  void *newptr = heapmem_zone_alloc(chunk->zone, size);
   if(newptr == NULL) {
+    zone_charge(chunk);
     return NULL;
   }
 
@@ -512,6 +736,8 @@ heapmem_stats(heapmem_stats_t *stats)
     if(CHUNK_ALLOCATED(chunk)) {
       stats->allocated += chunk->size;
       stats->overhead += sizeof(chunk_t);
+    } else if(CHUNK_CACHED(chunk)) {
+      stats->available += chunk->size;
     } else {
       coalesce_chunks(chunk);
       stats->available += chunk->size;
@@ -522,6 +748,70 @@ heapmem_stats(heapmem_stats_t *stats)
   stats->chunks = stats->overhead / sizeof(chunk_t);
 }
 
+/* heapmem_slab_stats: Obtain the statistics of a size class. */
+bool
+heapmem_slab_stats(unsigned class_index, heapmem_slab_stats_t *stats)
+{
+  memset(stats, 0, sizeof(*stats));
+#if HEAPMEM_SLAB
+  if(class_index < HEAPMEM_SLAB_CLASSES) {
+    stats->size = SLAB_CLASS_SIZE(class_index);
+    stats->cached = slab_classes[class_index].cached;
+    stats->hits = slab_classes[class_index].hits;
+    stats->misses = slab_classes[class_index].misses;
+    return true;
+  }
+#endif /* HEAPMEM_SLAB */
+  return false;
+}
+
+/* heapmem_zone_register: Register a zone with a capacity reserved from
+   the general zone. */
+heapmem_zone_t
+heapmem_zone_register(const char *name, size_t zone_size)
+{
+  if(zone_count == HEAPMEM_MAX_ZONES) {
+    LOG_WARN("%s: cannot register more than %u zones\n",
+             __func__, (unsigned)HEAPMEM_MAX_ZONES);
+    return HEAPMEM_ZONE_INVALID;
+  }
+
+  for(heapmem_zone_t zone = 0; zone < zone_count; zone++) {
+    if(strcmp(zones[zone].name, name) == 0) {
+      LOG_WARN("%s: zone %s is already registered\n", __func__, name);
+      return HEAPMEM_ZONE_INVALID;
+    }
+  }
+
+  heapmem_zone_stats_t *general = &zones[HEAPMEM_ZONE_GENERAL];
+  if(!zone_fits(HEAPMEM_ZONE_GENERAL, zone_size)) {
+    LOG_WARN("%s: cannot reserve %zu bytes for zone %s\n",
+             __func__, zone_size, name);
+    return HEAPMEM_ZONE_INVALID;
+  }
+  general->capacity -= zone_size;
+
+  zones[zone_count].name = name;
+  zones[zone_count].capacity = zone_size;
+
+  LOG_INFO("Registered zone %s with %zu bytes\n", name, zone_size);
+
+  return zone_count++;
+}
+
+/* heapmem_zone_stats: Obtain the statistics of a zone. */
+bool
+heapmem_zone_stats(heapmem_zone_t zone, heapmem_zone_stats_t *stats)
+{
+  if(zone >= zone_count) {
+    memset(stats, 0, sizeof(*stats));
+    return false;
+  }
+
+  *stats = zones[zone];
+  return true;
+}
+
 /* heapmem_alignment: return the minimum alignment of allocated addresses. */
 size_t
 heapmem_alignment(void)
@@ -52,6 +52,17 @@
  * heapmem_realloc(), because the chunk structure immediately precedes
  * the memory of the chunk.
  *
+ * The heap can be partitioned into zones, which makes it possible to
+ * isolate subsystems from each other. A zone is registered with a
+ * name and a capacity by calling heapmem_zone_register(), and
+ * allocations are made in it with heapmem_zone_alloc(). The capacity
+ * of a zone is reserved from the general zone, which is used by
+ * heapmem_alloc() and initially spans the whole heap. An allocation
+ * fails if it would make the memory allocated in its zone exceed the
+ * zone capacity, so that a subsystem that leaks memory or allocates
+ * in bursts cannot starve the others. The number of zones is set
+ * through the HEAPMEM_CONF_MAX_ZONES parameter.
+ *
  * \note This module does not contain a corresponding function to the
  *       standard C function calloc().
  *
@@ -74,8 +85,14 @@
 #ifndef HEAPMEM_H
 #define HEAPMEM_H
 
+#include <stdint.h>
 #include <stdlib.h>
 
+typedef uint8_t heapmem_zone_t;
+
+#define HEAPMEM_ZONE_INVALID 0xff
+#define HEAPMEM_ZONE_GENERAL 0
+
 typedef struct heapmem_stats {
   size_t allocated;
   size_t overhead;
@@ -84,14 +101,43 @@ typedef struct heapmem_stats {
   size_t chunks;
 } heapmem_stats_t;
 
+typedef struct heapmem_slab_stats {
+  size_t size;
+  size_t cached;
+  size_t hits;
+  size_t misses;
+} heapmem_slab_stats_t;
+
+typedef struct heapmem_zone_stats {
+  const char *name;
+  size_t capacity;
+  size_t allocated;
+  size_t high_water;
+  size_t failures;
+} heapmem_zone_stats_t;
+
+/**
+ * \brief      Allocate a chunk of memory in the general zone of the heap.
+ * \param size The number of bytes to allocate.
+ * \return     A pointer to the allocated memory chunk,
+ *             or NULL if the allocation failed.
+ *
+ * \sa         heapmem_zone_alloc
+ * \sa         heapmem_realloc
+ * \sa         heapmem_free
+ */
+
+#define heapmem_alloc(size) heapmem_zone_alloc(HEAPMEM_ZONE_GENERAL, (size))
+
 #if HEAPMEM_DEBUG
 
-#define heapmem_alloc(size) heapmem_alloc_debug((size), __FILE__, __LINE__)
+#define heapmem_zone_alloc(zone, size) \
+  heapmem_zone_alloc_debug((zone), (size), __FILE__, __LINE__)
 #define heapmem_realloc(ptr, size) heapmem_realloc_debug((ptr), (size), __FILE__, __LINE__)
 #define heapmem_free(ptr) heapmem_free_debug((ptr), __FILE__, __LINE__)
 
-void *heapmem_alloc_debug(size_t size,
-			  const char *file, const unsigned line);
+void *heapmem_zone_alloc_debug(heapmem_zone_t zone, size_t size,
+			       const char *file, const unsigned line);
 void *heapmem_realloc_debug(void *ptr, size_t size,
 			    const char *file, const unsigned line);
 void heapmem_free_debug(void *ptr,
@@ -100,16 +146,19 @@ void heapmem_free_debug(void *ptr,
 #else
 
 /**
- * \brief      Allocate a chunk of memory in the heap.
+ * \brief      Allocate a chunk of memory in a zone of the heap.
+ * \param zone The zone, as returned by heapmem_zone_register(), or
+ *             HEAPMEM_ZONE_GENERAL.
  * \param size The number of bytes to allocate.
  * \return     A pointer to the allocated memory chunk,
  *             or NULL if the allocation failed.
  *
+ * \sa         heapmem_alloc
  * \sa         heapmem_realloc
  * \sa         heapmem_free
  */
 
-void *heapmem_alloc(size_t size);
+void *heapmem_zone_alloc(heapmem_zone_t zone, size_t size);
 
 /**
  * \brief      Reallocate a chunk of memory in the heap.
@@ -122,6 +171,7 @@ void *heapmem_alloc(size_t size);
  * \note If ptr is NULL, this function behaves the same as heapmem_alloc.
  * \note If ptr is not NULL and size is zero, the function deallocates
  *       the chunk and returns NULL.
+ * \note The reallocated chunk stays in the zone of the original chunk.
  *
  * \sa         heapmem_alloc
  * \sa         heapmem_free
@@ -146,6 +196,38 @@ bool heapmem_free(void *ptr);
 
 #endif /* HEAMMEM_DEBUG */
 
+/**
+ * \brief           Register a zone of the heap.
+ * \param name      The name of the zone, which must remain valid.
+ * \param zone_size The capacity of the zone in bytes.
+ * \return          The zone, or HEAPMEM_ZONE_INVALID if no more zones can
+ *                  be registered, if the name is already registered, or
+ *                  if the general zone cannot spare the capacity.
+ *
+ * The capacity is reserved from the general zone. It limits the sum
+ * of the sizes of the chunks allocated in the zone, excluding the
+ * overhead of the chunk headers, which is not reserved.
+ */
+
+heapmem_zone_t heapmem_zone_register(const char *name, size_t zone_size);
+
+/**
+ * \brief       Obtain the statistics of a zone.
+ * \param zone  The zone.
+ * \param stats A pointer to an object of type heapmem_zone_stats_t,
+ *              which will be filled when calling this function.
+ * \return      False if there is no such zone.
+ *
+ * The statistics contain the name and the capacity of the zone, the
+ * number of bytes that are currently allocated in the zone, the
+ * highest number of bytes that has been allocated in it at any time,
+ * and the number of allocations that have failed in it. The zones
+ * are numbered consecutively from HEAPMEM_ZONE_GENERAL, so they can
+ * be enumerated by calling this function until it returns false.
+ */
+
+bool heapmem_zone_stats(heapmem_zone_t zone, heapmem_zone_stats_t *stats);
+
 /**
  * \brief       Obtain internal heapmem statistics regarding the
  *              allocated chunks.
@@ -162,6 +244,23 @@ bool heapmem_free(void *ptr);
 
 void heapmem_stats(heapmem_stats_t *stats);
 
+/**
+ * \brief             Obtain the statistics of a size class of the
+ *                    slab front-end.
+ * \param class_index The index of the size class, starting from zero.
+ * \param stats       A pointer to an object of type heapmem_slab_stats_t,
+ *                    which will be filled when calling this function.
+ * \return            False if there is no such size class, or if the
+ *                    slab front-end (HEAPMEM_CONF_SLAB) is disabled.
+ *
+ * For each size class, the statistics contain the object size, the
+ * number of deallocated chunks cached for reuse, and the number of
+ * allocations served from the cache (hits) or from the heap (misses).
+ * Cached chunks are counted as available memory by heapmem_stats().
+ */
+
+bool heapmem_slab_stats(unsigned class_index, heapmem_slab_stats_t *stats);
+
 /**
  * \brief       Obtain the minimum alignment of allocated addresses.
  * \return      The alignment value, which is a power of two.
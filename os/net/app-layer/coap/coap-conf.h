@@ -112,5 +112,70 @@
 #define COAP_OBSERVER_URL_LEN 20
 #endif
 
+/*
+ * Number of slots of the hash index used to dispatch requests to the
+ * activated resources, or zero to search the list of resources. The
+ * index must have more slots than there are resources; if it
+ * overflows, requests are dispatched by searching the list.
+ */
+#ifdef COAP_CONF_RESOURCE_INDEX_SIZE
+#define COAP_RESOURCE_INDEX_SIZE COAP_CONF_RESOURCE_INDEX_SIZE
+#else
+#define COAP_RESOURCE_INDEX_SIZE 0
+#endif /* COAP_CONF_RESOURCE_INDEX_SIZE */
+
+/*
+ * Congestion control for confirmable messages, after CoCoA: the
+ * initial retransmission timeout and the backoff are adapted to the
+ * round-trip times measured towards each endpoint, instead of using
+ * the fixed COAP_RESPONSE_TIMEOUT. COAP_CC_ENDPOINTS is the number of
+ * endpoints for which estimates are kept; the least recently used
+ * estimate is reclaimed for a new endpoint.
+ */
+#ifdef COAP_CONF_CONGESTION_CONTROL
+#define COAP_CONGESTION_CONTROL COAP_CONF_CONGESTION_CONTROL
+#else
+#define COAP_CONGESTION_CONTROL 0
+#endif /* COAP_CONF_CONGESTION_CONTROL */
+
+#ifdef COAP_CONF_CC_ENDPOINTS
+#define COAP_CC_ENDPOINTS COAP_CONF_CC_ENDPOINTS
+#else
+#define COAP_CC_ENDPOINTS 4
+#endif /* COAP_CONF_CC_ENDPOINTS */
+
+/*
+ * Streaming block-wise transfers with the Q-Block1 and Q-Block2
+ * options (RFC 9177). Blocks are sent in sets of up to
+ * COAP_QBLOCK_MAX_PAYLOADS (at most 32) without waiting for each to be
+ * acknowledged, and the blocks of a Q-Block2 set after the first one
+ * are paced COAP_QBLOCK_INTERVAL milliseconds apart. Up to
+ * COAP_QBLOCK_MAX_BURSTS Q-Block2 sets, each identified by the endpoint
+ * and token of its request, are sent at the same time.
+ */
+#ifdef COAP_CONF_WITH_QBLOCK
+#define COAP_WITH_QBLOCK COAP_CONF_WITH_QBLOCK
+#else
+#define COAP_WITH_QBLOCK 0
+#endif /* COAP_CONF_WITH_QBLOCK */
+
+#ifdef COAP_CONF_QBLOCK_MAX_PAYLOADS
+#define COAP_QBLOCK_MAX_PAYLOADS COAP_CONF_QBLOCK_MAX_PAYLOADS
+#else
+#define COAP_QBLOCK_MAX_PAYLOADS 10
+#endif /* COAP_CONF_QBLOCK_MAX_PAYLOADS */
+
+#ifdef COAP_CONF_QBLOCK_INTERVAL
+#define COAP_QBLOCK_INTERVAL COAP_CONF_QBLOCK_INTERVAL
+#else
+#define COAP_QBLOCK_INTERVAL 20
+#endif /* COAP_CONF_QBLOCK_INTERVAL */
+
+#ifdef COAP_CONF_QBLOCK_MAX_BURSTS
+#define COAP_QBLOCK_MAX_BURSTS COAP_CONF_QBLOCK_MAX_BURSTS
+#else
+#define COAP_QBLOCK_MAX_BURSTS 2
+#endif /* COAP_CONF_QBLOCK_MAX_BURSTS */
+
 #endif /* COAP_CONF_H_ */
 /** @} */
@@ -100,6 +100,7 @@ typedef enum {
   NOT_FOUND_4_04 = 132,         /* NOT_FOUND */
   METHOD_NOT_ALLOWED_4_05 = 133,        /* METHOD_NOT_ALLOWED */
   NOT_ACCEPTABLE_4_06 = 134,    /* NOT_ACCEPTABLE */
+  REQUEST_ENTITY_INCOMPLETE_4_08 = 136, /* REQUEST_ENTITY_INCOMPLETE */
   PRECONDITION_FAILED_4_12 = 140,       /* BAD_REQUEST */
   REQUEST_ENTITY_TOO_LARGE_4_13 = 141,  /* REQUEST_ENTITY_TOO_LARGE */
   UNSUPPORTED_MEDIA_TYPE_4_15 = 143,    /* UNSUPPORTED_MEDIA_TYPE */
@@ -134,10 +135,12 @@ typedef enum {
   COAP_OPTION_MAX_AGE = 14,     /* 0-4 B */
   COAP_OPTION_URI_QUERY = 15,   /* 0-255 B */
   COAP_OPTION_ACCEPT = 17,      /* 0-2 B */
+  COAP_OPTION_Q_BLOCK1 = 19,    /* 1-3 B */
   COAP_OPTION_LOCATION_QUERY = 20,      /* 0-255 B */
   COAP_OPTION_BLOCK2 = 23,      /* 1-3 B */
   COAP_OPTION_BLOCK1 = 27,      /* 1-3 B */
   COAP_OPTION_SIZE2 = 28,       /* 0-4 B */
+  COAP_OPTION_Q_BLOCK2 = 31,    /* 1-3 B */
   COAP_OPTION_PROXY_URI = 35,   /* 1-1034 B */
   COAP_OPTION_PROXY_SCHEME = 39,        /* 1-255 B */
   COAP_OPTION_SIZE1 = 60,       /* 0-4 B */
@@ -167,7 +170,8 @@ typedef enum {
   APPLICATION_SOAP_FASTINFOSET = 49,
   APPLICATION_JSON = 50,
   APPLICATION_X_OBIX_BINARY = 51,
-  APPLICATION_CBOR = 60
+  APPLICATION_CBOR = 60,
+  APPLICATION_MISSING_BLOCKS_CBOR_SEQ = 272
 } coap_content_format_t;
 
 /**
@@ -72,6 +72,25 @@ LIST(coap_handlers);
 LIST(coap_resource_services);
 static uint8_t is_initialized = 0;
 
+#if COAP_RESOURCE_INDEX_SIZE
+/*
+ * The resource index is an open-addressing hash table of the URI paths
+ * of the activated resources. A request is dispatched by looking up
+ * its full path and each of its parent paths, which may be handled by
+ * resources with sub-resources. The order of activation is kept to
+ * resolve ambiguities in the same way as the list of resources.
+ */
+typedef struct {
+  coap_resource_t *resource;
+  uint16_t hash;
+  uint16_t order;
+} resource_index_entry_t;
+
+static resource_index_entry_t resource_index[COAP_RESOURCE_INDEX_SIZE];
+static uint16_t resource_index_count;
+static uint8_t resource_index_overflow;
+#endif /* COAP_RESOURCE_INDEX_SIZE */
+
 /*---------------------------------------------------------------------------*/
 /*- CoAP service handlers---------------------------------------------------*/
 /*---------------------------------------------------------------------------*/
@@ -192,7 +211,12 @@ coap_receive(const coap_endpoint_t *src,
           /* get offset for blockwise transfers */
         }
         if(coap_get_header_block2
-           (message, &block_num, NULL, &block_size, &block_offset)) {
+           (message, &block_num, NULL, &block_size, &block_offset)
+#if COAP_WITH_QBLOCK
+           || coap_get_header_q_block2
+           (message, &block_num, NULL, &block_size, &block_offset)
+#endif /* COAP_WITH_QBLOCK */
+           ) {
           LOG_DBG("Blockwise: block request %"PRIu32" (%u/%u) @ %"PRIu32" bytes\n",
                   block_num, block_size, COAP_MAX_BLOCK_SIZE, block_offset);
           block_size = MIN(block_size, COAP_MAX_BLOCK_SIZE);
@@ -226,8 +250,23 @@ coap_receive(const coap_endpoint_t *src,
                 coap_status_code = NOT_IMPLEMENTED_5_01;
                 coap_error_message = "NoBlock1Support";
 
+#if COAP_WITH_QBLOCK
+                /* resource is unaware of Q-Block1 */
+              } else if(coap_is_option(message, COAP_OPTION_Q_BLOCK1)
+                        && response->code < BAD_REQUEST_4_00
+                        && !coap_is_option(response, COAP_OPTION_Q_BLOCK1)) {
+                LOG_DBG("Q-Block1 NOT IMPLEMENTED\n");
+
+                coap_status_code = BAD_OPTION_4_02;
+                coap_error_message = "NoQBlock1Support";
+#endif /* COAP_WITH_QBLOCK */
+
                 /* client requested Block2 transfer */
-              } else if(coap_is_option(message, COAP_OPTION_BLOCK2)) {
+              } else if(coap_is_option(message, COAP_OPTION_BLOCK2)
+#if COAP_WITH_QBLOCK
+                        || coap_is_option(message, COAP_OPTION_Q_BLOCK2)
+#endif /* COAP_WITH_QBLOCK */
+                        ) {
 
                 /* unchanged new_offset indicates that resource is unaware of blockwise transfer */
                 if(new_offset == block_offset) {
@@ -264,6 +303,15 @@ coap_receive(const coap_endpoint_t *src,
                   }
                 } /* if(resource aware of blockwise) */
 
+#if COAP_WITH_QBLOCK
+                /* answer Q-Block2 requests with Q-Block2 */
+                if(coap_is_option(message, COAP_OPTION_Q_BLOCK2)
+                   && coap_is_option(response, COAP_OPTION_BLOCK2)) {
+                  coap_clear_option(response, COAP_OPTION_BLOCK2);
+                  coap_set_option(response, COAP_OPTION_Q_BLOCK2);
+                }
+#endif /* COAP_WITH_QBLOCK */
+
                 /* Resource requested Block2 transfer */
               } else if(new_offset != 0) {
                 LOG_DBG("Blockwise: no block option for blockwise resource, using block size %u\n",
@@ -312,6 +360,9 @@ coap_receive(const coap_endpoint_t *src,
         coap_resource_response_handler_t callback = transaction->callback;
         void *callback_data = transaction->callback_data;
 
+#if COAP_CONGESTION_CONTROL
+        coap_transaction_acknowledged(transaction);
+#endif /* COAP_CONGESTION_CONTROL */
         coap_clear_transaction(transaction);
 
         /* check if someone registered for the response */
@@ -365,6 +416,119 @@ coap_receive(const coap_endpoint_t *src,
   /* if(new data) */
   return coap_status_code;
 }
+#if COAP_RESOURCE_INDEX_SIZE
+/*---------------------------------------------------------------------------*/
+/* FNV-1a, which spreads the many similar paths of LwM2M objects well. */
+#define PATH_HASH_INIT 2166136261UL
+
+static CC_INLINE uint32_t
+path_hash(uint32_t hash, char c)
+{
+  return (hash ^ (uint8_t)c) * 16777619UL;
+}
+/*---------------------------------------------------------------------------*/
+static CC_INLINE uint16_t
+path_hash_fold(uint32_t hash)
+{
+  return (uint16_t)(hash ^ (hash >> 16));
+}
+/*---------------------------------------------------------------------------*/
+static void
+resource_index_insert(coap_resource_t *resource)
+{
+  uint32_t hash = PATH_HASH_INIT;
+  uint16_t key;
+  uint16_t i;
+
+  /* Keep a free slot to terminate the lookups. */
+  if(resource_index_count >= COAP_RESOURCE_INDEX_SIZE - 1) {
+    LOG_WARN("Resource index full, dispatching by list\n");
+    resource_index_overflow = 1;
+    return;
+  }
+
+  for(const char *c = resource->url; *c != '\0'; c++) {
+    hash = path_hash(hash, *c);
+  }
+
+  key = path_hash_fold(hash);
+
+  for(i = key % COAP_RESOURCE_INDEX_SIZE;
+      resource_index[i].resource != NULL;
+      i = (i + 1) % COAP_RESOURCE_INDEX_SIZE);
+
+  resource_index[i].resource = resource;
+  resource_index[i].hash = key;
+  resource_index[i].order = resource_index_count++;
+}
+/*---------------------------------------------------------------------------*/
+static void
+resource_index_rebuild(void)
+{
+  coap_resource_t *resource;
+
+  memset(resource_index, 0, sizeof(resource_index));
+  resource_index_count = 0;
+  resource_index_overflow = 0;
+
+  for(resource = list_head(coap_resource_services);
+      resource; resource = resource->next) {
+    resource_index_insert(resource);
+  }
+}
+/*---------------------------------------------------------------------------*/
+/*
+ * Find the resource activated under a path that was activated before
+ * *order, and update *order. If sub_only is set, only resources that
+ * have sub-resources are considered.
+ */
+static coap_resource_t *
+resource_index_find(const char *path, int path_len, uint16_t hash,
+                    uint8_t sub_only, uint16_t *order)
+{
+  coap_resource_t *found = NULL;
+  resource_index_entry_t *entry;
+
+  for(uint16_t i = hash % COAP_RESOURCE_INDEX_SIZE;
+      resource_index[i].resource != NULL;
+      i = (i + 1) % COAP_RESOURCE_INDEX_SIZE) {
+    entry = &resource_index[i];
+    if(entry->hash == hash && entry->order < *order
+       && (!sub_only || (entry->resource->flags & HAS_SUB_RESOURCES))
+       && (int)strlen(entry->resource->url) == path_len
+       && (path_len == 0
+           || strncmp(entry->resource->url, path, path_len) == 0)) {
+      found = entry->resource;
+      *order = entry->order;
+    }
+  }
+  return found;
+}
+/*---------------------------------------------------------------------------*/
+static coap_resource_t *
+resource_index_lookup(const char *path, int path_len)
+{
+  coap_resource_t *found = NULL;
+  coap_resource_t *resource;
+  uint16_t order = UINT16_MAX;
+  uint32_t hash = PATH_HASH_INIT;
+
+  for(int i = 0; i < path_len; i++) {
+    if(path[i] == '/') {
+      resource = resource_index_find(path, i, path_hash_fold(hash), 1,
+                                     &order);
+      if(resource != NULL) {
+        found = resource;
+      }
+    }
+    hash = path_hash(hash, path[i]);
+  }
+
+  resource = resource_index_find(path, path_len, path_hash_fold(hash), 0,
+                                 &order);
+  return resource != NULL ? resource : found;
+}
+#endif /* COAP_RESOURCE_INDEX_SIZE */
 /*---------------------------------------------------------------------------*/
 void
 coap_engine_init(void)
@@ -379,6 +543,9 @@ coap_engine_init(void)
 
   list_init(coap_handlers);
   list_init(coap_resource_services);
+#if COAP_RESOURCE_INDEX_SIZE
+  resource_index_rebuild();
+#endif /* COAP_RESOURCE_INDEX_SIZE */
 
   coap_activate_resource(&res_well_known_core, ".well-known/core");
 
@@ -397,9 +564,22 @@ void
 coap_activate_resource(coap_resource_t *resource, const char *path)
 {
   coap_periodic_resource_t *periodic;
+#if COAP_RESOURCE_INDEX_SIZE
+  bool reactivated = list_contains(coap_resource_services, resource);
+#endif /* COAP_RESOURCE_INDEX_SIZE */
+
   resource->url = path;
   list_add(coap_resource_services, resource);
 
+#if COAP_RESOURCE_INDEX_SIZE
+  if(reactivated) {
+    /* The resource has moved to the end of the list. */
+    resource_index_rebuild();
+  } else {
+    resource_index_insert(resource);
+  }
+#endif /* COAP_RESOURCE_INDEX_SIZE */
+
   LOG_INFO("Activating: %s\n", resource->url);
 
   /* Only add periodic resources with a periodic_handler and a period > 0. */
@@ -430,6 +610,34 @@ coap_get_next_resource(coap_resource_t *resource)
   return list_item_next(resource);
 }
 /*---------------------------------------------------------------------------*/
+coap_resource_t *
+coap_find_resource(const char *path, int path_len)
+{
+  coap_resource_t *resource;
+  int res_url_len;
+
+#if COAP_RESOURCE_INDEX_SIZE
+  if(!resource_index_overflow) {
+    return resource_index_lookup(path, path_len);
+  }
+#endif /* COAP_RESOURCE_INDEX_SIZE */
+
+  for(resource = list_head(coap_resource_services);
+      resource; resource = resource->next) {
+
+    /* if the web service handles that kind of requests and urls matches */
+    res_url_len = strlen(resource->url);
+    if((path_len == res_url_len
+        || (path_len > res_url_len
+            && (resource->flags & HAS_SUB_RESOURCES)
+            && path[res_url_len] == '/'))
+       && strncmp(resource->url, path, res_url_len) == 0) {
+      return resource;
+    }
+  }
+  return NULL;
+}
+/*---------------------------------------------------------------------------*/
 static int
 invoke_coap_resource_service(coap_message_t *request, coap_message_t *response,
                              uint8_t *buffer, uint16_t buffer_size,
@@ -440,44 +648,34 @@ invoke_coap_resource_service(coap_message_t *request, coap_message_t *response,
 
   coap_resource_t *resource = NULL;
   const char *url = NULL;
-  int url_len, res_url_len;
+  int url_len;
 
   url_len = coap_get_header_uri_path(request, &url);
-  for(resource = list_head(coap_resource_services);
-      resource; resource = resource->next) {
-
-    /* if the web service handles that kind of requests and urls matches */
-    res_url_len = strlen(resource->url);
-    if((url_len == res_url_len
-        || (url_len > res_url_len
-            && (resource->flags & HAS_SUB_RESOURCES)
-            && url[res_url_len] == '/'))
-       && strncmp(resource->url, url, res_url_len) == 0) {
-      coap_resource_flags_t method = coap_get_method_type(request);
-      found = 1;
-
-      LOG_INFO("/%s, method %u, resource->flags %u\n", resource->url,
-               (uint16_t)method, resource->flags);
-
-      if((method & METHOD_GET) && resource->get_handler != NULL) {
-        /* call handler function */
-        resource->get_handler(request, response, buffer, buffer_size, offset);
-      } else if((method & METHOD_POST) && resource->post_handler != NULL) {
-        /* call handler function */
-        resource->post_handler(request, response, buffer, buffer_size,
+  resource = coap_find_resource(url, url_len);
+  if(resource != NULL) {
+    coap_resource_flags_t method = coap_get_method_type(request);
+    found = 1;
+
+    LOG_INFO("/%s, method %u, resource->flags %u\n", resource->url,
+             (uint16_t)method, resource->flags);
+
+    if((method & METHOD_GET) && resource->get_handler != NULL) {
+      /* call handler function */
+      resource->get_handler(request, response, buffer, buffer_size, offset);
+    } else if((method & METHOD_POST) && resource->post_handler != NULL) {
+      /* call handler function */
+      resource->post_handler(request, response, buffer, buffer_size,
+                             offset);
+    } else if((method & METHOD_PUT) && resource->put_handler != NULL) {
+      /* call handler function */
+      resource->put_handler(request, response, buffer, buffer_size, offset);
+    } else if((method & METHOD_DELETE) && resource->delete_handler != NULL) {
+      /* call handler function */
+      resource->delete_handler(request, response, buffer, buffer_size,
                                offset);
-      } else if((method & METHOD_PUT) && resource->put_handler != NULL) {
-        /* call handler function */
-        resource->put_handler(request, response, buffer, buffer_size, offset);
-      } else if((method & METHOD_DELETE) && resource->delete_handler != NULL) {
-        /* call handler function */
-        resource->delete_handler(request, response, buffer, buffer_size,
-                                 offset);
-      } else {
-        allowed = 0;
-        coap_set_status_code(response, METHOD_NOT_ALLOWED_4_05);
-      }
-      break;
+    } else {
+      allowed = 0;
+      coap_set_status_code(response, METHOD_NOT_ALLOWED_4_05);
     }
   }
   if(!found) {
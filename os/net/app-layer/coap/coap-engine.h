@@ -167,6 +167,17 @@ coap_resource_t *coap_get_first_resource(void);
  */
 coap_resource_t *coap_get_next_resource(coap_resource_t *resource);
 /*---------------------------------------------------------------------------*/
+/**
+ * \brief      Finds the resource that handles a URI path.
+ * \param path The URI path, which does not need to be null-terminated.
+ * \param path_len The length of the URI path.
+ * \return     The resource activated under the path, or under a parent
+ *             path if the resource has sub-resources, or NULL if none
+ *             exists. If several resources match, the one that was
+ *             activated first is returned.
+ */
+coap_resource_t *coap_find_resource(const char *path, int path_len);
+/*---------------------------------------------------------------------------*/
 
 #include "coap-transactions.h"
 #include "coap-observe.h"
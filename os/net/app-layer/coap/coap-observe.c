@@ -185,18 +185,174 @@ coap_notify_observers(coap_resource_t *resource)
 {
   coap_notify_observers_sub(resource, NULL);
 }
+/*---------------------------------------------------------------------------*/
+/*
+ * The representation of a notification is rendered and serialized
+ * once, without token and with a zero-length Observe option, into
+ * this template. The message for each observer is then obtained by
+ * patching the type, MID, token and Observe value into a copy.
+ */
+static uint8_t notification_template[COAP_MAX_PACKET_SIZE];
+static size_t notification_template_len;
+/* Offset of the Observe option in the template, or 0 if it has none. */
+static size_t notification_observe_offset;
+/*---------------------------------------------------------------------------*/
+static size_t
+find_observe_option(const uint8_t *buffer, size_t len)
+{
+  size_t pos = COAP_HEADER_LEN; /* The template has no token. */
+  unsigned int number = 0;
+
+  while(pos < len && buffer[pos] != 0xFF) {
+    unsigned int delta = buffer[pos] >> 4;
+    size_t length = buffer[pos] & COAP_HEADER_OPTION_SHORT_LENGTH_MASK;
+    size_t header_len = 1;
+
+    if(delta == 13) {
+      delta = buffer[pos + header_len] + 13;
+      header_len += 1;
+    } else if(delta == 14) {
+      delta = (buffer[pos + header_len] << 8) + buffer[pos + header_len + 1] + 269;
+      header_len += 2;
+    }
+    if(length == 13) {
+      length = buffer[pos + header_len] + 13;
+      header_len += 1;
+    } else if(length == 14) {
+      length = (buffer[pos + header_len] << 8) + buffer[pos + header_len + 1] + 269;
+      header_len += 2;
+    }
+
+    number += delta;
+    if(number == COAP_OPTION_OBSERVE) {
+      return pos;
+    } else if(number > COAP_OPTION_OBSERVE) {
+      break;
+    }
+    pos += header_len + length;
+  }
+  return 0;
+}
+/*---------------------------------------------------------------------------*/
+static int
+render_notification(coap_resource_t *resource, const char *url)
+{
+  coap_message_t notification[1]; /* this way the message can be treated as pointer as usual */
+  coap_message_t request[1]; /* this way the message can be treated as pointer as usual */
+  int32_t new_offset = 0;
+
+  coap_init_message(notification, COAP_TYPE_NON, CONTENT_2_05, 0);
+  /* create a "fake" request for the URI */
+  coap_init_message(request, COAP_TYPE_CON, COAP_GET, 0);
+  coap_set_header_uri_path(request, url);
+
+  /* Either old style get_handler or the full handler */
+  if(coap_call_handlers(request, notification, notification_template +
+                        COAP_MAX_HEADER_SIZE, COAP_MAX_CHUNK_SIZE,
+                        &new_offset) > 0) {
+    LOG_DBG("Notification on new handlers\n");
+  } else {
+    if(resource != NULL) {
+      resource->get_handler(request, notification,
+                            notification_template + COAP_MAX_HEADER_SIZE,
+                            COAP_MAX_CHUNK_SIZE, &new_offset);
+    } else {
+      /* What to do here? */
+      notification->code = BAD_REQUEST_4_00;
+    }
+  }
+
+  if(notification->code < BAD_REQUEST_4_00) {
+    /* The value is patched in for each observer. */
+    coap_set_header_observe(notification, 0);
+  }
+
+  if(new_offset != 0) {
+    coap_set_header_block2(notification,
+                           0,
+                           new_offset != -1,
+                           COAP_MAX_BLOCK_SIZE);
+    coap_set_payload(notification,
+                     notification->payload,
+                     MIN(notification->payload_len,
+                         COAP_MAX_BLOCK_SIZE));
+  }
+
+  notification_template_len =
+    coap_serialize_message(notification, notification_template);
+  if(notification_template_len == 0) {
+    LOG_WARN("Failed to serialize notification for %s\n", url);
+    return 0;
+  }
+
+  /* Leave room for the token and the Observe value of any observer. */
+  if(notification_template_len + COAP_TOKEN_LEN + 3 > COAP_MAX_PACKET_SIZE) {
+    LOG_WARN("Notification for %s is too large\n", url);
+    return 0;
+  }
+
+  if(notification->code < BAD_REQUEST_4_00) {
+    notification_observe_offset =
+      find_observe_option(notification_template, notification_template_len);
+  } else {
+    notification_observe_offset = 0;
+  }
+
+  return 1;
+}
+/*---------------------------------------------------------------------------*/
+static size_t
+patch_notification(uint8_t *buffer, const coap_observer_t *obs,
+                   coap_message_type_t type, uint16_t mid)
+{
+  const uint8_t *in = notification_template + COAP_HEADER_LEN;
+  const uint8_t *end = notification_template + notification_template_len;
+  uint8_t *out = buffer;
+  size_t len;
+
+  *out++ = (notification_template[0] &
+            ~(COAP_HEADER_TYPE_MASK | COAP_HEADER_TOKEN_LEN_MASK)) |
+    (COAP_HEADER_TYPE_MASK & type << COAP_HEADER_TYPE_POSITION) |
+    (COAP_HEADER_TOKEN_LEN_MASK & obs->token_len << COAP_HEADER_TOKEN_LEN_POSITION);
+  *out++ = notification_template[1];
+  *out++ = (uint8_t)(mid >> 8);
+  *out++ = (uint8_t)mid;
+
+  memcpy(out, obs->token, obs->token_len);
+  out += obs->token_len;
+
+  if(notification_observe_offset != 0) {
+    /* Copy the options preceding Observe, whose header keeps its delta. */
+    len = notification_template + notification_observe_offset - in;
+    memcpy(out, in, len);
+    out += len;
+    in += len;
+
+    len = obs->obs_counter > 0xffff ? 3 : obs->obs_counter > 0xff ? 2 :
+      obs->obs_counter > 0 ? 1 : 0;
+    *out++ = (*in++ & COAP_HEADER_OPTION_DELTA_MASK) | len;
+    while(len > 0) {
+      *out++ = (uint8_t)(obs->obs_counter >> (8 * --len));
+    }
+  }
+
+  /* The remaining options are relative to Observe and can be copied. */
+  memcpy(out, in, end - in);
+  out += end - in;
+
+  return out - buffer;
+}
+/*---------------------------------------------------------------------------*/
 /* Can be used either for sub - or when there is not resource - just
    a handler */
 void
 coap_notify_observers_sub(coap_resource_t *resource, const char *subpath)
 {
-  /* build notification */
-  coap_message_t notification[1]; /* this way the message can be treated as pointer as usual */
-  coap_message_t request[1]; /* this way the message can be treated as pointer as usual */
   coap_observer_t *obs = NULL;
   int url_len, obs_url_len;
   char url[COAP_OBSERVER_URL_LEN];
   uint8_t sub_ok = 0;
+  uint8_t rendered = 0;
 
   if(resource != NULL) {
     url_len = strlen(resource->url);
@@ -216,11 +372,6 @@ coap_notify_observers_sub(coap_resource_t *resource, const char *subpath)
   /* url now contains the notify URL that needs to match the observer */
   LOG_INFO("Notification from %s\n", url);
 
-  coap_init_message(notification, COAP_TYPE_NON, CONTENT_2_05, 0);
-  /* create a "fake" request for the URI */
-  coap_init_message(request, COAP_TYPE_CON, COAP_GET, 0);
-  coap_set_header_uri_path(request, url);
-
   /* iterate over observers */
   url_len = strlen(url);
   /* Assumes lazy evaluation... */
@@ -240,15 +391,26 @@ coap_notify_observers_sub(coap_resource_t *resource, const char *subpath)
             && obs->url[url_len] == '/'))
        && strncmp(url, obs->url, url_len) == 0) {
       coap_transaction_t *transaction = NULL;
-
-      /*TODO implement special transaction for CON, sharing the same buffer to allow for more observers */
+      coap_message_type_t type = COAP_TYPE_NON;
+
+      /*
+       * All matching observers receive the same representation, since
+       * the handler sees the same request for each of them, so it is
+       * only rendered for the first one.
+       */
+      if(!rendered) {
+        if(!render_notification(resource, url)) {
+          return;
+        }
+        rendered = 1;
+      }
 
       if((transaction = coap_new_transaction(coap_get_mid(), &obs->endpoint))) {
         /* if COAP_OBSERVE_REFRESH_INTERVAL is zero, never send observations as confirmable messages */
         if(COAP_OBSERVE_REFRESH_INTERVAL != 0
             && (obs->obs_counter % COAP_OBSERVE_REFRESH_INTERVAL == 0)) {
           LOG_DBG("           Force Confirmable for\n");
-          notification->type = COAP_TYPE_CON;
+          type = COAP_TYPE_CON;
         }
 
         LOG_DBG("           Observer ");
@@ -258,47 +420,15 @@ coap_notify_observers_sub(coap_resource_t *resource, const char *subpath)
         /* update last MID for RST matching */
         obs->last_mid = transaction->mid;
 
-        /* prepare response */
-        notification->mid = transaction->mid;
-
-	int32_t new_offset = 0;
-
-        /* Either old style get_handler or the full handler */
-        if(coap_call_handlers(request, notification, transaction->message +
-                              COAP_MAX_HEADER_SIZE, COAP_MAX_CHUNK_SIZE,
-                              &new_offset) > 0) {
-          LOG_DBG("Notification on new handlers\n");
-        } else {
-          if(resource != NULL) {
-            resource->get_handler(request, notification,
-                                  transaction->message + COAP_MAX_HEADER_SIZE,
-                                  COAP_MAX_CHUNK_SIZE, &new_offset);
-          } else {
-            /* What to do here? */
-            notification->code = BAD_REQUEST_4_00;
-          }
-        }
+        transaction->message_len =
+          patch_notification(transaction->message, obs, type,
+                             transaction->mid);
 
-        if(notification->code < BAD_REQUEST_4_00) {
-          coap_set_header_observe(notification, (obs->obs_counter)++);
+        if(notification_observe_offset != 0) {
+          (obs->obs_counter)++;
           /* mask out to keep the CoAP observe option length <= 3 bytes */
           obs->obs_counter &= 0xffffff;
         }
-        coap_set_token(notification, obs->token, obs->token_len);
-
-	if(new_offset != 0) {
-	  coap_set_header_block2(notification,
-				 0,
-				 new_offset != -1,
-				 COAP_MAX_BLOCK_SIZE);
-	  coap_set_payload(notification,
-			   notification->payload,
-			   MIN(notification->payload_len,
-			       COAP_MAX_BLOCK_SIZE));
-	}
-
-        transaction->message_len =
-          coap_serialize_message(notification, transaction->message);
 
         coap_send_transaction(transaction);
       }
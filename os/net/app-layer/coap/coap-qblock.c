@@ -0,0 +1,465 @@
+/*
+ * Copyright (c) 2026, RISE Research Institutes of Sweden.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ *         Streaming block-wise transfers with the Q-Block1 and Q-Block2
+ *         options (RFC 9177).
+ */
+
+/**
+ * \addtogroup coap
+ * @{
+ */
+
+#include "coap-qblock.h"
+#include "coap-engine.h"
+#include "lib/memb.h"
+#include "lib/list.h"
+#include "sys/cc.h"
+#include <string.h>
+
+#if COAP_WITH_QBLOCK
+
+#if COAP_QBLOCK_MAX_PAYLOADS > 32
+#error "COAP_QBLOCK_MAX_PAYLOADS must be at most 32"
+#endif
+
+/* Log configuration */
+#include "coap-log.h"
+#define LOG_MODULE "coap"
+#define LOG_LEVEL  LOG_LEVEL_COAP
+
+/* The payload of a 4.08 response: one CBOR unsigned integer per block */
+static uint8_t missing_blocks[COAP_QBLOCK_MAX_PAYLOADS * 5];
+
+/* A Q-Block2 set being sent, identified by its endpoint and token */
+typedef struct qblock2_burst {
+  struct qblock2_burst *next_burst;
+  coap_timer_t timer;
+  coap_endpoint_t endpoint;
+  const coap_qblock2_source_t *source;
+  uint8_t token[COAP_TOKEN_LEN];
+  uint8_t token_len;
+  uint16_t size;
+  uint32_t next;
+  uint32_t end;
+} qblock2_burst_t;
+
+MEMB(bursts_memb, qblock2_burst_t, COAP_QBLOCK_MAX_BURSTS);
+LIST(bursts_list);
+
+/* The blocks of all sets are built in turn in the same buffer */
+static coap_message_t burst_message[1];
+static uint8_t burst_buffer[COAP_MAX_PACKET_SIZE + 1];
+/*---------------------------------------------------------------------------*/
+static uint32_t
+set_last(const coap_qblock1_receiver_t *receiver)
+{
+  uint32_t last = receiver->set_start + COAP_QBLOCK_MAX_PAYLOADS - 1;
+
+  if(receiver->last_known && receiver->last < last) {
+    return receiver->last;
+  }
+  return last;
+}
+/*---------------------------------------------------------------------------*/
+static int
+set_complete(uint32_t received, uint32_t count)
+{
+  uint32_t mask = count >= 32 ? UINT32_MAX : (1UL << count) - 1;
+
+  return (received & mask) == mask;
+}
+/*---------------------------------------------------------------------------*/
+static int
+in_set(const coap_qblock1_receiver_t *receiver, uint32_t num)
+{
+  return num >= receiver->set_start
+    && num - receiver->set_start < COAP_QBLOCK_MAX_PAYLOADS;
+}
+/*---------------------------------------------------------------------------*/
+static uint16_t
+encode_missing_blocks(const coap_qblock1_receiver_t *receiver)
+{
+  uint16_t len = 0;
+  uint32_t num;
+
+  for(num = receiver->set_start; num <= set_last(receiver); num++) {
+    if(receiver->received & (1UL << (num - receiver->set_start))) {
+      continue;
+    }
+    /* CBOR major type 0 */
+    if(num < 24) {
+      missing_blocks[len++] = num;
+    } else if(num <= UINT8_MAX) {
+      missing_blocks[len++] = 0x18;
+      missing_blocks[len++] = num;
+    } else if(num <= UINT16_MAX) {
+      missing_blocks[len++] = 0x19;
+      missing_blocks[len++] = num >> 8;
+      missing_blocks[len++] = num;
+    } else {
+      missing_blocks[len++] = 0x1a;
+      missing_blocks[len++] = num >> 24;
+      missing_blocks[len++] = num >> 16;
+      missing_blocks[len++] = num >> 8;
+      missing_blocks[len++] = num;
+    }
+  }
+  return len;
+}
+/*---------------------------------------------------------------------------*/
+int
+coap_qblock1_accept(coap_qblock1_receiver_t *receiver,
+                    coap_message_t *request)
+{
+  const coap_endpoint_t *src = coap_get_src_endpoint(request);
+  const uint8_t *payload;
+  uint32_t num;
+  uint8_t more;
+  uint16_t size;
+
+  if(!coap_get_header_q_block1(request, &num, &more, &size, NULL)) {
+    coap_status_code = BAD_REQUEST_4_00;
+    coap_error_message = "NoQBlock1";
+    return -1;
+  }
+
+  if(coap_get_payload(request, &payload) == 0) {
+    coap_status_code = BAD_REQUEST_4_00;
+    coap_error_message = "NoPayload";
+    return -1;
+  }
+
+  if(num == 0) {
+    /* A new body, unless block 0 of the current one is repeated */
+    if(!receiver->active || receiver->set_start > 0
+       || !coap_endpoint_cmp(&receiver->endpoint, src)) {
+      memset(receiver, 0, sizeof(*receiver));
+      coap_endpoint_copy(&receiver->endpoint, src);
+      receiver->size = size;
+      receiver->active = 1;
+      LOG_DBG("Q-Block1: new body, %u B/blk\n", size);
+    }
+  } else if(!receiver->active || !coap_endpoint_cmp(&receiver->endpoint, src)) {
+    coap_status_code = REQUEST_ENTITY_INCOMPLETE_4_08;
+    coap_error_message = "NoFirstBlock";
+    return -1;
+  }
+
+  if(size != receiver->size) {
+    coap_status_code = BAD_REQUEST_4_00;
+    coap_error_message = "BlockSizeChanged";
+    return -1;
+  }
+
+  return in_set(receiver, num)
+    && !(receiver->received & (1UL << (num - receiver->set_start)));
+}
+/*---------------------------------------------------------------------------*/
+int
+coap_qblock1_is_final(const coap_qblock1_receiver_t *receiver,
+                      coap_message_t *request)
+{
+  uint32_t num;
+  uint8_t more;
+  uint32_t last;
+
+  if(!coap_get_header_q_block1(request, &num, &more, NULL, NULL)
+     || !receiver->active || !in_set(receiver, num)) {
+    return 0;
+  }
+
+  if(receiver->last_known) {
+    last = receiver->last;
+  } else if(!more) {
+    last = num;
+  } else {
+    return 0;
+  }
+
+  return in_set(receiver, last)
+    && set_complete(receiver->received | (1UL << (num - receiver->set_start)),
+                    last - receiver->set_start + 1);
+}
+/*---------------------------------------------------------------------------*/
+int
+coap_qblock1_respond(coap_qblock1_receiver_t *receiver,
+                     coap_message_t *request, coap_message_t *response)
+{
+  uint32_t num;
+  uint8_t more;
+  uint16_t size;
+  uint32_t last;
+
+  coap_get_header_q_block1(request, &num, &more, &size, NULL);
+
+  if(in_set(receiver, num)) {
+    receiver->received |= 1UL << (num - receiver->set_start);
+    if(!more) {
+      receiver->last = num;
+      receiver->last_known = 1;
+      receiver->length = num * size + request->payload_len;
+    }
+  }
+
+  if(receiver->last_known && receiver->set_start > receiver->last) {
+    /* The body is already complete: repeat the final response */
+    coap_set_header_q_block1(response, num, 0, size);
+    return 0;
+  }
+
+  if(num < receiver->set_start) {
+    /* A block of a complete set: our 2.31 may have been lost */
+    if(request->type == COAP_TYPE_CON
+       || (num + 1) % COAP_QBLOCK_MAX_PAYLOADS == 0) {
+      coap_set_status_code(response, CONTINUE_2_31);
+      coap_set_header_q_block1(response, num, 1, size);
+    } else {
+      coap_status_code = MANUAL_RESPONSE;
+    }
+    return 1;
+  }
+
+  last = set_last(receiver);
+  if(set_complete(receiver->received, last - receiver->set_start + 1)) {
+    receiver->set_start = last + 1;
+    receiver->received = 0;
+
+    if(receiver->last_known && last == receiver->last) {
+      LOG_DBG("Q-Block1: body complete, %lu blocks\n",
+              (unsigned long)last + 1);
+      coap_set_header_q_block1(response, num, 0, size);
+      return 0;
+    }
+
+    LOG_DBG("Q-Block1: set complete, continue at %lu\n",
+            (unsigned long)receiver->set_start);
+    coap_set_status_code(response, CONTINUE_2_31);
+    coap_set_header_q_block1(response, last, 1, size);
+    return 1;
+  }
+
+  if(num >= last) {
+    /* The set should be complete: ask for the missing blocks */
+    LOG_DBG("Q-Block1: missing blocks in set at %lu\n",
+            (unsigned long)receiver->set_start);
+    coap_set_status_code(response, REQUEST_ENTITY_INCOMPLETE_4_08);
+    coap_set_header_content_format(response,
+                                   APPLICATION_MISSING_BLOCKS_CBOR_SEQ);
+    coap_set_payload(response, missing_blocks,
+                     encode_missing_blocks(receiver));
+    return 1;
+  }
+
+  if(request->type == COAP_TYPE_CON) {
+    coap_set_status_code(response, CONTINUE_2_31);
+    coap_set_header_q_block1(response, num, 1, size);
+  } else {
+    /* Blocks within a set are not answered */
+    coap_status_code = MANUAL_RESPONSE;
+  }
+  return 1;
+}
+/*---------------------------------------------------------------------------*/
+int
+coap_qblock1_handler(coap_qblock1_receiver_t *receiver,
+                     coap_message_t *request, coap_message_t *response,
+                     coap_qblock_write_t write, void *user)
+{
+  const uint8_t *payload;
+  uint32_t offset;
+  int accepted;
+  int len;
+
+  accepted = coap_qblock1_accept(receiver, request);
+  if(accepted < 0) {
+    return -1;
+  }
+
+  if(accepted) {
+    len = coap_get_payload(request, &payload);
+    coap_get_header_q_block1(request, NULL, NULL, NULL, &offset);
+    if(write(user, offset, payload, len) != 0) {
+      coap_status_code = INTERNAL_SERVER_ERROR_5_00;
+      coap_error_message = "WriteFailed";
+      return -1;
+    }
+  }
+
+  return coap_qblock1_respond(receiver, request, response);
+}
+/*---------------------------------------------------------------------------*/
+static qblock2_burst_t *
+find_burst(const coap_endpoint_t *endpoint, const uint8_t *token,
+           uint8_t token_len)
+{
+  qblock2_burst_t *burst;
+
+  for(burst = list_head(bursts_list); burst != NULL;
+      burst = burst->next_burst) {
+    if(burst->token_len == token_len
+       && memcmp(burst->token, token, token_len) == 0
+       && coap_endpoint_cmp(&burst->endpoint, endpoint)) {
+      return burst;
+    }
+  }
+  return NULL;
+}
+/*---------------------------------------------------------------------------*/
+static void
+free_burst(qblock2_burst_t *burst)
+{
+  coap_timer_stop(&burst->timer);
+  list_remove(bursts_list, burst);
+  memb_free(&bursts_memb, burst);
+}
+/*---------------------------------------------------------------------------*/
+static void
+send_next_block(coap_timer_t *timer)
+{
+  qblock2_burst_t *burst = coap_timer_get_user_data(timer);
+  const coap_qblock2_source_t *source = burst->source;
+  uint32_t offset = burst->next * burst->size;
+  uint8_t *payload = burst_buffer + COAP_MAX_HEADER_SIZE;
+  size_t message_len;
+  int len;
+
+  /* Load the block directly into the message buffer */
+  len = source->read(source->user, offset, payload,
+                     MIN(burst->size, source->length - offset));
+  if(len < 0) {
+    LOG_WARN("Q-Block2: failed to load block %lu\n",
+             (unsigned long)burst->next);
+    free_burst(burst);
+    return;
+  }
+
+  coap_init_message(burst_message, COAP_TYPE_NON, CONTENT_2_05,
+                    coap_get_mid());
+  coap_set_token(burst_message, burst->token, burst->token_len);
+  coap_set_header_content_format(burst_message, source->content_format);
+  coap_set_header_q_block2(burst_message, burst->next,
+                           offset + len < source->length, burst->size);
+  coap_set_payload(burst_message, payload, len);
+
+  message_len = coap_serialize_message(burst_message, burst_buffer);
+  if(message_len > 0) {
+    coap_sendto(&burst->endpoint, burst_buffer, message_len);
+  }
+
+  if(burst->next++ < burst->end) {
+    coap_timer_set(timer, COAP_QBLOCK_INTERVAL);
+  } else {
+    free_burst(burst);
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+start_burst(const coap_qblock2_source_t *source, coap_message_t *request,
+            uint32_t num, uint16_t size)
+{
+  const coap_endpoint_t *endpoint = coap_get_src_endpoint(request);
+  uint32_t last = (source->length - 1) / size;
+  qblock2_burst_t *burst;
+
+  if(num >= last) {
+    return;
+  }
+
+  /* A repeated request restarts the set of its transfer */
+  burst = find_burst(endpoint, request->token, request->token_len);
+  if(burst == NULL) {
+    burst = memb_alloc(&bursts_memb);
+    if(burst == NULL) {
+      /* The client requests the other blocks of the set itself */
+      LOG_WARN("Q-Block2: no free burst for block %lu\n",
+               (unsigned long)num);
+      return;
+    }
+    memset(burst, 0, sizeof(*burst));
+    coap_endpoint_copy(&burst->endpoint, endpoint);
+    memcpy(burst->token, request->token, request->token_len);
+    burst->token_len = request->token_len;
+    list_add(bursts_list, burst);
+  } else {
+    coap_timer_stop(&burst->timer);
+  }
+
+  burst->source = source;
+  burst->size = size;
+  burst->next = num + 1;
+  burst->end = MIN(num + COAP_QBLOCK_MAX_PAYLOADS - 1, last);
+
+  LOG_DBG("Q-Block2: sending blocks %lu-%lu\n", (unsigned long)burst->next,
+          (unsigned long)burst->end);
+
+  coap_timer_set_callback(&burst->timer, send_next_block);
+  coap_timer_set_user_data(&burst->timer, burst);
+  coap_timer_set(&burst->timer, COAP_QBLOCK_INTERVAL);
+}
+/*---------------------------------------------------------------------------*/
+void
+coap_qblock2_handler(const coap_qblock2_source_t *source,
+                     coap_message_t *request, coap_message_t *response,
+                     uint8_t *buffer, uint16_t preferred_size,
+                     int32_t *offset)
+{
+  uint32_t start = *offset;
+  uint32_t num;
+  int len;
+
+  if(start > 0 && start >= source->length) {
+    coap_set_status_code(response, BAD_OPTION_4_02);
+    coap_set_payload(response, "BlockOutOfScope", 15);
+    return;
+  }
+
+  len = source->read(source->user, start, buffer,
+                     MIN(preferred_size, source->length - start));
+  if(len < 0) {
+    coap_set_status_code(response, INTERNAL_SERVER_ERROR_5_00);
+    return;
+  }
+
+  coap_set_header_content_format(response, source->content_format);
+  coap_set_header_size2(response, source->length);
+  coap_set_payload(response, buffer, len);
+  *offset = start + len < source->length ? start + len : -1;
+
+  /* Send the rest of the set when its first block is requested */
+  if(coap_get_header_q_block2(request, &num, NULL, NULL, NULL)
+     && num % COAP_QBLOCK_MAX_PAYLOADS == 0 && *offset != -1) {
+    start_burst(source, request, start / preferred_size, preferred_size);
+  }
+}
+/*---------------------------------------------------------------------------*/
+#endif /* COAP_WITH_QBLOCK */
+/** @} */
@@ -0,0 +1,169 @@
+/*
+ * Copyright (c) 2026, RISE Research Institutes of Sweden.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ *         Streaming block-wise transfers with the Q-Block1 and Q-Block2
+ *         options (RFC 9177).
+ */
+
+/**
+ * \addtogroup coap
+ * @{
+ */
+
+#ifndef COAP_QBLOCK_H_
+#define COAP_QBLOCK_H_
+
+#include "coap.h"
+#include "coap-timer.h"
+#include <stdint.h>
+
+/**
+ * \brief        Store a block of a body, e.g., in CFS or flash.
+ * \param user   The user data of the receiver.
+ * \param offset The offset of the block in the body.
+ * \param data   The block, in the buffer of the request.
+ * \param len    The length of the block.
+ * \return       Zero on success, or non-zero on failure.
+ */
+typedef int (*coap_qblock_write_t)(void *user, uint32_t offset,
+                                   const uint8_t *data, uint16_t len);
+
+/**
+ * \brief        Load a block of a body, e.g., from CFS or flash.
+ * \param user   The user data of the source.
+ * \param offset The offset of the block in the body.
+ * \param data   The buffer of the message to load the block into.
+ * \param len    The length of the block.
+ * \return       The number of bytes loaded, or -1 on failure.
+ */
+typedef int (*coap_qblock_read_t)(void *user, uint32_t offset,
+                                  uint8_t *data, uint16_t len);
+
+/* The state of a body received with Q-Block1 */
+typedef struct {
+  coap_endpoint_t endpoint;
+  uint32_t set_start;   /* the first block of the current set */
+  uint32_t received;    /* bitmap of the received blocks of the set */
+  uint32_t last;        /* the last block of the body, if known */
+  uint32_t length;      /* the length of the body, if known */
+  uint16_t size;
+  uint8_t active;
+  uint8_t last_known;
+} coap_qblock1_receiver_t;
+
+/* A body sent with Q-Block2 */
+typedef struct {
+  coap_qblock_read_t read;
+  void *user;
+  uint32_t length;
+  coap_content_format_t content_format;
+} coap_qblock2_source_t;
+
+/**
+ * \brief          Check a block of a body received with Q-Block1.
+ * \param receiver The state of the body.
+ * \param request  The request that carries the block.
+ * \return         1 if the block is new and must be stored, 0 if it
+ *                 must not be stored, or -1 if the request is invalid.
+ *
+ *                 A request for block 0 starts a new body. Blocks that
+ *                 were already received or that are beyond the current
+ *                 set are not stored; they are handled by
+ *                 coap_qblock1_respond().
+ */
+int coap_qblock1_accept(coap_qblock1_receiver_t *receiver,
+                        coap_message_t *request);
+
+/**
+ * \brief          Check if storing a block completes the body.
+ * \param receiver The state of the body.
+ * \param request  The request that carries the block.
+ * \return         Non-zero if the block is the last one missing.
+ */
+int coap_qblock1_is_final(const coap_qblock1_receiver_t *receiver,
+                          coap_message_t *request);
+
+/**
+ * \brief          Record a stored block and set up the response.
+ * \param receiver The state of the body.
+ * \param request  The request that carries the block.
+ * \param response The response to the request.
+ * \return         0 if the body is complete, 1 if more blocks will follow.
+ *
+ *                 The response is 2.31 (Continue) when a set is
+ *                 complete, 4.08 (Request Entity Incomplete) with the
+ *                 list of missing blocks when the last block of a set
+ *                 arrives before others, and no response at all to
+ *                 non-confirmable requests in between. When the body is
+ *                 complete, the response code set by the caller is kept.
+ */
+int coap_qblock1_respond(coap_qblock1_receiver_t *receiver,
+                         coap_message_t *request, coap_message_t *response);
+
+/**
+ * \brief          Q-Block1 support within a CoAP resource.
+ * \param receiver The state of the body.
+ * \param request  Request pointer from the handler.
+ * \param response Response pointer from the handler.
+ * \param write    The function that stores each new block.
+ * \param user     The user data passed to write.
+ * \return         0 if the body is complete, 1 if more blocks will
+ *                 follow, or -1 on failure.
+ */
+int coap_qblock1_handler(coap_qblock1_receiver_t *receiver,
+                         coap_message_t *request, coap_message_t *response,
+                         coap_qblock_write_t write, void *user);
+
+/**
+ * \brief          Q-Block2 support within a CoAP resource.
+ * \param source   The body to send.
+ * \param request  Request pointer from the handler.
+ * \param response Response pointer from the handler.
+ * \param buffer   Buffer pointer from the handler.
+ * \param preferred_size Preferred size from the handler.
+ * \param offset   Offset pointer from the handler.
+ *
+ *                 The requested block is loaded into the response. If
+ *                 the request carries Q-Block2 and asks for the first
+ *                 block of a set, the other blocks of the set are then
+ *                 sent without further requests. A request for any
+ *                 other block, e.g., a missing one, is answered with
+ *                 that block only. The sets of different transfers,
+ *                 told apart by the endpoint and token of the request,
+ *                 are sent concurrently.
+ */
+void coap_qblock2_handler(const coap_qblock2_source_t *source,
+                          coap_message_t *request, coap_message_t *response,
+                          uint8_t *buffer, uint16_t preferred_size,
+                          int32_t *offset);
+
+#endif /* COAP_QBLOCK_H_ */
+/** @} */
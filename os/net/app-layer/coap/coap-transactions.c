@@ -47,6 +47,7 @@
 #include "lib/memb.h"
 #include "lib/list.h"
 #include <stdlib.h>
+#include <string.h>
 
 /* Log configuration */
 #include "coap-log.h"
@@ -57,6 +58,134 @@
 MEMB(transactions_memb, coap_transaction_t, COAP_MAX_OPEN_TRANSACTIONS);
 LIST(transactions_list);
 
+#if COAP_CONGESTION_CONTROL
+/* CoCoA parameters, in milliseconds */
+#define COCOA_DEFAULT_RTO       2000
+#define COCOA_MIN_RTO            100
+#define COCOA_MAX_RTO          60000
+/* Bounds of the RTO that select a larger or smaller backoff factor */
+#define COCOA_SMALL_RTO         1000
+#define COCOA_LARGE_RTO         3000
+/* Weights of the RTT variance in the strong and weak estimators */
+#define COCOA_STRONG_K             4
+#define COCOA_WEAK_K               1
+
+typedef struct {
+  coap_rto_stats_t stats;
+  uint64_t last_used;
+  uint64_t last_update;
+  uint8_t used;
+} rto_estimate_t;
+
+static rto_estimate_t estimates[COAP_CC_ENDPOINTS];
+#endif /* COAP_CONGESTION_CONTROL */
+
+/*---------------------------------------------------------------------------*/
+#if COAP_CONGESTION_CONTROL
+static rto_estimate_t *
+find_estimate(const coap_endpoint_t *endpoint)
+{
+  for(int i = 0; i < COAP_CC_ENDPOINTS; i++) {
+    if(estimates[i].used
+       && coap_endpoint_cmp(&estimates[i].stats.endpoint, endpoint)) {
+      return &estimates[i];
+    }
+  }
+  return NULL;
+}
+/*---------------------------------------------------------------------------*/
+static rto_estimate_t *
+new_estimate(const coap_endpoint_t *endpoint, uint64_t now)
+{
+  rto_estimate_t *e = &estimates[0];
+
+  /* Reclaim the least recently used estimate if all are in use. */
+  for(int i = 0; i < COAP_CC_ENDPOINTS; i++) {
+    if(!estimates[i].used) {
+      e = &estimates[i];
+      break;
+    }
+    if(estimates[i].last_used < e->last_used) {
+      e = &estimates[i];
+    }
+  }
+
+  memset(e, 0, sizeof(*e));
+  coap_endpoint_copy(&e->stats.endpoint, endpoint);
+  e->stats.rto = COCOA_DEFAULT_RTO;
+  e->last_update = now;
+  e->used = 1;
+  return e;
+}
+/*---------------------------------------------------------------------------*/
+/*
+ * Let an RTO that has not been updated for a while return towards the
+ * default, as it may no longer reflect the path to the endpoint.
+ */
+static void
+age_estimate(rto_estimate_t *e, uint64_t now)
+{
+  uint64_t idle = now - e->last_update;
+
+  if(e->stats.rto < COCOA_SMALL_RTO && idle > 16 * (uint64_t)e->stats.rto) {
+    e->stats.rto *= 2;
+    e->last_update = now;
+  } else if(e->stats.rto > COCOA_LARGE_RTO
+            && idle > 4 * (uint64_t)e->stats.rto) {
+    e->stats.rto = (COCOA_DEFAULT_RTO + e->stats.rto) / 2;
+    e->last_update = now;
+  }
+}
+/*---------------------------------------------------------------------------*/
+/* Update an RTT estimator as in RFC 6298 and return its RTO estimate. */
+static uint32_t
+update_estimator(uint32_t *srtt, uint32_t *rttvar, uint16_t *samples,
+                 uint32_t rtt, uint32_t k)
+{
+  uint32_t delta;
+
+  if(*samples == 0) {
+    *srtt = rtt;
+    *rttvar = rtt / 2;
+  } else {
+    delta = *srtt > rtt ? *srtt - rtt : rtt - *srtt;
+    *rttvar = (3 * *rttvar + delta) / 4;
+    *srtt = (7 * *srtt + rtt) / 8;
+  }
+  if(*samples < UINT16_MAX) {
+    (*samples)++;
+  }
+  return *srtt + k * *rttvar;
+}
+/*---------------------------------------------------------------------------*/
+static uint32_t
+initial_interval(coap_transaction_t *t)
+{
+  uint64_t now = coap_timer_uptime();
+  rto_estimate_t *e = find_estimate(&t->endpoint);
+  uint32_t rto;
+
+  if(e == NULL) {
+    e = new_estimate(&t->endpoint, now);
+  } else {
+    age_estimate(e, now);
+  }
+  e->last_used = now;
+  rto = e->stats.rto;
+
+  /* Variable backoff: back off faster from small RTOs than large ones. */
+  if(rto < COCOA_SMALL_RTO) {
+    t->backoff_factor = 6;
+  } else if(rto > COCOA_LARGE_RTO) {
+    t->backoff_factor = 3;
+  } else {
+    t->backoff_factor = 4;
+  }
+  t->start_time = now;
+
+  return rto + (rand() % (rto / 2 + 1));
+}
+#endif /* COAP_CONGESTION_CONTROL */
 /*---------------------------------------------------------------------------*/
 static void
 coap_retransmit_transaction(coap_timer_t *nt)
@@ -108,15 +237,30 @@ coap_send_transaction(coap_transaction_t *t)
       if(t->retrans_counter == 0) {
         coap_timer_set_callback(&t->retrans_timer, coap_retransmit_transaction);
         coap_timer_set_user_data(&t->retrans_timer, t);
+#if COAP_CONGESTION_CONTROL
+        t->retrans_interval = initial_interval(t);
+#else /* COAP_CONGESTION_CONTROL */
         t->retrans_interval =
           COAP_RESPONSE_TIMEOUT_TICKS + (rand() %
                                          COAP_RESPONSE_TIMEOUT_BACKOFF_MASK);
+#endif /* COAP_CONGESTION_CONTROL */
         LOG_DBG("Initial interval %lu msec\n",
                 (unsigned long)t->retrans_interval);
       } else {
+#if COAP_CONGESTION_CONTROL
+        rto_estimate_t *e = find_estimate(&t->endpoint);
+        if(e != NULL && e->stats.retransmissions < UINT16_MAX) {
+          e->stats.retransmissions++;
+        }
+        t->retrans_interval = MIN(t->retrans_interval * t->backoff_factor / 2,
+                                  COCOA_MAX_RTO);
+        LOG_DBG("Backed off (%u) interval %lu msec\n", t->retrans_counter,
+                (unsigned long)t->retrans_interval);
+#else /* COAP_CONGESTION_CONTROL */
         t->retrans_interval <<= 1;  /* double */
         LOG_DBG("Doubled (%u) interval %lu s\n", t->retrans_counter,
                 (unsigned long)(t->retrans_interval / 1000));
+#endif /* COAP_CONGESTION_CONTROL */
       }
 
       /* interval updated above */
@@ -127,6 +271,13 @@ coap_send_transaction(coap_transaction_t *t)
       coap_resource_response_handler_t callback = t->callback;
       void *callback_data = t->callback_data;
 
+#if COAP_CONGESTION_CONTROL
+      rto_estimate_t *e = find_estimate(&t->endpoint);
+      if(e != NULL && e->stats.timeouts < UINT16_MAX) {
+        e->stats.timeouts++;
+      }
+#endif /* COAP_CONGESTION_CONTROL */
+
       /* handle observers */
       coap_remove_observer_by_client(&t->endpoint);
 
@@ -168,4 +319,51 @@ coap_get_transaction_by_mid(uint16_t mid)
   return NULL;
 }
 /*---------------------------------------------------------------------------*/
+#if COAP_CONGESTION_CONTROL
+void
+coap_transaction_acknowledged(coap_transaction_t *t)
+{
+  rto_estimate_t *e;
+  uint64_t now;
+  uint32_t rtt;
+  uint32_t estimate;
+
+  /* RTTs measured after more than two retransmissions are too ambiguous. */
+  if(t->retrans_counter > 2 || (e = find_estimate(&t->endpoint)) == NULL) {
+    return;
+  }
+
+  now = coap_timer_uptime();
+  rtt = (uint32_t)MIN(now - t->start_time, COCOA_MAX_RTO);
+
+  if(t->retrans_counter == 0) {
+    /* Strong RTT: the acknowledged transmission is known. */
+    estimate = update_estimator(&e->stats.strong_srtt, &e->stats.strong_rttvar,
+                                &e->stats.strong_samples, rtt, COCOA_STRONG_K);
+    e->stats.rto = (estimate + e->stats.rto) / 2;
+  } else {
+    /* Weak RTT: measured from the first transmission. */
+    estimate = update_estimator(&e->stats.weak_srtt, &e->stats.weak_rttvar,
+                                &e->stats.weak_samples, rtt, COCOA_WEAK_K);
+    e->stats.rto = (estimate + 3 * e->stats.rto) / 4;
+  }
+  e->stats.rto = MAX(MIN(e->stats.rto, COCOA_MAX_RTO), COCOA_MIN_RTO);
+  e->last_update = now;
+
+  LOG_DBG("RTT %lu msec (%s), RTO %lu msec\n", (unsigned long)rtt,
+          t->retrans_counter == 0 ? "strong" : "weak",
+          (unsigned long)e->stats.rto);
+}
+/*---------------------------------------------------------------------------*/
+int
+coap_transactions_rto_stats(unsigned index, coap_rto_stats_t *stats)
+{
+  if(index >= COAP_CC_ENDPOINTS || !estimates[index].used) {
+    return 0;
+  }
+  *stats = estimates[index].stats;
+  return 1;
+}
+#endif /* COAP_CONGESTION_CONTROL */
+/*---------------------------------------------------------------------------*/
 /** @} */
@@ -63,6 +63,10 @@ typedef struct coap_transaction {
   coap_timer_t retrans_timer;
   uint32_t retrans_interval;
   uint8_t retrans_counter;
+#if COAP_CONGESTION_CONTROL
+  uint8_t backoff_factor;               /* in halves */
+  uint64_t start_time;
+#endif /* COAP_CONGESTION_CONTROL */
 
   coap_endpoint_t endpoint;
 
@@ -79,5 +83,36 @@ void coap_send_transaction(coap_transaction_t *t);
 void coap_clear_transaction(coap_transaction_t *t);
 coap_transaction_t *coap_get_transaction_by_mid(uint16_t mid);
 
+#if COAP_CONGESTION_CONTROL
+/* Round-trip time estimates kept for an endpoint, in milliseconds */
+typedef struct {
+  coap_endpoint_t endpoint;
+  uint32_t rto;
+  uint32_t strong_srtt;
+  uint32_t strong_rttvar;
+  uint32_t weak_srtt;
+  uint32_t weak_rttvar;
+  uint16_t strong_samples;
+  uint16_t weak_samples;
+  uint16_t retransmissions;
+  uint16_t timeouts;
+} coap_rto_stats_t;
+
+/**
+ * \brief      Update the round-trip time estimates of the endpoint of
+ *             a transaction that has been acknowledged.
+ * \param t    The acknowledged transaction.
+ */
+void coap_transaction_acknowledged(coap_transaction_t *t);
+
+/**
+ * \brief       Get the round-trip time estimates kept for an endpoint.
+ * \param index The index of the estimate, from 0 to COAP_CC_ENDPOINTS - 1.
+ * \param stats A pointer to the structure to fill in.
+ * \return      Non-zero if an endpoint is kept at this index, zero otherwise.
+ */
+int coap_transactions_rto_stats(unsigned index, coap_rto_stats_t *stats);
+#endif /* COAP_CONGESTION_CONTROL */
+
 #endif /* COAP_TRANSACTIONS_H_ */
 /** @} */
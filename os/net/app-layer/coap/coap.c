@@ -372,11 +372,17 @@ coap_serialize_message(coap_message_t *coap_pkt, uint8_t *buffer)
   COAP_SERIALIZE_STRING_OPTION(COAP_OPTION_URI_QUERY, uri_query, '&',
                                "Uri-Query");
   COAP_SERIALIZE_INT_OPTION(COAP_OPTION_ACCEPT, accept, "Accept");
+#if COAP_WITH_QBLOCK
+  COAP_SERIALIZE_BLOCK_OPTION(COAP_OPTION_Q_BLOCK1, block1, "Q-Block1");
+#endif /* COAP_WITH_QBLOCK */
   COAP_SERIALIZE_STRING_OPTION(COAP_OPTION_LOCATION_QUERY, location_query,
                                '&', "Location-Query");
   COAP_SERIALIZE_BLOCK_OPTION(COAP_OPTION_BLOCK2, block2, "Block2");
   COAP_SERIALIZE_BLOCK_OPTION(COAP_OPTION_BLOCK1, block1, "Block1");
   COAP_SERIALIZE_INT_OPTION(COAP_OPTION_SIZE2, size2, "Size2");
+#if COAP_WITH_QBLOCK
+  COAP_SERIALIZE_BLOCK_OPTION(COAP_OPTION_Q_BLOCK2, block2, "Q-Block2");
+#endif /* COAP_WITH_QBLOCK */
   COAP_SERIALIZE_STRING_OPTION(COAP_OPTION_PROXY_URI, proxy_uri, '\0',
                                "Proxy-Uri");
   COAP_SERIALIZE_STRING_OPTION(COAP_OPTION_PROXY_SCHEME, proxy_scheme, '\0',
@@ -674,6 +680,9 @@ coap_parse_message(coap_message_t *coap_pkt, uint8_t *data, uint16_t data_len)
                                                 option_length);
       LOG_DBG_("Observe [%"PRId32"]\n", coap_pkt->observe);
       break;
+#if COAP_WITH_QBLOCK
+    case COAP_OPTION_Q_BLOCK2:
+#endif /* COAP_WITH_QBLOCK */
     case COAP_OPTION_BLOCK2:
       coap_pkt->block2_num = coap_parse_int_option(current_option,
                                                    option_length);
@@ -686,6 +695,9 @@ coap_parse_message(coap_message_t *coap_pkt, uint8_t *data, uint16_t data_len)
                (unsigned long)coap_pkt->block2_num,
                coap_pkt->block2_more ? "+" : "", coap_pkt->block2_size);
       break;
+#if COAP_WITH_QBLOCK
+    case COAP_OPTION_Q_BLOCK1:
+#endif /* COAP_WITH_QBLOCK */
     case COAP_OPTION_BLOCK1:
       coap_pkt->block1_num = coap_parse_int_option(current_option,
                                                    option_length);
@@ -1112,6 +1124,76 @@ coap_set_header_block1(coap_message_t *coap_pkt, uint32_t num, uint8_t more,
   return 1;
 }
 /*---------------------------------------------------------------------------*/
+#if COAP_WITH_QBLOCK
+int
+coap_get_header_q_block2(coap_message_t *coap_pkt, uint32_t *num,
+                         uint8_t *more, uint16_t *size, uint32_t *offset)
+{
+  if(!coap_is_option(coap_pkt, COAP_OPTION_Q_BLOCK2)) {
+    return 0;
+  }
+  /* Q-Block2 shares the parsed fields of Block2 */
+  if(num != NULL) {
+    *num = coap_pkt->block2_num;
+  }
+  if(more != NULL) {
+    *more = coap_pkt->block2_more;
+  }
+  if(size != NULL) {
+    *size = coap_pkt->block2_size;
+  }
+  if(offset != NULL) {
+    *offset = coap_pkt->block2_offset;
+  }
+  return 1;
+}
+int
+coap_set_header_q_block2(coap_message_t *coap_pkt, uint32_t num, uint8_t more,
+                         uint16_t size)
+{
+  if(!coap_set_header_block2(coap_pkt, num, more, size)) {
+    return 0;
+  }
+  coap_clear_option(coap_pkt, COAP_OPTION_BLOCK2);
+  coap_set_option(coap_pkt, COAP_OPTION_Q_BLOCK2);
+  return 1;
+}
+/*---------------------------------------------------------------------------*/
+int
+coap_get_header_q_block1(coap_message_t *coap_pkt, uint32_t *num,
+                         uint8_t *more, uint16_t *size, uint32_t *offset)
+{
+  if(!coap_is_option(coap_pkt, COAP_OPTION_Q_BLOCK1)) {
+    return 0;
+  }
+  /* Q-Block1 shares the parsed fields of Block1 */
+  if(num != NULL) {
+    *num = coap_pkt->block1_num;
+  }
+  if(more != NULL) {
+    *more = coap_pkt->block1_more;
+  }
+  if(size != NULL) {
+    *size = coap_pkt->block1_size;
+  }
+  if(offset != NULL) {
+    *offset = coap_pkt->block1_offset;
+  }
+  return 1;
+}
+int
+coap_set_header_q_block1(coap_message_t *coap_pkt, uint32_t num, uint8_t more,
+                         uint16_t size)
+{
+  if(!coap_set_header_block1(coap_pkt, num, more, size)) {
+    return 0;
+  }
+  coap_clear_option(coap_pkt, COAP_OPTION_BLOCK1);
+  coap_set_option(coap_pkt, COAP_OPTION_Q_BLOCK1);
+  return 1;
+}
+#endif /* COAP_WITH_QBLOCK */
+/*---------------------------------------------------------------------------*/
 int
 coap_get_header_size2(coap_message_t *coap_pkt, uint32_t *size)
 {
@@ -138,6 +138,14 @@ coap_set_option(coap_message_t *message, unsigned int opt)
   return 1;
 }
 
+static inline void
+coap_clear_option(coap_message_t *message, unsigned int opt)
+{
+  if(opt <= COAP_OPTION_SIZE1) {
+    message->options[opt / COAP_OPTION_MAP_SIZE] &= ~(1 << (opt % COAP_OPTION_MAP_SIZE));
+  }
+}
+
 static inline int
 coap_is_option(const coap_message_t *message, unsigned int opt)
 {
@@ -290,6 +298,19 @@ int coap_get_header_block1(coap_message_t *message, uint32_t *num, uint8_t *more
 int coap_set_header_block1(coap_message_t *message, uint32_t num, uint8_t more,
                            uint16_t size);
 
+#if COAP_WITH_QBLOCK
+/* Q-Block1 and Q-Block2 (RFC 9177) share the fields of Block1 and Block2 */
+int coap_get_header_q_block2(coap_message_t *message, uint32_t *num,
+                             uint8_t *more, uint16_t *size, uint32_t *offset);
+int coap_set_header_q_block2(coap_message_t *message, uint32_t num,
+                             uint8_t more, uint16_t size);
+
+int coap_get_header_q_block1(coap_message_t *message, uint32_t *num,
+                             uint8_t *more, uint16_t *size, uint32_t *offset);
+int coap_set_header_q_block1(coap_message_t *message, uint32_t num,
+                             uint8_t more, uint16_t size);
+#endif /* COAP_WITH_QBLOCK */
+
 int coap_get_header_size2(coap_message_t *message, uint32_t *size);
 int coap_set_header_size2(coap_message_t *message, uint32_t size);
 
@@ -152,7 +152,9 @@ typedef struct seed_id_s {
 struct mpl_msg {
   struct mpl_msg *next; /* Next message in the set, or NULL if this is largest */
   struct mpl_seed *seed; /* The seed set this message belongs to */
+#if !MPL_WITH_SEED_WINDOWS
   struct trickle_timer tt; /* The trickle timer associated with this msg */
+#endif
   uip_ip6addr_t srcipaddr; /* The original ip this message was sent from */
   uint16_t size; /* Side of the data stored above */
   uint8_t seq; /* The sequence number of the message */
@@ -202,12 +204,19 @@ struct mpl_msg {
 /*---------------------------------------------------------------------------*/
 /* Seed Set */
 struct mpl_seed {
+#if MPL_WITH_SEED_WINDOWS
+  struct mpl_seed *next; /* Next seed in least recently active order */
+#endif
   seed_id_t seed_id;
   uint8_t min_seqno; /* Used when the seed set is empty */
   uint8_t lifetime; /* Decrements by one every minute */
   uint8_t count; /* Only used for determining largest msg set during reclaim */
   LIST_STRUCT(min_seq); /* Pointer to the first msg in this seed's set */
   struct mpl_domain *domain; /* The domain this seed belongs to */
+#if MPL_WITH_SEED_WINDOWS
+  uint32_t window; /* Bit n is set if seq min_seqno + n is buffered */
+  struct trickle_timer tt; /* The trickle timer shared by all msgs */
+#endif
 };
 /**
  * \brief Get the state of the used flag in the buffered message set entry
@@ -405,6 +414,10 @@ static seed_id_t local_seed_id;
 static uip_ip6addr_t all_forwarders;
 #endif
 static struct ctimer lifetime_timer;
+#if MPL_WITH_SEED_WINDOWS
+/* Seeds in use, from the least to the most recently active */
+LIST(seed_lru);
+#endif
 /*---------------------------------------------------------------------------*/
 /* Temporary Stores */
 /*---------------------------------------------------------------------------*/
@@ -443,6 +456,41 @@ extern uint16_t uip_slen;
  * t: Pointer to set that should be reset
  */
 #define mpl_trickle_timer_reset(t) { (t)->e = 0; trickle_timer_reset_event(&(t)->tt); }
+#if MPL_WITH_SEED_WINDOWS
+/* Number of sequence numbers spanned by a seed window */
+#define MPL_SEED_WINDOW_SIZE 32
+/**
+ * \brief Check whether a message is still being forwarded by its seed's timer
+ * m: Pointer to the message
+ */
+#define msg_timer_is_running(m) ((m)->e <= MPL_DATA_MESSAGE_TIMER_EXPIRATIONS)
+/**
+ * \brief Stop forwarding a message
+ * m: Pointer to the message
+ */
+#define msg_timer_stop(m) ((m)->e = MPL_DATA_MESSAGE_TIMER_EXPIRATIONS + 1)
+/**
+ * \brief Start forwarding a message with its seed's timer
+ * m: Pointer to the message
+ */
+#define msg_timer_start(m) seed_timer_start(m)
+/**
+ * \brief Call inconsistency on the timer forwarding a message
+ * m: Pointer to the message
+ */
+#define msg_timer_inconsistency(m) seed_timer_inconsistency(m)
+/**
+ * \brief Call consistency on the timer forwarding a message
+ * m: Pointer to the message
+ */
+#define msg_timer_consistency(m) trickle_timer_consistency(&(m)->seed->tt)
+#else /* MPL_WITH_SEED_WINDOWS */
+#define msg_timer_is_running(m) trickle_timer_is_running(&(m)->tt)
+#define msg_timer_stop(m) trickle_timer_stop(&(m)->tt)
+#define msg_timer_start(m) mpl_data_trickle_timer_start(m)
+#define msg_timer_inconsistency(m) mpl_trickle_timer_inconsistency(m)
+#define msg_timer_consistency(m) trickle_timer_consistency(&(m)->tt)
+#endif /* MPL_WITH_SEED_WINDOWS */
 /**
  * \brief Set a single bit within a bit vector that spans multiple bytes
  * v: The bit vector
@@ -480,11 +528,85 @@ buffer_allocate(void)
 static void
 buffer_free(struct mpl_msg *msg)
 {
-  if(trickle_timer_is_running(&msg->tt)) {
-    trickle_timer_stop(&msg->tt);
+  if(msg_timer_is_running(msg)) {
+    msg_timer_stop(msg);
   }
   MSG_SET_CLEAR_USED(msg);
 }
+#if MPL_WITH_SEED_WINDOWS
+static void seed_message_expiration(void *ptr, uint8_t suppress);
+static void
+seed_timer_start(struct mpl_msg *msg)
+{
+  /* The timer keeps running as long as one message is being forwarded */
+  msg->e = 0;
+  if(!trickle_timer_is_running(&msg->seed->tt)) {
+    trickle_timer_set(&msg->seed->tt, seed_message_expiration, msg->seed);
+  }
+}
+static void
+seed_timer_inconsistency(struct mpl_msg *msg)
+{
+  seed_timer_start(msg);
+  trickle_timer_inconsistency(&msg->seed->tt);
+}
+/* Remove the oldest message of a seed and slide its window forward */
+static struct mpl_msg *
+seed_window_pop(struct mpl_seed *seed)
+{
+  struct mpl_msg *msg;
+  struct mpl_msg *next;
+
+  msg = list_pop(seed->min_seq);
+  if(msg == NULL) {
+    return NULL;
+  }
+  next = list_head(seed->min_seq);
+  if(next == NULL) {
+    /* Anything up to this message is now too old */
+    seed->min_seqno = SEQ_VAL_ADD(msg->seq, 1);
+    seed->window = 0;
+  } else {
+    seed->window >>= (uint8_t)(next->seq - seed->min_seqno);
+    seed->min_seqno = next->seq;
+  }
+  seed->count--;
+  return msg;
+}
+static struct mpl_msg *
+buffer_reclaim(void)
+{
+  static struct mpl_seed *ssptr; /* Can't use locssptr since it's used by calling function */
+  static struct mpl_seed *victim;
+  static struct mpl_msg *reclaim;
+
+  /**
+   * Reclaim the oldest message of the least recently active seed. Seeds whose
+   *   oldest message is no longer being forwarded are preferred, since their
+   *   neighbours are most likely to have it already.
+   */
+  victim = NULL;
+  for(ssptr = list_head(seed_lru); ssptr != NULL; ssptr = list_item_next(ssptr)) {
+    reclaim = list_head(ssptr->min_seq);
+    if(reclaim != NULL) {
+      if(!msg_timer_is_running(reclaim)) {
+        victim = ssptr;
+        break;
+      }
+      if(victim == NULL) {
+        victim = ssptr;
+      }
+    }
+  }
+  reclaim = NULL;
+  if(victim != NULL) {
+    reclaim = seed_window_pop(victim);
+    mpl_trickle_timer_reset(victim->domain);
+    memset(reclaim, 0, sizeof(struct mpl_msg));
+  }
+  return reclaim;
+}
+#else /* MPL_WITH_SEED_WINDOWS */
 static struct mpl_msg *
 buffer_reclaim(void)
 {
@@ -518,6 +640,7 @@ buffer_reclaim(void)
   }
   return reclaim;
 }
+#endif /* MPL_WITH_SEED_WINDOWS */
 static struct mpl_domain *
 domain_set_allocate(uip_ip6addr_t *address)
 {
@@ -598,6 +721,12 @@ seed_set_free(struct mpl_seed *s)
   while((locmmptr = list_pop(s->min_seq)) != NULL) {
     buffer_free(locmmptr);
   }
+#if MPL_WITH_SEED_WINDOWS
+  if(trickle_timer_is_running(&s->tt)) {
+    trickle_timer_stop(&s->tt);
+  }
+  list_remove(seed_lru, s);
+#endif
   SEED_SET_CLEAR_USED(s);
 }
 static struct mpl_domain *
@@ -759,7 +888,11 @@ icmp_out(struct mpl_domain *dom)
   uint8_t vector[32];
   uint8_t vec_size;
   uint8_t vec_len;
+#if MPL_WITH_SEED_WINDOWS
+  uint8_t i;
+#else
   uint8_t cur_seq;
+#endif
   uint16_t payload_len;
   uip_ds6_addr_t *addr;
   size_t seed_info_len;
@@ -825,10 +958,19 @@ icmp_out(struct mpl_domain *dom)
       /* Populate the seed info message vector */
       memset(vector, 0, sizeof(vector));
       vec_len = 0;
-      cur_seq = 0;
       LOG_INFO("\nBuffer for seed: ");
       LOG_INFO_SEED(locssptr->seed_id);
       LOG_INFO_("\n");
+#if MPL_WITH_SEED_WINDOWS
+      /* The window already is the vector, relative to min_seqno */
+      for(i = 0; i < MPL_SEED_WINDOW_SIZE; i++) {
+        if(locssptr->window & ((uint32_t)1 << i)) {
+          BIT_VECTOR_SET_BIT(vector, i);
+          vec_len = i + 1;
+        }
+      }
+#else /* MPL_WITH_SEED_WINDOWS */
+      cur_seq = 0;
       for(locmmptr = list_head(locssptr->min_seq); locmmptr != NULL; locmmptr = list_item_next(locmmptr)) {
         LOG_INFO("%d -- %x\n", locmmptr->seq, locmmptr->data[locmmptr->size - 1]);
         cur_seq = SEQ_VAL_ADD(locssptr->min_seqno, vec_len);
@@ -842,6 +984,7 @@ icmp_out(struct mpl_domain *dom)
           vec_len++;
         }
       }
+#endif /* MPL_WITH_SEED_WINDOWS */
 
       /* Convert vector length from bits to bytes */
       vec_size = (vec_len - 1) / 8 + 1;
@@ -902,6 +1045,109 @@ icmp_out(struct mpl_domain *dom)
   return;
 }
 static void
+data_message_out(void)
+{
+  /* Transmit the buffered message pointed to by locmmptr */
+  LOG_DBG("Data message TX\n");
+  LOG_DBG("Seed ID=");
+  LOG_DBG_SEED(locmmptr->seed->seed_id);
+  LOG_DBG_(", S=%u, Seq=%u\n", locmmptr->seed->seed_id.s, locmmptr->seq);
+  /* Setup the IP Header */
+  UIP_IP_BUF->vtc = 0x60;
+  UIP_IP_BUF->tcflow = 0;
+  UIP_IP_BUF->flow = 0;
+  UIP_IP_BUF->proto = UIP_PROTO_HBHO;
+  /*UIP_IP_BUF->ttl = MPL_IP_HOP_LIMIT; */
+  uip_ip6addr_copy(&UIP_IP_BUF->destipaddr, &locmmptr->seed->domain->data_addr);
+  uip_len = UIP_IPH_LEN;
+  /* Setup the HBHO Header */
+  UIP_EXT_BUF->next = UIP_PROTO_UDP;
+  lochbhmptr = UIP_EXT_OPT_FIRST;
+  lochbhmptr->type = HBHO_OPT_TYPE_MPL;
+  lochbhmptr->flags = 0x00;
+  switch(locmmptr->seed->seed_id.s) {
+  case 0:
+    UIP_EXT_BUF->len = HBHO_S0_LEN / 8;
+    lochbhmptr->len = MPL_OPT_LEN_S0;
+    HBH_CLR_S(lochbhmptr);
+    HBH_SET_S(lochbhmptr, 0);
+    uip_len += HBHO_BASE_LEN + HBHO_S0_LEN;
+    uip_ext_len += HBHO_BASE_LEN + HBHO_S0_LEN;
+    lochbhmptr->padn.opt_type = UIP_EXT_HDR_OPT_PADN;
+    lochbhmptr->padn.opt_len = 0x00;
+    break;
+  case 1:
+    UIP_EXT_BUF->len = HBHO_S1_LEN / 8;
+    lochbhmptr->len = MPL_OPT_LEN_S1;
+    HBH_CLR_S(lochbhmptr);
+    HBH_SET_S(lochbhmptr, 1);
+    seed_id_host_to_net(&((struct mpl_hbho_s1 *)lochbhmptr)->seed_id, &locmmptr->seed->seed_id);
+    uip_len += HBHO_BASE_LEN + HBHO_S1_LEN;
+    uip_ext_len += HBHO_BASE_LEN + HBHO_S1_LEN;
+    break;
+  case 2:
+    UIP_EXT_BUF->len = HBHO_S2_LEN / 8;
+    lochbhmptr->len = MPL_OPT_LEN_S2;
+    HBH_CLR_S(lochbhmptr);
+    HBH_SET_S(lochbhmptr, 2);
+    seed_id_host_to_net(&((struct mpl_hbho_s2 *)lochbhmptr)->seed_id, &locmmptr->seed->seed_id);
+    uip_len += HBHO_BASE_LEN + HBHO_S2_LEN;
+    uip_ext_len += HBHO_BASE_LEN + HBHO_S2_LEN;
+    ((struct mpl_hbho_s2 *)lochbhmptr)->padn.opt_type = UIP_EXT_HDR_OPT_PADN;
+    ((struct mpl_hbho_s2 *)lochbhmptr)->padn.opt_len = 0x00;
+    break;
+  case 3:
+    UIP_EXT_BUF->len = HBHO_S3_LEN / 8;
+    lochbhmptr->len = MPL_OPT_LEN_S3;
+    HBH_CLR_S(lochbhmptr);
+    HBH_SET_S(lochbhmptr, 3);
+    seed_id_host_to_net(&((struct mpl_hbho_s3 *)lochbhmptr)->seed_id, &locmmptr->seed->seed_id);
+    uip_len += HBHO_BASE_LEN + HBHO_S3_LEN;
+    uip_ext_len += HBHO_BASE_LEN + HBHO_S3_LEN;
+    ((struct mpl_hbho_s3 *)lochbhmptr)->padn.opt_type = UIP_EXT_HDR_OPT_PADN;
+    ((struct mpl_hbho_s3 *)lochbhmptr)->padn.opt_len = 0x00;
+    break;
+  }
+  lochbhmptr->seq = locmmptr->seq;
+  if(list_item_next(locmmptr) == NULL) {
+    HBH_SET_M(lochbhmptr);
+  }
+  /* Now insert payload */
+  memcpy(((void *)UIP_EXT_BUF) + 8 + UIP_EXT_BUF->len * 8, &locmmptr->data, locmmptr->size);
+  uip_len += locmmptr->size;
+  uipbuf_set_len_field(UIP_IP_BUF, uip_len - UIP_IPH_LEN);
+  uip_ip6addr_copy(&UIP_IP_BUF->srcipaddr, &locmmptr->srcipaddr);
+  tcpip_output(NULL);
+  uipbuf_clear();
+  UIP_MCAST6_STATS_ADD(mcast_out);
+}
+#if MPL_WITH_SEED_WINDOWS
+static void
+seed_message_expiration(void *ptr, uint8_t suppress)
+{
+  static struct mpl_seed *seed;
+  static uint8_t running;
+
+  /* Callback for the trickle timer shared by the messages of a seed */
+  seed = ((struct mpl_seed *)ptr);
+  running = 0;
+  for(locmmptr = list_head(seed->min_seq); locmmptr != NULL; locmmptr = list_item_next(locmmptr)) {
+    if(!msg_timer_is_running(locmmptr)) {
+      continue;
+    }
+    running = 1;
+    if(suppress == TRICKLE_TIMER_TX_OK) { /* Only transmit if not suppressed */
+      data_message_out();
+    }
+    locmmptr->e++;
+  }
+  if(!running) {
+    /* Every message has expired enough times */
+    trickle_timer_stop(&seed->tt);
+  }
+}
+#else /* MPL_WITH_SEED_WINDOWS */
+static void
 data_message_expiration(void *ptr, uint8_t suppress)
 {
   /* Callback for data message trickle timers */
@@ -912,82 +1158,12 @@ data_message_expiration(void *ptr, uint8_t suppress)
     return;
   }
   if(suppress == TRICKLE_TIMER_TX_OK) { /* Only transmit if not suppressed */
-    LOG_DBG("Data message TX\n");
-    LOG_DBG("Seed ID=");
-    LOG_DBG_SEED(locmmptr->seed->seed_id);
-    LOG_DBG_(", S=%u, Seq=%u\n", locmmptr->seed->seed_id.s, locmmptr->seq);
-    /* Setup the IP Header */
-    UIP_IP_BUF->vtc = 0x60;
-    UIP_IP_BUF->tcflow = 0;
-    UIP_IP_BUF->flow = 0;
-    UIP_IP_BUF->proto = UIP_PROTO_HBHO;
-    /*UIP_IP_BUF->ttl = MPL_IP_HOP_LIMIT; */
-    uip_ip6addr_copy(&UIP_IP_BUF->destipaddr, &locmmptr->seed->domain->data_addr);
-    uip_len = UIP_IPH_LEN;
-    /* Setup the HBHO Header */
-    UIP_EXT_BUF->next = UIP_PROTO_UDP;
-    lochbhmptr = UIP_EXT_OPT_FIRST;
-    lochbhmptr->type = HBHO_OPT_TYPE_MPL;
-    lochbhmptr->flags = 0x00;
-    switch(locmmptr->seed->seed_id.s) {
-    case 0:
-      UIP_EXT_BUF->len = HBHO_S0_LEN / 8;
-      lochbhmptr->len = MPL_OPT_LEN_S0;
-      HBH_CLR_S(lochbhmptr);
-      HBH_SET_S(lochbhmptr, 0);
-      uip_len += HBHO_BASE_LEN + HBHO_S0_LEN;
-      uip_ext_len += HBHO_BASE_LEN + HBHO_S0_LEN;
-      lochbhmptr->padn.opt_type = UIP_EXT_HDR_OPT_PADN;
-      lochbhmptr->padn.opt_len = 0x00;
-      break;
-    case 1:
-      UIP_EXT_BUF->len = HBHO_S1_LEN / 8;
-      lochbhmptr->len = MPL_OPT_LEN_S1;
-      HBH_CLR_S(lochbhmptr);
-      HBH_SET_S(lochbhmptr, 1);
-      seed_id_host_to_net(&((struct mpl_hbho_s1 *)lochbhmptr)->seed_id, &locmmptr->seed->seed_id);
-      uip_len += HBHO_BASE_LEN + HBHO_S1_LEN;
-      uip_ext_len += HBHO_BASE_LEN + HBHO_S1_LEN;
-      break;
-    case 2:
-      UIP_EXT_BUF->len = HBHO_S2_LEN / 8;
-      lochbhmptr->len = MPL_OPT_LEN_S2;
-      HBH_CLR_S(lochbhmptr);
-      HBH_SET_S(lochbhmptr, 2);
-      seed_id_host_to_net(&((struct mpl_hbho_s2 *)lochbhmptr)->seed_id, &locmmptr->seed->seed_id);
-      uip_len += HBHO_BASE_LEN + HBHO_S2_LEN;
-      uip_ext_len += HBHO_BASE_LEN + HBHO_S2_LEN;
-      ((struct mpl_hbho_s2 *)lochbhmptr)->padn.opt_type = UIP_EXT_HDR_OPT_PADN;
-      ((struct mpl_hbho_s2 *)lochbhmptr)->padn.opt_len = 0x00;
-      break;
-    case 3:
-      UIP_EXT_BUF->len = HBHO_S3_LEN / 8;
-      lochbhmptr->len = MPL_OPT_LEN_S3;
-      HBH_CLR_S(lochbhmptr);
-      HBH_SET_S(lochbhmptr, 3);
-      seed_id_host_to_net(&((struct mpl_hbho_s3 *)lochbhmptr)->seed_id, &locmmptr->seed->seed_id);
-      uip_len += HBHO_BASE_LEN + HBHO_S3_LEN;
-      uip_ext_len += HBHO_BASE_LEN + HBHO_S3_LEN;
-      ((struct mpl_hbho_s3 *)lochbhmptr)->padn.opt_type = UIP_EXT_HDR_OPT_PADN;
-      ((struct mpl_hbho_s3 *)lochbhmptr)->padn.opt_len = 0x00;
-      break;
-    }
-    lochbhmptr->seq = locmmptr->seq;
-    if(list_item_next(locmmptr) == NULL) {
-      HBH_SET_M(lochbhmptr);
-    }
-    /* Now insert payload */
-    memcpy(((void *)UIP_EXT_BUF) + 8 + UIP_EXT_BUF->len * 8, &locmmptr->data, locmmptr->size);
-    uip_len += locmmptr->size;
-    uipbuf_set_len_field(UIP_IP_BUF, uip_len - UIP_IPH_LEN);
-    uip_ip6addr_copy(&UIP_IP_BUF->srcipaddr, &locmmptr->srcipaddr);
-    tcpip_output(NULL);
-    uipbuf_clear();
-    UIP_MCAST6_STATS_ADD(mcast_out);
+    data_message_out();
   }
 
   locmmptr->e++;
 }
+#endif /* MPL_WITH_SEED_WINDOWS */
 static void
 control_message_expiration(void *ptr, uint8_t suppress)
 {
@@ -1038,7 +1214,7 @@ lifetime_timer_expiration(void *ptr)
       /* Check no timers are running */
       locmmptr = list_head(locssptr->min_seq);
       while(locmmptr != NULL) {
-        if(trickle_timer_is_running(&locmmptr->tt)) {
+        if(msg_timer_is_running(locmmptr)) {
           /* We must keep this seed */
           break;
         }
@@ -1063,11 +1239,18 @@ static void
 icmp_in(void)
 {
   static seed_id_t seed_id;
-  static uint8_t r;
   static uint8_t *vector;
-  static uint8_t vector_len;
   static uint8_t r_missing;
   static uint8_t l_missing;
+#if MPL_WITH_SEED_WINDOWS
+  static uint16_t vector_len;
+  static uint16_t bit;
+  static uint8_t seq;
+  static uint8_t offset;
+#else
+  static uint8_t r;
+  static uint8_t vector_len;
+#endif
 
   LOG_INFO("MPL ICMP Control Message In\n");
 
@@ -1171,11 +1354,11 @@ icmp_in(void)
       if(list_head(locssptr->min_seq) != NULL) {
         for(locmmptr = list_head(locssptr->min_seq); locmmptr != NULL; locmmptr = list_item_next(locmmptr)) {
           LOG_DBG("Resetting timer for messages\n");
-          if(!trickle_timer_is_running(&locmmptr->tt)) {
+          if(!msg_timer_is_running(locmmptr)) {
             LOG_DBG("Starting timer for messages\n");
-            mpl_data_trickle_timer_start(locmmptr);
+            msg_timer_start(locmmptr);
           }
-          mpl_trickle_timer_inconsistency(locmmptr);
+          msg_timer_inconsistency(locmmptr);
         }
       }
       /* Otherwise we jump here and continute */
@@ -1210,7 +1393,7 @@ seed_present:
     }
 
     /* Work out where remote bit vector starts */
-    vector_len = SEED_INFO_GET_LEN(locsiptr) * 8;
+    vector_len = (uint16_t)SEED_INFO_GET_LEN(locsiptr) * 8;
     switch(SEED_INFO_GET_S(locsiptr)) {
     case 0:
       vector = ((void *)locsiptr) + sizeof(struct seed_info);
@@ -1226,6 +1409,35 @@ seed_present:
       break;
     }
 
+#if MPL_WITH_SEED_WINDOWS
+    /* Compare the remote bit vector with our window, one bit at a time */
+    for(bit = 0; bit < vector_len; bit++) {
+      if(BIT_VECTOR_GET_BIT(vector, bit)) {
+        seq = SEQ_VAL_ADD(locsiptr->min_seqno, bit);
+        offset = seq - locssptr->min_seqno;
+        /* Messages older than our window were deliberately released */
+        if(!SEQ_VAL_IS_LT(seq, locssptr->min_seqno)
+           && (offset >= MPL_SEED_WINDOW_SIZE
+               || (locssptr->window & ((uint32_t)1 << offset)) == 0)) {
+          LOG_DBG("We are missing seq=%u\n", seq);
+          l_missing = 1;
+          break;
+        }
+      }
+    }
+    for(locmmptr = list_head(locssptr->min_seq); locmmptr != NULL; locmmptr = list_item_next(locmmptr)) {
+      /* Messages older than the remote window are not missing, but too old */
+      if(SEQ_VAL_IS_LT(locmmptr->seq, locsiptr->min_seqno)) {
+        continue;
+      }
+      bit = (uint8_t)(locmmptr->seq - locsiptr->min_seqno);
+      if(bit >= vector_len || !BIT_VECTOR_GET_BIT(vector, bit)) {
+        LOG_DBG("Remote is missing seq=%u\n", locmmptr->seq);
+        r_missing = 1;
+        msg_timer_inconsistency(locmmptr);
+      }
+    }
+#else /* MPL_WITH_SEED_WINDOWS */
     /* Potential quick resolution here */
     locmmptr = list_head(locssptr->min_seq);
     if(locmmptr == NULL) {
@@ -1271,10 +1483,10 @@ seed_present:
           /* Additionally all data message timers in set if r is behind us */
           if(list_head(locssptr->min_seq) != NULL) {
             for(locmmptr = list_head(locssptr->min_seq); locmmptr != NULL; locmmptr = list_item_next(locmmptr)) {
-              if(!trickle_timer_is_running(&locmmptr->tt)) {
-                mpl_data_trickle_timer_start(locmmptr);
+              if(!msg_timer_is_running(locmmptr)) {
+                msg_timer_start(locmmptr);
               }
-              mpl_trickle_timer_inconsistency(locmmptr);
+              msg_timer_inconsistency(locmmptr);
             }
           }
         } else {
@@ -1310,10 +1522,10 @@ seed_present:
         /* Local message is missing from remote set. Reset control and data timers */
         LOG_DBG("Remote is missing seq=%u\n", locmmptr->seq);
         r_missing = 1;
-        if(!trickle_timer_is_running(&locmmptr->tt)) {
-          mpl_data_trickle_timer_start(locmmptr);
+        if(!msg_timer_is_running(locmmptr)) {
+          msg_timer_start(locmmptr);
         }
-        mpl_trickle_timer_inconsistency(locmmptr);
+        msg_timer_inconsistency(locmmptr);
       }
 
       /* Now increment our pointers */
@@ -1342,14 +1554,15 @@ seed_present:
        */
       while(locmmptr != NULL) {
         LOG_DBG("Remote is missing all above seq=%u\n", locmmptr->seq);
-        if(!trickle_timer_is_running(&locmmptr->tt)) {
-          mpl_data_trickle_timer_start(locmmptr);
+        if(!msg_timer_is_running(locmmptr)) {
+          msg_timer_start(locmmptr);
         }
-        mpl_trickle_timer_inconsistency(locmmptr);
+        msg_timer_inconsistency(locmmptr);
         r_missing = 1;
         locmmptr = list_item_next(locmmptr);
       }
     }
+#endif /* MPL_WITH_SEED_WINDOWS */
     /* Now point to next seed info */
 next:
     switch(SEED_INFO_GET_S(locsiptr)) {
@@ -1395,6 +1608,9 @@ accept(uint8_t in)
   static uint8_t S;
   static struct mpl_msg *mmiterptr;
   static struct uip_ext_hdr *hptr;
+#if MPL_WITH_SEED_WINDOWS
+  static uint8_t offset;
+#endif
 
   LOG_INFO("Multicast I/O\n");
 
@@ -1509,6 +1725,25 @@ accept(uint8_t in)
       UIP_MCAST6_STATS_ADD(mcast_dropped);
       return UIP_MCAST6_DROP;
     }
+#if MPL_WITH_SEED_WINDOWS
+    offset = seq_val - locssptr->min_seqno;
+    if(offset < MPL_SEED_WINDOW_SIZE && (locssptr->window & ((uint32_t)1 << offset))) {
+      /* Seen before , drop */
+      LOG_INFO("Seen before\n");
+      if(HBH_GET_M(lochbhmptr) && (locssptr->window >> offset) > 1) {
+        /* The sender is missing our newer messages */
+        for(locmmptr = list_head(locssptr->min_seq); locmmptr != NULL; locmmptr = list_item_next(locmmptr)) {
+          if(SEQ_VAL_IS_GT(locmmptr->seq, seq_val)) {
+            msg_timer_inconsistency(locmmptr);
+          }
+        }
+      } else {
+        trickle_timer_consistency(&locssptr->tt);
+      }
+      UIP_MCAST6_STATS_ADD(mcast_dropped);
+      return UIP_MCAST6_DROP;
+    }
+#else /* MPL_WITH_SEED_WINDOWS */
     if(list_head(locssptr->min_seq) != NULL) {
       for(locmmptr = list_head(locssptr->min_seq); locmmptr != NULL; locmmptr = list_item_next(locmmptr)) {
         if(SEQ_VAL_IS_EQ(seq_val, locmmptr->seq)) {
@@ -1524,6 +1759,7 @@ accept(uint8_t in)
         }
       }
     }
+#endif /* MPL_WITH_SEED_WINDOWS */
   }
   /* We have not seen this message before */
 
@@ -1541,8 +1777,23 @@ accept(uint8_t in)
     LIST_STRUCT_INIT(locssptr, min_seq);
     seed_id_cpy(&locssptr->seed_id, &seed_id);
     locssptr->domain = locdsptr;
+#if MPL_WITH_SEED_WINDOWS
+    if(!trickle_timer_config(&locssptr->tt,
+                             MPL_DATA_MESSAGE_IMIN,
+                             MPL_DATA_MESSAGE_IMAX,
+                             MPL_DATA_MESSAGE_K)) {
+      LOG_ERR("Failed to configure timer for seed. Dropping...\n");
+      SEED_SET_CLEAR_USED(locssptr);
+      return UIP_MCAST6_DROP;
+    }
+#endif
   }
 
+#if MPL_WITH_SEED_WINDOWS
+  /* This seed is now the most recently active, and the last one to reclaim from */
+  list_add(seed_lru, locssptr);
+#endif
+
   /* Allocate a buffer */
   locmmptr = buffer_allocate();
   if(!locmmptr) {
@@ -1555,6 +1806,20 @@ accept(uint8_t in)
     }
   }
 
+#if MPL_WITH_SEED_WINDOWS
+  /* Reclaiming may have released older messages of this very seed */
+  if(SEQ_VAL_IS_LT(seq_val, locssptr->min_seqno)) {
+    LOG_INFO("Too old\n");
+    UIP_MCAST6_STATS_ADD(mcast_dropped);
+    return UIP_MCAST6_DROP;
+  }
+  /* Release the oldest messages of the seed until this one fits in its window */
+  while(list_head(locssptr->min_seq) != NULL
+        && (uint8_t)(seq_val - locssptr->min_seqno) >= MPL_SEED_WINDOW_SIZE) {
+    buffer_free(seed_window_pop(locssptr));
+  }
+#endif
+
   /* We have a domain set, a seed set, and we have a buffer. Accept this message */
   LOG_INFO("Message from seed ");
   LOG_INFO_SEED(locssptr->seed_id);
@@ -1579,6 +1844,25 @@ accept(uint8_t in)
   memcpy(&locmmptr->data, hptr, locmmptr->size);
   locmmptr->seq = seq_val;
   locmmptr->seed = locssptr;
+#if MPL_WITH_SEED_WINDOWS
+  /* Not forwarded until the seed's timer is started for it */
+  msg_timer_stop(locmmptr);
+
+  /* Place the message into the buffered message linked list and window */
+  if(list_head(locssptr->min_seq) == NULL) {
+    list_push(locssptr->min_seq, locmmptr);
+    locssptr->min_seqno = locmmptr->seq;
+    locssptr->window = 0;
+  } else {
+    mmiterptr = list_head(locssptr->min_seq);
+    while(list_item_next(mmiterptr) != NULL
+          && SEQ_VAL_IS_LT(((struct mpl_msg *)list_item_next(mmiterptr))->seq, locmmptr->seq)) {
+      mmiterptr = list_item_next(mmiterptr);
+    }
+    list_insert(locssptr->min_seq, mmiterptr, locmmptr);
+  }
+  locssptr->window |= (uint32_t)1 << (uint8_t)(locmmptr->seq - locssptr->min_seqno);
+#else /* MPL_WITH_SEED_WINDOWS */
   if(!trickle_timer_config(&locmmptr->tt,
                            MPL_DATA_MESSAGE_IMIN,
                            MPL_DATA_MESSAGE_IMAX,
@@ -1601,11 +1885,12 @@ accept(uint8_t in)
       }
     }
   }
+#endif /* MPL_WITH_SEED_WINDOWS */
   locssptr->count++;
 
 #if MPL_PROACTIVE_FORWARDING
   /* Start Forwarding the message */
-  mpl_data_trickle_timer_start(locmmptr);
+  msg_timer_start(locmmptr);
 #endif
 
   LOG_INFO("Min Seq Number=%u, %u values\n", locssptr->min_seqno, locssptr->count);
@@ -1632,10 +1917,10 @@ accept(uint8_t in)
 #if MPL_PROACTIVE_FORWARDING
   if(HBH_GET_M(lochbhmptr) == 1 && list_item_next(locmmptr) != NULL) {
     LOG_DBG("MPL Domain is inconsistent\n");
-    mpl_trickle_timer_inconsistency(locmmptr);
+    msg_timer_inconsistency(locmmptr);
   } else {
     LOG_DBG("MPL Domain is consistent\n");
-    trickle_timer_consistency(&locmmptr->tt);
+    msg_timer_consistency(locmmptr);
   }
 #endif
 
@@ -1772,6 +2057,9 @@ init(void)
   memset(domain_set, 0, sizeof(struct mpl_domain) * MPL_DOMAIN_SET_SIZE);
   memset(seed_set, 0, sizeof(struct mpl_seed) * MPL_SEED_SET_SIZE);
   memset(buffered_message_set, 0, sizeof(struct mpl_msg) * MPL_BUFFERED_MESSAGE_SET_SIZE);
+#if MPL_WITH_SEED_WINDOWS
+  list_init(seed_lru);
+#endif
 
   /* Register the ICMPv6 input handler */
   uip_icmp6_register_input_handler(&mpl_icmp_handler);
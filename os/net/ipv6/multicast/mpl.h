@@ -233,6 +233,25 @@
 #define MPL_PROACTIVE_FORWARDING MPL_CONF_PROACTIVE_FORWARDING
 #endif
 /*---------------------------------------------------------------------------*/
+/**
+ * Seed Windows
+ * With seed windows enabled, each seed keeps a bitmap of the sequence numbers
+ * it has buffered, relative to its minimum sequence number. Duplicates are
+ * detected with a single bit test, and control messages are built straight
+ * from the bitmap. Seeds further share a single trickle timer among all their
+ * buffered messages, and when the buffer is full the oldest message of the
+ * least recently active seed is reclaimed first. A seed window spans at most
+ * 32 sequence numbers: older messages are released to make room for newer
+ * ones.
+ * 1 - Indicates that seed windows be enabled
+ * 0 - Indicates that seed windows be disabled
+ */
+#ifndef MPL_CONF_WITH_SEED_WINDOWS
+#define MPL_WITH_SEED_WINDOWS               0
+#else
+#define MPL_WITH_SEED_WINDOWS MPL_CONF_WITH_SEED_WINDOWS
+#endif
+/*---------------------------------------------------------------------------*/
 /**
  * Seed Set Entry Lifetime
  * MPL Seed set entries remain in the seed set for a set period of time after
@@ -123,6 +123,23 @@ uip_sr_expire_parent(const void *graph, const uip_ipaddr_t *child,
   }
 }
 /*---------------------------------------------------------------------------*/
+static uip_sr_node_t *
+add_node(const uip_ipaddr_t *child)
+{
+  uip_sr_node_t *node = memb_alloc(&nodememb);
+  /* No space left, abort */
+  if(node == NULL) {
+    LOG_ERR("NS: no space left for child ");
+    LOG_ERR_6ADDR(child);
+    LOG_ERR_("\n");
+    return NULL;
+  }
+  node->parent = NULL;
+  list_add(nodelist, node);
+  num_nodes++;
+  return node;
+}
+/*---------------------------------------------------------------------------*/
 uip_sr_node_t *
 uip_sr_update_node(void *graph, const uip_ipaddr_t *child,
                    const uip_ipaddr_t *parent, uint32_t lifetime)
@@ -144,17 +161,10 @@ uip_sr_update_node(void *graph, const uip_ipaddr_t *child,
 
   /* No node for this child, add one */
   if(child_node == NULL) {
-    child_node = memb_alloc(&nodememb);
-    /* No space left, abort */
+    child_node = add_node(child);
     if(child_node == NULL) {
-      LOG_ERR("NS: no space left for child ");
-      LOG_ERR_6ADDR(child);
-      LOG_ERR_("\n");
       return NULL;
     }
-    child_node->parent = NULL;
-    list_add(nodelist, child_node);
-    num_nodes++;
   }
 
   /* Initialize node */
@@ -187,6 +197,97 @@ uip_sr_update_node(void *graph, const uip_ipaddr_t *child,
   return child_node;
 }
 /*---------------------------------------------------------------------------*/
+/* Same as uip_sr_is_addr_reachable, from node pointers */
+static int
+is_node_reachable(const uip_sr_node_t *node, const uip_sr_node_t *root_node)
+{
+  int max_depth = UIP_SR_LINK_NUM;
+
+  while(node != NULL && node != root_node && max_depth > 0) {
+    node = node->parent;
+    max_depth--;
+  }
+  return node != NULL && node == root_node;
+}
+/*---------------------------------------------------------------------------*/
+int
+uip_sr_update_nodes(void *graph, const uip_sr_update_t *updates, int count)
+{
+  uip_ipaddr_t root_ipaddr;
+  uip_sr_node_t *root_node;
+  uip_sr_node_t *child_node;
+  uip_sr_node_t *parent_node = NULL;
+  uip_sr_node_t *old_parent_node;
+  const uip_ipaddr_t *parent = NULL;
+  int applied = 0;
+  int i;
+
+  /* Unlike with one uip_sr_update_node call per link, the root node is looked
+   * up once per batch, consecutive links to the same parent share the parent
+   * lookup, and reachability is checked without any address lookup. */
+  NETSTACK_ROUTING.get_root_ipaddr(&root_ipaddr);
+  root_node = uip_sr_get_node(graph, &root_ipaddr);
+
+  for(i = 0; i < count; i++) {
+    const uip_sr_update_t *update = &updates[i];
+
+    if(update->lifetime == 0) {
+      uip_sr_expire_parent(graph, update->child, update->parent);
+      applied++;
+      continue;
+    }
+
+    if(parent == NULL || !uip_ipaddr_cmp(parent, update->parent)) {
+      parent = update->parent;
+      parent_node = uip_sr_get_node(graph, parent);
+      if(parent_node == NULL) {
+        /* No node for the parent, add one with infinite lifetime */
+        parent_node = uip_sr_update_node(graph, parent, NULL, UIP_SR_INFINITE_LIFETIME);
+        if(parent_node == NULL) {
+          LOG_ERR("NS: no space left for root node!\n");
+          parent = NULL;
+          continue;
+        }
+        if(root_node == NULL) {
+          root_node = uip_sr_get_node(graph, &root_ipaddr);
+        }
+      }
+    }
+
+    child_node = uip_sr_get_node(graph, update->child);
+    if(child_node == NULL) {
+      child_node = add_node(update->child);
+      if(child_node == NULL) {
+        continue;
+      }
+      if(root_node == NULL) {
+        root_node = uip_sr_get_node(graph, &root_ipaddr);
+      }
+    }
+
+    child_node->graph = graph;
+    child_node->lifetime = update->lifetime;
+    memcpy(child_node->link_identifier, ((const unsigned char *)update->child) + 8, 8);
+
+    if(is_node_reachable(child_node, root_node)) {
+      old_parent_node = child_node->parent;
+      child_node->parent = parent_node;
+      /* Keep the old parent if the new one creates a loop, as in
+       * uip_sr_update_node */
+      if(!is_node_reachable(child_node, root_node)) {
+        child_node->parent = old_parent_node;
+      }
+    } else {
+      child_node->parent = parent_node;
+    }
+    applied++;
+  }
+
+  LOG_INFO("NS: updated %u/%u links, num_nodes %u\n", applied, count, num_nodes);
+
+  return applied;
+}
+/*---------------------------------------------------------------------------*/
 void
 uip_sr_init(void)
 {
@@ -100,6 +100,13 @@ typedef struct uip_sr_node {
   struct uip_sr_node *parent;
 } uip_sr_node_t;
 
+/** \brief A child-parent link update, as applied by uip_sr_update_nodes */
+typedef struct uip_sr_update {
+  const uip_ipaddr_t *child;
+  const uip_ipaddr_t *parent;
+  uint32_t lifetime; /* The link lifetime in seconds, 0 to expire the link */
+} uip_sr_update_t;
+
 /********** Public functions **********/
 
 /**
@@ -131,6 +138,18 @@ uip_sr_node_t *uip_sr_update_node(void *graph, const uip_ipaddr_t *child,
                                   const uip_ipaddr_t *parent,
                                   uint32_t lifetime);
 
+/**
+ * Updates a batch of child-parent links, as carried by an aggregated DAO.
+ * Equivalent to one call to uip_sr_update_node (or uip_sr_expire_parent for
+ * a zero lifetime) per link, in order, with fewer list lookups.
+ *
+ * \param graph The graph the links belong to
+ * \param updates The link updates
+ * \param count The number of link updates
+ * \return The number of link updates that were applied
+ */
+int uip_sr_update_nodes(void *graph, const uip_sr_update_t *updates, int count);
+
 /**
  * Returns the head of the non-storing node list
  *
@@ -55,10 +55,11 @@
 /* Maximum value for the freshness counter */
 #define FRESHNESS_MAX                   16
 
-/* EWMA (exponential moving average) used to maintain statistics over time */
-#define EWMA_SCALE                     100
-#define EWMA_ALPHA                      10
-#define EWMA_BOOTSTRAP_ALPHA            25
+/* EWMA (exponential moving average) used to maintain statistics over time.
+ * The scale is a power of two, so that updates need no division. */
+#define EWMA_SCALE                     128
+#define EWMA_ALPHA                      13
+#define EWMA_BOOTSTRAP_ALPHA            32
 
 /* ETX fixed point divisor. 128 is the value used by RPL (RFC 6551 and RFC 6719) */
 #define ETX_DIVISOR                     LINK_STATS_ETX_DIVISOR
@@ -73,14 +74,43 @@ NBR_TABLE(struct link_stats, link_stats);
 /* Called at a period of FRESHNESS_HALF_LIFE */
 struct ctimer periodic_timer;
 
+#if LINK_STATS_DEFERRED_UPDATES
+/* A deferred update, possibly resulting from several coalesced callbacks.
+ * Only identical callbacks are coalesced, so that applying the update count
+ * times gives the same statistics as applying each callback by itself. */
+struct deferred_update {
+  linkaddr_t lladdr;
+  uint8_t is_tx;    /* Transmission (packet sent) or reception (input) */
+  uint8_t status;   /* Tx status, same for all coalesced packets */
+  uint8_t count;    /* Number of coalesced callbacks */
+  uint16_t numtx;   /* Tx: number of transmissions of each packet */
+  int16_t rssi;     /* Rx: RSSI of each received packet */
+};
+
+/* Maximum number of callbacks coalesced in a single update */
+#define DEFERRED_COALESCE_MAX          64
+
+static struct deferred_update deferred[LINK_STATS_DEFERRED_UPDATES];
+static uint8_t deferred_count;
+
+PROCESS(link_stats_process, "Link stats");
+#endif /* LINK_STATS_DEFERRED_UPDATES */
+
 /*---------------------------------------------------------------------------*/
-/* Returns the neighbor's link stats */
+/* Returns the neighbor's link stats, as of the last applied updates */
 const struct link_stats *
 link_stats_from_lladdr(const linkaddr_t *lladdr)
 {
   return nbr_table_get_from_lladdr(link_stats, lladdr);
 }
 /*---------------------------------------------------------------------------*/
+/* Returns the link stats of the neighbor owning an item of another table */
+const struct link_stats *
+link_stats_from_nbr_item(const nbr_table_t *table, const nbr_table_item_t *item)
+{
+  return nbr_table_get_from_item(link_stats, table, item);
+}
+/*---------------------------------------------------------------------------*/
 /* Returns the neighbor's address given a link stats item */
 const linkaddr_t *
 link_stats_get_lladdr(const struct link_stats *stat)
@@ -128,20 +158,55 @@ guess_etx_from_rssi(const struct link_stats *stats)
 }
 #endif /* LINK_STATS_INIT_ETX_FROM_RSSI */
 /*---------------------------------------------------------------------------*/
-/* Packet sent callback. Updates stats for transmissions to lladdr */
-void
-link_stats_packet_sent(const linkaddr_t *lladdr, int status, int numtx)
+#if LINK_STATS_WINDOW_SIZE
+/* Records the RSSI of a received packet in the window */
+static void
+window_add_rssi(struct link_stats *stats, int16_t rssi)
+{
+  stats->rssi_window[stats->rssi_window_pos] = MAX(MIN(rssi, INT8_MAX), INT8_MIN);
+  stats->rssi_window_pos = (stats->rssi_window_pos + 1) % LINK_STATS_WINDOW_SIZE;
+  if(stats->rssi_window_len < LINK_STATS_WINDOW_SIZE) {
+    stats->rssi_window_len++;
+  }
+}
+/*---------------------------------------------------------------------------*/
+/* RSSI percentile over the last receptions */
+int16_t
+link_stats_get_rssi_percentile(const struct link_stats *stats, uint8_t percentile)
+{
+  int8_t sorted[LINK_STATS_WINDOW_SIZE];
+  int i, j;
+
+  if(stats == NULL || stats->rssi_window_len == 0) {
+    return LINK_STATS_RSSI_UNKNOWN;
+  }
+
+  /* Insertion sort of the (small) window */
+  for(i = 0; i < stats->rssi_window_len; i++) {
+    int8_t rssi = stats->rssi_window[i];
+    for(j = i; j > 0 && sorted[j - 1] > rssi; j--) {
+      sorted[j] = sorted[j - 1];
+    }
+    sorted[j] = rssi;
+  }
+
+  percentile = MIN(percentile, 100);
+  return sorted[(percentile * (stats->rssi_window_len - 1) + 50) / 100];
+}
+#endif /* LINK_STATS_WINDOW_SIZE */
+/*---------------------------------------------------------------------------*/
+/* Updates the statistics of lladdr after count packets were sent with the
+ * same status, using numtx transmissions each */
+static void
+update_tx(const linkaddr_t *lladdr, int status, int count, int numtx)
 {
   struct link_stats *stats;
 #if !LINK_STATS_ETX_FROM_PACKET_COUNT
   uint16_t packet_etx;
   uint8_t ewma_alpha;
 #endif /* !LINK_STATS_ETX_FROM_PACKET_COUNT */
-
-  if(status != MAC_TX_OK && status != MAC_TX_NOACK && status != MAC_TX_QUEUE_FULL) {
-    /* Do not penalize the ETX when collisions or transmission errors occur. */
-    return;
-  }
+  int packet_numtx;
+  int i;
 
   stats = nbr_table_get_from_lladdr(link_stats, lladdr);
   if(stats == NULL) {
@@ -160,72 +225,80 @@ link_stats_packet_sent(const linkaddr_t *lladdr, int status, int numtx)
 
   if(status == MAC_TX_QUEUE_FULL) {
 #if LINK_STATS_PACKET_COUNTERS
-    stats->cnt_current.num_queue_drops += 1;
+    stats->cnt_current.num_queue_drops += count;
 #endif
     /* Do not penalize the ETX when the packet is dropped due to a full queue */
     return;
   }
 
-  /* Update last timestamp and freshness */
+  /* Update last timestamp */
   stats->last_tx_time = clock_time();
-  stats->freshness = MIN(stats->freshness + numtx, FRESHNESS_MAX);
 
 #if LINK_STATS_PACKET_COUNTERS
   /* Update paket counters */
-  stats->cnt_current.num_packets_tx += numtx;
+  stats->cnt_current.num_packets_tx += count * numtx;
   if(status == MAC_TX_OK) {
-    stats->cnt_current.num_packets_acked++;
+    stats->cnt_current.num_packets_acked += count;
   }
 #endif
 
-  /* Add penalty in case of no-ACK */
-  if(status == MAC_TX_NOACK) {
-    numtx += ETX_NOACK_PENALTY;
-  }
+  packet_numtx = numtx;
+
+  /* Apply each packet in turn, as its freshness affects the next EWMA step */
+  for(i = 0; i < count; i++) {
+    stats->freshness = MIN(stats->freshness + packet_numtx, FRESHNESS_MAX);
+
+    numtx = packet_numtx;
+    /* Add penalty in case of no-ACK */
+    if(status == MAC_TX_NOACK) {
+      numtx += ETX_NOACK_PENALTY;
+    }
 
 #if LINK_STATS_ETX_FROM_PACKET_COUNT
-  /* Compute ETX from packet and ACK count */
-  /* Halve both counter after TX_COUNT_MAX */
-  if(stats->tx_count + numtx > TX_COUNT_MAX) {
-    stats->tx_count /= 2;
-    stats->ack_count /= 2;
-  }
-  /* Update tx_count and ack_count */
-  stats->tx_count += numtx;
-  if(status == MAC_TX_OK) {
-    stats->ack_count++;
-  }
-  /* Compute ETX */
-  if(stats->ack_count > 0) {
-    stats->etx = ((uint16_t)stats->tx_count * ETX_DIVISOR) / stats->ack_count;
-  } else {
-    stats->etx = (uint16_t)MAX(ETX_NOACK_PENALTY, stats->tx_count) * ETX_DIVISOR;
-  }
+    /* Compute ETX from packet and ACK count */
+    /* Halve both counter after TX_COUNT_MAX */
+    if(stats->tx_count + numtx > TX_COUNT_MAX) {
+      stats->tx_count /= 2;
+      stats->ack_count /= 2;
+    }
+    /* Update tx_count and ack_count */
+    stats->tx_count += numtx;
+    if(status == MAC_TX_OK) {
+      stats->ack_count++;
+    }
+    /* Compute ETX */
+    if(stats->ack_count > 0) {
+      stats->etx = ((uint16_t)stats->tx_count * ETX_DIVISOR) / stats->ack_count;
+    } else {
+      stats->etx = (uint16_t)MAX(ETX_NOACK_PENALTY, stats->tx_count) * ETX_DIVISOR;
+    }
 #else /* LINK_STATS_ETX_FROM_PACKET_COUNT */
-  /* Compute ETX using an EWMA */
+    /* Compute ETX using an EWMA */
 
-  /* ETX used for this update */
-  packet_etx = numtx * ETX_DIVISOR;
-  /* ETX alpha used for this update */
-  ewma_alpha = link_stats_is_fresh(stats) ? EWMA_ALPHA : EWMA_BOOTSTRAP_ALPHA;
+    /* ETX used for this update */
+    packet_etx = numtx * ETX_DIVISOR;
+    /* ETX alpha used for this update */
+    ewma_alpha = link_stats_is_fresh(stats) ? EWMA_ALPHA : EWMA_BOOTSTRAP_ALPHA;
 
-  if(stats->etx == 0) {
-    /* Initialize ETX */
-    stats->etx = packet_etx;
-  } else {
-    /* Compute EWMA and update ETX */
-    stats->etx = ((uint32_t)stats->etx * (EWMA_SCALE - ewma_alpha) +
-        (uint32_t)packet_etx * ewma_alpha) / EWMA_SCALE;
-  }
+    if(stats->etx == 0) {
+      /* Initialize ETX */
+      stats->etx = packet_etx;
+    } else {
+      /* Compute EWMA and update ETX */
+      stats->etx = ((uint32_t)stats->etx * (EWMA_SCALE - ewma_alpha) +
+          (uint32_t)packet_etx * ewma_alpha) / EWMA_SCALE;
+    }
 #endif /* LINK_STATS_ETX_FROM_PACKET_COUNT */
+  }
 }
 /*---------------------------------------------------------------------------*/
-/* Packet input callback. Updates statistics for receptions on a given link */
-void
-link_stats_input_callback(const linkaddr_t *lladdr)
+/* Updates the statistics of lladdr after count packets were received with
+ * an RSSI of packet_rssi each */
+static void
+update_rx(const linkaddr_t *lladdr, int count, int16_t packet_rssi)
 {
   struct link_stats *stats;
-  int16_t packet_rssi = packetbuf_attr(PACKETBUF_ATTR_RSSI);
+  int i;
 
   stats = nbr_table_get_from_lladdr(link_stats, lladdr);
   if(stats == NULL) {
@@ -237,13 +310,19 @@ link_stats_input_callback(const linkaddr_t *lladdr)
     stats->rssi = LINK_STATS_RSSI_UNKNOWN;
   }
 
-  if(stats->rssi == LINK_STATS_RSSI_UNKNOWN) {
-    /* Initialize RSSI */
-    stats->rssi = packet_rssi;
-  } else {
-    /* Update RSSI EWMA */
-    stats->rssi = ((int32_t)stats->rssi * (EWMA_SCALE - EWMA_ALPHA) +
-        (int32_t)packet_rssi * EWMA_ALPHA) / EWMA_SCALE;
+  for(i = 0; i < count; i++) {
+    if(stats->rssi == LINK_STATS_RSSI_UNKNOWN) {
+      /* Initialize RSSI */
+      stats->rssi = packet_rssi;
+    } else {
+      /* Update RSSI EWMA */
+      stats->rssi = ((int32_t)stats->rssi * (EWMA_SCALE - EWMA_ALPHA) +
+          (int32_t)packet_rssi * EWMA_ALPHA) / EWMA_SCALE;
+    }
+
+#if LINK_STATS_WINDOW_SIZE
+    window_add_rssi(stats, packet_rssi);
+#endif /* LINK_STATS_WINDOW_SIZE */
   }
 
   if(stats->etx == 0) {
@@ -256,10 +335,94 @@ link_stats_input_callback(const linkaddr_t *lladdr)
   }
 
 #if LINK_STATS_PACKET_COUNTERS
-  stats->cnt_current.num_packets_rx++;
+  stats->cnt_current.num_packets_rx += count;
 #endif
 }
 /*---------------------------------------------------------------------------*/
+#if LINK_STATS_DEFERRED_UPDATES
+/* Buffers an update, coalescing it with the previous one if identical */
+static void
+defer_update(const linkaddr_t *lladdr, int is_tx, int status, int numtx,
+             int16_t rssi)
+{
+  struct deferred_update *u = NULL;
+
+  if(deferred_count > 0) {
+    u = &deferred[deferred_count - 1];
+    if(u->is_tx != is_tx || u->status != status
+       || u->numtx != numtx || u->rssi != rssi
+       || u->count >= DEFERRED_COALESCE_MAX
+       || !linkaddr_cmp(&u->lladdr, lladdr)) {
+      u = NULL;
+    }
+  }
+
+  if(u == NULL) {
+    if(deferred_count == LINK_STATS_DEFERRED_UPDATES) {
+      /* No space left, apply pending updates now */
+      link_stats_flush();
+    }
+    u = &deferred[deferred_count++];
+    linkaddr_copy(&u->lladdr, lladdr);
+    u->is_tx = is_tx;
+    u->status = status;
+    u->count = 0;
+    u->numtx = numtx;
+    u->rssi = rssi;
+    process_poll(&link_stats_process);
+  }
+
+  u->count++;
+}
+#endif /* LINK_STATS_DEFERRED_UPDATES */
+/*---------------------------------------------------------------------------*/
+/* Applies all deferred updates */
+void
+link_stats_flush(void)
+{
+#if LINK_STATS_DEFERRED_UPDATES
+  uint8_t i;
+  for(i = 0; i < deferred_count; i++) {
+    struct deferred_update *u = &deferred[i];
+    if(u->is_tx) {
+      update_tx(&u->lladdr, u->status, u->count, u->numtx);
+    } else {
+      update_rx(&u->lladdr, u->count, u->rssi);
+    }
+  }
+  deferred_count = 0;
+#endif /* LINK_STATS_DEFERRED_UPDATES */
+}
+/*---------------------------------------------------------------------------*/
+/* Packet sent callback. Updates stats for transmissions to lladdr */
+void
+link_stats_packet_sent(const linkaddr_t *lladdr, int status, int numtx)
+{
+  if(status != MAC_TX_OK && status != MAC_TX_NOACK && status != MAC_TX_QUEUE_FULL) {
+    /* Do not penalize the ETX when collisions or transmission errors occur. */
+    return;
+  }
+
+#if LINK_STATS_DEFERRED_UPDATES
+  defer_update(lladdr, 1, status, numtx, 0);
+#else /* LINK_STATS_DEFERRED_UPDATES */
+  update_tx(lladdr, status, 1, numtx);
+#endif /* LINK_STATS_DEFERRED_UPDATES */
+}
+/*---------------------------------------------------------------------------*/
+/* Packet input callback. Updates statistics for receptions on a given link */
+void
+link_stats_input_callback(const linkaddr_t *lladdr)
+{
+  int16_t packet_rssi = packetbuf_attr(PACKETBUF_ATTR_RSSI);
+
+#if LINK_STATS_DEFERRED_UPDATES
+  defer_update(lladdr, 0, 0, 0, packet_rssi);
+#else /* LINK_STATS_DEFERRED_UPDATES */
+  update_rx(lladdr, 1, packet_rssi);
+#endif /* LINK_STATS_DEFERRED_UPDATES */
+}
+/*---------------------------------------------------------------------------*/
 #if LINK_STATS_PACKET_COUNTERS
 /*---------------------------------------------------------------------------*/
 static void
@@ -295,6 +458,7 @@ periodic(void *ptr)
   /* Age (by halving) freshness counter of all neighbors */
   struct link_stats *stats;
   ctimer_reset(&periodic_timer);
+  link_stats_flush();
   for(stats = nbr_table_head(link_stats); stats != NULL; stats = nbr_table_next(link_stats, stats)) {
     stats->freshness >>= 1;
   }
@@ -309,6 +473,9 @@ void
 link_stats_reset(void)
 {
   struct link_stats *stats;
+#if LINK_STATS_DEFERRED_UPDATES
+  deferred_count = 0;
+#endif /* LINK_STATS_DEFERRED_UPDATES */
   stats = nbr_table_head(link_stats);
   while(stats != NULL) {
     nbr_table_remove(link_stats, stats);
@@ -322,4 +489,24 @@ link_stats_init(void)
 {
   nbr_table_register(link_stats, NULL);
   ctimer_set(&periodic_timer, FRESHNESS_HALF_LIFE, periodic, NULL);
-}
\ No newline at end of file
+#if LINK_STATS_DEFERRED_UPDATES
+  if(!process_is_running(&link_stats_process)) {
+    process_start(&link_stats_process, NULL);
+  }
+#endif /* LINK_STATS_DEFERRED_UPDATES */
+}
+/*---------------------------------------------------------------------------*/
+#if LINK_STATS_DEFERRED_UPDATES
+/* Applies deferred updates once the MAC layer has handed over control */
+PROCESS_THREAD(link_stats_process, ev, data)
+{
+  PROCESS_BEGIN();
+
+  while(1) {
+    PROCESS_YIELD_UNTIL(ev == PROCESS_EVENT_POLL);
+    link_stats_flush();
+  }
+
+  PROCESS_END();
+}
+#endif /* LINK_STATS_DEFERRED_UPDATES */
\ No newline at end of file
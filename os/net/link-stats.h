@@ -34,6 +34,7 @@
 #define LINK_STATS_H_
 
 #include "net/linkaddr.h"
+#include "net/nbr-table.h"
 
 /* ETX fixed point divisor. 128 is the value used by RPL (RFC 6551 and RFC 6719) */
 #ifdef LINK_STATS_CONF_ETX_DIVISOR
@@ -63,6 +64,27 @@
 #define LINK_STATS_PACKET_COUNTERS           0
 #endif /* LINK_STATS_PACKET_COUNTERS */
 
+/* Number of MAC callbacks that can be buffered and applied later in a batch,
+ * from the link-stats process. Consecutive identical updates for the same
+ * neighbor are coalesced into one entry. Zero disables deferred updates. */
+#ifdef LINK_STATS_CONF_DEFERRED_UPDATES
+#define LINK_STATS_DEFERRED_UPDATES LINK_STATS_CONF_DEFERRED_UPDATES
+#else /* LINK_STATS_CONF_DEFERRED_UPDATES */
+#define LINK_STATS_DEFERRED_UPDATES           0
+#endif /* LINK_STATS_CONF_DEFERRED_UPDATES */
+
+/* Number of recent receptions over which RSSI percentiles are computed.
+ * At most 32. Zero disables windowed statistics. */
+#ifdef LINK_STATS_CONF_WINDOW_SIZE
+#define LINK_STATS_WINDOW_SIZE LINK_STATS_CONF_WINDOW_SIZE
+#else /* LINK_STATS_CONF_WINDOW_SIZE */
+#define LINK_STATS_WINDOW_SIZE                0
+#endif /* LINK_STATS_CONF_WINDOW_SIZE */
+
+#if LINK_STATS_WINDOW_SIZE > 32
+#error "LINK_STATS_WINDOW_SIZE must be at most 32"
+#endif
+
 /* Special value that signal the RSSI is not initialized */
 #define LINK_STATS_RSSI_UNKNOWN 0x7fff
 
@@ -91,6 +113,12 @@ struct link_stats {
   uint8_t ack_count;          /* ACK count, used for ETX calculation */
 #endif /* LINK_STATS_ETX_FROM_PACKET_COUNT */
 
+#if LINK_STATS_WINDOW_SIZE
+  uint8_t rssi_window_len;    /* Number of valid samples in rssi_window */
+  uint8_t rssi_window_pos;    /* Next position to write in rssi_window */
+  int8_t rssi_window[LINK_STATS_WINDOW_SIZE]; /* RSSI of the last receptions */
+#endif /* LINK_STATS_WINDOW_SIZE */
+
 #if LINK_STATS_PACKET_COUNTERS
   struct link_packet_counter cnt_current; /* packets in the current period */
   struct link_packet_counter cnt_total;   /* packets in total */
@@ -99,10 +127,22 @@ struct link_stats {
 
 /* Returns the neighbor's link statistics */
 const struct link_stats *link_stats_from_lladdr(const linkaddr_t *lladdr);
+/* Returns the link statistics of the neighbor owning an item of another
+ * neighbor table, without an address lookup */
+const struct link_stats *link_stats_from_nbr_item(const nbr_table_t *table,
+                                                  const nbr_table_item_t *item);
 /* Returns the address of the neighbor */
 const linkaddr_t *link_stats_get_lladdr(const struct link_stats *);
 /* Are the statistics fresh? */
 int link_stats_is_fresh(const struct link_stats *stats);
+#if LINK_STATS_WINDOW_SIZE
+/* RSSI percentile (0 to 100) over the last receptions. LINK_STATS_RSSI_UNKNOWN if unknown */
+int16_t link_stats_get_rssi_percentile(const struct link_stats *stats, uint8_t percentile);
+#endif /* LINK_STATS_WINDOW_SIZE */
+/* Applies all deferred updates. The link-stats process calls it once the
+ * MAC layer has handed over control; until then, statistics are read as of
+ * the last applied updates */
+void link_stats_flush(void);
 /* Resets link-stats module */
 void link_stats_reset(void);
 /* Initializes link-stats module */
@@ -52,6 +52,16 @@
 /* This node's current frame counter value */
 static uint32_t counter;
 
+#if ANTI_REPLAY_TABLE_SIZE
+/* Anti-replay information of the senders of received frames, replaced in
+   FIFO order. The addresses are kept apart so that a lookup scans a
+   contiguous array */
+static linkaddr_t senders[ANTI_REPLAY_TABLE_SIZE];
+static struct anti_replay_info infos[ANTI_REPLAY_TABLE_SIZE];
+static uint8_t table_len;
+static uint8_t table_next;
+#endif /* ANTI_REPLAY_TABLE_SIZE */
+
 /*---------------------------------------------------------------------------*/
 void
 anti_replay_set_counter(void)
@@ -110,6 +120,30 @@ anti_replay_was_replayed(struct anti_replay_info *info)
   }
 }
 /*---------------------------------------------------------------------------*/
+#if ANTI_REPLAY_TABLE_SIZE
+int
+anti_replay_was_replayed_by(const linkaddr_t *sender)
+{
+  uint8_t i;
+
+  for(i = 0; i < table_len; i++) {
+    if(linkaddr_cmp(&senders[i], sender)) {
+      return anti_replay_was_replayed(&infos[i]);
+    }
+  }
+
+  /* New sender */
+  i = table_next;
+  table_next = (table_next + 1) % ANTI_REPLAY_TABLE_SIZE;
+  if(table_len < ANTI_REPLAY_TABLE_SIZE) {
+    table_len++;
+  }
+  linkaddr_copy(&senders[i], sender);
+  anti_replay_init_info(&infos[i]);
+  return 0;
+}
+#endif /* ANTI_REPLAY_TABLE_SIZE */
+/*---------------------------------------------------------------------------*/
 #endif /* LLSEC802154_USES_FRAME_COUNTER */
 
 /** @} */
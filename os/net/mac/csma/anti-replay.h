@@ -46,6 +46,15 @@
 #define ANTI_REPLAY_H
 
 #include "contiki.h"
+#include "net/linkaddr.h"
+
+/* Number of senders for which anti_replay_was_replayed_by() keeps the
+   last frame counters. Set to 0 to not keep any */
+#ifdef ANTI_REPLAY_CONF_TABLE_SIZE
+#define ANTI_REPLAY_TABLE_SIZE ANTI_REPLAY_CONF_TABLE_SIZE
+#else /* ANTI_REPLAY_CONF_TABLE_SIZE */
+#define ANTI_REPLAY_TABLE_SIZE 0
+#endif /* ANTI_REPLAY_CONF_TABLE_SIZE */
 
 struct anti_replay_info {
   uint32_t last_broadcast_counter;
@@ -75,6 +84,16 @@ void anti_replay_init_info(struct anti_replay_info *info);
  */
 int anti_replay_was_replayed(struct anti_replay_info *info);
 
+/**
+ * \brief               Checks if received frame was replayed, with the
+ *                      anti-replay information kept for its sender. The
+ *                      first frame of a sender that is not in the table
+ *                      replaces the oldest entry and is accepted.
+ * \param sender        The sender of the received frame
+ * \retval 0            <-> received frame was not replayed
+ */
+int anti_replay_was_replayed_by(const linkaddr_t *sender);
+
 #endif /* ANTI_REPLAY_H */
 
 /** @} */
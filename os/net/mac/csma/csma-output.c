@@ -45,6 +45,7 @@
 #include "net/queuebuf.h"
 #include "dev/watchdog.h"
 #include "sys/ctimer.h"
+#include "sys/timer.h"
 #include "sys/clock.h"
 #include "lib/random.h"
 #include "net/netstack.h"
@@ -87,6 +88,36 @@
 #define CSMA_MAX_FRAME_RETRIES 7
 #endif
 
+/* Maximum number of frames sent in a row to the same neighbor. After a
+   successful transmission, the next frame queued for that neighbor is sent
+   without backoff until the burst reaches this length. Set to 0 to always
+   back off between frames, as IEEE 802.15.4 CSMA-CA does */
+#ifdef CSMA_CONF_BURST_MAX_LEN
+#define CSMA_BURST_MAX_LEN CSMA_CONF_BURST_MAX_LEN
+#else
+#define CSMA_BURST_MAX_LEN 0
+#endif
+
+/* Schedule the transmissions of all neighbor queues with a single ctimer,
+   instead of one ctimer per neighbor queue */
+#ifdef CSMA_CONF_SHARED_TRANSMIT_TIMER
+#define CSMA_SHARED_TRANSMIT_TIMER CSMA_CONF_SHARED_TRANSMIT_TIMER
+#else
+#define CSMA_SHARED_TRANSMIT_TIMER 0
+#endif
+
+/* Number of buckets, a power of two, of the hash table used to look up
+   neighbor queues by address. Set to 0 to search the neighbor list */
+#ifdef CSMA_CONF_NEIGHBOR_QUEUE_HASH_SIZE
+#define CSMA_NEIGHBOR_QUEUE_HASH_SIZE CSMA_CONF_NEIGHBOR_QUEUE_HASH_SIZE
+#else
+#define CSMA_NEIGHBOR_QUEUE_HASH_SIZE 0
+#endif
+
+#if CSMA_NEIGHBOR_QUEUE_HASH_SIZE & (CSMA_NEIGHBOR_QUEUE_HASH_SIZE - 1)
+#error CSMA_CONF_NEIGHBOR_QUEUE_HASH_SIZE must be a power of two
+#endif
+
 /* Packet metadata */
 struct qbuf_metadata {
   mac_callback_t sent;
@@ -97,10 +128,21 @@ struct qbuf_metadata {
 /* Every neighbor has its own packet queue */
 struct neighbor_queue {
   struct neighbor_queue *next;
+#if CSMA_NEIGHBOR_QUEUE_HASH_SIZE
+  struct neighbor_queue *hash_next;
+#endif /* CSMA_NEIGHBOR_QUEUE_HASH_SIZE */
   linkaddr_t addr;
+#if CSMA_SHARED_TRANSMIT_TIMER
+  struct timer transmit_time;
+  uint8_t transmit_scheduled;
+#else /* CSMA_SHARED_TRANSMIT_TIMER */
   struct ctimer transmit_timer;
+#endif /* CSMA_SHARED_TRANSMIT_TIMER */
   uint8_t transmissions;
   uint8_t collisions;
+#if CSMA_BURST_MAX_LEN
+  uint8_t burst_len;
+#endif /* CSMA_BURST_MAX_LEN */
   LIST_STRUCT(packet_queue);
 };
 
@@ -131,6 +173,12 @@ MEMB(neighbor_memb, struct neighbor_queue, CSMA_MAX_NEIGHBOR_QUEUES);
 MEMB(packet_memb, struct packet_queue, MAX_QUEUED_PACKETS);
 MEMB(metadata_memb, struct qbuf_metadata, MAX_QUEUED_PACKETS);
 LIST(neighbor_list);
+#if CSMA_NEIGHBOR_QUEUE_HASH_SIZE
+static struct neighbor_queue *neighbor_hash[CSMA_NEIGHBOR_QUEUE_HASH_SIZE];
+#endif /* CSMA_NEIGHBOR_QUEUE_HASH_SIZE */
+#if CSMA_SHARED_TRANSMIT_TIMER
+static struct ctimer transmit_timer;
+#endif /* CSMA_SHARED_TRANSMIT_TIMER */
 
 static void packet_sent(struct neighbor_queue *n,
     struct packet_queue *q,
@@ -138,9 +186,32 @@ static void packet_sent(struct neighbor_queue *n,
     int num_transmissions);
 static void transmit_from_queue(void *ptr);
 /*---------------------------------------------------------------------------*/
+#if CSMA_NEIGHBOR_QUEUE_HASH_SIZE
+static struct neighbor_queue **
+neighbor_hash_bucket(const linkaddr_t *addr)
+{
+  unsigned i;
+  uint8_t h = 0;
+
+  for(i = 0; i < LINKADDR_SIZE; i++) {
+    h = h * 31 + addr->u8[i];
+  }
+  return &neighbor_hash[h & (CSMA_NEIGHBOR_QUEUE_HASH_SIZE - 1)];
+}
+#endif /* CSMA_NEIGHBOR_QUEUE_HASH_SIZE */
+/*---------------------------------------------------------------------------*/
 static struct neighbor_queue *
 neighbor_queue_from_addr(const linkaddr_t *addr)
 {
+#if CSMA_NEIGHBOR_QUEUE_HASH_SIZE
+  struct neighbor_queue *n = *neighbor_hash_bucket(addr);
+  while(n != NULL) {
+    if(linkaddr_cmp(&n->addr, addr)) {
+      return n;
+    }
+    n = n->hash_next;
+  }
+#else /* CSMA_NEIGHBOR_QUEUE_HASH_SIZE */
   struct neighbor_queue *n = list_head(neighbor_list);
   while(n != NULL) {
     if(linkaddr_cmp(&n->addr, addr)) {
@@ -148,9 +219,40 @@ neighbor_queue_from_addr(const linkaddr_t *addr)
     }
     n = list_item_next(n);
   }
+#endif /* CSMA_NEIGHBOR_QUEUE_HASH_SIZE */
   return NULL;
 }
 /*---------------------------------------------------------------------------*/
+static void
+neighbor_queue_add(struct neighbor_queue *n)
+{
+#if CSMA_NEIGHBOR_QUEUE_HASH_SIZE
+  struct neighbor_queue **bucket = neighbor_hash_bucket(&n->addr);
+  n->hash_next = *bucket;
+  *bucket = n;
+#endif /* CSMA_NEIGHBOR_QUEUE_HASH_SIZE */
+  list_add(neighbor_list, n);
+}
+/*---------------------------------------------------------------------------*/
+static void
+neighbor_queue_free(struct neighbor_queue *n)
+{
+#if CSMA_NEIGHBOR_QUEUE_HASH_SIZE
+  struct neighbor_queue **prev = neighbor_hash_bucket(&n->addr);
+  while(*prev != n) {
+    prev = &(*prev)->hash_next;
+  }
+  *prev = n->hash_next;
+#endif /* CSMA_NEIGHBOR_QUEUE_HASH_SIZE */
+#if CSMA_SHARED_TRANSMIT_TIMER
+  n->transmit_scheduled = 0;
+#else /* CSMA_SHARED_TRANSMIT_TIMER */
+  ctimer_stop(&n->transmit_timer);
+#endif /* CSMA_SHARED_TRANSMIT_TIMER */
+  list_remove(neighbor_list, n);
+  memb_free(&neighbor_memb, n);
+}
+/*---------------------------------------------------------------------------*/
 static clock_time_t
 backoff_period(void)
 {
@@ -272,6 +374,69 @@ transmit_from_queue(void *ptr)
   }
 }
 /*---------------------------------------------------------------------------*/
+#if CSMA_SHARED_TRANSMIT_TIMER
+static struct neighbor_queue *
+next_scheduled(clock_time_t *delay)
+{
+  struct neighbor_queue *n;
+  struct neighbor_queue *next = NULL;
+  clock_time_t remaining;
+
+  /* Find the neighbor queue with the earliest transmission time */
+  for(n = list_head(neighbor_list); n != NULL; n = list_item_next(n)) {
+    if(n->transmit_scheduled) {
+      remaining = timer_expired(&n->transmit_time) ?
+        0 : timer_remaining(&n->transmit_time);
+      if(next == NULL || remaining < *delay) {
+        next = n;
+        *delay = remaining;
+      }
+    }
+  }
+  return next;
+}
+/*---------------------------------------------------------------------------*/
+static void
+transmit_timer_expired(void *ptr)
+{
+  struct neighbor_queue *n;
+  clock_time_t delay;
+  int i;
+
+  /* Serve every neighbor queue whose time has come, at most once each */
+  for(i = 0; i < CSMA_MAX_NEIGHBOR_QUEUES; i++) {
+    n = next_scheduled(&delay);
+    if(n == NULL || delay > 0) {
+      break;
+    }
+    n->transmit_scheduled = 0;
+    transmit_from_queue(n);
+  }
+  /* Rearm for the next neighbor queue, if any */
+  n = next_scheduled(&delay);
+  if(n != NULL) {
+    ctimer_set(&transmit_timer, delay, transmit_timer_expired, NULL);
+  }
+}
+#endif /* CSMA_SHARED_TRANSMIT_TIMER */
+/*---------------------------------------------------------------------------*/
+static void
+set_transmit_timer(struct neighbor_queue *n, clock_time_t delay)
+{
+#if CSMA_SHARED_TRANSMIT_TIMER
+  struct neighbor_queue *next;
+
+  timer_set(&n->transmit_time, delay);
+  n->transmit_scheduled = 1;
+  next = next_scheduled(&delay);
+  if(next == n) {
+    ctimer_set(&transmit_timer, delay, transmit_timer_expired, NULL);
+  }
+#else /* CSMA_SHARED_TRANSMIT_TIMER */
+  ctimer_set(&n->transmit_timer, delay, transmit_from_queue, n);
+#endif /* CSMA_SHARED_TRANSMIT_TIMER */
+}
+/*---------------------------------------------------------------------------*/
 static void
 schedule_transmission(struct neighbor_queue *n)
 {
@@ -289,7 +454,7 @@ schedule_transmission(struct neighbor_queue *n)
 
   LOG_DBG("scheduling transmission in %u ticks, NB=%u, BE=%u\n",
       (unsigned)delay, n->collisions, backoff_exponent);
-  ctimer_set(&n->transmit_timer, delay, transmit_from_queue, n);
+  set_transmit_timer(n, delay);
 }
 /*---------------------------------------------------------------------------*/
 static void
@@ -308,13 +473,21 @@ free_packet(struct neighbor_queue *n, struct packet_queue *p, int status)
       /* There is a next packet. We reset current tx information */
       n->transmissions = 0;
       n->collisions = 0;
+#if CSMA_BURST_MAX_LEN
+      if(status == MAC_TX_OK && n->burst_len + 1 < CSMA_BURST_MAX_LEN) {
+        /* The neighbor just acknowledged a frame: send the next one in
+           the same burst, without backoff */
+        n->burst_len++;
+        set_transmit_timer(n, 0);
+        return;
+      }
+      n->burst_len = 0;
+#endif /* CSMA_BURST_MAX_LEN */
       /* Schedule next transmissions */
       schedule_transmission(n);
     } else {
       /* This was the last packet in the queue, we free the neighbor */
-      ctimer_stop(&n->transmit_timer);
-      list_remove(neighbor_list, n);
-      memb_free(&neighbor_memb, n);
+      neighbor_queue_free(n);
     }
   }
 }
@@ -470,10 +643,16 @@ csma_output_packet(mac_callback_t sent, void *ptr)
       linkaddr_copy(&n->addr, addr);
       n->transmissions = 0;
       n->collisions = 0;
+#if CSMA_BURST_MAX_LEN
+      n->burst_len = 0;
+#endif /* CSMA_BURST_MAX_LEN */
+#if CSMA_SHARED_TRANSMIT_TIMER
+      n->transmit_scheduled = 0;
+#endif /* CSMA_SHARED_TRANSMIT_TIMER */
       /* Init packet queue for this neighbor */
       LIST_STRUCT_INIT(n, packet_queue);
       /* Add neighbor to the neighbor list */
-      list_add(neighbor_list, n);
+      neighbor_queue_add(n);
     }
   }
 
@@ -517,8 +696,7 @@ csma_output_packet(mac_callback_t sent, void *ptr)
       }
       /* The packet allocation failed. Remove and free neighbor entry if empty. */
       if(list_length(n->packet_queue) == 0) {
-        list_remove(neighbor_list, n);
-        memb_free(&neighbor_memb, n);
+        neighbor_queue_free(n);
       }
     } else {
       LOG_WARN("Neighbor queue full\n");
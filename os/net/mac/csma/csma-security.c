@@ -291,7 +291,16 @@ csma_security_parse_frame(void)
     return FRAMER_FAILED;
   }
 
-  /* TODO anti-reply protection */
+#if ANTI_REPLAY_TABLE_SIZE
+  if(anti_replay_was_replayed_by(packetbuf_addr(PACKETBUF_ADDR_SENDER))) {
+    LOG_INFO("received replayed frame %u from ",
+             (unsigned int) anti_replay_get_counter());
+    LOG_INFO_LLADDR(packetbuf_addr(PACKETBUF_ADDR_SENDER));
+    LOG_INFO_("\n");
+    return FRAMER_FAILED;
+  }
+#endif /* ANTI_REPLAY_TABLE_SIZE */
+
   return hdr_len;
 }
 /*---------------------------------------------------------------------------*/
@@ -314,6 +314,16 @@
 #define TSCH_QUEUE_MAX_NEIGHBOR_QUEUES ((NBR_TABLE_CONF_MAX_NEIGHBORS) + 2)
 #endif
 
+/* With queuebuf swapping (QUEUEBUFRAM_CONF_NUM < QUEUEBUF_CONF_NUM),
+ * tells whether the packets added to a neighbor queue may have their
+ * payload stored in CFS. By default, the EB and broadcast queues,
+ * which are often served in shared slots, are kept in RAM */
+#ifdef TSCH_QUEUE_CONF_MAY_SWAP
+#define TSCH_QUEUE_MAY_SWAP(n) TSCH_QUEUE_CONF_MAY_SWAP(n)
+#else
+#define TSCH_QUEUE_MAY_SWAP(n) (!(n)->is_broadcast)
+#endif
+
 /******** Configuration: scheduling  *******/
 
 /* Initializes TSCH with a 6TiSCH minimal schedule */
@@ -258,6 +258,8 @@ tsch_queue_add_packet(const linkaddr_t *addr, uint8_t max_transmissions,
         p = memb_alloc(&packet_memb);
         if(p != NULL) {
           /* Enqueue packet */
+          queuebuf_set_swap_policy(TSCH_QUEUE_MAY_SWAP(n) ?
+                                   QUEUEBUF_SWAP_ALLOWED : QUEUEBUF_SWAP_NEVER);
           p->qb = queuebuf_new_from_packetbuf();
           if(p->qb != NULL) {
             p->sent = sent;
@@ -447,6 +449,12 @@ tsch_queue_get_packet_for_nbr(const struct tsch_neighbor *n, struct tsch_link *l
       if(get_index != -1 &&
           !(is_shared_link && !tsch_queue_backoff_expired(n))) {    /* If this is a shared link,
                                                                     make sure the backoff has expired */
+        /* A payload that is still in CFS cannot be read within the
+           timeslot: request it for a later one */
+        queuebuf_prefetch(n->tx_array[get_index]->qb);
+        if(!queuebuf_in_ram(n->tx_array[get_index]->qb)) {
+          return NULL;
+        }
 #if TSCH_WITH_LINK_SELECTOR
         int packet_attr_slotframe = queuebuf_attr(n->tx_array[get_index]->qb, PACKETBUF_ATTR_TSCH_SLOTFRAME);
         int packet_attr_timeslot = queuebuf_attr(n->tx_array[get_index]->qb, PACKETBUF_ATTR_TSCH_TIMESLOT);
@@ -464,6 +472,49 @@ tsch_queue_get_packet_for_nbr(const struct tsch_neighbor *n, struct tsch_link *l
   return NULL;
 }
 /*---------------------------------------------------------------------------*/
+#if WITH_SWAP
+/* Requests the payload of the head packet of a neighbor queue */
+static void
+prefetch_head(const struct tsch_neighbor *n)
+{
+  int16_t get_index;
+
+  if(n != NULL) {
+    get_index = ringbufindex_peek_get(&n->tx_ringbuf);
+    if(get_index != -1) {
+      queuebuf_prefetch(n->tx_array[get_index]->qb);
+    }
+  }
+}
+#endif /* WITH_SWAP */
+/*---------------------------------------------------------------------------*/
+/* Requests the payloads of the packets that may be sent on a link */
+void
+tsch_queue_prefetch_for_link(const struct tsch_link *link)
+{
+#if WITH_SWAP
+  struct tsch_neighbor *n;
+
+  if(tsch_is_locked() || link == NULL
+     || !(link->link_options & LINK_OPTION_TX)) {
+    return;
+  }
+
+  n = tsch_queue_get_nbr(&link->addr);
+  prefetch_head(n);
+  if(n == n_broadcast) {
+    /* A broadcast link also serves the unicast queues without Tx link */
+    n = (struct tsch_neighbor *)nbr_table_head(tsch_neighbors);
+    while(n != NULL) {
+      if(!n->is_broadcast && n->tx_links_count == 0) {
+        prefetch_head(n);
+      }
+      n = (struct tsch_neighbor *)nbr_table_next(tsch_neighbors, n);
+    }
+  }
+#endif /* WITH_SWAP */
+}
+/*---------------------------------------------------------------------------*/
 /* Returns the head packet from a neighbor queue (from neighbor address) */
 struct tsch_packet *
 tsch_queue_get_packet_for_dest_addr(const linkaddr_t *addr, struct tsch_link *link)
@@ -163,6 +163,13 @@ struct tsch_packet *tsch_queue_get_packet_for_dest_addr(const linkaddr_t *addr,
  * \return The packet if any, else NULL
  */
 struct tsch_packet *tsch_queue_get_unicast_packet_for_any(struct tsch_neighbor **n, struct tsch_link *link);
+/**
+ * \brief Requests the payloads of the packets that may be sent on a link
+ * to be brought to RAM before the link's timeslot. Called from the slot
+ * operation, with the next active link
+ * \param link The next active link
+ */
+void tsch_queue_prefetch_for_link(const struct tsch_link *link);
 /**
  * \brief Is the neighbor backoff timer expired?
  * \param n The neighbor queue
@@ -539,6 +539,10 @@ PT_THREAD(tsch_tx_slot(struct pt *pt, struct rtimer *t))
       /* encrypted payload */
       static uint8_t encrypted_packet[TSCH_PACKET_MAX_LEN];
 #endif /* LLSEC802154_ENABLED */
+#if QUEUEBUF_SHARED_DATA
+      /* copy of a payload shared with other queued packets */
+      static uint8_t shared_packet[TSCH_PACKET_MAX_LEN];
+#endif /* QUEUEBUF_SHARED_DATA */
       /* packet payload length */
       static uint8_t packet_len;
       /* packet seqno */
@@ -556,6 +560,14 @@ PT_THREAD(tsch_tx_slot(struct pt *pt, struct rtimer *t))
       /* get payload */
       packet = queuebuf_dataptr(current_packet->qb);
       packet_len = queuebuf_datalen(current_packet->qb);
+#if QUEUEBUF_SHARED_DATA
+      if(queuebuf_is_shared(current_packet->qb)) {
+        /* The frame is modified in place below: work on a copy, so that
+         * the other packets sharing the payload are left untouched */
+        memcpy(shared_packet, packet, packet_len);
+        packet = shared_packet;
+      }
+#endif /* QUEUEBUF_SHARED_DATA */
       /* if is this a broadcast packet, don't wait for ack */
       do_wait_for_ack = !current_neighbor->is_broadcast;
       /* Unicast. More packets in queue for the neighbor? */
@@ -1182,6 +1194,9 @@ PT_THREAD(tsch_slot_operation(struct rtimer *t, void *ptr))
         prev_slot_start = current_slot_start;
         current_slot_start += time_to_next_active_slot;
       } while(!tsch_schedule_slot_operation(t, prev_slot_start, time_to_next_active_slot, "main"));
+
+      /* Have swapped payloads read back to RAM before the next slot */
+      tsch_queue_prefetch_for_link(current_link);
     }
 
     tsch_in_slot_operation = 0;
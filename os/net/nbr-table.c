@@ -457,6 +457,15 @@ nbr_table_get_from_lladdr(const nbr_table_t *table, const linkaddr_t *lladdr)
   return nbr_get_bit(used_map, table, item) ? item : NULL;
 }
 /*---------------------------------------------------------------------------*/
+/* Get an item from the item of the same neighbor in another table */
+void *
+nbr_table_get_from_item(const nbr_table_t *table, const nbr_table_t *other,
+                        const void *other_item)
+{
+  void *item = item_from_index(table, index_from_item(other, other_item));
+  return nbr_get_bit(used_map, table, item) ? item : NULL;
+}
+/*---------------------------------------------------------------------------*/
 /* Removes a neighbor from the current table (unset "used" bit) */
 int
 nbr_table_remove(const nbr_table_t *table, const void *item)
@@ -125,6 +125,9 @@ nbr_table_item_t *nbr_table_add_lladdr(const nbr_table_t *table,
                                        const void *data);
 nbr_table_item_t *nbr_table_get_from_lladdr(const nbr_table_t *table,
                                             const linkaddr_t *lladdr);
+nbr_table_item_t *nbr_table_get_from_item(const nbr_table_t *table,
+                                          const nbr_table_t *other,
+                                          const nbr_table_item_t *other_item);
 /** @} */
 
 /** \name Neighbor tables: set flags (unused, locked, unlocked) */
@@ -47,6 +47,7 @@
 
 #if WITH_SWAP
 #include "cfs/cfs.h"
+#include "sys/critical.h"
 #endif
 
 #include <string.h> /* for memcpy() */
@@ -54,68 +55,89 @@
 /* Structure pointing to a buffer either stored
    in RAM or swapped in CFS */
 struct queuebuf {
-#if QUEUEBUF_DEBUG
+#if QUEUEBUF_DEBUG || WITH_SWAP
   struct queuebuf *next;
+#endif /* QUEUEBUF_DEBUG || WITH_SWAP */
+#if QUEUEBUF_DEBUG
   const char *file;
   int line;
   clock_time_t time;
 #endif /* QUEUEBUF_DEBUG */
+  /* With swapping, NULL while the payload is in CFS */
+  struct queuebuf_data *ram_ptr;
 #if WITH_SWAP
-  enum {IN_RAM, IN_CFS} location;
-  union {
-#endif
-    struct queuebuf_data *ram_ptr;
-#if WITH_SWAP
-    int swap_id;
-  };
-#endif
+  int16_t swap_slot;
+  uint8_t may_swap;
+  /* Set by queuebuf_prefetch(), possibly from an interrupt */
+  volatile uint8_t hot;
+#endif /* WITH_SWAP */
+#if QUEUEBUF_SHARED_DATA
+  /* With shared payloads, attributes are kept per queuebuf */
+  struct packetbuf_attr attrs[PACKETBUF_NUM_ATTRS];
+  struct packetbuf_addr addrs[PACKETBUF_NUM_ADDRS];
+#endif /* QUEUEBUF_SHARED_DATA */
 };
 
 /* The actual queuebuf data */
 struct queuebuf_data {
+#if QUEUEBUF_SHARED_DATA
+  struct queuebuf_data *next;
+#endif /* QUEUEBUF_SHARED_DATA */
   uint8_t data[PACKETBUF_SIZE];
   uint16_t len;
+#if QUEUEBUF_SHARED_DATA
+  uint16_t hash;
+  uint8_t refcount;
+#else /* QUEUEBUF_SHARED_DATA */
   struct packetbuf_attr attrs[PACKETBUF_NUM_ATTRS];
   struct packetbuf_addr addrs[PACKETBUF_NUM_ADDRS];
+#endif /* QUEUEBUF_SHARED_DATA */
 };
 
-MEMB(bufmem, struct queuebuf, QUEUEBUF_NUM);
+MEMB(bufmem, struct queuebuf, QUEUEBUF_NUM + QUEUEBUF_SHARED_NUM);
 MEMB(buframmem, struct queuebuf_data, QUEUEBUFRAM_NUM);
 
+#if QUEUEBUF_SHARED_DATA
+#include "lib/list.h"
+/* The payloads in RAM, candidates for sharing */
+LIST(shared_data_list);
+#endif /* QUEUEBUF_SHARED_DATA */
+
 #if WITH_SWAP
 
-/* Swapping allows to store up to QUEUEBUF_NUM - QUEUEBUFRAM_NUM
-   queuebufs in CFS. The swap is made of several large CFS files.
-   Every buffer stored in CFS has a swap id, referring to a specific
-   offset in one of these files. */
-#define NQBUF_FILES 4
-#define NQBUF_PER_FILE 256
-#define QBUF_FILE_SIZE (NQBUF_PER_FILE*sizeof(struct queuebuf_data))
-#define NQBUF_ID (NQBUF_PER_FILE * NQBUF_FILES)
-
-struct qbuf_file {
-  int fd;
-  int usage;
-  int renewable;
-};
+/* Swapping allows to store the payloads of the queuebufs that do not
+   fit in RAM in CFS. The swap is a single CFS file of
+   QUEUEBUF_SWAP_SLOTS slots, which is written once at initialization
+   so that storing a payload only overwrites a slot. Slots are taken
+   in ring order, starting after the last slot taken. */
+#define SWAP_SLOT_SIZE sizeof(struct queuebuf_data)
 
 /* A statically allocated queuebuf used as a cache for swapped qbufs */
 static struct queuebuf_data tmpdata;
 /* A pointer to the qbuf associated to the data in tmpdata */
 static struct queuebuf *tmpdata_qbuf = NULL;
-/* The swap id counter */
-static int next_swap_id = 0;
-/* The swap files */
-static struct qbuf_file qbuf_files[NQBUF_FILES];
-/* The timer used to renew files during inactivity periods */
-static struct ctimer renew_timer;
+/* The swap file */
+static int swap_fd = -1;
+/* One bit per slot of the swap file that holds a payload */
+static uint8_t swap_used[(QUEUEBUF_SWAP_SLOTS + 7) / 8];
+/* The slot at which the search for a free slot starts */
+static uint16_t swap_next;
+/* The swap policy of the queuebufs created next */
+static uint8_t swap_policy = QUEUEBUF_SWAP_ALLOWED;
+
+PROCESS(queuebuf_swap_process, "Queuebuf swap");
 
 #endif
 
 #if QUEUEBUF_DEBUG
+#include <stdio.h>
+#endif /* QUEUEBUF_DEBUG */
+
+#if QUEUEBUF_DEBUG || WITH_SWAP
 #include "lib/list.h"
+/* The queuebufs in use, which the swap process goes through */
 LIST(queuebuf_list);
-#endif /* QUEUEBUF_DEBUG */
+#endif /* QUEUEBUF_DEBUG || WITH_SWAP */
 
 #define DEBUG 0
 #if DEBUG
@@ -137,104 +159,98 @@ uint8_t queuebuf_len, queuebuf_max_len;
 
 #if WITH_SWAP
 /*---------------------------------------------------------------------------*/
-static void
-qbuf_renew_file(int file)
+static int
+swap_slot_alloc(void)
 {
-  int ret;
-  char name[2];
-  name[0] = 'a' + file;
-  name[1] = '\0';
-  if(qbuf_files[file].renewable == 1) {
-    PRINTF("qbuf_renew_file: removing file %d\n", file);
-    cfs_remove(name);
-  }
-  ret = cfs_open(name, CFS_READ | CFS_WRITE);
-  if(ret == -1) {
-    PRINTF("qbuf_renew_file: cfs open error\n");
+  uint16_t i;
+  uint16_t slot;
+
+  for(i = 0; i < QUEUEBUF_SWAP_SLOTS; i++) {
+    slot = (swap_next + i) % QUEUEBUF_SWAP_SLOTS;
+    if(!(swap_used[slot / 8] & (1 << (slot % 8)))) {
+      swap_used[slot / 8] |= 1 << (slot % 8);
+      swap_next = (slot + 1) % QUEUEBUF_SWAP_SLOTS;
+      return slot;
+    }
   }
-  qbuf_files[file].fd = ret;
-  qbuf_files[file].usage = 0;
-  qbuf_files[file].renewable = 0;
+  PRINTF("queuebuf: the swap is full\n");
+  return -1;
 }
 /*---------------------------------------------------------------------------*/
-/* Renews every file with renewable flag set */
 static void
-qbuf_renew_all(void *unused)
+swap_slot_free(int slot)
 {
-  int i;
-  for(i=0; i<NQBUF_FILES; i++) {
-    if(qbuf_files[i].renewable == 1) {
-      qbuf_renew_file(i);
-    }
+  if(slot >= 0) {
+    swap_used[slot / 8] &= ~(1 << (slot % 8));
   }
 }
 /*---------------------------------------------------------------------------*/
-/* Removes a queuebuf from its swap file */
-static void
-queuebuf_remove_from_file(int swap_id)
-{
-  int fileid;
-  if(swap_id != -1) {
-    fileid = swap_id / NQBUF_PER_FILE;
-    qbuf_files[fileid].usage--;
-
-    /* The file is full but doesn't contain any more queuebuf, mark it as renewable */
-    if(qbuf_files[fileid].usage == 0 && fileid != next_swap_id / NQBUF_PER_FILE) {
-      qbuf_files[fileid].renewable = 1;
-      /* This file is renewable, set a timer to renew files */
-      ctimer_set(&renew_timer, 0, qbuf_renew_all, NULL);
-    }
-
-    if(tmpdata_qbuf->swap_id == swap_id) {
-      tmpdata_qbuf->swap_id = -1;
-    }
+static int
+swap_write(int slot, const struct queuebuf_data *data)
+{
+  if(cfs_seek(swap_fd, (cfs_offset_t)slot * SWAP_SLOT_SIZE, CFS_SEEK_SET) ==
+     (cfs_offset_t)-1 ||
+     cfs_write(swap_fd, data, SWAP_SLOT_SIZE) != SWAP_SLOT_SIZE) {
+    PRINTF("queuebuf: cfs write error in slot %d\n", slot);
+    return -1;
   }
+  return 0;
 }
 /*---------------------------------------------------------------------------*/
 static int
-get_new_swap_id(void)
-{
-  int fileid;
-  int swap_id = next_swap_id;
-  fileid = swap_id / NQBUF_PER_FILE;
-  if(swap_id % NQBUF_PER_FILE == 0) { /* This is the first id in the file */
-    if(qbuf_files[fileid].renewable) {
-      qbuf_renew_file(fileid);
-    }
-    if(qbuf_files[fileid].usage>0) {
-      return -1;
+swap_read(int slot, struct queuebuf_data *data)
+{
+  if(cfs_seek(swap_fd, (cfs_offset_t)slot * SWAP_SLOT_SIZE, CFS_SEEK_SET) ==
+     (cfs_offset_t)-1 ||
+     cfs_read(swap_fd, data, SWAP_SLOT_SIZE) != SWAP_SLOT_SIZE) {
+    PRINTF("queuebuf: cfs read error in slot %d\n", slot);
+    return -1;
+  }
+  return 0;
+}
+/*---------------------------------------------------------------------------*/
+/* Creates the swap file with all of its slots */
+static void
+swap_init(void)
+{
+  int i;
+
+  if(swap_fd >= 0) {
+    cfs_close(swap_fd);
+  }
+  cfs_remove(QUEUEBUF_SWAP_FILE);
+  swap_fd = cfs_open(QUEUEBUF_SWAP_FILE, CFS_READ | CFS_WRITE);
+  if(swap_fd < 0) {
+    PRINTF("queuebuf: cfs open error\n");
+  }
+
+  memset(&tmpdata, 0, sizeof(tmpdata));
+  for(i = 0; i < QUEUEBUF_SWAP_SLOTS; i++) {
+    if(swap_write(i, &tmpdata) < 0) {
+      break;
     }
   }
-  qbuf_files[fileid].usage++;
-  next_swap_id = (next_swap_id+1) % NQBUF_ID;
-  return swap_id;
+
+  memset(swap_used, 0, sizeof(swap_used));
+  swap_next = 0;
+  tmpdata_qbuf = NULL;
+  list_init(queuebuf_list);
+
+  process_start(&queuebuf_swap_process, NULL);
 }
 /*---------------------------------------------------------------------------*/
-/* Flush tmpdata to CFS */
+/* Flush tmpdata to the slot of its queuebuf */
 static int
 queuebuf_flush_tmpdata(void)
 {
-  int fileid, fd, ret;
-  cfs_offset_t offset;
   if(tmpdata_qbuf) {
-    queuebuf_remove_from_file(tmpdata_qbuf->swap_id);
-    tmpdata_qbuf->swap_id = get_new_swap_id();
-    if(tmpdata_qbuf->swap_id == -1) {
-      return -1;
-    }
-    fileid = tmpdata_qbuf->swap_id / NQBUF_PER_FILE;
-    offset = (tmpdata_qbuf->swap_id % NQBUF_PER_FILE) * sizeof(struct queuebuf_data);
-    fd = qbuf_files[fileid].fd;
-    ret = cfs_seek(fd, offset, CFS_SEEK_SET);
-    if(ret == -1) {
-      PRINTF("queuebuf_flush_tmpdata: cfs seek error\n");
-      return -1;
-    }
-    ret = cfs_write(fd, &tmpdata, sizeof(struct queuebuf_data));
-    if(ret == -1) {
-      PRINTF("queuebuf_flush_tmpdata: cfs write error\n");
-      return -1;
+    if(tmpdata_qbuf->swap_slot < 0) {
+      tmpdata_qbuf->swap_slot = swap_slot_alloc();
+      if(tmpdata_qbuf->swap_slot < 0) {
+        return -1;
+      }
     }
+    return swap_write(tmpdata_qbuf->swap_slot, &tmpdata);
   }
   return 0;
 }
@@ -243,30 +259,108 @@ queuebuf_flush_tmpdata(void)
 static struct queuebuf_data *
 queuebuf_load_to_ram(struct queuebuf *b)
 {
-  int fileid, fd, ret;
-  cfs_offset_t offset;
-  if(b->location == IN_RAM) { /* the qbuf is loacted in RAM */
+  if(b->ram_ptr != NULL) { /* the qbuf is located in RAM */
     return b->ram_ptr;
-  } else { /* the qbuf is located in CFS */
-    if(tmpdata_qbuf && tmpdata_qbuf->swap_id == b->swap_id) { /* the qbuf is already in tmpdata */
-      return &tmpdata;
-    } else { /* the qbuf needs to be loaded from CFS */
-      tmpdata_qbuf = b;
-      /* read the qbuf from CFS */
-      fileid = b->swap_id / NQBUF_PER_FILE;
-      offset = (b->swap_id % NQBUF_PER_FILE) * sizeof(struct queuebuf_data);
-      fd = qbuf_files[fileid].fd;
-      ret = cfs_seek(fd, offset, CFS_SEEK_SET);
-      if(ret == -1) {
-        PRINTF("queuebuf_load_to_ram: cfs seek error\n");
-      }
-      ret = cfs_read(fd, &tmpdata, sizeof(struct queuebuf_data));
-      if(ret == -1) {
-        PRINTF("queuebuf_load_to_ram: cfs read error\n");
+  }
+  if(tmpdata_qbuf != b) { /* the qbuf needs to be loaded from CFS */
+    tmpdata_qbuf = b;
+    swap_read(b->swap_slot, &tmpdata);
+  }
+  return &tmpdata;
+}
+/*---------------------------------------------------------------------------*/
+/* Writes the payload of a queuebuf that may be swapped and that is not
+   about to be sent to CFS, and returns the RAM buffer it used */
+static struct queuebuf_data *
+swap_out(void)
+{
+  struct queuebuf *b;
+  struct queuebuf_data *data;
+  int_master_status_t status;
+  int slot;
+
+  for(b = list_head(queuebuf_list); b != NULL; b = list_item_next(b)) {
+    if(b->ram_ptr != NULL && b->may_swap && !b->hot) {
+      break;
+    }
+  }
+  if(b == NULL) {
+    return NULL;
+  }
+
+  slot = swap_slot_alloc();
+  if(slot < 0) {
+    return NULL;
+  }
+  if(swap_write(slot, b->ram_ptr) < 0) {
+    swap_slot_free(slot);
+    return NULL;
+  }
+
+  /* The queuebuf may have been prefetched by an interrupt meanwhile */
+  status = critical_enter();
+  if(b->hot) {
+    critical_exit(status);
+    swap_slot_free(slot);
+    return NULL;
+  }
+  data = b->ram_ptr;
+  b->ram_ptr = NULL;
+  critical_exit(status);
+  b->swap_slot = slot;
+
+  PRINTF("queuebuf: swapped out %p to slot %d\n", b, slot);
+  return data;
+}
+/*---------------------------------------------------------------------------*/
+/* Reads the payload of a queuebuf from CFS to a RAM buffer */
+static void
+swap_in(struct queuebuf *b)
+{
+  struct queuebuf_data *data;
+
+  data = memb_alloc(&buframmem);
+  if(data == NULL) {
+    data = swap_out();
+    if(data == NULL) {
+      return;
+    }
+  }
+
+  if(tmpdata_qbuf == b) {
+    memcpy(data, &tmpdata, sizeof(tmpdata));
+    tmpdata_qbuf = NULL;
+  } else if(swap_read(b->swap_slot, data) < 0) {
+    memb_free(&buframmem, data);
+    return;
+  }
+
+  swap_slot_free(b->swap_slot);
+  b->swap_slot = -1;
+  /* The payload is visible to interrupts from now on */
+  b->ram_ptr = data;
+
+  PRINTF("queuebuf: swapped in %p\n", b);
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(queuebuf_swap_process, ev, data)
+{
+  struct queuebuf *b;
+
+  PROCESS_BEGIN();
+
+  while(1) {
+    PROCESS_YIELD_UNTIL(ev == PROCESS_EVENT_POLL);
+
+    /* Bring the payloads about to be sent to RAM */
+    for(b = list_head(queuebuf_list); b != NULL; b = list_item_next(b)) {
+      if(b->hot && b->ram_ptr == NULL) {
+        swap_in(b);
       }
-      return &tmpdata;
     }
   }
+
+  PROCESS_END();
 }
 #else /* WITH_SWAP */
 /*---------------------------------------------------------------------------*/
@@ -277,18 +371,111 @@ queuebuf_load_to_ram(struct queuebuf *b)
 }
 #endif /* WITH_SWAP */
 /*---------------------------------------------------------------------------*/
+#if QUEUEBUF_SHARED_DATA
+#define queuebuf_attrs(b) ((b)->attrs)
+#define queuebuf_addrs(b) ((b)->addrs)
+/*---------------------------------------------------------------------------*/
+/* Hashes the content of the packetbuf, to speed up the lookup */
+static uint16_t
+packetbuf_hash(void)
+{
+  const uint8_t *p;
+  uint16_t hash;
+  uint16_t i;
+
+  hash = packetbuf_totlen();
+  p = packetbuf_hdrptr();
+  for(i = 0; i < packetbuf_hdrlen(); i++) {
+    hash = (hash << 5) + hash + p[i];
+  }
+  p = packetbuf_dataptr();
+  for(i = 0; i < packetbuf_datalen(); i++) {
+    hash = (hash << 5) + hash + p[i];
+  }
+  return hash;
+}
+/*---------------------------------------------------------------------------*/
+/* Returns a payload in RAM identical to the packetbuf, if any */
+static struct queuebuf_data *
+shared_data_lookup(uint16_t hash)
+{
+  struct queuebuf_data *data;
+  uint8_t hdrlen = packetbuf_hdrlen();
+
+  for(data = list_head(shared_data_list); data != NULL;
+      data = list_item_next(data)) {
+    if(data->hash == hash
+       && data->refcount < 0xff
+       && data->len == packetbuf_totlen()
+       && memcmp(data->data, packetbuf_hdrptr(), hdrlen) == 0
+       && memcmp(data->data + hdrlen, packetbuf_dataptr(),
+                 packetbuf_datalen()) == 0) {
+      return data;
+    }
+  }
+  return NULL;
+}
+/*---------------------------------------------------------------------------*/
+/* Allocates a payload with a single reference */
+static struct queuebuf_data *
+shared_data_alloc(void)
+{
+  struct queuebuf_data *data;
+
+  data = memb_alloc(&buframmem);
+  if(data != NULL) {
+    data->refcount = 1;
+    list_add(shared_data_list, data);
+  }
+  return data;
+}
+/*---------------------------------------------------------------------------*/
+/* Releases a reference to a payload */
+static void
+shared_data_release(struct queuebuf_data *data)
+{
+  if(--data->refcount == 0) {
+    list_remove(shared_data_list, data);
+    memb_free(&buframmem, data);
+  }
+}
+/*---------------------------------------------------------------------------*/
+/* Gives the queuebuf a payload of its own before it gets modified */
+static int
+shared_data_detach(struct queuebuf *b)
+{
+  struct queuebuf_data *data;
+
+  if(b->ram_ptr->refcount > 1) {
+    data = shared_data_alloc();
+    if(data == NULL) {
+      PRINTF("queuebuf: could not copy shared data\n");
+      return 0;
+    }
+    memcpy(data->data, b->ram_ptr->data, b->ram_ptr->len);
+    data->len = b->ram_ptr->len;
+    data->hash = b->ram_ptr->hash;
+    b->ram_ptr->refcount--;
+    b->ram_ptr = data;
+  }
+  return 1;
+}
+#else /* QUEUEBUF_SHARED_DATA */
+#define queuebuf_attrs(b) (queuebuf_load_to_ram(b)->attrs)
+#define queuebuf_addrs(b) (queuebuf_load_to_ram(b)->addrs)
+#endif /* QUEUEBUF_SHARED_DATA */
+/*---------------------------------------------------------------------------*/
 void
 queuebuf_init(void)
 {
 #if WITH_SWAP
-  int i;
-  for(i=0; i<NQBUF_FILES; i++) {
-    qbuf_files[i].renewable = 1;
-    qbuf_renew_file(i);
-  }
+  swap_init();
 #endif
   memb_init(&buframmem);
   memb_init(&bufmem);
+#if QUEUEBUF_SHARED_DATA
+  list_init(shared_data_list);
+#endif /* QUEUEBUF_SHARED_DATA */
 #if QUEUEBUF_STATS
   queuebuf_max_len = 0;
 #endif /* QUEUEBUF_STATS */
@@ -297,7 +484,12 @@ queuebuf_init(void)
 int
 queuebuf_numfree(void)
 {
+#if QUEUEBUF_SHARED_DATA
+  /* A queuebuf with a payload of its own needs both structures */
+  return MIN(memb_numfree(&bufmem), memb_numfree(&buframmem));
+#else /* QUEUEBUF_SHARED_DATA */
   return memb_numfree(&bufmem);
+#endif /* QUEUEBUF_SHARED_DATA */
 }
 /*---------------------------------------------------------------------------*/
 #if QUEUEBUF_DEBUG
@@ -309,27 +501,56 @@ queuebuf_new_from_packetbuf(void)
 #endif /* QUEUEBUF_DEBUG */
 {
   struct queuebuf *buf;
-
+#if QUEUEBUF_SHARED_DATA
+  uint16_t hash;
+#else /* QUEUEBUF_SHARED_DATA */
   struct queuebuf_data *buframptr;
+#endif /* QUEUEBUF_SHARED_DATA */
+
   buf = memb_alloc(&bufmem);
   if(buf != NULL) {
 #if QUEUEBUF_DEBUG
-    list_add(queuebuf_list, buf);
     buf->file = file;
     buf->line = line;
     buf->time = clock_time();
 #endif /* QUEUEBUF_DEBUG */
+#if QUEUEBUF_SHARED_DATA
+    hash = packetbuf_hash();
+    buf->ram_ptr = shared_data_lookup(hash);
+    if(buf->ram_ptr != NULL) {
+      /* Share the payload, only the attributes are copied */
+      buf->ram_ptr->refcount++;
+    } else {
+      buf->ram_ptr = shared_data_alloc();
+      if(buf->ram_ptr == NULL) {
+        PRINTF("queuebuf_new_from_packetbuf: could not queuebuf data\n");
+        memb_free(&bufmem, buf);
+        return NULL;
+      }
+      buf->ram_ptr->len = packetbuf_copyto(buf->ram_ptr->data);
+      buf->ram_ptr->hash = hash;
+    }
+    packetbuf_attr_copyto(buf->attrs, buf->addrs);
+#else /* QUEUEBUF_SHARED_DATA */
     buf->ram_ptr = memb_alloc(&buframmem);
 #if WITH_SWAP
-    /* If the allocation failed, store the qbuf in swap files */
+    buf->swap_slot = -1;
+    buf->may_swap = swap_policy;
+    buf->hot = 0;
+    if(buf->ram_ptr == NULL && !buf->may_swap) {
+      /* Make room in RAM for a payload that may not be swapped */
+      buf->ram_ptr = swap_out();
+    }
     if(buf->ram_ptr != NULL) {
-      buf->location = IN_RAM;
       buframptr = buf->ram_ptr;
-    } else {
-      buf->location = IN_CFS;
-      buf->swap_id = -1;
+    } else if(buf->may_swap) {
+      /* Store the qbuf in the swap file */
       tmpdata_qbuf = buf;
       buframptr = &tmpdata;
+    } else {
+      PRINTF("queuebuf_new_from_packetbuf: could not queuebuf data\n");
+      memb_free(&bufmem, buf);
+      return NULL;
     }
 #else
     if(buf->ram_ptr == NULL) {
@@ -344,14 +565,19 @@ queuebuf_new_from_packetbuf(void)
     packetbuf_attr_copyto(buframptr->attrs, buframptr->addrs);
 
 #if WITH_SWAP
-    if(buf->location == IN_CFS) {
+    if(buf->ram_ptr == NULL) {
       if(queuebuf_flush_tmpdata() == -1) {
         /* We were unable to write the data in the swap */
+        tmpdata_qbuf = NULL;
         memb_free(&bufmem, buf);
         return NULL;
       }
     }
 #endif
+#endif /* QUEUEBUF_SHARED_DATA */
+#if QUEUEBUF_DEBUG || WITH_SWAP
+    list_add(queuebuf_list, buf);
+#endif /* QUEUEBUF_DEBUG || WITH_SWAP */
 
 #if QUEUEBUF_STATS
     ++queuebuf_len;
@@ -370,10 +596,9 @@ queuebuf_new_from_packetbuf(void)
 void
 queuebuf_update_attr_from_packetbuf(struct queuebuf *buf)
 {
-  struct queuebuf_data *buframptr = queuebuf_load_to_ram(buf);
-  packetbuf_attr_copyto(buframptr->attrs, buframptr->addrs);
+  packetbuf_attr_copyto(queuebuf_attrs(buf), queuebuf_addrs(buf));
 #if WITH_SWAP
-  if(buf->location == IN_CFS) {
+  if(buf->ram_ptr == NULL) {
     queuebuf_flush_tmpdata();
   }
 #endif
@@ -382,11 +607,20 @@ queuebuf_update_attr_from_packetbuf(struct queuebuf *buf)
 void
 queuebuf_update_from_packetbuf(struct queuebuf *buf)
 {
-  struct queuebuf_data *buframptr = queuebuf_load_to_ram(buf);
-  packetbuf_attr_copyto(buframptr->attrs, buframptr->addrs);
+  struct queuebuf_data *buframptr;
+#if QUEUEBUF_SHARED_DATA
+  if(!shared_data_detach(buf)) {
+    return;
+  }
+#endif /* QUEUEBUF_SHARED_DATA */
+  buframptr = queuebuf_load_to_ram(buf);
+  packetbuf_attr_copyto(queuebuf_attrs(buf), queuebuf_addrs(buf));
   buframptr->len = packetbuf_copyto(buframptr->data);
+#if QUEUEBUF_SHARED_DATA
+  buframptr->hash = packetbuf_hash();
+#endif /* QUEUEBUF_SHARED_DATA */
 #if WITH_SWAP
-  if(buf->location == IN_CFS) {
+  if(buf->ram_ptr == NULL) {
     queuebuf_flush_tmpdata();
   }
 #endif
@@ -397,11 +631,18 @@ queuebuf_free(struct queuebuf *buf)
 {
   if(memb_inmemb(&bufmem, buf)) {
 #if WITH_SWAP
-    if(buf->location == IN_RAM) {
+    if(buf->ram_ptr != NULL) {
       memb_free(&buframmem, buf->ram_ptr);
+      /* A payload waiting in CFS may be brought to RAM */
+      process_poll(&queuebuf_swap_process);
     } else {
-      queuebuf_remove_from_file(buf->swap_id);
+      swap_slot_free(buf->swap_slot);
+      if(tmpdata_qbuf == buf) {
+        tmpdata_qbuf = NULL;
+      }
     }
+#elif QUEUEBUF_SHARED_DATA
+    shared_data_release(buf->ram_ptr);
 #else
     memb_free(&buframmem, buf->ram_ptr);
 #endif
@@ -410,9 +651,9 @@ queuebuf_free(struct queuebuf *buf)
     --queuebuf_len;
     PRINTF("#A q=%d\n", queuebuf_len);
 #endif /* QUEUEBUF_STATS */
-#if QUEUEBUF_DEBUG
+#if QUEUEBUF_DEBUG || WITH_SWAP
     list_remove(queuebuf_list, buf);
-#endif /* QUEUEBUF_DEBUG */
+#endif /* QUEUEBUF_DEBUG || WITH_SWAP */
   }
 }
 /*---------------------------------------------------------------------------*/
@@ -422,7 +663,7 @@ queuebuf_to_packetbuf(struct queuebuf *b)
   if(memb_inmemb(&bufmem, b)) {
     struct queuebuf_data *buframptr = queuebuf_load_to_ram(b);
     packetbuf_copyfrom(buframptr->data, buframptr->len);
-    packetbuf_attr_copyfrom(buframptr->attrs, buframptr->addrs);
+    packetbuf_attr_copyfrom(queuebuf_attrs(b), queuebuf_addrs(b));
   }
 }
 /*---------------------------------------------------------------------------*/
@@ -446,26 +687,54 @@ queuebuf_datalen(struct queuebuf *b)
 linkaddr_t *
 queuebuf_addr(struct queuebuf *b, uint8_t type)
 {
-  struct queuebuf_data *buframptr = queuebuf_load_to_ram(b);
-  return &buframptr->addrs[type - PACKETBUF_ADDR_FIRST].addr;
+  return &queuebuf_addrs(b)[type - PACKETBUF_ADDR_FIRST].addr;
 }
 /*---------------------------------------------------------------------------*/
 packetbuf_attr_t
 queuebuf_attr(struct queuebuf *b, uint8_t type)
 {
-  struct queuebuf_data *buframptr = queuebuf_load_to_ram(b);
-  return buframptr->attrs[type].val;
+  return queuebuf_attrs(b)[type].val;
 }
 /*---------------------------------------------------------------------------*/
 #if BUILD_WITH_SDN_ORCHESTRA_CENTRALIZED
 void queuebuf_set_attr(struct queuebuf *b, uint8_t type, const packetbuf_attr_t val)
 {
-  struct queuebuf_data *buframptr = queuebuf_load_to_ram(b);
-  buframptr->attrs[type].val = val;
+  queuebuf_attrs(b)[type].val = val;
   // return packetbuf_set_attr(type, val);
 }
 #endif /* BUILD_WITH_SDN_ORCHESTRA_CENTRALIZED */
 /*---------------------------------------------------------------------------*/
+#if WITH_SWAP
+void
+queuebuf_set_swap_policy(uint8_t policy)
+{
+  swap_policy = policy;
+}
+/*---------------------------------------------------------------------------*/
+int
+queuebuf_in_ram(struct queuebuf *b)
+{
+  return b->ram_ptr != NULL;
+}
+/*---------------------------------------------------------------------------*/
+void
+queuebuf_prefetch(struct queuebuf *b)
+{
+  b->hot = 1;
+  if(b->ram_ptr == NULL) {
+    process_poll(&queuebuf_swap_process);
+  }
+}
+#endif /* WITH_SWAP */
+/*---------------------------------------------------------------------------*/
+#if QUEUEBUF_SHARED_DATA
+int
+queuebuf_is_shared(struct queuebuf *b)
+{
+  return b->ram_ptr->refcount > 1;
+}
+#endif /* QUEUEBUF_SHARED_DATA */
+/*---------------------------------------------------------------------------*/
 void
 queuebuf_debug_print(void)
 {
@@ -85,6 +85,65 @@
   #define WITH_SWAP 0
 #endif /* QUEUEBUFRAM_CONF_NUM */
 
+/* With swapping, the payloads that do not fit in RAM are stored in
+   QUEUEBUF_SWAP_SLOTS slots of a single CFS file, which is allocated
+   once by queuebuf_init() and used as a ring. The handle of a
+   queuebuf stays in RAM, so queuebuf_in_ram() can be called from
+   interrupts. queuebuf_prefetch() marks a queuebuf as about to be
+   sent, which keeps its payload in RAM, and asks the queuebuf swap
+   process to read it back from CFS if needed. That process may write
+   the payload of a queuebuf that is not about to be sent to CFS in
+   exchange. A MAC layer with strict timing should only access the
+   payloads that are in RAM: the others are read from CFS on access. */
+#if WITH_SWAP
+  #ifdef QUEUEBUF_CONF_SWAP_SLOTS
+    #define QUEUEBUF_SWAP_SLOTS QUEUEBUF_CONF_SWAP_SLOTS
+  #else /* QUEUEBUF_CONF_SWAP_SLOTS */
+    #define QUEUEBUF_SWAP_SLOTS QUEUEBUF_NUM
+  #endif /* QUEUEBUF_CONF_SWAP_SLOTS */
+  #ifdef QUEUEBUF_CONF_SWAP_FILE
+    #define QUEUEBUF_SWAP_FILE QUEUEBUF_CONF_SWAP_FILE
+  #else /* QUEUEBUF_CONF_SWAP_FILE */
+    #define QUEUEBUF_SWAP_FILE "qbuf"
+  #endif /* QUEUEBUF_CONF_SWAP_FILE */
+#endif /* WITH_SWAP */
+
+/* Swap policies of the queuebufs, as set by queuebuf_set_swap_policy()
+   for a queue before adding packets to it. The payload of a queuebuf
+   with QUEUEBUF_SWAP_NEVER is kept in RAM, if needed by swapping out
+   the payload of another queuebuf. */
+#define QUEUEBUF_SWAP_NEVER 0
+#define QUEUEBUF_SWAP_ALLOWED 1
+
+/* QUEUEBUF_SHARED_DATA enables reference-counted payloads. A queuebuf
+   created from a packetbuf whose content is identical to that of a
+   queuebuf in RAM (e.g. the same frame queued for several neighbors)
+   shares its payload, and only holds its own attributes. A shared
+   payload is copied when updated through
+   queuebuf_update_from_packetbuf(). The payload returned by
+   queuebuf_dataptr() must not be modified while queuebuf_is_shared()
+   is true; a caller that changes a frame in place works on a copy.
+   QUEUEBUF_SHARED_NUM queuebufs are available in addition to
+   QUEUEBUF_NUM, to point to shared payloads. */
+#ifdef QUEUEBUF_CONF_SHARED_DATA
+#define QUEUEBUF_SHARED_DATA QUEUEBUF_CONF_SHARED_DATA
+#else /* QUEUEBUF_CONF_SHARED_DATA */
+#define QUEUEBUF_SHARED_DATA 0
+#endif /* QUEUEBUF_CONF_SHARED_DATA */
+
+#if QUEUEBUF_SHARED_DATA
+  #if WITH_SWAP
+    #error "QUEUEBUF_CONF_SHARED_DATA cannot be used with swapping"
+  #endif
+  #ifdef QUEUEBUF_CONF_SHARED_NUM
+    #define QUEUEBUF_SHARED_NUM QUEUEBUF_CONF_SHARED_NUM
+  #else /* QUEUEBUF_CONF_SHARED_NUM */
+    #define QUEUEBUF_SHARED_NUM QUEUEBUF_NUM
+  #endif /* QUEUEBUF_CONF_SHARED_NUM */
+#else /* QUEUEBUF_SHARED_DATA */
+  #define QUEUEBUF_SHARED_NUM 0
+#endif /* QUEUEBUF_SHARED_DATA */
+
 #ifdef QUEUEBUF_CONF_DEBUG
 #define QUEUEBUF_DEBUG QUEUEBUF_CONF_DEBUG
 #else /* QUEUEBUF_CONF_DEBUG */
@@ -119,6 +178,22 @@ void queuebuf_set_attr(struct queuebuf *b, uint8_t type, const packetbuf_attr_t
 
 void queuebuf_debug_print(void);
 
+#if WITH_SWAP
+void queuebuf_set_swap_policy(uint8_t policy);
+int queuebuf_in_ram(struct queuebuf *b);
+void queuebuf_prefetch(struct queuebuf *b);
+#else /* WITH_SWAP */
+#define queuebuf_set_swap_policy(policy)
+#define queuebuf_in_ram(b) 1
+#define queuebuf_prefetch(b)
+#endif /* WITH_SWAP */
+
+#if QUEUEBUF_SHARED_DATA
+int queuebuf_is_shared(struct queuebuf *b);
+#else /* QUEUEBUF_SHARED_DATA */
+#define queuebuf_is_shared(b) 0
+#endif /* QUEUEBUF_SHARED_DATA */
+
 int queuebuf_numfree(void);
 
 #endif /* __QUEUEBUF_H__ */
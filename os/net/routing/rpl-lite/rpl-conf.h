@@ -326,6 +326,37 @@
 #define RPL_DAO_RETRANSMISSION_TIMEOUT    (5 * CLOCK_SECOND)
 #endif /* RPL_CONF_DAO_RETRANSMISSION_TIMEOUT */
 
+/*
+ * DAO aggregation, for non-storing mode. When enabled, nodes send their DAOs
+ * to their preferred parent rather than to the root. Each node holds the
+ * targets it receives from its sub-DODAG for RPL_DAO_AGGREGATION_DELAY, and
+ * forwards them upwards together with its own target, in a single
+ * multi-target DAO. DAO-ACKs are fanned out back down to the children. The
+ * root processes each multi-target DAO as one batch of source routing links.
+ * All nodes of a DODAG must use the same setting. Note that the delay adds up
+ * at every hop, and must remain well below RPL_DAO_RETRANSMISSION_TIMEOUT
+ * for the deepest nodes.
+ */
+#ifdef RPL_CONF_WITH_DAO_AGGREGATION
+#define RPL_WITH_DAO_AGGREGATION RPL_CONF_WITH_DAO_AGGREGATION
+#else /* RPL_CONF_WITH_DAO_AGGREGATION */
+#define RPL_WITH_DAO_AGGREGATION 0
+#endif /* RPL_CONF_WITH_DAO_AGGREGATION */
+
+/* The time a node holds the targets from its sub-DODAG before forwarding */
+#ifdef RPL_CONF_DAO_AGGREGATION_DELAY
+#define RPL_DAO_AGGREGATION_DELAY RPL_CONF_DAO_AGGREGATION_DELAY
+#else /* RPL_CONF_DAO_AGGREGATION_DELAY */
+#define RPL_DAO_AGGREGATION_DELAY (CLOCK_SECOND / 2)
+#endif /* RPL_CONF_DAO_AGGREGATION_DELAY */
+
+/* The maximum number of targets from the sub-DODAG held by a node */
+#ifdef RPL_CONF_DAO_AGGREGATION_MAX_TARGETS
+#define RPL_DAO_AGGREGATION_MAX_TARGETS RPL_CONF_DAO_AGGREGATION_MAX_TARGETS
+#else /* RPL_CONF_DAO_AGGREGATION_MAX_TARGETS */
+#define RPL_DAO_AGGREGATION_MAX_TARGETS 8
+#endif /* RPL_CONF_DAO_AGGREGATION_MAX_TARGETS */
+
 /******************************************************************************/
 /************************** More parameterization *****************************/
 /******************************************************************************/
@@ -406,6 +437,18 @@
 #define RPL_LOOP_ERROR_DROP 0
 #endif /* RPL_CONF_LOOP_ERROR_DROP */
 
+/* Set to 1 to keep parent candidates in a list ordered by path cost, with
+ * the OF results cached per neighbor. Neighbors are re-evaluated lazily, only
+ * after a DIO or a link-stats update concerning them, instead of recomputing
+ * the OF for the whole neighbor table at every parent selection. This makes
+ * DIO processing cheaper in dense networks, at the cost of a few bytes per
+ * neighbor. */
+#ifdef RPL_CONF_INCREMENTAL_PARENT_SET
+#define RPL_INCREMENTAL_PARENT_SET RPL_CONF_INCREMENTAL_PARENT_SET
+#else /* RPL_CONF_INCREMENTAL_PARENT_SET */
+#define RPL_INCREMENTAL_PARENT_SET 0
+#endif /* RPL_CONF_INCREMENTAL_PARENT_SET */
+
 /** @} */
 
 #endif /* RPL_CONF_H */
@@ -102,6 +102,12 @@ rpl_dag_leave(void)
   LOG_INFO_6ADDR(&curr_instance.dag.dag_id);
   LOG_INFO_(", instance %u\n", curr_instance.instance_id);
 
+#if RPL_WITH_DAO_AGGREGATION
+  /* Drop the targets held for our sub-DODAG, which the No-path DAO must
+   * not advertise again */
+  rpl_dao_aggregation_reset();
+#endif /* RPL_WITH_DAO_AGGREGATION */
+
   /* Issue a no-path DAO */
   if(!rpl_dag_root_is_root()) {
     RPL_LOLLIPOP_INCREMENT(curr_instance.dag.dao_last_seqno);
@@ -138,6 +144,10 @@ void
 rpl_dag_periodic(unsigned seconds)
 {
   if(curr_instance.used) {
+    /* Refresh the cached OF results once in a while, to catch link metric
+     * changes that were not notified through rpl_link_callback */
+    rpl_neighbor_mark_all_dirty();
+
     if(curr_instance.dag.lifetime != RPL_LIFETIME(RPL_INFINITE_LIFETIME)) {
       curr_instance.dag.lifetime =
         curr_instance.dag.lifetime > seconds ? curr_instance.dag.lifetime - seconds : 0;
@@ -393,6 +403,7 @@ update_nbr_from_dio(uip_ipaddr_t *from, rpl_dio_t *dio)
 #if RPL_WITH_MC
   memcpy(&nbr->mc, &dio->mc, sizeof(nbr->mc));
 #endif /* RPL_WITH_MC */
+  rpl_neighbor_mark_dirty(nbr);
 
   return nbr;
 }
@@ -515,6 +526,9 @@ init_dag(uint8_t instance_id, uip_ipaddr_t *dag_id, rpl_ocp_t ocp,
   curr_instance.dag.dao_last_seqno = RPL_LOLLIPOP_INIT;
   memcpy(&curr_instance.dag.dag_id, dag_id, sizeof(curr_instance.dag.dag_id));
 
+  /* Cached OF results, if any, are stale with a new instance */
+  rpl_neighbor_mark_all_dirty();
+
   return 1;
 }
 /*---------------------------------------------------------------------------*/
@@ -632,6 +646,29 @@ rpl_process_dis(uip_ipaddr_t *from, int is_multicast)
 void
 rpl_process_dao(uip_ipaddr_t *from, rpl_dao_t *dao)
 {
+#if RPL_WITH_DAO_AGGREGATION
+  static uip_sr_update_t updates[RPL_DAO_AGGREGATION_MAX_TARGETS + 1];
+  int i;
+
+  if(!rpl_dag_root_is_root()) {
+    /* Hold the targets, to be forwarded upwards along with others. The
+     * DAO-ACK will be sent once we receive one for the forwarding DAO. */
+    rpl_dao_aggregation_input(from, dao);
+    return;
+  }
+
+  /* DAOs come from our children, each target is the child of a link */
+  for(i = 0; i < dao->num_targets; i++) {
+    updates[i].child = &dao->targets[i].target;
+    updates[i].parent = &dao->targets[i].parent;
+    updates[i].lifetime = dao->targets[i].lifetime == 0
+      ? 0 : RPL_LIFETIME(dao->targets[i].lifetime);
+  }
+  if(uip_sr_update_nodes(NULL, updates, dao->num_targets) < dao->num_targets) {
+    LOG_ERR("failed to add links on incoming DAO\n");
+    return;
+  }
+#else /* RPL_WITH_DAO_AGGREGATION */
   if(dao->lifetime == 0) {
     uip_sr_expire_parent(NULL, from, &dao->parent_addr);
   } else {
@@ -640,6 +677,7 @@ rpl_process_dao(uip_ipaddr_t *from, rpl_dao_t *dao)
       return;
     }
   }
+#endif /* RPL_WITH_DAO_AGGREGATION */
 
 #if RPL_WITH_DAO_ACK
   if(dao->flags & RPL_DAO_K_FLAG) {
@@ -700,6 +738,7 @@ rpl_process_hbh(rpl_nbr_t *sender, uint16_t sender_rank, int loop_detected, int
      * the sender's rank from ext header */
     if(sender != NULL) {
       sender->rank = sender_rank;
+      rpl_neighbor_mark_dirty(sender);
       /* Select DAG and preferred parent. In case of a parent switch,
       the new parent will be used to forward the current packet. */
       rpl_dag_update_state();
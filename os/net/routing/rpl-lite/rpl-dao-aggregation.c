@@ -0,0 +1,252 @@
+/*
+ * Copyright (c) 2026, RISE Research Institutes of Sweden.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+/**
+ * \addtogroup rpl-lite
+ * @{
+ *
+ * \file
+ *         DAO aggregation in non-storing mode: targets from the sub-DODAG
+ *         are held for a short while and forwarded upwards in multi-target
+ *         DAOs, and the resulting DAO-ACKs are fanned out to the children.
+ */
+
+#include "contiki.h"
+#include "net/routing/rpl-lite/rpl.h"
+#include "sys/ctimer.h"
+
+#include <string.h>
+
+/* Log configuration */
+#include "sys/log.h"
+#define LOG_MODULE "RPL"
+#define LOG_LEVEL LOG_LEVEL_RPL
+
+#if RPL_WITH_DAO_AGGREGATION
+
+/* Entry flags */
+#define ENTRY_PENDING     0x01 /* Waiting to be forwarded upwards */
+#define ENTRY_SENT        0x02 /* Forwarded, waiting for the DAO-ACK */
+#define ENTRY_ACKED       0x04 /* DAO-ACK to be sent to the child */
+#define ENTRY_ACK_REQ     0x08 /* The child requested a DAO-ACK */
+
+/* A target held on behalf of a child */
+struct dao_entry {
+  rpl_dao_target_t target;
+  uip_ipaddr_t from; /* Link-local address of the child that sent the DAO */
+  uint8_t sequence; /* Sequence number of the child's DAO */
+  uint8_t forwarded_in; /* Sequence number of our DAO that carried it */
+  uint8_t status; /* DAO-ACK status to pass on to the child */
+  uint8_t flags;
+};
+
+static struct dao_entry entries[RPL_DAO_AGGREGATION_MAX_TARGETS];
+static struct ctimer hold_timer;
+#if RPL_WITH_DAO_ACK
+static struct ctimer ack_timer;
+#endif /* RPL_WITH_DAO_ACK */
+
+/*---------------------------------------------------------------------------*/
+static int
+num_pending(void)
+{
+  int i;
+  int count = 0;
+
+  for(i = 0; i < RPL_DAO_AGGREGATION_MAX_TARGETS; i++) {
+    if(entries[i].flags & ENTRY_PENDING) {
+      count++;
+    }
+  }
+  return count;
+}
+/*---------------------------------------------------------------------------*/
+static void
+handle_hold_timer(void *ptr)
+{
+  if(curr_instance.used && num_pending() > 0) {
+    /* Forward the held targets along with our own, in a new DAO */
+    rpl_timers_send_aggregated_dao();
+  }
+}
+/*---------------------------------------------------------------------------*/
+static struct dao_entry *
+get_entry(const uip_ipaddr_t *target)
+{
+  int i;
+  struct dao_entry *sent = NULL;
+
+  for(i = 0; i < RPL_DAO_AGGREGATION_MAX_TARGETS; i++) {
+    if(entries[i].flags != 0
+       && uip_ipaddr_cmp(&entries[i].target.target, target)) {
+      /* A newer DAO for the same target replaces the previous one */
+      return &entries[i];
+    }
+  }
+  for(i = 0; i < RPL_DAO_AGGREGATION_MAX_TARGETS; i++) {
+    if(entries[i].flags == 0) {
+      return &entries[i];
+    }
+    if(entries[i].flags & ENTRY_SENT) {
+      sent = &entries[i];
+    }
+  }
+  /* No free entry: reuse one still waiting for an ACK. Should the ACK never
+   * come, the child would retransmit its DAO anyway. */
+  return sent;
+}
+/*---------------------------------------------------------------------------*/
+void
+rpl_dao_aggregation_input(const uip_ipaddr_t *from, const rpl_dao_t *dao)
+{
+  int i;
+  struct dao_entry *entry;
+
+  for(i = 0; i < dao->num_targets; i++) {
+    entry = get_entry(&dao->targets[i].target);
+    if(entry == NULL) {
+      LOG_WARN("DAO aggregation: no space left for target ");
+      LOG_WARN_6ADDR(&dao->targets[i].target);
+      LOG_WARN_("\n");
+      continue;
+    }
+    memcpy(&entry->target, &dao->targets[i], sizeof(entry->target));
+    uip_ipaddr_copy(&entry->from, from);
+    entry->sequence = dao->sequence;
+    entry->flags = ENTRY_PENDING;
+    if(dao->flags & RPL_DAO_K_FLAG) {
+      entry->flags |= ENTRY_ACK_REQ;
+    }
+  }
+
+  if(num_pending() == RPL_DAO_AGGREGATION_MAX_TARGETS) {
+    /* Full, forward without waiting any longer */
+    ctimer_set(&hold_timer, 0, handle_hold_timer, NULL);
+  } else if(ctimer_expired(&hold_timer)) {
+    ctimer_set(&hold_timer, RPL_DAO_AGGREGATION_DELAY, handle_hold_timer, NULL);
+  }
+}
+/*---------------------------------------------------------------------------*/
+const rpl_dao_target_t *
+rpl_dao_aggregation_next_target(int *index, uint8_t sequence,
+                                int *ack_requested)
+{
+  struct dao_entry *entry;
+
+  for(; *index < RPL_DAO_AGGREGATION_MAX_TARGETS; (*index)++) {
+    entry = &entries[*index];
+    if(entry->flags & (ENTRY_PENDING | ENTRY_SENT)) {
+#if RPL_WITH_DAO_ACK
+      /* Held until our DAO is ACKed, to be sent again in its
+       * retransmissions, or in a newer DAO if it is never ACKed */
+      entry->flags = ENTRY_SENT | (entry->flags & ENTRY_ACK_REQ);
+      entry->forwarded_in = sequence;
+      if(entry->flags & ENTRY_ACK_REQ) {
+        *ack_requested = 1;
+      }
+#else /* RPL_WITH_DAO_ACK */
+      entry->flags = 0;
+#endif /* RPL_WITH_DAO_ACK */
+      /* The entry is not reused before the DAO is sent */
+      (*index)++;
+      return &entry->target;
+    }
+  }
+  return NULL;
+}
+/*---------------------------------------------------------------------------*/
+#if RPL_WITH_DAO_ACK
+static void
+handle_ack_timer(void *ptr)
+{
+  int i;
+  int j;
+
+  for(i = 0; i < RPL_DAO_AGGREGATION_MAX_TARGETS; i++) {
+    if(entries[i].flags & ENTRY_ACKED) {
+      /* A child that sent several targets in one DAO gets a single ACK */
+      for(j = i + 1; j < RPL_DAO_AGGREGATION_MAX_TARGETS; j++) {
+        if((entries[j].flags & ENTRY_ACKED)
+           && entries[j].sequence == entries[i].sequence
+           && uip_ipaddr_cmp(&entries[j].from, &entries[i].from)) {
+          entries[j].flags = 0;
+        }
+      }
+      entries[i].flags = 0;
+      rpl_icmp6_dao_ack_output(&entries[i].from, entries[i].sequence,
+                               entries[i].status);
+    }
+  }
+}
+#endif /* RPL_WITH_DAO_ACK */
+/*---------------------------------------------------------------------------*/
+void
+rpl_dao_aggregation_ack(uint8_t sequence, uint8_t status)
+{
+#if RPL_WITH_DAO_ACK
+  int i;
+  int fan_out = 0;
+
+  for(i = 0; i < RPL_DAO_AGGREGATION_MAX_TARGETS; i++) {
+    if((entries[i].flags & ENTRY_SENT) && entries[i].forwarded_in == sequence) {
+      if(entries[i].flags & ENTRY_ACK_REQ) {
+        entries[i].flags = ENTRY_ACKED;
+        entries[i].status = status;
+        fan_out = 1;
+      } else {
+        entries[i].flags = 0;
+      }
+    }
+  }
+
+  if(fan_out) {
+    /* Sending from here is unsafe; postpone */
+    ctimer_set(&ack_timer, 0, handle_ack_timer, NULL);
+  }
+
+  if(num_pending() > 0 && ctimer_expired(&hold_timer)) {
+    /* Targets that did not fit in the DAO */
+    ctimer_set(&hold_timer, RPL_DAO_AGGREGATION_DELAY, handle_hold_timer, NULL);
+  }
+#endif /* RPL_WITH_DAO_ACK */
+}
+/*---------------------------------------------------------------------------*/
+void
+rpl_dao_aggregation_reset(void)
+{
+  memset(entries, 0, sizeof(entries));
+  ctimer_stop(&hold_timer);
+#if RPL_WITH_DAO_ACK
+  ctimer_stop(&ack_timer);
+#endif /* RPL_WITH_DAO_ACK */
+}
+/*---------------------------------------------------------------------------*/
+#endif /* RPL_WITH_DAO_AGGREGATION */
+
+/** @}*/
@@ -0,0 +1,92 @@
+/*
+ * Copyright (c) 2026, RISE Research Institutes of Sweden.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+/**
+ * \addtogroup rpl-lite
+ * @{
+ *
+ * \file
+ *	Header file for rpl-dao-aggregation module
+ */
+
+#ifndef RPL_DAO_AGGREGATION_H
+#define RPL_DAO_AGGREGATION_H
+
+/********** Includes **********/
+
+#include "net/routing/rpl-lite/rpl.h"
+
+#if RPL_WITH_DAO_AGGREGATION
+
+/********** Public functions **********/
+
+/**
+ * Holds the targets of a DAO received from the sub-DODAG, until they are
+ * forwarded upwards. Schedules forwarding after RPL_DAO_AGGREGATION_DELAY.
+ *
+ * \param from The link-local address of the child that sent the DAO
+ * \param dao The DAO
+*/
+void rpl_dao_aggregation_input(const uip_ipaddr_t *from, const rpl_dao_t *dao);
+
+/**
+ * Returns the next target to be forwarded upwards, i.e., waiting to be
+ * forwarded or forwarded in a DAO that was not ACKed yet, and marks it as
+ * forwarded in a DAO with a given sequence number. A retransmission of a DAO
+ * thus carries the same targets again.
+ *
+ * \param index The index to start from, 0 for the first target of a DAO;
+ * updated to the index following the target returned
+ * \param sequence The sequence number of the DAO the target is added to
+ * \param ack_requested Set to 1 if the child requested a DAO-ACK
+ * \return The target, NULL if there is none left
+*/
+const rpl_dao_target_t *rpl_dao_aggregation_next_target(int *index,
+                                                        uint8_t sequence,
+                                                        int *ack_requested);
+
+/**
+ * Schedules DAO-ACKs to all children whose targets were forwarded in a DAO
+ * that was just ACKed.
+ *
+ * \param sequence The sequence number of the ACKed DAO
+ * \param status The status of the DAO-ACK, passed on to the children
+*/
+void rpl_dao_aggregation_ack(uint8_t sequence, uint8_t status);
+
+/**
+ * Drops all held targets and stops the aggregation timers
+*/
+void rpl_dao_aggregation_reset(void);
+
+#endif /* RPL_WITH_DAO_AGGREGATION */
+
+ /** @} */
+
+#endif /* RPL_DAO_AGGREGATION_H */
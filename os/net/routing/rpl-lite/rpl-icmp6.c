@@ -451,19 +451,60 @@ rpl_icmp6_dio_output(uip_ipaddr_t *uc_addr)
   uip_icmp6_send(addr, ICMP6_RPL, RPL_CODE_DIO, pos);
 }
 /*---------------------------------------------------------------------------*/
+#if RPL_WITH_DAO_AGGREGATION
+/* Length of a target option followed by a transit information option, both
+ * with a full IPv6 address */
+#define DAO_TARGET_GROUP_LEN  (4 + 16 + 6 + 16)
+/* Room for DAO options, leaving space for a RPL hop-by-hop option */
+#define DAO_MAX_PAYLOAD_LEN   (UIP_BUFSIZE - UIP_IPH_LEN - UIP_ICMPH_LEN - RPL_HOP_BY_HOP_LEN)
+/* Maximum number of targets accepted in an incoming DAO */
+#define DAO_MAX_TARGETS       (RPL_DAO_AGGREGATION_MAX_TARGETS + 1)
+
+static int
+add_dao_target(unsigned char *buffer, int pos, const rpl_dao_target_t *target)
+{
+  buffer[pos++] = RPL_OPTION_TARGET;
+  buffer[pos++] = 2 + sizeof(target->target);
+  buffer[pos++] = 0; /* reserved */
+  buffer[pos++] = sizeof(target->target) * CHAR_BIT;
+  memcpy(buffer + pos, &target->target, sizeof(target->target));
+  pos += sizeof(target->target);
+
+  buffer[pos++] = RPL_OPTION_TRANSIT;
+  buffer[pos++] = 20;
+  buffer[pos++] = 0; /* flags - ignored */
+  buffer[pos++] = 0; /* path control - ignored */
+  buffer[pos++] = 0; /* path seq - ignored */
+  buffer[pos++] = target->lifetime;
+  memcpy(buffer + pos, &target->parent, sizeof(target->parent));
+  pos += sizeof(target->parent);
+
+  return pos;
+}
+#endif /* RPL_WITH_DAO_AGGREGATION */
+/*---------------------------------------------------------------------------*/
 static void
 dao_input(void)
 {
   struct rpl_dao dao;
   uint8_t subopt_type;
   unsigned char *buffer;
-  uint8_t buffer_length;
+  uint16_t buffer_length;
   int pos;
   int len;
   int i;
   uip_ipaddr_t from;
+#if RPL_WITH_DAO_AGGREGATION
+  static rpl_dao_target_t targets[DAO_MAX_TARGETS];
+  int group_start = 0;
+  int in_transit = 0;
+  int j;
+#endif /* RPL_WITH_DAO_AGGREGATION */
 
   memset(&dao, 0, sizeof(dao));
+#if RPL_WITH_DAO_AGGREGATION
+  dao.targets = targets;
+#endif /* RPL_WITH_DAO_AGGREGATION */
 
   dao.instance_id = UIP_ICMP_PAYLOAD[0];
   if(!curr_instance.used || curr_instance.instance_id != dao.instance_id) {
@@ -511,6 +552,24 @@ dao_input(void)
         dao.prefixlen = buffer[i + 3];
         memset(&dao.prefix, 0, sizeof(dao.prefix));
         memcpy(&dao.prefix, buffer + i + 4, (dao.prefixlen + 7) / CHAR_BIT);
+#if RPL_WITH_DAO_AGGREGATION
+        /* Targets followed by transit information options form a group, all
+         * targets of a group share the same transit information */
+        if(in_transit) {
+          group_start = dao.num_targets;
+          in_transit = 0;
+        }
+        if(dao.num_targets < DAO_MAX_TARGETS) {
+          uip_ipaddr_copy(&targets[dao.num_targets].target, &dao.prefix);
+          targets[dao.num_targets].lifetime = dao.lifetime;
+          memset(&targets[dao.num_targets].parent, 0, sizeof(uip_ipaddr_t));
+          dao.num_targets++;
+        } else {
+          LOG_WARN("dao_input: too many targets, ignoring ");
+          LOG_WARN_6ADDR(&dao.prefix);
+          LOG_WARN_("\n");
+        }
+#endif /* RPL_WITH_DAO_AGGREGATION */
         break;
       case RPL_OPTION_TRANSIT:
         /* The path sequence and control are ignored. */
@@ -520,6 +579,13 @@ dao_input(void)
         if(len >= 20) {
           memcpy(&dao.parent_addr, buffer + i + 6, 16);
         }
+#if RPL_WITH_DAO_AGGREGATION
+        in_transit = 1;
+        for(j = group_start; j < dao.num_targets; j++) {
+          targets[j].lifetime = dao.lifetime;
+          uip_ipaddr_copy(&targets[j].parent, &dao.parent_addr);
+        }
+#endif /* RPL_WITH_DAO_AGGREGATION */
         break;
     }
   }
@@ -531,6 +597,9 @@ dao_input(void)
   LOG_INFO_6ADDR(&dao.prefix);
   LOG_INFO_(", prefix length %u, parent ", dao.prefixlen);
   LOG_INFO_6ADDR(&dao.parent_addr);
+#if RPL_WITH_DAO_AGGREGATION
+  LOG_INFO_(", %u targets", dao.num_targets);
+#endif /* RPL_WITH_DAO_AGGREGATION */
   LOG_INFO_(" \n");
 
   rpl_process_dao(&from, &dao);
@@ -547,6 +616,12 @@ rpl_icmp6_dao_output(uint8_t lifetime)
   int pos;
   const uip_ipaddr_t *prefix = rpl_get_global_address();
   uip_ipaddr_t *parent_ipaddr = rpl_neighbor_get_ipaddr(curr_instance.dag.preferred_parent);
+#if RPL_WITH_DAO_AGGREGATION
+  const rpl_dao_target_t *target;
+  int target_index = 0;
+  int ack_requested = 0;
+  int num_targets = 1;
+#endif /* RPL_WITH_DAO_AGGREGATION */
 
   /* Make sure we're up-to-date before sending data out */
   rpl_dag_update_state();
@@ -604,6 +679,33 @@ rpl_icmp6_dao_output(uint8_t lifetime)
   memcpy(buffer + pos, ((const unsigned char *)parent_ipaddr) + 8, 8); /* Interface identifier */
   pos += 8;
 
+#if RPL_WITH_DAO_AGGREGATION
+  /* Add the targets from our sub-DODAG that are waiting to be forwarded */
+  while(pos + DAO_TARGET_GROUP_LEN <= DAO_MAX_PAYLOAD_LEN
+        && (target = rpl_dao_aggregation_next_target(&target_index,
+                                                     curr_instance.dag.dao_last_seqno,
+                                                     &ack_requested)) != NULL) {
+    pos = add_dao_target(buffer, pos, target);
+    num_targets++;
+  }
+#if RPL_WITH_DAO_ACK
+  if(ack_requested) {
+    buffer[1] |= RPL_DAO_K_FLAG;
+  }
+#endif /* RPL_WITH_DAO_ACK */
+
+  LOG_INFO("sending a %sDAO seqno %u, tx count %u, lifetime %u, %u targets, prefix ",
+         lifetime == 0 ? "No-path " : "",
+         curr_instance.dag.dao_last_seqno, curr_instance.dag.dao_transmissions, lifetime,
+         num_targets);
+  LOG_INFO_6ADDR(prefix);
+  LOG_INFO_(" to parent ");
+  LOG_INFO_6ADDR(parent_ipaddr);
+  LOG_INFO_("\n");
+
+  /* Send DAO to the preferred parent, which aggregates it */
+  uip_icmp6_send(parent_ipaddr, ICMP6_RPL, RPL_CODE_DAO, pos);
+#else /* RPL_WITH_DAO_AGGREGATION */
   LOG_INFO("sending a %sDAO seqno %u, tx count %u, lifetime %u, prefix ",
          lifetime == 0 ? "No-path " : "",
          curr_instance.dag.dao_last_seqno, curr_instance.dag.dao_transmissions, lifetime);
@@ -616,6 +718,7 @@ rpl_icmp6_dao_output(uint8_t lifetime)
 
   /* Send DAO to root (IPv6 address is DAG ID) */
   uip_icmp6_send(&curr_instance.dag.dag_id, ICMP6_RPL, RPL_CODE_DAO, pos);
+#endif /* RPL_WITH_DAO_AGGREGATION */
 }
 #if RPL_WITH_DAO_ACK
 /*---------------------------------------------------------------------------*/
@@ -645,6 +748,10 @@ dao_ack_input(void)
   LOG_INFO_("\n");
 
   rpl_process_dao_ack(sequence, status);
+#if RPL_WITH_DAO_AGGREGATION
+  /* Pass the DAO-ACK on to the children whose targets the DAO carried */
+  rpl_dao_aggregation_ack(sequence, status);
+#endif /* RPL_WITH_DAO_AGGREGATION */
 
   discard:
     uipbuf_clear();
@@ -72,6 +72,16 @@ struct rpl_dio {
 };
 typedef struct rpl_dio rpl_dio_t;
 
+#if RPL_WITH_DAO_AGGREGATION
+/* A target of a multi-target DAO, with its transit information */
+struct rpl_dao_target {
+  uip_ipaddr_t target;
+  uip_ipaddr_t parent;
+  uint8_t lifetime;
+};
+typedef struct rpl_dao_target rpl_dao_target_t;
+#endif /* RPL_WITH_DAO_AGGREGATION */
+
 /* Logical representation of a Destination Advertisement Object (DAO.) */
 struct rpl_dao {
   uip_ipaddr_t parent_addr;
@@ -81,6 +91,11 @@ struct rpl_dao {
   uint8_t lifetime;
   uint8_t prefixlen;
   uint8_t flags;
+#if RPL_WITH_DAO_AGGREGATION
+  /* All targets of the DAO, of which prefix and parent_addr are the last */
+  rpl_dao_target_t *targets;
+  uint8_t num_targets;
+#endif /* RPL_WITH_DAO_AGGREGATION */
 };
 typedef struct rpl_dao rpl_dao_t;
 
@@ -114,7 +129,9 @@ void rpl_icmp6_dio_output(uip_ipaddr_t *uc_addr);
 
 /**
  * Creates an ICMPv6 DAO packet and sends it to the root, advertising the
- * current preferred parent, and with our global address as prefix.
+ * current preferred parent, and with our global address as prefix. With
+ * RPL_WITH_DAO_AGGREGATION, the DAO is sent to the preferred parent instead,
+ * and also carries the targets from our sub-DODAG waiting to be forwarded.
  *
  * \param lifetime The DAO lifetime. Use 0 to send a No-path DAO
 */
@@ -64,6 +64,18 @@ static rpl_nbr_t * best_parent(int fresh_only);
 /* Per-neighbor RPL information */
 NBR_TABLE_GLOBAL(rpl_nbr_t, rpl_neighbors);
 
+#if RPL_INCREMENTAL_PARENT_SET
+/* Parent set flags */
+#define RPL_NBR_PSET_VALID      0x01 /* The cached OF results were computed */
+#define RPL_NBR_PSET_DIRTY      0x02 /* Queued for re-evaluation */
+#define RPL_NBR_PSET_CANDIDATE  0x04 /* Member of the candidate list */
+
+/* Acceptable parents, by increasing cached path cost */
+static rpl_nbr_t *candidates;
+/* Neighbors whose cached OF results are outdated */
+static rpl_nbr_t *dirty_list;
+#endif /* RPL_INCREMENTAL_PARENT_SET */
+
 /*---------------------------------------------------------------------------*/
 static int
 max_acceptable_rank(void)
@@ -190,6 +202,105 @@ rpl_get_ds6_nbr(rpl_nbr_t *nbr)
 }
 #endif /* UIP_ND6_SEND_NS */
 /*---------------------------------------------------------------------------*/
+#if RPL_INCREMENTAL_PARENT_SET
+static void
+candidate_unlink(rpl_nbr_t *nbr)
+{
+  rpl_nbr_t **prev;
+
+  if(nbr->pset_flags & RPL_NBR_PSET_CANDIDATE) {
+    for(prev = &candidates; *prev != NULL; prev = &(*prev)->next_candidate) {
+      if(*prev == nbr) {
+        *prev = nbr->next_candidate;
+        break;
+      }
+    }
+    nbr->next_candidate = NULL;
+    nbr->pset_flags &= ~RPL_NBR_PSET_CANDIDATE;
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+candidate_insert(rpl_nbr_t *nbr)
+{
+  rpl_nbr_t **prev = &candidates;
+
+  /* Insert after any candidate of equal cost, so that ties keep their order */
+  while(*prev != NULL && (*prev)->path_cost <= nbr->path_cost) {
+    prev = &(*prev)->next_candidate;
+  }
+  nbr->next_candidate = *prev;
+  *prev = nbr;
+  nbr->pset_flags |= RPL_NBR_PSET_CANDIDATE;
+}
+/*---------------------------------------------------------------------------*/
+static void
+dirty_unlink(rpl_nbr_t *nbr)
+{
+  rpl_nbr_t **prev;
+
+  if(nbr->pset_flags & RPL_NBR_PSET_DIRTY) {
+    for(prev = &dirty_list; *prev != NULL; prev = &(*prev)->next_dirty) {
+      if(*prev == nbr) {
+        *prev = nbr->next_dirty;
+        break;
+      }
+    }
+    nbr->next_dirty = NULL;
+    nbr->pset_flags &= ~RPL_NBR_PSET_DIRTY;
+  }
+}
+/*---------------------------------------------------------------------------*/
+void
+rpl_neighbor_mark_dirty(rpl_nbr_t *nbr)
+{
+  if(nbr != NULL && !(nbr->pset_flags & RPL_NBR_PSET_DIRTY)) {
+    nbr->pset_flags |= RPL_NBR_PSET_DIRTY;
+    nbr->next_dirty = dirty_list;
+    dirty_list = nbr;
+  }
+}
+/*---------------------------------------------------------------------------*/
+void
+rpl_neighbor_mark_all_dirty(void)
+{
+  rpl_nbr_t *nbr;
+
+  for(nbr = nbr_table_head(rpl_neighbors);
+      nbr != NULL;
+      nbr = nbr_table_next(rpl_neighbors, nbr)) {
+    rpl_neighbor_mark_dirty(nbr);
+  }
+}
+/*---------------------------------------------------------------------------*/
+/* Re-evaluates the neighbors marked as dirty, and only those. Each of them
+ * gets its OF results cached and is moved to its place in the candidate list. */
+static void
+update_parent_set(void)
+{
+  rpl_nbr_t *nbr;
+
+  if(curr_instance.used == 0) {
+    return;
+  }
+
+  while(dirty_list != NULL) {
+    nbr = dirty_list;
+    dirty_list = nbr->next_dirty;
+    nbr->next_dirty = NULL;
+    nbr->pset_flags &= ~RPL_NBR_PSET_DIRTY;
+
+    candidate_unlink(nbr);
+    nbr->path_cost = curr_instance.of->nbr_path_cost(nbr);
+    nbr->rank_via = curr_instance.of->rank_via_nbr(nbr);
+    nbr->pset_flags |= RPL_NBR_PSET_VALID;
+    if(curr_instance.of->nbr_is_acceptable_parent(nbr)) {
+      candidate_insert(nbr);
+    }
+  }
+}
+#endif /* RPL_INCREMENTAL_PARENT_SET */
+/*---------------------------------------------------------------------------*/
 static void
 remove_neighbor(rpl_nbr_t *nbr)
 {
@@ -205,6 +316,10 @@ remove_neighbor(rpl_nbr_t *nbr)
   if(nbr == curr_instance.dag.unicast_dio_target) {
     curr_instance.dag.unicast_dio_target = NULL;
   }
+#if RPL_INCREMENTAL_PARENT_SET
+  candidate_unlink(nbr);
+  dirty_unlink(nbr);
+#endif /* RPL_INCREMENTAL_PARENT_SET */
   nbr_table_remove(rpl_neighbors, nbr);
   rpl_timers_schedule_state_update(); /* Updating from here is unsafe; postpone */
 }
@@ -236,6 +351,12 @@ rpl_neighbor_get_link_metric(rpl_nbr_t *nbr)
 rpl_rank_t
 rpl_neighbor_rank_via_nbr(rpl_nbr_t *nbr)
 {
+#if RPL_INCREMENTAL_PARENT_SET
+  if(nbr != NULL && (nbr->pset_flags & (RPL_NBR_PSET_VALID | RPL_NBR_PSET_DIRTY))
+     == RPL_NBR_PSET_VALID) {
+    return nbr->rank_via;
+  }
+#endif /* RPL_INCREMENTAL_PARENT_SET */
   if(nbr != NULL && curr_instance.of->rank_via_nbr != NULL) {
     return curr_instance.of->rank_via_nbr(nbr);
   }
@@ -336,6 +457,58 @@ rpl_neighbor_get_from_ipaddr(uip_ipaddr_t *addr)
   return nbr_table_get_from_lladdr(rpl_neighbors, (linkaddr_t *)lladdr);
 }
 /*---------------------------------------------------------------------------*/
+#if RPL_INCREMENTAL_PARENT_SET
+static rpl_nbr_t *
+best_parent(int fresh_only)
+{
+  rpl_nbr_t *nbr;
+  rpl_nbr_t *best = NULL;
+  rpl_nbr_t *preferred;
+  uint16_t cutoff;
+
+  if(curr_instance.used == 0) {
+    return NULL;
+  }
+
+  update_parent_set();
+
+  /* The OFs never prefer a neighbor with a strictly higher path cost than
+  both the best so far and the preferred parent (hysteresis). Candidates are
+  sorted by path cost, so the walk stops as soon as one is past that cost. */
+  preferred = curr_instance.dag.preferred_parent;
+  cutoff = preferred != NULL && (preferred->pset_flags & RPL_NBR_PSET_CANDIDATE)
+    ? preferred->path_cost : 0;
+
+  for(nbr = candidates; nbr != NULL; nbr = nbr->next_candidate) {
+
+    if(best != NULL && nbr->path_cost > MAX(cutoff, best->path_cost)) {
+      break;
+    }
+
+    if(!acceptable_rank(nbr->rank_via)) {
+      /* Exclude neighbors with a rank that is not acceptable */
+      continue;
+    }
+
+    if(fresh_only && !rpl_neighbor_is_fresh(nbr)) {
+      /* Filter out non-fresh nerighbors if fresh_only is set */
+      continue;
+    }
+
+#if UIP_ND6_SEND_NS
+    /* Exclude links to a neighbor that is not reachable at a NUD level */
+    if(rpl_get_ds6_nbr(nbr) == NULL) {
+      continue;
+    }
+#endif /* UIP_ND6_SEND_NS */
+
+    /* Now we have an acceptable parent, check if it is the new best */
+    best = curr_instance.of->best_parent(best, nbr);
+  }
+
+  return best;
+}
+#else /* RPL_INCREMENTAL_PARENT_SET */
 static rpl_nbr_t *
 best_parent(int fresh_only)
 {
@@ -373,6 +546,7 @@ best_parent(int fresh_only)
 
   return best;
 }
+#endif /* RPL_INCREMENTAL_PARENT_SET */
 /*---------------------------------------------------------------------------*/
 rpl_nbr_t *
 rpl_neighbor_select_best(void)
@@ -184,6 +184,25 @@ void rpl_neighbor_remove_all(void);
 */
 rpl_nbr_t *rpl_neighbor_select_best(void);
 
+#if RPL_INCREMENTAL_PARENT_SET
+/**
+ * Schedules a neighbor for re-evaluation by the objective function. To be
+ * called whenever the rank or the link metric of the neighbor changes.
+ *
+ * \param nbr The neighbor
+*/
+void rpl_neighbor_mark_dirty(rpl_nbr_t *nbr);
+
+/**
+ * Schedules all neighbors for re-evaluation by the objective function. To be
+ * called when instance-wide parameters used by the objective function change.
+*/
+void rpl_neighbor_mark_all_dirty(void);
+#else /* RPL_INCREMENTAL_PARENT_SET */
+#define rpl_neighbor_mark_dirty(nbr)
+#define rpl_neighbor_mark_all_dirty()
+#endif /* RPL_INCREMENTAL_PARENT_SET */
+
 /**
 * Print a textual description of RPL neighbor into a string
 *
@@ -272,14 +272,25 @@ rpl_timers_schedule_dao(void)
 }
 /*---------------------------------------------------------------------------*/
 static void
-send_new_dao(void *ptr)
+send_dao(void)
 {
 #if RPL_WITH_DAO_ACK
   /* We are sending a new DAO here. Prepare retransmissions */
   curr_instance.dag.dao_transmissions = 1;
   /* Schedule next retransmission */
   schedule_dao_retransmission();
-#else /* RPL_WITH_DAO_ACK */
+#endif /* RPL_WITH_DAO_ACK */
+
+  /* Increment seqno */
+  RPL_LOLLIPOP_INCREMENT(curr_instance.dag.dao_last_seqno);
+  /* Send a DAO with own prefix as target and default lifetime */
+  rpl_icmp6_dao_output(curr_instance.default_lifetime);
+}
+/*---------------------------------------------------------------------------*/
+static void
+send_new_dao(void *ptr)
+{
+#if !RPL_WITH_DAO_ACK
   /* No DAO-ACK: assume we are reachable as soon as we send a DAO */
   if(curr_instance.dag.state == DAG_JOINED) {
     curr_instance.dag.state = DAG_REACHABLE;
@@ -289,11 +300,20 @@ send_new_dao(void *ptr)
   schedule_dao_refresh();
 #endif /* !RPL_WITH_DAO_ACK */
 
-  /* Increment seqno */
-  RPL_LOLLIPOP_INCREMENT(curr_instance.dag.dao_last_seqno);
-  /* Send a DAO with own prefix as target and default lifetime */
-  rpl_icmp6_dao_output(curr_instance.default_lifetime);
+  send_dao();
+}
+/*---------------------------------------------------------------------------*/
+#if RPL_WITH_DAO_AGGREGATION
+void
+rpl_timers_send_aggregated_dao(void)
+{
+  if(curr_instance.used && curr_instance.mop != RPL_MOP_NO_DOWNWARD_ROUTES) {
+    /* With DAO-ACKs, the retransmissions replace the refresh until the DAO is
+    ACKed. Without, the refresh schedule is kept as it is. */
+    send_dao();
+  }
 }
+#endif /* RPL_WITH_DAO_AGGREGATION */
 #if RPL_WITH_DAO_ACK
 /*---------------------------------------------------------------------------*/
 /*------------------------------- DAO-ACK ---------------------------------- */
@@ -94,6 +94,14 @@ void rpl_timers_schedule_unicast_dio(rpl_nbr_t *target);
 */
 void rpl_timers_schedule_dao(void);
 
+#if RPL_WITH_DAO_AGGREGATION
+/**
+ * Send a new DAO with no delay, to forward the targets held by DAO
+ * aggregation. The DAO is retransmitted until it is ACKed, as any other.
+*/
+void rpl_timers_send_aggregated_dao(void);
+#endif /* RPL_WITH_DAO_AGGREGATION */
+
 /**
  * Schedule a DAO-ACK with no delay
 */
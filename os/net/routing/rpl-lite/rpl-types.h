@@ -142,6 +142,13 @@ struct rpl_nbr {
 #endif /* RPL_WITH_MC */
   rpl_rank_t rank;
   uint8_t dtsn;
+#if RPL_INCREMENTAL_PARENT_SET
+  struct rpl_nbr *next_candidate; /* Next in the cost-ordered candidate list */
+  struct rpl_nbr *next_dirty; /* Next in the list of neighbors to re-evaluate */
+  uint16_t path_cost; /* Cached OF path cost */
+  rpl_rank_t rank_via; /* Cached rank via this neighbor */
+  uint8_t pset_flags; /* Parent set flags, RPL_NBR_PSET_* */
+#endif /* RPL_INCREMENTAL_PARENT_SET */
 };
 typedef struct rpl_nbr rpl_nbr_t;
 
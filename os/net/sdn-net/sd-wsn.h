@@ -582,6 +582,7 @@ uint16_t sdn_nachksum(uint8_t len);
  * \return The checksum of the RA packet in uip_buf
  */
 uint16_t sdn_rachksum(uint8_t len);
+uint16_t sdn_sachksum(uint8_t len);
 
 /** \brief Periodic processing of data structures */
 extern struct etimer sdn_ds_timer_periodic;
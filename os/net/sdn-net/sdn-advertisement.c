@@ -177,6 +177,9 @@ static void send_na_output(void)
 {
     const linkaddr_t *nxthop;
     const struct link_stats *stats;
+#if LINK_STATS_WINDOW_SIZE
+    int16_t rssi;
+#endif /* LINK_STATS_WINDOW_SIZE */
     nxthop = NETSTACK_ROUTING.nexthop(&ctrl_addr);
     if (nxthop != NULL)
     {
@@ -209,10 +212,20 @@ static void send_na_output(void)
         {
             SDN_NA_PAYLOAD(count)->nb_addr.u16 = sdnip_htons(nbr->addr.u16);
             // We get the ETX, RSSI values from link-stats.c
-            stats = link_stats_from_lladdr(&nbr->addr);
+            stats = sdn_ds_nbr_get_link_stats(nbr);
             if (stats != NULL)
             {
+#if LINK_STATS_WINDOW_SIZE
+                /* The median RSSI is robust to a few outlying receptions */
+                rssi = link_stats_get_rssi_percentile(stats, 50);
+                if (rssi == LINK_STATS_RSSI_UNKNOWN)
+                {
+                    rssi = stats->rssi;
+                }
+                SDN_NA_PAYLOAD(count)->rssi = sdnip_htons(rssi);
+#else
                 SDN_NA_PAYLOAD(count)->rssi = sdnip_htons(stats->rssi);
+#endif /* LINK_STATS_WINDOW_SIZE */
                 SDN_NA_PAYLOAD(count)->etx = sdnip_htons(stats->etx);
             }
             else
@@ -206,6 +206,11 @@ const linkaddr_t *sdn_ds_nbr_get_ll(const sdn_ds_nbr_t *nbr)
     return (const linkaddr_t *)nbr_table_get_lladdr(ds_neighbors, nbr);
 }
 /*---------------------------------------------------------------------------*/
+const struct link_stats *sdn_ds_nbr_get_link_stats(const sdn_ds_nbr_t *nbr)
+{
+    return link_stats_from_nbr_item(ds_neighbors, nbr);
+}
+/*---------------------------------------------------------------------------*/
 int sdn_ds_nbr_num(void)
 {
     int num = 0;
@@ -50,6 +50,7 @@
 #include "contiki.h"
 #include "net/linkaddr.h"
 #include "net/nbr-table.h"
+#include "net/link-stats.h"
 #include "sys/stimer.h"
 
 /** \brief Set the maximum number of neighbor cache entries */
@@ -144,6 +145,13 @@ int sdn_ds_nbr_rm(sdn_ds_nbr_t *nbr);
  */
 const linkaddr_t *sdn_ds_nbr_get_ll(const sdn_ds_nbr_t *nbr);
 
+/**
+ * Get the link statistics of a neighbor, without an address lookup
+ * \param nbr the address of a neighbor cache
+ * \return the link_stats structure address if any, NULL otherwise
+ */
+const struct link_stats *sdn_ds_nbr_get_link_stats(const sdn_ds_nbr_t *nbr);
+
 /**
  * Get the neighbor cache associated with a specified IPv6 address
  * \param addr address used as a search key
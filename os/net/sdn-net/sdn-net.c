@@ -51,6 +51,7 @@
 #include "net/sdn-net/sdn.h"
 #include "net/link-stats.h"
 #include "net/sdn-net/sdnbuf.h"
+#include <stddef.h>
 #include <string.h>
 /* Log configuration */
 /* Log configuration */
@@ -62,6 +63,47 @@
 #define LOG_LEVEL LOG_LEVEL_NONE
 #endif /* LOG_CONF_LEVEL_SDN_NET */
 
+/*
+ * SDN_NET_CONF_COMPRESSION enables compression of the SDN IP header,
+ * in the spirit of 6LoWPAN IPHC. The source and destination addresses
+ * are elided when they are equal to the link-layer sender and
+ * receiver addresses, and the total length is elided when it can be
+ * derived from the frame length. All nodes of a network must use the
+ * same setting; uncompressed frames are still accepted on input.
+ */
+#ifdef SDN_NET_CONF_COMPRESSION
+#define SDN_NET_COMPRESSION SDN_NET_CONF_COMPRESSION
+#else
+#define SDN_NET_COMPRESSION 0
+#endif /* SDN_NET_CONF_COMPRESSION */
+
+/*
+ * SDN_NET_CONF_COMPRESS_CHKSUMS elides the IP header checksum and the
+ * checksum of the ND, NA, RA and SA headers from compressed frames.
+ * These checksums are redundant with the CRC (or the MIC) of IEEE
+ * 802.15.4 frames, and are regenerated by the receiver. A checksum is
+ * only elided if it is correct, so a packet that has been corrupted
+ * before reaching the radio is still dropped by the receiver.
+ */
+#ifdef SDN_NET_CONF_COMPRESS_CHKSUMS
+#define SDN_NET_COMPRESS_CHKSUMS SDN_NET_CONF_COMPRESS_CHKSUMS
+#else
+#define SDN_NET_COMPRESS_CHKSUMS 1
+#endif /* SDN_NET_CONF_COMPRESS_CHKSUMS */
+
+/*
+ * The compressed header starts with a dispatch byte, which cannot be
+ * mistaken for the version bits of an uncompressed header, followed
+ * by vap, ttl and the fields that are not elided: tlen, scr, dest and
+ * hdr_chksum, in that order.
+ */
+#define SDN_NET_HC_DISPATCH       0xc0
+#define SDN_NET_HC_DISPATCH_MASK  0xe0
+#define SDN_NET_HC_SCR            0x10 /* scr is the link-layer sender */
+#define SDN_NET_HC_DEST           0x08 /* dest is the link-layer receiver */
+#define SDN_NET_HC_CHKSUMS        0x04 /* Checksums are elided */
+#define SDN_NET_HC_TLEN           0x02 /* tlen is the packet length */
+
 // uint8_t *sdn_net_buf;
 // uint16_t sdn_net_len;
 // static sdn_net_input_callback current_callback = NULL;
@@ -110,6 +152,289 @@ set_packet_attrs(void)
   packetbuf_set_attr(PACKETBUF_ATTR_NETWORK_ID, SDN_IP_BUF->vap & 0x0F);
 }
 
+#if SDN_NET_COMPRESSION
+/*--------------------------------------------------------------------*/
+/* Is an address of the SDN IP header, which is stored in network byte
+   order, equal to a link-layer address? */
+static int
+hdr_addr_cmp(const linkaddr_t *hdr_addr, const linkaddr_t *lladdr)
+{
+  return hdr_addr->u16 == sdnip_htons(lladdr->u16);
+}
+/*--------------------------------------------------------------------*/
+/* Offset of the checksum in the header of a protocol, or -1 if the
+   protocol has no checksum. */
+static int
+proto_chksum_offset(uint8_t proto)
+{
+  switch(proto) {
+  case SDN_PROTO_ND:
+    return offsetof(struct sdn_nd_hdr, ndchksum);
+  case SDN_PROTO_NA:
+    return offsetof(struct sdn_na_hdr, pkt_chksum);
+  case SDN_PROTO_RA:
+    return offsetof(struct sdn_ra_hdr, pkt_chksum);
+  case SDN_PROTO_SA:
+    return offsetof(struct sdn_sa_hdr, pkt_chksum);
+  default:
+    return -1;
+  }
+}
+/*--------------------------------------------------------------------*/
+/* Number of payload bytes covered by the protocol checksum. */
+static uint16_t
+proto_chksum_len(uint8_t proto)
+{
+  switch(proto) {
+  case SDN_PROTO_ND:
+    return SDN_NDH_LEN;
+  case SDN_PROTO_NA:
+    return SDN_NAH_LEN + nabuf_get_len_field(SDN_NA_BUF);
+  case SDN_PROTO_RA:
+    return SDN_RAH_LEN + ncbuf_get_len_field(SDN_RA_BUF);
+  case SDN_PROTO_SA:
+    return SDN_SAH_LEN + srbuf_get_len_field(SDN_SA_BUF);
+  default:
+    return 0;
+  }
+}
+/*--------------------------------------------------------------------*/
+/* Compute the protocol checksum of the packet in sdn_buf. The result
+   is 0xffff if the checksum field is correct. */
+static uint16_t
+proto_chksum(uint8_t proto)
+{
+  switch(proto) {
+  case SDN_PROTO_ND:
+    return sdn_ndchksum();
+  case SDN_PROTO_NA:
+    return sdn_nachksum(nabuf_get_len_field(SDN_NA_BUF));
+  case SDN_PROTO_RA:
+    return sdn_rachksum(ncbuf_get_len_field(SDN_RA_BUF));
+  case SDN_PROTO_SA:
+    return sdn_sachksum(srbuf_get_len_field(SDN_SA_BUF));
+  default:
+    return 0xffff;
+  }
+}
+/*--------------------------------------------------------------------*/
+#if SDN_NET_COMPRESS_CHKSUMS
+/* Can the checksums of the packet in sdn_buf be elided? They can if
+   the receiver regenerates exactly the same values, which requires
+   the data covered by the protocol checksum to be in the packet, and
+   rules out the alternative one's complement encoding of a valid
+   checksum (0x0000 vs 0xffff). */
+static int
+chksums_elidable(int chksum_offset)
+{
+  uint8_t proto = SDN_IP_BUF->vap & 0x0F;
+  uint16_t chksum;
+  uint16_t regenerated;
+
+  if(chksum_offset >= 0) {
+    if(sdn_len < SDN_IPH_LEN + proto_chksum_len(proto)) {
+      return 0;
+    }
+    memcpy(&chksum, SDN_IP_PAYLOAD(chksum_offset), sizeof(uint16_t));
+    memset(SDN_IP_PAYLOAD(chksum_offset), 0, sizeof(uint16_t));
+    regenerated = ~proto_chksum(proto);
+    memcpy(SDN_IP_PAYLOAD(chksum_offset), &chksum, sizeof(uint16_t));
+    if(regenerated != chksum) {
+      return 0;
+    }
+  }
+
+  chksum = SDN_IP_BUF->hdr_chksum;
+  SDN_IP_BUF->hdr_chksum = 0;
+  regenerated = ~sdn_ipchksum();
+  SDN_IP_BUF->hdr_chksum = chksum;
+  return regenerated == chksum;
+}
+#endif /* SDN_NET_COMPRESS_CHKSUMS */
+/*--------------------------------------------------------------------*/
+/**
+ * Compress the packet in sdn_buf into packetbuf. Returns 0 if the
+ * packet cannot be compressed, in which case it is sent uncompressed.
+ */
+static int
+compress_hdr(const linkaddr_t *dest)
+{
+  uint8_t *hc = packetbuf_dataptr();
+  uint8_t *dispatch = hc++;
+  int chksum_offset = proto_chksum_offset(SDN_IP_BUF->vap & 0x0F);
+  uint16_t payload_len;
+
+  if(sdn_len < SDN_IPH_LEN) {
+    return 0;
+  }
+
+  /* The padding between ttl and hdr_chksum is not transmitted, but it
+     is covered by the header checksum. */
+  for(size_t i = offsetof(struct sdn_ip_hdr, ttl) + 1;
+      i < offsetof(struct sdn_ip_hdr, hdr_chksum); i++) {
+    if(sdn_buf[i] != 0) {
+      return 0;
+    }
+  }
+
+  *dispatch = SDN_NET_HC_DISPATCH;
+  *hc++ = SDN_IP_BUF->vap;
+  *hc++ = SDN_IP_BUF->ttl;
+
+  if(sdnbuf_get_len_field(SDN_IP_BUF) == sdn_len) {
+    *dispatch |= SDN_NET_HC_TLEN;
+  } else {
+    *hc++ = SDN_IP_BUF->tlen;
+  }
+
+  if(hdr_addr_cmp(&SDN_IP_BUF->scr, &linkaddr_node_addr)) {
+    *dispatch |= SDN_NET_HC_SCR;
+  } else {
+    memcpy(hc, &SDN_IP_BUF->scr, sizeof(linkaddr_t));
+    hc += sizeof(linkaddr_t);
+  }
+
+  if(hdr_addr_cmp(&SDN_IP_BUF->dest, dest)) {
+    *dispatch |= SDN_NET_HC_DEST;
+  } else {
+    memcpy(hc, &SDN_IP_BUF->dest, sizeof(linkaddr_t));
+    hc += sizeof(linkaddr_t);
+  }
+
+#if SDN_NET_COMPRESS_CHKSUMS
+  if(chksums_elidable(chksum_offset)) {
+    *dispatch |= SDN_NET_HC_CHKSUMS;
+  }
+#endif /* SDN_NET_COMPRESS_CHKSUMS */
+
+  if(!(*dispatch & SDN_NET_HC_CHKSUMS)) {
+    memcpy(hc, &SDN_IP_BUF->hdr_chksum, sizeof(uint16_t));
+    hc += sizeof(uint16_t);
+  }
+
+  payload_len = sdn_len - SDN_IPH_LEN;
+  if((*dispatch & SDN_NET_HC_CHKSUMS) && chksum_offset >= 0) {
+    payload_len -= sizeof(uint16_t);
+  }
+  if(hc - (uint8_t *)packetbuf_dataptr() + payload_len > PACKETBUF_SIZE) {
+    return 0;
+  }
+
+  if((*dispatch & SDN_NET_HC_CHKSUMS) && chksum_offset >= 0) {
+    /* Copy the payload around the protocol checksum. */
+    memcpy(hc, SDN_IP_PAYLOAD(0), chksum_offset);
+    memcpy(hc + chksum_offset,
+           SDN_IP_PAYLOAD(chksum_offset + sizeof(uint16_t)),
+           payload_len - chksum_offset);
+  } else {
+    memcpy(hc, SDN_IP_PAYLOAD(0), payload_len);
+  }
+  hc += payload_len;
+
+  packetbuf_set_datalen(hc - (uint8_t *)packetbuf_dataptr());
+
+  LOG_DBG("compressed header: %u -> %u bytes\n",
+          sdn_len, packetbuf_datalen());
+  return 1;
+}
+/*--------------------------------------------------------------------*/
+/**
+ * Uncompress the packet in packetbuf into sdn_buf, regenerating the
+ * elided fields. Returns 0 if the compressed header is malformed.
+ */
+static int
+uncompress_hdr(void)
+{
+  const uint8_t *hc = packetbuf_ptr;
+  const uint8_t *end = packetbuf_ptr + packetbuf_datalen();
+  uint8_t dispatch = *hc++;
+  uint16_t hc_len = 3;
+  uint16_t payload_len;
+  uint8_t proto;
+  int chksum_offset;
+
+  if(!(dispatch & SDN_NET_HC_TLEN)) {
+    hc_len++;
+  }
+  if(!(dispatch & SDN_NET_HC_SCR)) {
+    hc_len += sizeof(linkaddr_t);
+  }
+  if(!(dispatch & SDN_NET_HC_DEST)) {
+    hc_len += sizeof(linkaddr_t);
+  }
+  if(!(dispatch & SDN_NET_HC_CHKSUMS)) {
+    hc_len += sizeof(uint16_t);
+  }
+  if(packetbuf_datalen() < hc_len) {
+    return 0;
+  }
+
+  memset(SDN_IP_BUF, 0, SDN_IPH_LEN);
+  SDN_IP_BUF->vap = *hc++;
+  SDN_IP_BUF->ttl = *hc++;
+  if(!(dispatch & SDN_NET_HC_TLEN)) {
+    SDN_IP_BUF->tlen = *hc++;
+  }
+
+  if(dispatch & SDN_NET_HC_SCR) {
+    SDN_IP_BUF->scr.u16 = sdnip_htons(packetbuf_addr(PACKETBUF_ADDR_SENDER)->u16);
+  } else {
+    memcpy(&SDN_IP_BUF->scr, hc, sizeof(linkaddr_t));
+    hc += sizeof(linkaddr_t);
+  }
+
+  if(dispatch & SDN_NET_HC_DEST) {
+    SDN_IP_BUF->dest.u16 = sdnip_htons(packetbuf_addr(PACKETBUF_ADDR_RECEIVER)->u16);
+  } else {
+    memcpy(&SDN_IP_BUF->dest, hc, sizeof(linkaddr_t));
+    hc += sizeof(linkaddr_t);
+  }
+
+  if(!(dispatch & SDN_NET_HC_CHKSUMS)) {
+    memcpy(&SDN_IP_BUF->hdr_chksum, hc, sizeof(uint16_t));
+    hc += sizeof(uint16_t);
+  }
+
+  proto = SDN_IP_BUF->vap & 0x0F;
+  chksum_offset = proto_chksum_offset(proto);
+  payload_len = end - hc;
+
+  if((dispatch & SDN_NET_HC_CHKSUMS) && chksum_offset >= 0) {
+    if(payload_len < chksum_offset ||
+       SDN_IPH_LEN + payload_len + sizeof(uint16_t) > SDN_BUFSIZE) {
+      return 0;
+    }
+    /* Make room for the protocol checksum. */
+    memcpy(SDN_IP_PAYLOAD(0), hc, chksum_offset);
+    memset(SDN_IP_PAYLOAD(chksum_offset), 0, sizeof(uint16_t));
+    memcpy(SDN_IP_PAYLOAD(chksum_offset + sizeof(uint16_t)),
+           hc + chksum_offset, payload_len - chksum_offset);
+    payload_len += sizeof(uint16_t);
+  } else {
+    if(SDN_IPH_LEN + payload_len > SDN_BUFSIZE) {
+      return 0;
+    }
+    memcpy(SDN_IP_PAYLOAD(0), hc, payload_len);
+  }
+
+  sdn_len = SDN_IPH_LEN + payload_len;
+  if(dispatch & SDN_NET_HC_TLEN) {
+    sdnbuf_set_len_field(SDN_IP_BUF, sdn_len);
+  }
+
+  if(dispatch & SDN_NET_HC_CHKSUMS) {
+    if(chksum_offset >= 0) {
+      uint16_t chksum = ~proto_chksum(proto);
+      memcpy(SDN_IP_PAYLOAD(chksum_offset), &chksum, sizeof(uint16_t));
+    }
+    SDN_IP_BUF->hdr_chksum = ~sdn_ipchksum();
+  }
+
+  LOG_DBG("uncompressed header: %u -> %u bytes\n",
+          packetbuf_datalen(), sdn_len);
+  return 1;
+}
+#endif /* SDN_NET_COMPRESSION */
 /*--------------------------------------------------------------------*/
 static void
 init(void)
@@ -149,10 +474,21 @@ input(void)
      want to query us for it later. */
   last_rssi = (signed short)packetbuf_attr(PACKETBUF_ATTR_RSSI);
 
-  sdn_len = packetbuf_datalen();
+#if SDN_NET_COMPRESSION
+  if((packetbuf_ptr[0] & SDN_NET_HC_DISPATCH_MASK) == SDN_NET_HC_DISPATCH) {
+    if(!uncompress_hdr()) {
+      LOG_WARN("input: malformed compressed header\n");
+      sdnbuf_clear();
+      return;
+    }
+  } else
+#endif /* SDN_NET_COMPRESSION */
+  {
+    sdn_len = packetbuf_datalen();
 
-  /* Put uncompressed IP header in sdn_buf. */
-  memcpy(buffer, packetbuf_ptr, sdn_len);
+    /* Put uncompressed IP header in sdn_buf. */
+    memcpy(buffer, packetbuf_ptr, sdn_len);
+  }
 
   if (callback)
   {
@@ -223,7 +559,6 @@ output(const linkaddr_t *localdest)
    * broadcast packet.
    */
   packetbuf_clear();
-  packetbuf_copyfrom(sdn_buf, sdn_len);
 
   /*
    * The destination address will be tagged to each outbound
@@ -238,6 +573,13 @@ output(const linkaddr_t *localdest)
   {
     linkaddr_copy(&dest, localdest);
   }
+
+#if SDN_NET_COMPRESSION
+  if(!compress_hdr(&dest))
+#endif /* SDN_NET_COMPRESSION */
+  {
+    packetbuf_copyfrom(sdn_buf, sdn_len);
+  }
   // if (dest == NULL)
   // {
   //   PRINTF("address null\n");
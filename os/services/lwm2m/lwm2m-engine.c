@@ -49,6 +49,9 @@
 #include "lwm2m-json.h"
 #include "coap-constants.h"
 #include "coap-engine.h"
+#if COAP_WITH_QBLOCK
+#include "coap-qblock.h"
+#endif /* COAP_WITH_QBLOCK */
 #include "lwm2m-tlv.h"
 #include "lwm2m-tlv-reader.h"
 #include "lwm2m-tlv-writer.h"
@@ -118,6 +121,12 @@ static uint8_t d_buf[COAP_MAX_BLOCK_SIZE * 2];
 static lwm2m_buffer_t lwm2m_buf = {
   .len = 0, .size =  COAP_MAX_BLOCK_SIZE * 2, .buffer = d_buf
 };
+
+#if COAP_WITH_QBLOCK
+/* The state of the body of the current Q-Block1 write */
+static coap_qblock1_receiver_t qblock1_receiver;
+#endif /* COAP_WITH_QBLOCK */
+
 static lwm2m_object_instance_t instance_buffer;
 
 /* obj-id / ... */
@@ -1136,7 +1145,11 @@ perform_multi_resource_write_op(lwm2m_object_t *object,
        small TLV but rather a large opaque - this needs to be fixed in the
        future */
 
-    if(coap_get_header_block1(ctx->request, &num, &more, &size, &offset)) {
+    if(coap_get_header_block1(ctx->request, &num, &more, &size, &offset)
+#if COAP_WITH_QBLOCK
+       || coap_get_header_q_block1(ctx->request, &num, &more, &size, &offset)
+#endif /* COAP_WITH_QBLOCK */
+       ) {
       LOG_DBG("CoAP BLOCK1: %"PRIu32"/%d/%d offset:%"PRIu32
               "  LWM2M CTX->offset=%"PRIu32"\n",
               num, more, size, offset, ctx->offset);
@@ -1366,6 +1379,9 @@ lwm2m_handler_callback(coap_message_t *request, coap_message_t *response,
   lwm2m_status_t success;
   lwm2m_buffer_t inbuf;
   lwm2m_buffer_t outbuf;
+#if COAP_WITH_QBLOCK
+  int qblock1_accepted = 1;
+#endif /* COAP_WITH_QBLOCK */
 
   /* Initialize the context */
   memset(&context, 0, sizeof(context));
@@ -1563,6 +1579,18 @@ lwm2m_queue_mode_request_received();
     context.offset = boffset;
   }
 
+#if COAP_WITH_QBLOCK
+  if(coap_is_option(request, COAP_OPTION_Q_BLOCK1)) {
+    qblock1_accepted = coap_qblock1_accept(&qblock1_receiver, request);
+    if(qblock1_accepted < 0) {
+      return COAP_HANDLER_STATUS_PROCESSED;
+    }
+    coap_get_header_q_block1(request, NULL, NULL, NULL, &boffset);
+    context.offset = boffset;
+    context.qblock1_final = coap_qblock1_is_final(&qblock1_receiver, request);
+  }
+#endif /* COAP_WITH_QBLOCK */
+
   /* This is a discovery operation */
   switch(context.operation) {
   case LWM2M_OP_DISCOVER:
@@ -1573,6 +1601,13 @@ lwm2m_queue_mode_request_received();
     success = perform_multi_resource_read_op(object, instance, &context);
     break;
   case LWM2M_OP_WRITE:
+#if COAP_WITH_QBLOCK
+    if(!qblock1_accepted) {
+      /* The block is already stored or is beyond the current set */
+      success = LWM2M_STATUS_OK;
+      break;
+    }
+#endif /* COAP_WITH_QBLOCK */
     success = perform_multi_resource_write_op(object, instance, &context, format);
     break;
   case LWM2M_OP_EXECUTE:
@@ -1601,6 +1636,11 @@ lwm2m_queue_mode_request_received();
               (offset != NULL ? *offset : 0));
       coap_set_header_block1(response, bnum, 0, bsize);
     }
+#if COAP_WITH_QBLOCK
+    if(coap_is_option(request, COAP_OPTION_Q_BLOCK1)) {
+      coap_qblock1_respond(&qblock1_receiver, request, response);
+    }
+#endif /* COAP_WITH_QBLOCK */
 
     if(context.outbuf->len > 0) {
       LOG_DBG("[");
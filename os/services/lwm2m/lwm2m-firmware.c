@@ -70,6 +70,8 @@
 static uint8_t state = STATE_IDLE;
 static uint8_t result = RESULT_DEFAULT;
 
+static lwm2m_firmware_store_t store;
+
 static lwm2m_object_instance_t reg_object;
 
 static const lwm2m_resource_id_t resources[] =
@@ -122,6 +124,13 @@ lwm2m_callback(lwm2m_object_instance_t *object,
       /* The firmware is written */
       LOG_DBG("Firmware received: %"PRIu32" %d fin:%d\n", ctx->offset,
               (int)ctx->inbuf->size, lwm2m_object_is_final_incoming(ctx));
+      if(store != NULL
+         && store(ctx->offset, ctx->inbuf->buffer, ctx->inbuf->size) != 0) {
+        LOG_WARN("Failed to store firmware at %"PRIu32"\n", ctx->offset);
+        state = STATE_IDLE;
+        result = RESULT_NO_STORAGE;
+        return LWM2M_STATUS_ERROR;
+      }
       if(lwm2m_object_is_final_incoming(ctx)) {
         state = STATE_DOWNLOADED;
       } else {
@@ -165,4 +174,10 @@ lwm2m_firmware_init(void)
   lwm2m_engine_add_object(&reg_object);
 }
 /*---------------------------------------------------------------------------*/
+void
+lwm2m_firmware_set_store(lwm2m_firmware_store_t store_function)
+{
+  store = store_function;
+}
+/*---------------------------------------------------------------------------*/
 /** @} */
@@ -39,7 +39,29 @@
 #ifndef LWM2M_FIRMWARE_H_
 #define LWM2M_FIRMWARE_H_
 
+#include <stdint.h>
+
+/**
+ * \brief        Store a chunk of a firmware package, e.g., in CFS or flash.
+ * \param offset The offset of the chunk in the package.
+ * \param data   The chunk, in the buffer of the CoAP request.
+ * \param len    The length of the chunk.
+ * \return       Zero on success, or non-zero on failure.
+ *
+ *               Chunks may arrive out of order and more than once when
+ *               the package is pushed with Q-Block1.
+ */
+typedef int (*lwm2m_firmware_store_t)(uint32_t offset, const uint8_t *data,
+                                      uint16_t len);
+
 void lwm2m_firmware_init(void);
 
+/**
+ * \brief       Set the function that stores the firmware package as it
+ *              is received, without buffering the package in RAM.
+ * \param store The store function, or NULL to discard the package.
+ */
+void lwm2m_firmware_set_store(lwm2m_firmware_store_t store);
+
 #endif /* LWM2M_FIRMWARE_H_ */
 /** @} */
@@ -160,6 +160,10 @@ typedef struct lwm2m_context {
   uint8_t writer_flags; /* flags for reader/writer */
   const lwm2m_reader_t *reader;
   const lwm2m_writer_t *writer;
+
+#if COAP_WITH_QBLOCK
+  uint8_t qblock1_final; /* the Q-Block1 request completes the body */
+#endif /* COAP_WITH_QBLOCK */
 } lwm2m_context_t;
 
 /* LWM2M format writer for the various formats supported */
@@ -349,6 +353,12 @@ static inline int
 lwm2m_object_is_final_incoming(lwm2m_context_t *ctx)
 {
   uint8_t more;
+#if COAP_WITH_QBLOCK
+  /* Q-Block1 blocks may arrive in any order */
+  if(coap_is_option(ctx->request, COAP_OPTION_Q_BLOCK1)) {
+    return ctx->qblock1_final;
+  }
+#endif /* COAP_WITH_QBLOCK */
   if(coap_get_header_block1(ctx->request, NULL, &more, NULL, NULL)) {
     return !more;
   }
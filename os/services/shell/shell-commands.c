@@ -66,6 +66,15 @@
 #endif
 #include "net/routing/routing.h"
 #include "net/mac/llsec802154.h"
+#ifdef HEAPMEM_CONF_ARENA_SIZE
+#include "lib/heapmem.h"
+#endif /* HEAPMEM_CONF_ARENA_SIZE */
+#if BUILD_WITH_COAP
+#include "coap-transactions.h"
+#endif /* BUILD_WITH_COAP */
+#if BUILD_WITH_COFFEE
+#include "cfs/cfs-coffee.h"
+#endif /* BUILD_WITH_COFFEE */
 
 /* For RPL-specific commands */
 #if ROUTING_CONF_RPL_LITE
@@ -796,6 +805,94 @@ PT_THREAD(cmd_reboot(struct pt *pt, shell_output_func output, char *args))
   watchdog_reboot();
   PT_END(pt);
 }
+#ifdef HEAPMEM_CONF_ARENA_SIZE
+/*---------------------------------------------------------------------------*/
+static
+PT_THREAD(cmd_heapmem(struct pt *pt, shell_output_func output, char *args))
+{
+  heapmem_stats_t stats;
+  heapmem_zone_stats_t zone_stats;
+  heapmem_slab_stats_t slab_stats;
+
+  PT_BEGIN(pt);
+
+  heapmem_stats(&stats);
+  SHELL_OUTPUT(output, "Heapmem: allocated %lu, overhead %lu, available %lu, footprint %lu, chunks %lu\n",
+               (unsigned long)stats.allocated, (unsigned long)stats.overhead,
+               (unsigned long)stats.available, (unsigned long)stats.footprint,
+               (unsigned long)stats.chunks);
+
+  SHELL_OUTPUT(output, "-- Zones:\n");
+  for(heapmem_zone_t zone = HEAPMEM_ZONE_GENERAL;
+      heapmem_zone_stats(zone, &zone_stats); zone++) {
+    SHELL_OUTPUT(output, "---- %s: capacity %lu, allocated %lu, high-water %lu, failures %lu\n",
+                 zone_stats.name, (unsigned long)zone_stats.capacity,
+                 (unsigned long)zone_stats.allocated,
+                 (unsigned long)zone_stats.high_water,
+                 (unsigned long)zone_stats.failures);
+  }
+
+  for(unsigned class_index = 0;
+      heapmem_slab_stats(class_index, &slab_stats); class_index++) {
+    if(class_index == 0) {
+      SHELL_OUTPUT(output, "-- Slab classes:\n");
+    }
+    SHELL_OUTPUT(output, "---- %lu bytes: cached %lu, hits %lu, misses %lu\n",
+                 (unsigned long)slab_stats.size, (unsigned long)slab_stats.cached,
+                 (unsigned long)slab_stats.hits, (unsigned long)slab_stats.misses);
+  }
+
+  PT_END(pt);
+}
+#endif /* HEAPMEM_CONF_ARENA_SIZE */
+#if BUILD_WITH_COFFEE
+/*---------------------------------------------------------------------------*/
+static
+PT_THREAD(cmd_coffee_gc(struct pt *pt, shell_output_func output, char *args))
+{
+  struct cfs_coffee_gc_stats stats;
+
+  PT_BEGIN(pt);
+
+  cfs_coffee_gc_stats(&stats);
+  SHELL_OUTPUT(output, "Coffee GC: collections %lu, background steps %lu, erased sectors %lu\n",
+               (unsigned long)stats.collections, (unsigned long)stats.steps,
+               (unsigned long)stats.erased);
+  SHELL_OUTPUT(output, "-- Longest step: %lu ms\n",
+               (unsigned long)((uint64_t)stats.longest_step * 1000 / RTIMER_SECOND));
+  SHELL_OUTPUT(output, "-- Sector erasures: min %lu, max %lu\n",
+               (unsigned long)stats.min_erases, (unsigned long)stats.max_erases);
+
+  PT_END(pt);
+}
+#endif /* BUILD_WITH_COFFEE */
+#if BUILD_WITH_COAP && COAP_CONGESTION_CONTROL
+/*---------------------------------------------------------------------------*/
+static
+PT_THREAD(cmd_coap_rto(struct pt *pt, shell_output_func output, char *args))
+{
+  coap_rto_stats_t stats;
+  char endpoint[64];
+
+  PT_BEGIN(pt);
+
+  SHELL_OUTPUT(output, "CoAP RTO estimates (msec):\n");
+  for(unsigned i = 0; coap_transactions_rto_stats(i, &stats); i++) {
+    coap_endpoint_snprint(endpoint, sizeof(endpoint), &stats.endpoint);
+    SHELL_OUTPUT(output, "-- %s: RTO %lu\n", endpoint, (unsigned long)stats.rto);
+    SHELL_OUTPUT(output, "---- strong: SRTT %lu, RTTVAR %lu, samples %u\n",
+                 (unsigned long)stats.strong_srtt,
+                 (unsigned long)stats.strong_rttvar, stats.strong_samples);
+    SHELL_OUTPUT(output, "---- weak: SRTT %lu, RTTVAR %lu, samples %u\n",
+                 (unsigned long)stats.weak_srtt,
+                 (unsigned long)stats.weak_rttvar, stats.weak_samples);
+    SHELL_OUTPUT(output, "---- retransmissions %u, timeouts %u\n",
+                 stats.retransmissions, stats.timeouts);
+  }
+
+  PT_END(pt);
+}
+#endif /* BUILD_WITH_COAP && COAP_CONGESTION_CONTROL */
 #if MAC_CONF_WITH_TSCH
 /*---------------------------------------------------------------------------*/
 static
@@ -981,6 +1078,15 @@ const struct shell_command_t builtin_shell_commands[] = {
   { "reboot",               cmd_reboot,               "'> reboot': Reboot the board by watchdog_reboot()" },
   { "log",                  cmd_log,                  "'> log module level': Sets log level (0--4) for a given module (or \"all\"). For module \"mac\", level 4 also enables per-slot logging." },
   { "mac-addr",             cmd_macaddr,               "'> mac-addr': Shows the node's MAC address" },
+#ifdef HEAPMEM_CONF_ARENA_SIZE
+  { "heapmem",              cmd_heapmem,              "'> heapmem': Shows the heap memory statistics of each zone and slab class" },
+#endif /* HEAPMEM_CONF_ARENA_SIZE */
+#if BUILD_WITH_COFFEE
+  { "coffee-gc",            cmd_coffee_gc,            "'> coffee-gc': Shows the garbage collection statistics of the Coffee file system" },
+#endif /* BUILD_WITH_COFFEE */
+#if BUILD_WITH_COAP && COAP_CONGESTION_CONTROL
+  { "coap-rto",             cmd_coap_rto,             "'> coap-rto': Shows the CoAP retransmission timeout estimates of each endpoint" },
+#endif /* BUILD_WITH_COAP && COAP_CONGESTION_CONTROL */
 #if NETSTACK_CONF_WITH_IPV6
   { "ip-addr",              cmd_ipaddr,               "'> ip-addr': Shows all IPv6 addresses" },
   { "ip-nbr",               cmd_ip_neighbors,         "'> ip-nbr': Shows all IPv6 neighbors" },
@@ -158,3 +158,55 @@ db_processing(db_handle_t *handle)
 {
   return handle->flags & DB_HANDLE_FLAG_PROCESSING;
 }
+
+#if DB_FEATURE_BATCH
+db_result_t
+db_batch_begin(const char *name)
+{
+  relation_t *rel;
+  db_result_t result;
+
+  rel = relation_load((char *)name);
+  if(rel == NULL) {
+    return DB_NAME_ERROR;
+  }
+
+  result = relation_batch_begin(rel);
+  if(DB_ERROR(result)) {
+    relation_release(rel);
+  }
+
+  return result;
+}
+
+db_result_t
+db_batch_commit(void)
+{
+  return relation_batch_commit();
+}
+
+db_result_t
+db_batch_end(void)
+{
+  return relation_batch_end();
+}
+#endif /* DB_FEATURE_BATCH */
+
+#if DB_FEATURE_TIMESERIES
+db_result_t
+db_set_timeseries(const char *name)
+{
+  relation_t *rel;
+  db_result_t result;
+
+  rel = relation_load((char *)name);
+  if(rel == NULL) {
+    return DB_NAME_ERROR;
+  }
+
+  result = relation_set_timeseries(rel);
+  relation_release(rel);
+
+  return result;
+}
+#endif /* DB_FEATURE_TIMESERIES */
@@ -50,4 +50,13 @@ db_result_t db_print_header(db_handle_t *handle);
 db_result_t db_print_tuple(db_handle_t *handle);
 int db_processing(db_handle_t *handle);
 
+#if DB_FEATURE_BATCH
+db_result_t db_batch_begin(const char *name);
+db_result_t db_batch_commit(void);
+db_result_t db_batch_end(void);
+#endif /* DB_FEATURE_BATCH */
+#if DB_FEATURE_TIMESERIES
+db_result_t db_set_timeseries(const char *name);
+#endif /* DB_FEATURE_TIMESERIES */
+
 #endif /* DB_H */
@@ -87,6 +87,9 @@ aql_clear(aql_adt_t *adt)
   adt->attribute_count = 0;
   adt->value_count = 0;
   adt->flags = 0;
+#if DB_FEATURE_PREPARE
+  adt->parameter_count = 0;
+#endif /* DB_FEATURE_PREPARE */
   memset(adt->aggregators, 0, sizeof(adt->aggregators));
 }
 
@@ -162,3 +165,21 @@ aql_add_value(aql_adt_t *adt, domain_t domain, void *value_ptr)
 
   return DB_OK;
 }
+
+#if DB_FEATURE_PREPARE
+db_result_t
+aql_add_parameter(aql_adt_t *adt, uint8_t type, unsigned position)
+{
+  aql_parameter_t *parameter;
+
+  if(adt->parameter_count == AQL_PARAMETER_LIMIT) {
+    return DB_LIMIT_ERROR;
+  }
+
+  parameter = &adt->parameters[adt->parameter_count++];
+  parameter->type = type;
+  parameter->position = position;
+
+  return DB_OK;
+}
+#endif /* DB_FEATURE_PREPARE */
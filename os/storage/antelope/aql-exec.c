@@ -205,11 +205,159 @@ db_query(db_handle_t *handle, const char *format, ...)
     return DB_PARSING_ERROR;
   }
 
+#if DB_FEATURE_PREPARE
+  if(adt.parameter_count > 0) {
+    /* Parameters can only be bound in prepared statements. */
+    return DB_ARGUMENT_ERROR;
+  }
+#endif /* DB_FEATURE_PREPARE */
+
   /*aql_optimize(&adt);*/
 
   return aql_execute(handle, &adt);
 }
 
+#if DB_FEATURE_PREPARE
+db_result_t
+db_prepare(db_statement_t *stmt, const char *format, ...)
+{
+  va_list ap;
+  char query_string[AQL_MAX_QUERY_LENGTH];
+  lvm_instance_t *condition;
+  attribute_value_t *value;
+  size_t offset;
+  size_t length;
+  char *name;
+  int i;
+
+  va_start(ap, format);
+  vsnprintf(query_string, sizeof(query_string), format, ap);
+  va_end(ap);
+
+  if(AQL_ERROR(aql_parse(&stmt->adt, query_string))) {
+    return DB_PARSING_ERROR;
+  }
+
+  /* String values refer to a buffer that is reused by the parser,
+     so they are copied into the statement. */
+  offset = 0;
+  for(i = 0; i < stmt->adt.value_count; i++) {
+    value = &stmt->adt.values[i];
+    if(value->domain == DOMAIN_STRING) {
+      length = strlen((char *)VALUE_STRING(value)) + 1;
+      if(offset + length > sizeof(stmt->strings)) {
+        return DB_LIMIT_ERROR;
+      }
+      memcpy(&stmt->strings[offset], VALUE_STRING(value), length);
+      VALUE_STRING(value) = &stmt->strings[offset];
+      offset += length;
+    }
+  }
+
+  /* Keep the bytecode and the variable names of the condition, since
+     the LVM state will be overwritten when parsing other queries. */
+  memset(stmt->variables, 0, sizeof(stmt->variables));
+  condition = stmt->adt.lvm_instance;
+  if(condition != NULL) {
+    lvm_clone(&stmt->condition, condition);
+    memcpy(stmt->code, condition->code, sizeof(stmt->code));
+    stmt->condition.code = stmt->code;
+    stmt->adt.lvm_instance = &stmt->condition;
+
+    for(i = 0; i < LVM_MAX_VARIABLE_ID; i++) {
+      name = lvm_get_variable_name(i);
+      if(name == NULL) {
+        break;
+      }
+      strcpy(stmt->variables[i], name);
+    }
+  }
+
+  return DB_OK;
+}
+
+db_result_t
+db_bind(db_statement_t *stmt, unsigned index, long value)
+{
+  aql_parameter_t *parameter;
+  attribute_value_t *attr_value;
+
+  if(index >= stmt->adt.parameter_count) {
+    return DB_ARGUMENT_ERROR;
+  }
+
+  parameter = &stmt->adt.parameters[index];
+  if(parameter->type == AQL_PARAMETER_VALUE) {
+    attr_value = &stmt->adt.values[parameter->position];
+    attr_value->domain = DOMAIN_INT;
+    VALUE_LONG(attr_value) = value;
+    return DB_OK;
+  }
+
+  stmt->condition.code = stmt->code;
+  if(LVM_ERROR(lvm_set_long_operand(&stmt->condition,
+                                    parameter->position, value))) {
+    return DB_IMPLEMENTATION_ERROR;
+  }
+
+  return DB_OK;
+}
+
+db_result_t
+db_bind_string(db_statement_t *stmt, unsigned index, const char *value)
+{
+  aql_parameter_t *parameter;
+  attribute_value_t *attr_value;
+
+  if(index >= stmt->adt.parameter_count) {
+    return DB_ARGUMENT_ERROR;
+  }
+
+  /* The LVM handles only numeric operands. */
+  parameter = &stmt->adt.parameters[index];
+  if(parameter->type != AQL_PARAMETER_VALUE) {
+    return DB_TYPE_ERROR;
+  }
+
+  /* The string is not copied, so it must remain valid until
+     the statement has been executed. */
+  attr_value = &stmt->adt.values[parameter->position];
+  attr_value->domain = DOMAIN_STRING;
+  VALUE_STRING(attr_value) = (unsigned char *)value;
+
+  return DB_OK;
+}
+
+db_result_t
+db_execute(db_handle_t *handle, db_statement_t *stmt)
+{
+  int i;
+
+  if(handle != NULL) {
+    clear_handle(handle);
+  }
+
+  /* Execute a copy of the statement, because the execution may
+     modify the ADT. */
+  memcpy(&adt, &stmt->adt, sizeof(adt));
+
+  if(adt.lvm_instance != NULL) {
+    stmt->condition.code = stmt->code;
+    stmt->condition.ip = 0;
+    adt.lvm_instance = &stmt->condition;
+
+    /* Register the variables in their original order, so that they
+       get the same IDs as in the compiled code. */
+    lvm_reset_variables();
+    for(i = 0; i < LVM_MAX_VARIABLE_ID && stmt->variables[i][0] != '\0'; i++) {
+      lvm_register_variable(stmt->variables[i], LVM_LONG);
+    }
+  }
+
+  return aql_execute(handle, &adt);
+}
+#endif /* DB_FEATURE_PREPARE */
+
 db_result_t
 db_process(db_handle_t *handle)
 {
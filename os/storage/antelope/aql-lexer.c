@@ -65,6 +65,7 @@ static const struct keyword keywords[] = {
   {"*", MUL},
   {"/", DIV},
   {"#", COMMENT},
+  {"?", PARAMETER},
 
   {">=", GEQ},
   {"<=", LEQ},
@@ -92,6 +93,7 @@ static const struct keyword keywords[] = {
   {"WHERE", WHERE},
   {"COUNT", COUNT},
   {"INDEX", INDEX},
+  {"BTREE", BTREE},
 
   {"INSERT", INSERT},
   {"SELECT", SELECT},
@@ -112,9 +114,9 @@ static const struct keyword keywords[] = {
 };
 
 /* Provides a pointer to the first keyword of a specific length. */
-static const int8_t skip_hint[] = {0, 13, 21, 27, 33, 36, 44, 47, 48};
+static const int8_t skip_hint[] = {0, 14, 22, 28, 34, 38, 46, 49, 50};
 
-static char separators[] = "#.;,() \t\n";
+static char separators[] = "#.;,()? \t\n";
 
 int
 lexer_start(lexer_t *lexer, char *input, token_t *token, value_t *value)
@@ -107,6 +107,11 @@ static aql_adt_t *adt;
 static lvm_instance_t p;
 static unsigned char vmcode[DB_VM_BYTECODE_SIZE];
 
+/* The number of operands emitted into the bytecode. The order of the
+   operands is preserved when operators are shifted into prefix form,
+   so this number identifies the position of a parameter operand. */
+static uint8_t operand_count;
+
 /* Parsing functions for AQL. */
 PARSER_TOKEN(cmp)
 {
@@ -245,18 +250,37 @@ PARSER(values)
   NEXT;
   switch(TOKEN) {
   case STRING_VALUE:
-    AQL_ADD_VALUE(adt, DOMAIN_STRING, VALUE);
+    /* The strings of all values must fit in the buffer of the ADT. */
+    if(DB_ERROR(AQL_ADD_VALUE(adt, DOMAIN_STRING, VALUE))) {
+      RETURN(SYNTAX_ERROR);
+    }
     break;
   case INTEGER_VALUE:
-    AQL_ADD_VALUE(adt, DOMAIN_INT, VALUE);
+    if(DB_ERROR(AQL_ADD_VALUE(adt, DOMAIN_INT, VALUE))) {
+      RETURN(SYNTAX_ERROR);
+    }
+    break;
+#if DB_FEATURE_PREPARE
+  case PARAMETER:
+    if(DB_ERROR(AQL_ADD_PARAMETER(adt, AQL_PARAMETER_VALUE,
+                                  adt->value_count))) {
+      RETURN(SYNTAX_ERROR);
+    }
+    *(long *)lexer->value = 0;
+    if(DB_ERROR(AQL_ADD_VALUE(adt, DOMAIN_INT, VALUE))) {
+      RETURN(SYNTAX_ERROR);
+    }
     break;
+#endif /* DB_FEATURE_PREPARE */
   default:
     RETURN(SYNTAX_ERROR);
   }
 
   NEXT;
   if(TOKEN == COMMA) {
-    return PARSE(values);
+    if(!PARSE(values)) {
+      RETURN(SYNTAX_ERROR);
+    }
   } else {
     REWIND;
   }
@@ -274,6 +298,7 @@ PARSER(operand)
       RETURN(SYNTAX_ERROR);
     }
     AQL_ADD_PROCESSING_ATTRIBUTE(adt, VALUE);
+    operand_count++;
     break;
   case STRING_VALUE:
     break;
@@ -283,7 +308,20 @@ PARSER(operand)
     if(LVM_ERROR(lvm_set_long(&p, *(long *)lexer->value))) {
       RETURN(SYNTAX_ERROR);
     }
+    operand_count++;
     break;
+#if DB_FEATURE_PREPARE
+  case PARAMETER:
+    /* The parameter is compiled into a constant, which is
+       overwritten in the bytecode when a value is bound. */
+    if(DB_ERROR(AQL_ADD_PARAMETER(adt, AQL_PARAMETER_OPERAND,
+                                  operand_count)) ||
+       LVM_ERROR(lvm_set_long(&p, 0))) {
+      RETURN(SYNTAX_ERROR);
+    }
+    operand_count++;
+    break;
+#endif /* DB_FEATURE_PREPARE */
   default:
     RETURN(SYNTAX_ERROR);
   }
@@ -655,6 +693,9 @@ PARSER_TOKEN(index_type)
   case MEMHASH:
     type = INDEX_MEMHASH;
     break;
+  case BTREE:
+    type = INDEX_BTREE;
+    break;
   default:
     return NONE;
   };
@@ -799,6 +840,7 @@ aql_parse(aql_adt_t *external_adt, char *input_string)
   adt = external_adt;
   AQL_CLEAR(adt);
   AQL_SET_CONDITION(adt, NULL);
+  operand_count = 0;
 
   lexer_start(&lex, input_string, &token, &value);
 
@@ -42,6 +42,7 @@
 
 #include "db-options.h"
 #include "index.h"
+#include "lvm.h"
 #include "relation.h"
 #include "result.h"
 
@@ -104,6 +105,8 @@ enum token {
   MEMHASH = 46,
   RELATION = 47,
   ATTRIBUTE = 48,
+  BTREE = 49,
+  PARAMETER = 50,
 
   INTEGER_VALUE = 251,
   FLOAT_VALUE = 252,
@@ -145,6 +148,16 @@ struct aql_attribute {
 };
 typedef struct aql_attribute aql_attribute_t;
 
+#if DB_FEATURE_PREPARE
+/* A parameter slot is either the index of an INSERT value or the
+   ordinal number of a constant operand in the LVM code. */
+struct aql_parameter {
+  uint8_t type;
+  uint8_t position;
+};
+typedef struct aql_parameter aql_parameter_t;
+#endif /* DB_FEATURE_PREPARE */
+
 struct aql_adt {
   char relations[AQL_RELATION_LIMIT][RELATION_NAME_LENGTH + 1];
   aql_attribute_t attributes[AQL_ATTRIBUTE_LIMIT];
@@ -156,10 +169,28 @@ struct aql_adt {
   uint8_t value_count;
   uint8_t optype;
   uint8_t flags;
+#if DB_FEATURE_PREPARE
+  uint8_t parameter_count;
+  aql_parameter_t parameters[AQL_PARAMETER_LIMIT];
+#endif /* DB_FEATURE_PREPARE */
   void *lvm_instance;
 };
 typedef struct aql_adt aql_adt_t;
 
+#if DB_FEATURE_PREPARE
+/* A compiled AQL statement that can be executed multiple times.
+   The statement keeps its own copy of the LVM code, so that
+   other queries may be processed between executions. */
+struct db_statement {
+  aql_adt_t adt;
+  lvm_instance_t condition;
+  unsigned char code[DB_VM_BYTECODE_SIZE];
+  char variables[LVM_MAX_VARIABLE_ID][LVM_MAX_NAME_LENGTH + 1];
+  unsigned char strings[DB_MAX_CHAR_SIZE_PER_ROW];
+};
+typedef struct db_statement db_statement_t;
+#endif /* DB_FEATURE_PREPARE */
+
 #define AQL_TYPE_NONE           	0
 #define AQL_TYPE_SELECT			1
 #define AQL_TYPE_INSERT			2
@@ -180,6 +211,9 @@ typedef struct aql_adt aql_adt_t;
 #define AQL_FLAG_ASSIGN			2
 #define AQL_FLAG_INVERSE_LOGIC		4
 
+#define AQL_PARAMETER_VALUE		1
+#define AQL_PARAMETER_OPERAND		2
+
 #define AQL_CLEAR(adt)			aql_clear(adt)
 #define AQL_SET_TYPE(adt, type)	(((adt))->optype = (type))
 #define AQL_GET_TYPE(adt)		((adt)->optype)
@@ -204,6 +238,8 @@ typedef struct aql_adt aql_adt_t;
 #define AQL_SET_CONDITION(adt, cond)	((adt)->lvm_instance = (cond))
 #define AQL_ADD_VALUE(adt, domain, value)				\
     aql_add_value((adt), (domain), (value))
+#define AQL_ADD_PARAMETER(adt, type, position)				\
+    aql_add_parameter((adt), (type), (position))
 
 int lexer_start(lexer_t *, char *, token_t *, value_t *);
 int lexer_next(lexer_t *);
@@ -219,4 +255,14 @@ db_result_t aql_add_value(aql_adt_t *adt, domain_t domain, void *value);
 db_result_t db_query(db_handle_t *handle, const char *format, ...);
 db_result_t db_process(db_handle_t *handle);
 
+#if DB_FEATURE_PREPARE
+db_result_t aql_add_parameter(aql_adt_t *adt, uint8_t type,
+                              unsigned position);
+db_result_t db_prepare(db_statement_t *stmt, const char *format, ...);
+db_result_t db_bind(db_statement_t *stmt, unsigned index, long value);
+db_result_t db_bind_string(db_statement_t *stmt, unsigned index,
+                           const char *value);
+db_result_t db_execute(db_handle_t *handle, db_statement_t *stmt);
+#endif /* DB_FEATURE_PREPARE */
+
 #endif /* !AQL_H */
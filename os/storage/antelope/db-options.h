@@ -65,6 +65,31 @@
 #define DB_FEATURE_COFFEE		1
 #endif /* DB_FEATURE_COFFEE */
 
+/* Support B+-tree indexes, which answer range queries from flash. */
+#ifndef DB_FEATURE_BTREE
+#define DB_FEATURE_BTREE		0
+#endif /* DB_FEATURE_BTREE */
+
+/* Support batches of inserts that are written to the storage together. */
+#ifndef DB_FEATURE_BATCH
+#define DB_FEATURE_BATCH		0
+#endif /* DB_FEATURE_BATCH */
+
+/* Support prepared statements with bound parameters. */
+#ifndef DB_FEATURE_PREPARE
+#define DB_FEATURE_PREPARE		0
+#endif /* DB_FEATURE_PREPARE */
+
+/* Answer aggregate queries from the keys of an index when possible. */
+#ifndef DB_FEATURE_AGGREGATE
+#define DB_FEATURE_AGGREGATE		0
+#endif /* DB_FEATURE_AGGREGATE */
+
+/* Support time-series relations, which store tuples in compressed blocks. */
+#ifndef DB_FEATURE_TIMESERIES
+#define DB_FEATURE_TIMESERIES		0
+#endif /* DB_FEATURE_TIMESERIES */
+
 /* Enable basic data integrity checks. */
 #ifndef DB_FEATURE_INTEGRITY
 #define DB_FEATURE_INTEGRITY		0
@@ -99,6 +124,16 @@
 #define DB_MAX_ATTRIBUTES_PER_RELATION	6
 #endif /* DB_MAX_ATTRIBUTES_PER_RELATION */
 
+/* The size of the buffer for the tuples of an insert batch. */
+#ifndef DB_BATCH_BUFFER_SIZE
+#define DB_BATCH_BUFFER_SIZE		128
+#endif /* DB_BATCH_BUFFER_SIZE */
+
+/* The size of the tuples in a compressed block of a time-series relation. */
+#ifndef DB_TIMESERIES_BLOCK_SIZE
+#define DB_TIMESERIES_BLOCK_SIZE	256
+#endif /* DB_TIMESERIES_BLOCK_SIZE */
+
 /* The maximum physical storage size on an attribute value. */
 #ifndef DB_MAX_ELEMENT_SIZE
 #define DB_MAX_ELEMENT_SIZE		16
@@ -134,6 +169,11 @@
 #define AQL_ATTRIBUTE_LIMIT    		5
 #endif /* AQL_ATTRIBUTE_LIMIT */
 
+/* The maximum number of parameters in a prepared statement. */
+#ifndef AQL_PARAMETER_LIMIT
+#define AQL_PARAMETER_LIMIT    		4
+#endif /* AQL_PARAMETER_LIMIT */
+
 /*----------------------------------------------------------------------------*/
 
 /*
@@ -215,6 +255,31 @@
 #define DB_HEAP_CACHE_LIMIT		1
 #endif /* DB_HEAP_CACHE_LIMIT */
 
+/* The maximum number of B+-tree indexes. */
+#ifndef DB_BTREE_INDEX_LIMIT
+#define DB_BTREE_INDEX_LIMIT		1
+#endif /* DB_BTREE_INDEX_LIMIT */
+
+/* The maximum number of nodes cached in the B+-tree index. */
+#ifndef DB_BTREE_CACHE_LIMIT
+#define DB_BTREE_CACHE_LIMIT		4
+#endif /* DB_BTREE_CACHE_LIMIT */
+
+/* The storage size of a B+-tree node. */
+#ifndef DB_BTREE_NODE_SIZE
+#define DB_BTREE_NODE_SIZE		128
+#endif /* DB_BTREE_NODE_SIZE */
+
+/* The maximum number of nodes in a B+-tree, which sets its file size. */
+#ifndef DB_BTREE_NODE_LIMIT
+#define DB_BTREE_NODE_LIMIT		256
+#endif /* DB_BTREE_NODE_LIMIT */
+
+/* The maximum height of a B+-tree. */
+#ifndef DB_BTREE_MAX_HEIGHT
+#define DB_BTREE_MAX_HEIGHT		6
+#endif /* DB_BTREE_MAX_HEIGHT */
+
 /*----------------------------------------------------------------------------*/
 
 /* LVM options. */
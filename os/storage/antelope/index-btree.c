@@ -0,0 +1,780 @@
+/*
+ * Copyright (c) 2026, RISE Research Institutes of Sweden.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ *	A B+-tree index for flash memory.
+ *
+ *      The index keeps its nodes in a single file, with a header in the
+ *      first node slot. Each node occupies DB_BTREE_NODE_SIZE bytes.
+ *      Leaves hold sorted (key, tuple id) pairs and are linked from
+ *      left to right, so that a range query descends once to the first
+ *      key of the range and then reads the leaves in order.
+ *
+ *      Nodes are modified in a small write-back cache in RAM, and written
+ *      to the storage when they are evicted from the cache or when the
+ *      index is released. Because keys such as time stamps are mostly
+ *      inserted in increasing order, a full rightmost leaf is split by
+ *      starting a new leaf with the new key, instead of moving half of
+ *      the entries. The leaves therefore stay full and each of them is
+ *      written a few times only.
+ *
+ *      Deleted entries are removed from their leaves, but nodes are not
+ *      merged. Emptied leaves stay in the tree until it is rebuilt.
+ */
+
+#include <stddef.h>
+#include <string.h>
+
+#include "cfs/cfs.h"
+#include "lib/memb.h"
+
+#include "db-options.h"
+#include "index.h"
+#include "result.h"
+#include "storage.h"
+
+#define DEBUG DEBUG_NONE
+#include "net/ipv6/uip-debug.h"
+
+#define BTREE_MAGIC		0x4254
+
+typedef int32_t btree_key_t;
+typedef uint16_t btree_node_id_t;
+
+/* LONG values can be wider than the keys, which must not be truncated. */
+#define KEY_IN_RANGE(value)	((value) >= INT32_MIN && (value) <= INT32_MAX)
+
+/* The header occupies node 0, so no node refers to it as a child. */
+#define HEADER_NODE		0
+
+struct btree_header {
+  uint16_t magic;
+  btree_node_id_t root;
+  btree_node_id_t node_count;
+  uint8_t height;
+};
+
+struct btree_pair {
+  btree_key_t key;
+  tuple_id_t value;
+};
+
+#define NODE_HEADER_SIZE	8
+#define LEAF_ORDER		((DB_BTREE_NODE_SIZE - NODE_HEADER_SIZE) / \
+				 sizeof(struct btree_pair))
+#define INNER_ORDER		((DB_BTREE_NODE_SIZE - NODE_HEADER_SIZE + \
+				  sizeof(btree_key_t)) / \
+				 (sizeof(btree_key_t) + sizeof(btree_node_id_t)))
+
+struct btree_node {
+  /* The number of pairs in a leaf, or of keys in an inner node. */
+  uint16_t count;
+  /* The next leaf to the right, or HEADER_NODE in the last leaf. */
+  btree_node_id_t next;
+  uint8_t leaf;
+  uint8_t unused[NODE_HEADER_SIZE - 5];
+  union {
+    struct btree_pair pairs[LEAF_ORDER];
+    struct {
+      btree_key_t keys[INNER_ORDER - 1];
+      btree_node_id_t children[INNER_ORDER];
+    } inner;
+  } u;
+};
+
+struct btree {
+  db_storage_id_t storage;
+  struct btree_header header;
+  uint8_t header_dirty;
+};
+typedef struct btree btree_t;
+
+struct node_cache {
+  btree_t *tree;
+  btree_node_id_t id;
+  uint16_t last_used;
+  uint8_t dirty;
+  struct btree_node node;
+};
+
+/* Keep a cache of nodes read from storage. */
+static struct node_cache node_cache[DB_BTREE_CACHE_LIMIT];
+static uint16_t cache_clock;
+MEMB(btrees, btree_t, DB_BTREE_INDEX_LIMIT);
+
+static int node_flush(struct node_cache *);
+static struct node_cache *get_cache_victim(void);
+static struct btree_node *node_load(btree_t *, btree_node_id_t);
+static struct btree_node *node_new(btree_t *, btree_node_id_t *);
+static int tree_flush(btree_t *);
+static btree_node_id_t find_leaf(btree_t *, btree_key_t,
+                                 btree_node_id_t *, int *);
+static int insert_pair(btree_t *, btree_key_t, tuple_id_t);
+static int insert_key(btree_t *, btree_node_id_t *, int,
+                      btree_key_t, btree_node_id_t);
+
+static db_result_t create(index_t *);
+static db_result_t destroy(index_t *);
+static db_result_t load(index_t *);
+static db_result_t release(index_t *);
+static db_result_t insert(index_t *, attribute_value_t *, tuple_id_t);
+static db_result_t delete(index_t *, attribute_value_t *);
+static tuple_id_t get_next(index_iterator_t *);
+
+index_api_t index_btree = {
+  INDEX_BTREE,
+#if DB_FEATURE_AGGREGATE
+  INDEX_API_EXTERNAL | INDEX_API_RANGE_QUERIES | INDEX_API_KEYS,
+#else
+  INDEX_API_EXTERNAL | INDEX_API_RANGE_QUERIES,
+#endif /* DB_FEATURE_AGGREGATE */
+  create,
+  destroy,
+  load,
+  release,
+  insert,
+  delete,
+  get_next
+};
+
+static int
+node_flush(struct node_cache *cache)
+{
+  if(cache->tree == NULL || !cache->dirty) {
+    return 1;
+  }
+
+  if(DB_ERROR(storage_write(cache->tree->storage, &cache->node,
+                            (unsigned long)cache->id * DB_BTREE_NODE_SIZE,
+                            sizeof(cache->node)))) {
+    PRINTF("DB: Failed to write B+-tree node %u\n", (unsigned)cache->id);
+    return 0;
+  }
+  cache->dirty = 0;
+
+  return 1;
+}
+
+static struct node_cache *
+get_cache_victim(void)
+{
+  struct node_cache *victim;
+  int i;
+
+  /* Evict the least recently used node, and write it if needed. */
+  victim = &node_cache[0];
+  for(i = 0; i < DB_BTREE_CACHE_LIMIT; i++) {
+    if(node_cache[i].tree == NULL) {
+      return &node_cache[i];
+    }
+    if((uint16_t)(cache_clock - node_cache[i].last_used) >
+       (uint16_t)(cache_clock - victim->last_used)) {
+      victim = &node_cache[i];
+    }
+  }
+
+  if(node_flush(victim) == 0) {
+    return NULL;
+  }
+  victim->tree = NULL;
+
+  return victim;
+}
+
+/*
+ * Returns a node from the cache, after reading it from the storage if
+ * necessary. The pointer is valid until the next node is loaded. The
+ * caller sets the dirty flag of the cache entry through node_dirty()
+ * after modifying the node.
+ */
+static struct btree_node *
+node_load(btree_t *tree, btree_node_id_t id)
+{
+  struct node_cache *cache;
+  int i;
+
+  cache_clock++;
+
+  for(i = 0; i < DB_BTREE_CACHE_LIMIT; i++) {
+    if(node_cache[i].tree == tree && node_cache[i].id == id) {
+      node_cache[i].last_used = cache_clock;
+      return &node_cache[i].node;
+    }
+  }
+
+  if(id == HEADER_NODE || id >= tree->header.node_count) {
+    PRINTF("DB: Invalid B+-tree node %u\n", (unsigned)id);
+    return NULL;
+  }
+
+  cache = get_cache_victim();
+  if(cache == NULL) {
+    return NULL;
+  }
+
+  if(DB_ERROR(storage_read(tree->storage, &cache->node,
+                           (unsigned long)id * DB_BTREE_NODE_SIZE,
+                           sizeof(cache->node)))) {
+    PRINTF("DB: Failed to read B+-tree node %u\n", (unsigned)id);
+    return NULL;
+  }
+
+  cache->tree = tree;
+  cache->id = id;
+  cache->dirty = 0;
+  cache->last_used = cache_clock;
+
+  return &cache->node;
+}
+
+static void
+node_dirty(struct btree_node *node)
+{
+  struct node_cache *cache;
+
+  cache = (struct node_cache *)((char *)node -
+                                offsetof(struct node_cache, node));
+  cache->dirty = 1;
+}
+
+/* Allocates a cleared node in the cache, without reading the storage. */
+static struct btree_node *
+node_new(btree_t *tree, btree_node_id_t *id)
+{
+  struct node_cache *cache;
+
+  if(tree->header.node_count >= DB_BTREE_NODE_LIMIT) {
+    PRINTF("DB: No more B+-tree nodes available\n");
+    return NULL;
+  }
+
+  cache = get_cache_victim();
+  if(cache == NULL) {
+    return NULL;
+  }
+
+  *id = tree->header.node_count++;
+  tree->header_dirty = 1;
+
+  memset(&cache->node, 0, sizeof(cache->node));
+  cache->tree = tree;
+  cache->id = *id;
+  cache->dirty = 1;
+  cache->last_used = ++cache_clock;
+
+  return &cache->node;
+}
+
+static int
+tree_flush(btree_t *tree)
+{
+  int i;
+  int r;
+
+  r = 1;
+  for(i = 0; i < DB_BTREE_CACHE_LIMIT; i++) {
+    if(node_cache[i].tree == tree && node_flush(&node_cache[i]) == 0) {
+      r = 0;
+    }
+  }
+
+  if(tree->header_dirty) {
+    if(DB_ERROR(storage_write(tree->storage, &tree->header, 0,
+                              sizeof(tree->header)))) {
+      return 0;
+    }
+    tree->header_dirty = 0;
+  }
+
+  return r;
+}
+
+/*
+ * Descends to the leaf for a key. A search passes no path, and goes
+ * left of separators equal to the key, because duplicates of the key
+ * may remain in the leaf to the left of such a separator. An insertion
+ * goes right of them instead, and records the visited inner nodes in
+ * the path, so that the insertion can split them.
+ */
+static btree_node_id_t
+find_leaf(btree_t *tree, btree_key_t key, btree_node_id_t *path, int *depth)
+{
+  struct btree_node *node;
+  btree_node_id_t id;
+  int level;
+  int i;
+
+  id = tree->header.root;
+  for(level = 0; level < tree->header.height - 1; level++) {
+    node = node_load(tree, id);
+    if(node == NULL || node->leaf) {
+      return HEADER_NODE;
+    }
+    if(path != NULL) {
+      path[level] = id;
+    }
+    for(i = 0; i < node->count; i++) {
+      if(path != NULL ? key < node->u.inner.keys[i] :
+                        key <= node->u.inner.keys[i]) {
+        break;
+      }
+    }
+    id = node->u.inner.children[i];
+  }
+
+  if(depth != NULL) {
+    *depth = level;
+  }
+
+  return id;
+}
+
+/*
+ * Inserts a separator key and the node to its right into the inner
+ * nodes along the path, splitting them from the bottom up as needed.
+ */
+static int
+insert_key(btree_t *tree, btree_node_id_t *path, int depth,
+           btree_key_t key, btree_node_id_t child)
+{
+  static btree_key_t keys[INNER_ORDER];
+  static btree_node_id_t children[INNER_ORDER + 1];
+  struct btree_node *node;
+  btree_node_id_t id;
+  int count;
+  int half;
+  int i;
+
+  while(depth-- > 0) {
+    node = node_load(tree, path[depth]);
+    if(node == NULL) {
+      return 0;
+    }
+
+    for(i = node->count; i > 0 && node->u.inner.keys[i - 1] > key; i--);
+
+    if(node->count < INNER_ORDER - 1) {
+      memmove(&node->u.inner.keys[i + 1], &node->u.inner.keys[i],
+              (node->count - i) * sizeof(keys[0]));
+      memmove(&node->u.inner.children[i + 2], &node->u.inner.children[i + 1],
+              (node->count - i) * sizeof(children[0]));
+      node->u.inner.keys[i] = key;
+      node->u.inner.children[i + 1] = child;
+      node->count++;
+      node_dirty(node);
+      return 1;
+    }
+
+    /* Split the full node around its middle key. */
+    count = node->count;
+    memcpy(keys, node->u.inner.keys, i * sizeof(keys[0]));
+    keys[i] = key;
+    memcpy(&keys[i + 1], &node->u.inner.keys[i],
+           (count - i) * sizeof(keys[0]));
+    memcpy(children, node->u.inner.children, (i + 1) * sizeof(children[0]));
+    children[i + 1] = child;
+    memcpy(&children[i + 2], &node->u.inner.children[i + 1],
+           (count - i) * sizeof(children[0]));
+    count++;
+    half = count / 2;
+
+    memcpy(node->u.inner.keys, keys, half * sizeof(keys[0]));
+    memcpy(node->u.inner.children, children, (half + 1) * sizeof(children[0]));
+    node->count = half;
+    node_dirty(node);
+
+    node = node_new(tree, &id);
+    if(node == NULL) {
+      return 0;
+    }
+    node->count = count - half - 1;
+    memcpy(node->u.inner.keys, &keys[half + 1],
+           node->count * sizeof(keys[0]));
+    memcpy(node->u.inner.children, &children[half + 1],
+           (node->count + 1) * sizeof(children[0]));
+
+    key = keys[half];
+    child = id;
+  }
+
+  /* The root was split; grow the tree by one level. */
+  node = node_new(tree, &id);
+  if(node == NULL) {
+    return 0;
+  }
+  node->count = 1;
+  node->u.inner.keys[0] = key;
+  node->u.inner.children[0] = tree->header.root;
+  node->u.inner.children[1] = child;
+  tree->header.root = id;
+  tree->header.height++;
+
+  PRINTF("DB: The B+-tree grew to height %u\n",
+         (unsigned)tree->header.height);
+
+  return 1;
+}
+
+static int
+insert_pair(btree_t *tree, btree_key_t key, tuple_id_t value)
+{
+  static struct btree_pair moved[LEAF_ORDER];
+  btree_node_id_t path[DB_BTREE_MAX_HEIGHT];
+  struct btree_node *node;
+  btree_node_id_t leaf_id;
+  btree_node_id_t id;
+  btree_node_id_t next;
+  int depth;
+  int count;
+  int i;
+
+  if(tree->header.height >= DB_BTREE_MAX_HEIGHT) {
+    return 0;
+  }
+
+  leaf_id = find_leaf(tree, key, path, &depth);
+  node = node_load(tree, leaf_id);
+  if(node == NULL || !node->leaf) {
+    return 0;
+  }
+
+  for(i = node->count; i > 0 && node->u.pairs[i - 1].key > key; i--);
+
+  if(node->count < LEAF_ORDER) {
+    memmove(&node->u.pairs[i + 1], &node->u.pairs[i],
+            (node->count - i) * sizeof(node->u.pairs[0]));
+    node->u.pairs[i].key = key;
+    node->u.pairs[i].value = value;
+    node->count++;
+    node_dirty(node);
+    return 1;
+  }
+
+  if(i == node->count && node->next == HEADER_NODE) {
+    /* Appending to the last leaf; start a new leaf with the key. */
+    count = 0;
+  } else {
+    /* Move the upper half of the leaf, including the new pair. */
+    count = LEAF_ORDER + 1 - (LEAF_ORDER + 1) / 2;
+    if(i < LEAF_ORDER - count + 1) {
+      memcpy(moved, &node->u.pairs[LEAF_ORDER - count],
+             count * sizeof(moved[0]));
+      memmove(&node->u.pairs[i + 1], &node->u.pairs[i],
+              (LEAF_ORDER - count - i) * sizeof(moved[0]));
+      node->u.pairs[i].key = key;
+      node->u.pairs[i].value = value;
+    } else {
+      i -= LEAF_ORDER - count + 1;
+      memcpy(moved, &node->u.pairs[LEAF_ORDER - count + 1],
+             i * sizeof(moved[0]));
+      moved[i].key = key;
+      moved[i].value = value;
+      memcpy(&moved[i + 1], &node->u.pairs[LEAF_ORDER - count + 1 + i],
+             (count - i - 1) * sizeof(moved[0]));
+    }
+    node->count = LEAF_ORDER + 1 - count;
+  }
+  next = node->next;
+  node_dirty(node);
+
+  node = node_new(tree, &id);
+  if(node == NULL) {
+    return 0;
+  }
+  node->leaf = 1;
+  node->next = next;
+  if(count == 0) {
+    node->count = 1;
+    node->u.pairs[0].key = key;
+    node->u.pairs[0].value = value;
+  } else {
+    node->count = count;
+    memcpy(node->u.pairs, moved, count * sizeof(moved[0]));
+  }
+  key = node->u.pairs[0].key;
+
+  /* Link the split leaf to the new one. */
+  node = node_load(tree, leaf_id);
+  if(node == NULL) {
+    return 0;
+  }
+  node->next = id;
+  node_dirty(node);
+
+  return insert_key(tree, path, depth, key, id);
+}
+
+static db_result_t
+create(index_t *index)
+{
+  char *filename;
+  btree_t *tree;
+  struct btree_node *node;
+  btree_node_id_t id;
+
+  filename = storage_generate_file("btree",
+                                   (unsigned long)DB_BTREE_NODE_LIMIT *
+                                   DB_BTREE_NODE_SIZE);
+  if(filename == NULL) {
+    PRINTF("DB: Failed to generate a B+-tree file\n");
+    return DB_INDEX_ERROR;
+  }
+
+  memcpy(index->descriptor_file, filename, sizeof(index->descriptor_file));
+
+  index->opaque_data = tree = memb_alloc(&btrees);
+  if(tree == NULL) {
+    PRINTF("DB: Failed to allocate a B+-tree\n");
+    cfs_remove(index->descriptor_file);
+    return DB_ALLOCATION_ERROR;
+  }
+
+  tree->storage = storage_open(index->descriptor_file);
+  if(tree->storage < 0) {
+    memb_free(&btrees, tree);
+    cfs_remove(index->descriptor_file);
+    return DB_STORAGE_ERROR;
+  }
+
+  /* The tree starts as a single, empty leaf. */
+  tree->header.magic = BTREE_MAGIC;
+  tree->header.node_count = HEADER_NODE + 1;
+  tree->header.height = 1;
+  tree->header_dirty = 1;
+  node = node_new(tree, &id);
+  if(node == NULL) {
+    release(index);
+    cfs_remove(index->descriptor_file);
+    return DB_INDEX_ERROR;
+  }
+  node->leaf = 1;
+  tree->header.root = id;
+
+  if(tree_flush(tree) == 0) {
+    release(index);
+    cfs_remove(index->descriptor_file);
+    return DB_STORAGE_ERROR;
+  }
+
+  PRINTF("DB: Created a B+-tree index in file %s\n", index->descriptor_file);
+
+  return DB_OK;
+}
+
+static db_result_t
+destroy(index_t *index)
+{
+  cfs_remove(index->descriptor_file);
+  return DB_OK;
+}
+
+static db_result_t
+load(index_t *index)
+{
+  btree_t *tree;
+
+  index->opaque_data = tree = memb_alloc(&btrees);
+  if(tree == NULL) {
+    PRINTF("DB: Failed to allocate a B+-tree\n");
+    return DB_ALLOCATION_ERROR;
+  }
+
+  tree->storage = storage_open(index->descriptor_file);
+  if(tree->storage < 0) {
+    memb_free(&btrees, tree);
+    return DB_STORAGE_ERROR;
+  }
+
+  if(DB_ERROR(storage_read(tree->storage, &tree->header, 0,
+                           sizeof(tree->header))) ||
+     tree->header.magic != BTREE_MAGIC) {
+    PRINTF("DB: Invalid B+-tree file %s\n", index->descriptor_file);
+    storage_close(tree->storage);
+    memb_free(&btrees, tree);
+    return DB_INDEX_ERROR;
+  }
+  tree->header_dirty = 0;
+
+  PRINTF("DB: Loaded a B+-tree index of height %u from file %s\n",
+         (unsigned)tree->header.height, index->descriptor_file);
+
+  return DB_OK;
+}
+
+static db_result_t
+release(index_t *index)
+{
+  btree_t *tree;
+  db_result_t result;
+  int i;
+
+  tree = index->opaque_data;
+
+  result = tree_flush(tree) ? DB_OK : DB_STORAGE_ERROR;
+
+  for(i = 0; i < DB_BTREE_CACHE_LIMIT; i++) {
+    if(node_cache[i].tree == tree) {
+      node_cache[i].tree = NULL;
+    }
+  }
+
+  storage_close(tree->storage);
+  memb_free(&btrees, tree);
+
+  return result;
+}
+
+static db_result_t
+insert(index_t *index, attribute_value_t *key, tuple_id_t value)
+{
+  btree_t *tree;
+  long long_key;
+
+  tree = (btree_t *)index->opaque_data;
+
+  long_key = db_value_to_long(key);
+  if(!KEY_IN_RANGE(long_key)) {
+    PRINTF("DB: Key %ld is out of the range of a B+-tree index\n", long_key);
+    return DB_INDEX_ERROR;
+  }
+
+  if(insert_pair(tree, (btree_key_t)long_key, value) == 0) {
+    PRINTF("DB: Failed to insert key %ld into a B+-tree index\n", long_key);
+    return DB_INDEX_ERROR;
+  }
+  return DB_OK;
+}
+
+static db_result_t
+delete(index_t *index, attribute_value_t *value)
+{
+  btree_t *tree;
+  struct btree_node *node;
+  btree_node_id_t id;
+  btree_key_t key;
+  long long_key;
+  int i;
+  int j;
+
+  tree = (btree_t *)index->opaque_data;
+  long_key = db_value_to_long(value);
+  if(!KEY_IN_RANGE(long_key)) {
+    return DB_INDEX_ERROR;
+  }
+  key = (btree_key_t)long_key;
+
+  /* Remove all pairs with the key, which may span several leaves. */
+  for(id = find_leaf(tree, key, NULL, NULL); id != HEADER_NODE;
+      id = node->next) {
+    node = node_load(tree, id);
+    if(node == NULL) {
+      return DB_STORAGE_ERROR;
+    }
+
+    for(i = j = 0; i < node->count; i++) {
+      if(node->u.pairs[i].key != key) {
+        node->u.pairs[j++] = node->u.pairs[i];
+      }
+    }
+    if(j != node->count) {
+      node->count = j;
+      node_dirty(node);
+    }
+
+    if(j > 0 && node->u.pairs[j - 1].key > key) {
+      break;
+    }
+  }
+
+  return DB_OK;
+}
+
+static tuple_id_t
+get_next(index_iterator_t *iterator)
+{
+  struct iteration_cache {
+    index_iterator_t *index_iterator;
+    btree_node_id_t leaf;
+    uint16_t slot;
+  };
+  static struct iteration_cache cache;
+  btree_t *tree;
+  struct btree_node *node;
+  struct btree_pair *pair;
+  long min;
+  long max;
+
+  tree = (btree_t *)iterator->index->opaque_data;
+  min = db_value_to_long(&iterator->min_value);
+  max = db_value_to_long(&iterator->max_value);
+
+  /* Open ranges derived from a condition such as "a > 10" are bounded
+     by LONG_MIN or LONG_MAX, which do not fit in a key. */
+  if(min < INT32_MIN) {
+    min = INT32_MIN;
+  }
+  if(max > INT32_MAX) {
+    max = INT32_MAX;
+  }
+
+  if(cache.index_iterator != iterator || iterator->next_item_no == 0) {
+    /* Descend to the first leaf of a new search. */
+    cache.index_iterator = iterator;
+    cache.leaf = find_leaf(tree, (btree_key_t)min, NULL, NULL);
+    cache.slot = 0;
+  }
+
+  while(cache.leaf != HEADER_NODE) {
+    node = node_load(tree, cache.leaf);
+    if(node == NULL) {
+      break;
+    }
+
+    while(cache.slot < node->count) {
+      pair = &node->u.pairs[cache.slot++];
+      if(pair->key > max) {
+        cache.leaf = HEADER_NODE;
+        return INVALID_TUPLE;
+      }
+      if(pair->key >= min) {
+        iterator->next_item_no++;
+#if DB_FEATURE_AGGREGATE
+        iterator->key = pair->key;
+#endif /* DB_FEATURE_AGGREGATE */
+        return pair->value;
+      }
+    }
+
+    cache.leaf = node->next;
+    cache.slot = 0;
+  }
+
+  return INVALID_TUPLE;
+}
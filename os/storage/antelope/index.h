@@ -42,7 +42,8 @@ typedef enum {
   INDEX_NONE = 0,
   INDEX_INLINE = 1,
   INDEX_MEMHASH = 2,
-  INDEX_MAXHEAP = 3
+  INDEX_MAXHEAP = 3,
+  INDEX_BTREE = 4
 } index_type_t;
 
 #define INDEX_READY		0x00
@@ -54,6 +55,8 @@ typedef enum {
 #define INDEX_API_INLINE	0x04
 #define INDEX_API_COMPLETE	0x08
 #define INDEX_API_RANGE_QUERIES	0x10
+/* The iterator reports the key of each item, in ascending key order. */
+#define INDEX_API_KEYS		0x20
 
 struct index_api;
 
@@ -76,6 +79,9 @@ struct index_iterator {
   attribute_value_t max_value;
   tuple_id_t next_item_no;
   tuple_id_t found_items;
+#if DB_FEATURE_AGGREGATE
+  long key;
+#endif /* DB_FEATURE_AGGREGATE */
 };
 typedef struct index_iterator index_iterator_t;
 
@@ -93,6 +99,7 @@ struct index_api {
 
 typedef struct index_api index_api_t;
 
+extern index_api_t index_btree;
 extern index_api_t index_inline;
 extern index_api_t index_maxheap;
 extern index_api_t index_memhash;
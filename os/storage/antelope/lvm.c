@@ -539,6 +539,62 @@ lvm_clone(lvm_instance_t *dst, lvm_instance_t *src)
   memcpy(dst, src, sizeof(*dst));
 }
 
+#if DB_FEATURE_PREPARE
+void
+lvm_reset_variables(void)
+{
+  memset(variables, 0, sizeof(variables));
+  memset(derivations, 0, sizeof(derivations));
+}
+
+char *
+lvm_get_variable_name(variable_id_t id)
+{
+  if(id >= LVM_MAX_VARIABLE_ID || variables[id].name[0] == '\0') {
+    return NULL;
+  }
+  return variables[id].name;
+}
+
+lvm_status_t
+lvm_set_long_operand(lvm_instance_t *p, unsigned index, long l)
+{
+  lvm_ip_t ip;
+  node_type_t type;
+  operand_t op;
+
+  /* Walk through the code until we reach the operand with the
+     requested ordinal number. */
+  for(ip = 0; ip + sizeof(type) <= p->end;) {
+    type = *(node_type_t *)(p->code + ip);
+    ip += sizeof(type);
+
+    switch(type) {
+    case LVM_OPERAND:
+      if(index-- == 0) {
+        memcpy(&op, &p->code[ip], sizeof(op));
+        if(op.type != LVM_LONG) {
+          return LVM_TYPE_ERROR;
+        }
+        op.value.l = l;
+        memcpy(&p->code[ip], &op, sizeof(op));
+        return LVM_TRUE;
+      }
+      ip += sizeof(operand_t);
+      break;
+    case LVM_ARITH_OP:
+    case LVM_CMP_OP:
+      ip += sizeof(operator_t);
+      break;
+    default:
+      return LVM_EXECUTION_ERROR;
+    }
+  }
+
+  return LVM_INVALID_IDENTIFIER;
+}
+#endif /* DB_FEATURE_PREPARE */
+
 static void
 create_intersection(derivation_t *result, derivation_t *d1, derivation_t *d2)
 {
@@ -141,4 +141,10 @@ lvm_status_t lvm_set_operand(lvm_instance_t *p, operand_t *op);
 lvm_status_t lvm_set_long(lvm_instance_t *p, long l);
 lvm_status_t lvm_set_variable(lvm_instance_t *p, char *name);
 
+#if DB_FEATURE_PREPARE
+void lvm_reset_variables(void);
+char *lvm_get_variable_name(variable_id_t id);
+lvm_status_t lvm_set_long_operand(lvm_instance_t *p, unsigned index, long l);
+#endif /* DB_FEATURE_PREPARE */
+
 #endif /* LVM_H */
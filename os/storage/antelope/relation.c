@@ -88,10 +88,35 @@ static unsigned char * const left_row = row;
 static unsigned char * const right_row = extra_row;
 static unsigned char * const join_row = result_row;
 
+/* The number of tuples that have been aggregated in a selection. */
+static tuple_id_t aggregation_count;
+
+#if DB_FEATURE_TIMESERIES
+/* The range of the first attribute in the tuples of a selection. */
+static struct {
+  long min;
+  long max;
+} block_range;
+#endif /* DB_FEATURE_TIMESERIES */
+
 LIST(relations);
 MEMB(relations_memb, relation_t, DB_RELATION_POOL_SIZE);
 MEMB(attributes_memb, attribute_t, DB_ATTRIBUTE_POOL_SIZE);
 
+#if DB_FEATURE_BATCH
+/*
+ * Tuples inserted into the relation of a batch are buffered in RAM.
+ * When the buffer is full or the batch is committed, the tuples are
+ * written to the storage in one append, and their keys are inserted
+ * into the indexes of the relation.
+ */
+static struct {
+  relation_t *rel;
+  tuple_id_t rows;
+  unsigned char buf[DB_BATCH_BUFFER_SIZE];
+} batch;
+#endif /* DB_FEATURE_BATCH */
+
 static relation_t *relation_find(char *);
 static attribute_t *attribute_find(relation_t *, char *);
 static int get_attribute_value_offset(relation_t *, attribute_t *);
@@ -100,6 +125,9 @@ static void purge_relations(void);
 static void relation_clear(relation_t *);
 static relation_t *relation_allocate(void);
 static void relation_free(relation_t *);
+#if DB_FEATURE_BATCH
+static db_result_t batch_flush(relation_t *);
+#endif /* DB_FEATURE_BATCH */
 
 static relation_t *
 relation_find(char *name)
@@ -176,6 +204,9 @@ relation_clear(relation_t *rel)
 {
   memset(rel, 0, sizeof(*rel));
   rel->tuple_storage = -1;
+#if DB_FEATURE_TIMESERIES
+  rel->tail_storage = -1;
+#endif /* DB_FEATURE_TIMESERIES */
   rel->cardinality = INVALID_TUPLE;
   rel->dir = DB_STORAGE;
   LIST_STRUCT_INIT(rel, attributes);
@@ -250,7 +281,9 @@ relation_load(char *name)
   list_add(relations, rel);
 
 end:
-  if(rel->dir == DB_STORAGE && DB_ERROR(storage_load(rel))) {
+  /* The tuple file is shared by all references to the relation. */
+  if(rel->dir == DB_STORAGE && !RELATION_HAS_TUPLES(rel) &&
+     DB_ERROR(storage_load(rel))) {
     relation_release(rel);
     return NULL;
   }
@@ -336,6 +369,12 @@ relation_attribute_add(relation_t *rel, db_direction_t dir, char *name,
   attribute_t *attribute;
   tuple_id_t cardinality;
 
+#if DB_FEATURE_BATCH
+  if(DB_ERROR(batch_flush(rel))) {
+    return NULL;
+  }
+#endif /* DB_FEATURE_BATCH */
+
   cardinality = relation_cardinality(rel);
   if(cardinality != INVALID_TUPLE && cardinality > 0) {
     PRINTF("DB: Attempt to create an attribute in a non-empty relation\n");
@@ -464,9 +503,13 @@ relation_remove(char *name, int remove_tuples)
   }
 
   if(rel->references > 1) {
+    relation_release(rel);
     return DB_BUSY_ERROR;
   }
 
+  /* Close the tuple file first, as the file system may be unable to
+     find the catalog while too many files are open. */
+  storage_unload(rel);
   result = storage_drop_relation(rel, remove_tuples);
   relation_free(rel);
   return result;
@@ -480,6 +523,7 @@ relation_insert(relation_t *rel, attribute_value_t *values)
   unsigned char *ptr;
   attribute_value_t *value;
   db_result_t result;
+  int deferred;
 
   value = values;
 
@@ -487,6 +531,13 @@ relation_insert(relation_t *rel, attribute_value_t *values)
 	 rel->name, (unsigned)rel->row_length);
   ptr = record;
 
+  /* The index keys of a batched tuple are inserted when the
+     batch is committed. */
+  deferred = 0;
+#if DB_FEATURE_BATCH
+  deferred = rel == batch.rel;
+#endif /* DB_FEATURE_BATCH */
+
   PRINTF("DB: Insert (");
 
   for(attr = list_head(rel->attributes); attr != NULL; attr = attr->next, value++) {
@@ -533,7 +584,7 @@ relation_insert(relation_t *rel, attribute_value_t *values)
 #endif /* DEBUG */
 
     ptr += attr->element_size;
-    if(attr->index != NULL) {
+    if(attr->index != NULL && !deferred) {
       if(DB_ERROR(index_insert(attr->index, value, rel->next_row))) {
         return DB_INDEX_ERROR;
       }
@@ -542,11 +593,141 @@ relation_insert(relation_t *rel, attribute_value_t *values)
 
   PRINTF(")\n");
 
+#if DB_FEATURE_BATCH
+  if(deferred) {
+    /* The tuple is not buffered if the full buffer cannot be written. */
+    if((batch.rows + 1) * rel->row_length > sizeof(batch.buf)) {
+      result = relation_batch_commit();
+      if(DB_ERROR(result)) {
+        return result;
+      }
+    }
+    memcpy(&batch.buf[batch.rows * rel->row_length], record, rel->row_length);
+    batch.rows++;
+    return DB_OK;
+  }
+#endif /* DB_FEATURE_BATCH */
+
   rel->cardinality++;
   rel->next_row++;
   return storage_put_row(rel, record);
 }
 
+#if DB_FEATURE_BATCH
+db_result_t
+relation_batch_begin(relation_t *rel)
+{
+  if(batch.rel != NULL) {
+    return DB_BUSY_ERROR;
+  }
+
+  if(rel->dir != DB_STORAGE || rel->row_length == 0 ||
+     rel->row_length > sizeof(batch.buf)) {
+    return DB_LIMIT_ERROR;
+  }
+
+  /* The batch keeps the reference of the caller, so that the tuple file
+     stays open until the batch ends. */
+  batch.rel = rel;
+  batch.rows = 0;
+
+  return DB_OK;
+}
+
+db_result_t
+relation_batch_commit(void)
+{
+  relation_t *rel;
+  attribute_t *attr;
+  attribute_value_t value;
+  unsigned char *row_ptr;
+  db_result_t result;
+  tuple_id_t i;
+
+  rel = batch.rel;
+  if(rel == NULL || batch.rows == 0) {
+    return DB_OK;
+  }
+
+  /* The batch is kept if the tuples cannot be stored, so that the
+     commit can be retried. */
+  result = storage_put_rows(rel, batch.buf, batch.rows);
+  if(DB_ERROR(result)) {
+    return result;
+  }
+
+  /* The stored tuples stay in the relation even if an index cannot
+     take their keys. */
+  for(i = 0; i < batch.rows; i++) {
+    row_ptr = &batch.buf[i * rel->row_length];
+    for(attr = list_head(rel->attributes); attr != NULL; attr = attr->next) {
+      if(attr->index == NULL || (attr->flags & ATTRIBUTE_FLAG_INVALID)) {
+        continue;
+      }
+      if(DB_ERROR(relation_get_value(rel, attr, row_ptr, &value)) ||
+         DB_ERROR(index_insert(attr->index, &value, rel->next_row + i))) {
+        result = DB_INDEX_ERROR;
+      }
+    }
+  }
+
+  rel->cardinality += batch.rows;
+  rel->next_row += batch.rows;
+  batch.rows = 0;
+
+  return result;
+}
+
+db_result_t
+relation_batch_end(void)
+{
+  db_result_t result;
+
+  if(batch.rel == NULL) {
+    return DB_ARGUMENT_ERROR;
+  }
+
+  result = relation_batch_commit();
+  relation_release(batch.rel);
+  batch.rel = NULL;
+
+  return result;
+}
+
+static db_result_t
+batch_flush(relation_t *rel)
+{
+  return rel == batch.rel ? relation_batch_commit() : DB_OK;
+}
+#endif /* DB_FEATURE_BATCH */
+
+#if DB_FEATURE_TIMESERIES
+db_result_t
+relation_set_timeseries(relation_t *rel)
+{
+  tuple_id_t cardinality;
+
+  if(rel->dir != DB_STORAGE) {
+    return DB_ARGUMENT_ERROR;
+  }
+
+  if(storage_is_timeseries(rel)) {
+    return DB_OK;
+  }
+
+  cardinality = relation_cardinality(rel);
+  if(cardinality == INVALID_TUPLE) {
+    return DB_STORAGE_ERROR;
+  }
+  if(cardinality > 0) {
+    PRINTF("DB: Attempt to change the storage of a non-empty relation\n");
+    return DB_RELATIONAL_ERROR;
+  }
+
+  return storage_set_timeseries(rel);
+}
+#endif /* DB_FEATURE_TIMESERIES */
+
 static void
 aggregate(attribute_t *attr, attribute_value_t *value)
 {
@@ -571,6 +752,7 @@ aggregate(attribute_t *attr, attribute_value_t *value)
     attr->aggregation_value += long_value;
     break;
   case AQL_MEAN:
+    attr->aggregation_value += long_value;
     break;
   case AQL_MEDIAN:
     break;
@@ -655,7 +837,7 @@ select_index(db_handle_t *handle, lvm_instance_t *lvm_instance)
 
       if(range <= min_range) {
         index = attr->index;
-        av_min.domain = av_max.domain = DOMAIN_INT;
+        av_min.domain = av_max.domain = DOMAIN_LONG;
         VALUE_LONG(&av_min) = min.l;
         VALUE_LONG(&av_max) = max.l;
       }
@@ -671,6 +853,90 @@ select_index(db_handle_t *handle, lvm_instance_t *lvm_instance)
   }
 }
 
+#if DB_FEATURE_TIMESERIES
+static void
+select_blocks(db_handle_t *handle, lvm_instance_t *lvm_instance)
+{
+  attribute_t *attr;
+  operand_value_t min;
+  operand_value_t max;
+
+  /* The blocks of a time-series relation record the range of the
+     first attribute, so a scan can skip blocks outside of the range
+     derived from the condition. */
+  attr = list_head(handle->rel->attributes);
+  if(attr == NULL || !storage_is_timeseries(handle->rel) ||
+     (attr->domain != DOMAIN_INT && attr->domain != DOMAIN_LONG) ||
+     LVM_ERROR(lvm_get_derived_range(lvm_instance, attr->name, &min, &max))) {
+    return;
+  }
+
+  PRINTF("DB: Skipping blocks outside of %s in (%ld,%ld)\n",
+         attr->name, min.l, max.l);
+
+  block_range.min = min.l;
+  block_range.max = max.l;
+  handle->flags |= DB_HANDLE_FLAG_SKIP_BLOCKS;
+}
+#endif /* DB_FEATURE_TIMESERIES */
+
+#if DB_FEATURE_AGGREGATE
+static void
+select_aggregate_index(db_handle_t *handle, aql_adt_t *adt)
+{
+  attribute_t *attr;
+  attribute_value_t av_min;
+  attribute_value_t av_max;
+  int min_only;
+  int i;
+
+  /*
+   * An aggregate query that refers to a single attribute, both in the
+   * aggregators and in the condition, can be answered from the keys of
+   * an index on that attribute without reading any tuples.
+   */
+  attr = relation_attribute_get(handle->rel, adt->attributes[0].name);
+  if(attr == NULL || attr->index == NULL ||
+     !(((index_t *)attr->index)->api->flags & INDEX_API_KEYS)) {
+    return;
+  }
+
+  min_only = 1;
+  for(i = 0; i < AQL_ATTRIBUTE_COUNT(adt); i++) {
+    if(strcmp(adt->attributes[i].name, attr->name) != 0) {
+      return;
+    }
+    if(adt->aggregators[i] != AQL_MIN &&
+       !(adt->attributes[i].flags & ATTRIBUTE_FLAG_NO_STORE)) {
+      min_only = 0;
+    }
+  }
+
+  if(!(handle->flags & DB_HANDLE_FLAG_SEARCH_INDEX) ||
+     handle->index_iterator.index != attr->index) {
+    /* Iterate over all keys; the condition is evaluated for each key. */
+    av_min.domain = av_max.domain = DOMAIN_LONG;
+    VALUE_LONG(&av_min) = LONG_MIN;
+    VALUE_LONG(&av_max) = LONG_MAX;
+    if(index_get_iterator(&handle->index_iterator, attr->index,
+                          &av_min, &av_max) != DB_OK) {
+      handle->flags &= ~DB_HANDLE_FLAG_SEARCH_INDEX;
+      return;
+    }
+  }
+
+  PRINTF("DB: Aggregating the keys of the index on %s.%s\n",
+         handle->rel->name, attr->name);
+
+  handle->flags |= DB_HANDLE_FLAG_SEARCH_INDEX | DB_HANDLE_FLAG_INDEX_ONLY;
+  if(min_only) {
+    /* The keys arrive in ascending order, so the first match is the
+       minimum. */
+    handle->flags |= DB_HANDLE_FLAG_FIRST_MATCH;
+  }
+}
+#endif /* DB_FEATURE_AGGREGATE */
+
 static db_result_t
 generate_selection_result(db_handle_t *handle, relation_t *rel, aql_adt_t *adt)
 {
@@ -683,6 +949,7 @@ generate_selection_result(db_handle_t *handle, relation_t *rel, aql_adt_t *adt)
   handle->current_row = 0;
   handle->ncolumns = 0;
   handle->tuple_id = 0;
+  aggregation_count = 0;
   for(attr = list_head(result_rel->attributes); attr != NULL; attr = attr->next) {
     if(attr->flags & ATTRIBUTE_FLAG_NO_STORE) {
       continue;
@@ -700,9 +967,22 @@ generate_selection_result(db_handle_t *handle, relation_t *rel, aql_adt_t *adt)
     /* Try to establish acceptable ranges for the attribute values. */
     if(!LVM_ERROR(lvm_derive(adt->lvm_instance))) {
       select_index(handle, adt->lvm_instance);
+#if DB_FEATURE_TIMESERIES
+      /* Removals keep the tuples outside of the range. */
+      if(!(handle->flags & DB_HANDLE_FLAG_SEARCH_INDEX) &&
+         !(AQL_GET_FLAGS(adt) & AQL_FLAG_INVERSE_LOGIC)) {
+        select_blocks(handle, adt->lvm_instance);
+      }
+#endif /* DB_FEATURE_TIMESERIES */
     }
   }
 
+#if DB_FEATURE_AGGREGATE
+  if(AQL_GET_FLAGS(adt) & AQL_FLAG_AGGREGATE) {
+    select_aggregate_index(handle, adt);
+  }
+#endif /* DB_FEATURE_AGGREGATE */
+
   handle->flags |= DB_HANDLE_FLAG_PROCESSING;
 
   return DB_OK;
@@ -743,7 +1023,9 @@ relation_process_select(void *handle_ptr)
   unsigned char *from_ptr;
   unsigned char *to_ptr;
   operand_value_t operand_value;
+#if !DB_FEATURE_AGGREGATE
   uint8_t intbuf[2];
+#endif /* !DB_FEATURE_AGGREGATE */
   attribute_value_t value;
   lvm_status_t wanted_result;
 
@@ -753,10 +1035,23 @@ relation_process_select(void *handle_ptr)
   attribute_count = handle->result_rel->attribute_count;
   attr_map_end = attr_map + attribute_count;
 
+#if DB_FEATURE_AGGREGATE
+  if((handle->flags & DB_HANDLE_FLAG_INDEX_ONLY) &&
+     !(AQL_GET_FLAGS(adt) & AQL_FLAG_AGGREGATE)) {
+    /* The aggregated row has already been generated. */
+    return DB_FINISHED;
+  }
+#endif /* DB_FEATURE_AGGREGATE */
+
   if(handle->flags & DB_HANDLE_FLAG_SEARCH_INDEX) {
     handle->tuple_id = index_get_next(&handle->index_iterator);
     if(handle->tuple_id == INVALID_TUPLE) {
       PRINTF("DB: An attribute value could not be found in the index\n");
+#if DB_FEATURE_AGGREGATE
+      if(handle->flags & DB_HANDLE_FLAG_INDEX_ONLY) {
+        goto end_aggregation;
+      }
+#endif /* DB_FEATURE_AGGREGATE */
       if(handle->index_iterator.next_item_no == 0) {
         return DB_INDEX_ERROR;
       }
@@ -767,7 +1062,35 @@ relation_process_select(void *handle_ptr)
 
       return DB_FINISHED;
     }
+
+#if DB_FEATURE_AGGREGATE
+    if(handle->flags & DB_HANDLE_FLAG_INDEX_ONLY) {
+      /* The key is the only attribute value used by the query, so it
+         stands in for the tuple, which is not read from the storage. */
+      value.domain = attr_map[0].from_attr->domain;
+      if(value.domain == DOMAIN_INT) {
+        VALUE_INT(&value) = handle->index_iterator.key;
+      } else {
+        VALUE_LONG(&value) = handle->index_iterator.key;
+      }
+      result = db_value_to_phy(row + attr_map[0].from_offset,
+                               attr_map[0].from_attr, &value);
+      if(DB_ERROR(result)) {
+        return result;
+      }
+      goto process_row;
+    }
+#endif /* DB_FEATURE_AGGREGATE */
+  }
+
+#if DB_FEATURE_TIMESERIES
+  if(handle->flags & DB_HANDLE_FLAG_SKIP_BLOCKS) {
+    if(DB_ERROR(storage_skip_rows(handle->rel, &handle->tuple_id,
+                                  block_range.min, block_range.max))) {
+      return DB_STORAGE_ERROR;
+    }
   }
+#endif /* DB_FEATURE_TIMESERIES */
 
   /* Put the tuples fulfilling the given condition into a new relation.
      The tuples may be projected. */
@@ -783,16 +1106,20 @@ relation_process_select(void *handle_ptr)
     return DB_FINISHED;
   }
 
+#if DB_FEATURE_AGGREGATE
+process_row:
+#endif /* DB_FEATURE_AGGREGATE */
   /* Process the attributes in the result relation. */
   for(attr_map_ptr = attr_map; attr_map_ptr < attr_map_end; attr_map_ptr++) {
     from_ptr = row + attr_map_ptr->from_offset;
     result_attr = attr_map_ptr->to_attr;
 
-    /* Update the internal state of the PLE. */
-    if(result_attr->domain == DOMAIN_INT) {
+    /* Update the internal state of the PLE. The value is read in the
+       domain of the source, which differs for aggregated attributes. */
+    if(attr_map_ptr->from_attr->domain == DOMAIN_INT) {
       operand_value.l = from_ptr[0] << 8 | from_ptr[1];
       lvm_set_variable_value(result_attr->name, operand_value);
-    } else if(result_attr->domain == DOMAIN_LONG) {
+    } else if(attr_map_ptr->from_attr->domain == DOMAIN_LONG) {
       operand_value.l = (uint32_t)from_ptr[0] << 24 |
                         (uint32_t)from_ptr[1] << 16 |
                         (uint32_t)from_ptr[2] << 8 |
@@ -824,12 +1151,18 @@ relation_process_select(void *handle_ptr)
     if(AQL_GET_FLAGS(adt) & AQL_FLAG_AGGREGATE) {
       for(attr_map_ptr = attr_map; attr_map_ptr < attr_map_end; attr_map_ptr++) {
         from_ptr = row + attr_map_ptr->from_offset;
-        result = db_phy_to_value(&value, attr_map_ptr->to_attr, from_ptr);
+        result = db_phy_to_value(&value, attr_map_ptr->from_attr, from_ptr);
         if(DB_ERROR(result)) {
 	  return result;
         }
         aggregate(attr_map_ptr->to_attr, &value);
       }
+      aggregation_count++;
+#if DB_FEATURE_AGGREGATE
+      if(handle->flags & DB_HANDLE_FLAG_FIRST_MATCH) {
+        goto end_aggregation;
+      }
+#endif /* DB_FEATURE_AGGREGATE */
     } else {
       if(AQL_GET_FLAGS(adt) & AQL_FLAG_ASSIGN) {
         if(DB_ERROR(storage_put_row(handle->result_rel, result_row))) {
@@ -850,10 +1183,20 @@ end_aggregation:
     result_attr = attr_map_ptr->to_attr;
     to_ptr = result_row + attr_map_ptr->to_offset;
 
+    if(result_attr->aggregator == AQL_MEAN && aggregation_count > 0) {
+      result_attr->aggregation_value /= (long)aggregation_count;
+    }
+
+#if DB_FEATURE_AGGREGATE
+    value.domain = DOMAIN_LONG;
+    VALUE_LONG(&value) = result_attr->aggregation_value;
+    db_value_to_phy(to_ptr, result_attr, &value);
+#else
     intbuf[0] = result_attr->aggregation_value >> 8;
     intbuf[1] = result_attr->aggregation_value & 0xff;
     from_ptr = intbuf;
     memcpy(to_ptr, from_ptr, result_attr->element_size);
+#endif /* DB_FEATURE_AGGREGATE */
   }
 
   if(AQL_GET_FLAGS(adt) & AQL_FLAG_ASSIGN) {
@@ -880,9 +1223,17 @@ relation_select(void *handle_ptr, relation_t *rel, void *adt_ptr)
   attribute_t *attr;
   int i;
   int normal_attributes;
+  int aggregated_attributes;
 
   adt = (aql_adt_t *)adt_ptr;
 
+#if DB_FEATURE_BATCH
+  /* Make the batched tuples visible to the selection. */
+  if(DB_ERROR(batch_flush(rel))) {
+    return DB_STORAGE_ERROR;
+  }
+#endif /* DB_FEATURE_BATCH */
+
   handle = (db_handle_t *)handle_ptr;
   handle->rel = rel;
   handle->adt = adt;
@@ -903,7 +1254,8 @@ relation_select(void *handle_ptr, relation_t *rel, void *adt_ptr)
     return DB_ALLOCATION_ERROR;
   }
 
-  for(i = normal_attributes = 0; i < AQL_ATTRIBUTE_COUNT(adt); i++) {
+  normal_attributes = aggregated_attributes = 0;
+  for(i = 0; i < AQL_ATTRIBUTE_COUNT(adt); i++) {
     attribute_name = adt->attributes[i].name;
 
     attr = relation_attribute_get(rel, attribute_name);
@@ -916,10 +1268,18 @@ relation_select(void *handle_ptr, relation_t *rel, void *adt_ptr)
     PRINTF("DB: Found attribute %s in relation %s\n",
 	attribute_name, rel->name);
 
+#if DB_FEATURE_AGGREGATE
+    /* Aggregated values over large relations may exceed an integer. */
+    attr = relation_attribute_add(handle->result_rel, dir,
+				  attribute_name, 
+				  adt->aggregators[i] ? DOMAIN_LONG : attr->domain,
+				  adt->aggregators[i] ? 4 : attr->element_size);
+#else
     attr = relation_attribute_add(handle->result_rel, dir,
 				  attribute_name, 
 				  adt->aggregators[i] ? DOMAIN_INT : attr->domain,
 				  attr->element_size);
+#endif /* DB_FEATURE_AGGREGATE */
     if(attr == NULL) {
       PRINTF("DB: Failed to add a result attribute\n");
       relation_release(handle->result_rel);
@@ -935,12 +1295,15 @@ relation_select(void *handle_ptr, relation_t *rel, void *adt_ptr)
       }
       break;
     case AQL_MAX:
+      aggregated_attributes++;
       attr->aggregation_value = LONG_MIN;
       break;
     case AQL_MIN:
+      aggregated_attributes++;
       attr->aggregation_value = LONG_MAX;
       break;
     default:
+      aggregated_attributes++;
       attr->aggregation_value = 0;
       break;
     }
@@ -949,12 +1312,24 @@ relation_select(void *handle_ptr, relation_t *rel, void *adt_ptr)
   }
 
   /* Preclude mixes of normal attributes and aggregated ones in 
-     selection results. */
-  if(normal_attributes > 0 &&
-     handle->result_rel->attribute_count > normal_attributes) {
+     selection results. Attributes that are only used in the condition
+     are neither. */
+  if(normal_attributes > 0 && aggregated_attributes > 0) {
      return DB_RELATIONAL_ERROR;
   }
 
+#if DB_FEATURE_TIMESERIES
+  /* Keep the storage of a time-series relation whose tuples are
+     removed, which is done by assigning the remaining tuples. The
+     tail file is opened after the attributes have been stored, as
+     the file system limits the number of open files. */
+  if(dir == DB_STORAGE && storage_is_timeseries(rel) &&
+     DB_ERROR(relation_set_timeseries(handle->result_rel))) {
+    relation_release(handle->result_rel);
+    return DB_STORAGE_ERROR;
+  }
+#endif /* DB_FEATURE_TIMESERIES */
+
   return generate_selection_result(handle, rel, adt);
 }
 
@@ -1124,6 +1499,14 @@ relation_join(void *query_result, void *adt_ptr)
   adt = (aql_adt_t *)adt_ptr;
 
   handle = (db_handle_t *)query_result;
+
+#if DB_FEATURE_BATCH
+  if(DB_ERROR(batch_flush(handle->left_rel)) ||
+     DB_ERROR(batch_flush(handle->right_rel))) {
+    return DB_STORAGE_ERROR;
+  }
+#endif /* DB_FEATURE_BATCH */
+
   handle->current_row = 0;
   handle->ncolumns = 0;
   handle->adt = adt;
@@ -68,6 +68,10 @@ struct relation {
   tuple_id_t cardinality;
   tuple_id_t next_row;
   db_storage_id_t tuple_storage;
+#if DB_FEATURE_TIMESERIES
+  db_storage_id_t tail_storage;
+  tuple_id_t sealed_rows;
+#endif /* DB_FEATURE_TIMESERIES */
   db_direction_t dir;
   uint8_t references;
   char name[RELATION_NAME_LENGTH + 1];
@@ -97,5 +101,13 @@ db_result_t relation_insert(relation_t *, attribute_value_t *);
 db_result_t relation_select(void *, relation_t *, void *);
 db_result_t relation_join(void *, void *);
 tuple_id_t relation_cardinality(relation_t *);
+#if DB_FEATURE_BATCH
+db_result_t relation_batch_begin(relation_t *);
+db_result_t relation_batch_commit(void);
+db_result_t relation_batch_end(void);
+#endif /* DB_FEATURE_BATCH */
+#if DB_FEATURE_TIMESERIES
+db_result_t relation_set_timeseries(relation_t *);
+#endif /* DB_FEATURE_TIMESERIES */
 
 #endif /* RELATION_H */
@@ -49,6 +49,9 @@ typedef unsigned char *tuple_t;
 #define DB_HANDLE_FLAG_INDEX_STEP	0x01
 #define DB_HANDLE_FLAG_SEARCH_INDEX	0x02
 #define DB_HANDLE_FLAG_PROCESSING	0x04
+#define DB_HANDLE_FLAG_INDEX_ONLY	0x08
+#define DB_HANDLE_FLAG_FIRST_MATCH	0x10
+#define DB_HANDLE_FLAG_SKIP_BLOCKS	0x20
 
 struct db_handle {
   index_iterator_t index_iterator;
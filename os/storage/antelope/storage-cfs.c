@@ -35,6 +35,7 @@
  * 	Nicolas Tsiftes <nvt@sics.se>
  */
 
+#include <limits.h>
 #include <stdio.h>
 #include <string.h>
 
@@ -68,6 +69,68 @@ struct index_record {
 
 #define ROW_XOR 0xf6U
 
+#if DB_FEATURE_TIMESERIES
+/*
+ * A time-series relation stores its tuples in compressed blocks that
+ * each hold DB_TIMESERIES_BLOCK_SIZE bytes of tuples. Within a block,
+ * the tuples are stored column by column. The first attribute, which
+ * is normally a time stamp, is encoded as a varint of the difference
+ * between consecutive deltas. Other integers are encoded as varints
+ * of their deltas, floats as varints of the XOR with the previous
+ * value, and strings as they are. The block header records the range
+ * of the first attribute, so that scans can skip blocks.
+ *
+ * The tuples of the block being filled are appended uncompressed to a
+ * tail file, which begins with the number of tuples in the sealed
+ * blocks. A full tail is compressed into a block, and then replaced
+ * with an empty tail.
+ */
+#define TS_TUPLE_PREFIX		"ts"
+#define TS_TAIL_MARK		'l'
+#define TS_BASE_SIZE		4
+#define TS_HEADER_SIZE		12
+#define TS_BLOCK_END		0xb7
+
+#define TS_COLUMN_RAW		0
+#define TS_COLUMN_DELTA		1
+#define TS_COLUMN_DELTA2	2
+#define TS_COLUMN_XOR		3
+
+struct block_cursor {
+  relation_t *rel;
+  tuple_id_t first;
+  tuple_id_t count;
+  unsigned length;
+  unsigned long offset;
+  long min;
+  long max;
+};
+
+/* The header of the block that was accessed last. */
+static struct block_cursor cursor;
+
+/* The decoded tuples of the block that was read last. */
+static struct {
+  relation_t *rel;
+  tuple_id_t first;
+  tuple_id_t count;
+  unsigned char rows[DB_TIMESERIES_BLOCK_SIZE];
+} block_cache;
+
+/* An encoded block; a varint takes at most twice as many bytes
+   as the value that it encodes. */
+static unsigned char block_buf[TS_HEADER_SIZE +
+                               2 * DB_TIMESERIES_BLOCK_SIZE + 1];
+
+static db_result_t tail_load(relation_t *);
+static db_result_t get_timeseries_row(relation_t *, tuple_id_t,
+                                      storage_row_t);
+static db_result_t put_timeseries_rows(relation_t *, storage_row_t,
+                                       tuple_id_t);
+static tuple_id_t tail_rows(relation_t *);
+static void tail_filename(relation_t *, char *);
+#endif /* DB_FEATURE_TIMESERIES */
+
 static void
 merge_strings(char *dest, char *prefix, char *suffix)
 {
@@ -111,6 +174,14 @@ storage_load(relation_t *rel)
     return DB_STORAGE_ERROR;
   }
 
+#if DB_FEATURE_TIMESERIES
+  if(storage_is_timeseries(rel) && DB_ERROR(tail_load(rel))) {
+    PRINTF("DB: Failed to load the tail of %s\n", rel->name);
+    storage_unload(rel);
+    return DB_STORAGE_ERROR;
+  }
+#endif /* DB_FEATURE_TIMESERIES */
+
   return DB_OK;
 }
 
@@ -123,6 +194,19 @@ storage_unload(relation_t *rel)
     cfs_close(rel->tuple_storage);
     rel->tuple_storage = -1;
   }
+
+#if DB_FEATURE_TIMESERIES
+  if(rel->tail_storage >= 0) {
+    cfs_close(rel->tail_storage);
+    rel->tail_storage = -1;
+  }
+  if(cursor.rel == rel) {
+    cursor.rel = NULL;
+  }
+  if(block_cache.rel == rel) {
+    block_cache.rel = NULL;
+  }
+#endif /* DB_FEATURE_TIMESERIES */
 }
 
 db_result_t
@@ -279,7 +363,15 @@ storage_put_attribute(relation_t *rel, attribute_t *attr)
 db_result_t
 storage_drop_relation(relation_t *rel, int remove_tuples)
 {
-  if(remove_tuples && RELATION_HAS_TUPLES(rel)) {
+  if(remove_tuples && rel->tuple_filename[0] != '\0') {
+#if DB_FEATURE_TIMESERIES
+    if(storage_is_timeseries(rel)) {
+      char filename[sizeof(rel->tuple_filename)];
+
+      tail_filename(rel, filename);
+      cfs_remove(filename);
+    }
+#endif /* DB_FEATURE_TIMESERIES */
     cfs_remove(rel->tuple_filename);
   }
   return cfs_remove(rel->name) < 0 ? DB_STORAGE_ERROR : DB_OK;
@@ -406,6 +498,12 @@ storage_get_row(relation_t *rel, tuple_id_t *tuple_id, storage_row_t row)
   int r;
   tuple_id_t nrows;
 
+#if DB_FEATURE_TIMESERIES
+  if(storage_is_timeseries(rel)) {
+    return get_timeseries_row(rel, *tuple_id, row);
+  }
+#endif /* DB_FEATURE_TIMESERIES */
+
   if(DB_ERROR(storage_get_row_amount(rel, &nrows))) {
     return DB_STORAGE_ERROR;
   }
@@ -437,18 +535,34 @@ storage_get_row(relation_t *rel, tuple_id_t *tuple_id, storage_row_t row)
   return DB_OK;
 }
 
+static void
+xor_last_bytes(relation_t *rel, storage_row_t rows, tuple_id_t count)
+{
+  tuple_id_t i;
+
+  for(i = 0; i < count; i++) {
+    rows[(i + 1) * rel->row_length - 1] ^= ROW_XOR;
+  }
+}
+
 db_result_t
-storage_put_row(relation_t *rel, storage_row_t row)
+storage_put_rows(relation_t *rel, storage_row_t rows, tuple_id_t count)
 {
   cfs_offset_t end;
   unsigned remaining;
   int r;
-  unsigned char *last_byte;
+  storage_row_t ptr;
 #if DB_FEATURE_INTEGRITY
   int missing_bytes;
   char buf[rel->row_length];
 #endif
 
+#if DB_FEATURE_TIMESERIES
+  if(storage_is_timeseries(rel)) {
+    return put_timeseries_rows(rel, rows, count);
+  }
+#endif /* DB_FEATURE_TIMESERIES */
+
   end = cfs_seek(rel->tuple_storage, 0, CFS_SEEK_END);
   if(end == (cfs_offset_t)-1) {
     return DB_STORAGE_ERROR;
@@ -465,30 +579,38 @@ storage_put_row(relation_t *rel, storage_row_t row)
   }
 #endif
 
-  /* Ensure that last written byte is separated from 0, to make file
-     lengths correct in Coffee. */
-  last_byte = row + rel->row_length - 1;
-  *last_byte ^= ROW_XOR;
+  /* Ensure that last written byte of each row is separated from 0,
+     to make file lengths correct in Coffee. */
+  xor_last_bytes(rel, rows, count);
 
-  remaining = rel->row_length;
+  /* The rows are stored in a single append. */
+  ptr = rows;
+  remaining = rel->row_length * count;
   do {
-    r = cfs_write(rel->tuple_storage, row, remaining);
+    r = cfs_write(rel->tuple_storage, ptr, remaining);
     if(r < 0) {
       PRINTF("DB: Failed to store %u bytes\n", remaining);
-      *last_byte ^= ROW_XOR;
+      xor_last_bytes(rel, rows, count);
       return DB_STORAGE_ERROR;
     }
-    row += r;
+    ptr += r;
     remaining -= r;
   } while(remaining > 0);
 
-  PRINTF("DB: Stored a of %d bytes\n", rel->row_length);
+  PRINTF("DB: Stored %u rows of %d bytes\n", (unsigned)count,
+         rel->row_length);
 
-  *last_byte ^= ROW_XOR;
+  xor_last_bytes(rel, rows, count);
 
   return DB_OK;
 }
 
+db_result_t
+storage_put_row(relation_t *rel, storage_row_t row)
+{
+  return storage_put_rows(rel, row, 1);
+}
+
 db_result_t
 storage_get_row_amount(relation_t *rel, tuple_id_t *amount)
 {
@@ -496,6 +618,10 @@ storage_get_row_amount(relation_t *rel, tuple_id_t *amount)
 
   if(rel->row_length == 0) {
     *amount = 0;
+#if DB_FEATURE_TIMESERIES
+  } else if(storage_is_timeseries(rel)) {
+    *amount = rel->sealed_rows + tail_rows(rel);
+#endif /* DB_FEATURE_TIMESERIES */
   } else {
     offset = cfs_seek(rel->tuple_storage, 0, CFS_SEEK_END);
     if(offset == (cfs_offset_t)-1) {
@@ -581,3 +707,571 @@ storage_write(db_storage_id_t fd,
 
   return DB_OK;
 }
+
+#if DB_FEATURE_TIMESERIES
+static uint32_t
+get_be(const unsigned char *ptr, unsigned size)
+{
+  uint32_t value;
+
+  for(value = 0; size > 0; size--) {
+    value = value << 8 | *ptr++;
+  }
+  return value;
+}
+
+static void
+put_be(unsigned char *ptr, unsigned size, uint32_t value)
+{
+  while(size > 0) {
+    ptr[--size] = value & 0xff;
+    value >>= 8;
+  }
+}
+
+static unsigned char *
+put_varint(unsigned char *ptr, uint32_t value)
+{
+  while(value >= 0x80) {
+    *ptr++ = (value & 0x7f) | 0x80;
+    value >>= 7;
+  }
+  *ptr++ = value;
+  return ptr;
+}
+
+static const unsigned char *
+get_varint(const unsigned char *ptr, const unsigned char *end,
+           uint32_t *value)
+{
+  unsigned shift;
+
+  *value = 0;
+  for(shift = 0; ptr < end && shift < 32; shift += 7) {
+    *value |= (uint32_t)(*ptr & 0x7f) << shift;
+    if(!(*ptr++ & 0x80)) {
+      return ptr;
+    }
+  }
+  return NULL;
+}
+
+/* Map signed differences to unsigned values with small magnitudes. */
+static uint32_t
+zigzag(uint32_t value)
+{
+  return (value << 1) ^ (0 - (value >> 31));
+}
+
+static uint32_t
+unzigzag(uint32_t value)
+{
+  return (value >> 1) ^ (0 - (value & 1));
+}
+
+static int
+column_type(relation_t *rel, attribute_t *attr)
+{
+  if(attr->element_size > sizeof(uint32_t)) {
+    return TS_COLUMN_RAW;
+  }
+
+  switch(attr->domain) {
+  case DOMAIN_INT:
+  case DOMAIN_LONG:
+    return attr == list_head(rel->attributes) ?
+      TS_COLUMN_DELTA2 : TS_COLUMN_DELTA;
+  case DOMAIN_FLOAT:
+    return TS_COLUMN_XOR;
+  default:
+    return TS_COLUMN_RAW;
+  }
+}
+
+static tuple_id_t
+tuples_per_block(relation_t *rel)
+{
+  return rel->row_length == 0 ? 0 :
+    DB_TIMESERIES_BLOCK_SIZE / rel->row_length;
+}
+
+/* Encode the tuples in the block cache into the block buffer. */
+static unsigned
+encode_block(relation_t *rel, tuple_id_t count)
+{
+  attribute_t *attr;
+  unsigned char *out;
+  unsigned char *ptr;
+  unsigned offset;
+  uint32_t value;
+  uint32_t previous;
+  uint32_t delta;
+  uint32_t previous_delta;
+  long min;
+  long max;
+  tuple_id_t i;
+  int type;
+
+  out = block_buf + TS_HEADER_SIZE;
+  min = 0;
+  max = 0xffffffffUL;
+
+  for(offset = 0, attr = list_head(rel->attributes);
+      attr != NULL;
+      offset += attr->element_size, attr = attr->next) {
+    type = column_type(rel, attr);
+    if(type == TS_COLUMN_DELTA2) {
+      min = LONG_MAX;
+      max = LONG_MIN;
+    }
+
+    previous = previous_delta = 0;
+    for(i = 0; i < count; i++) {
+      ptr = block_cache.rows + i * rel->row_length + offset;
+      if(type == TS_COLUMN_RAW) {
+        memcpy(out, ptr, attr->element_size);
+        out += attr->element_size;
+        continue;
+      }
+
+      value = get_be(ptr, attr->element_size);
+      delta = value - previous;
+      switch(type) {
+      case TS_COLUMN_DELTA2:
+        out = put_varint(out, zigzag(delta - previous_delta));
+        /* Use the same conversion as the PLE for the range. */
+        if((long)value < min) {
+          min = (long)value;
+        }
+        if((long)value > max) {
+          max = (long)value;
+        }
+        break;
+      case TS_COLUMN_DELTA:
+        out = put_varint(out, zigzag(delta));
+        break;
+      default:
+        out = put_varint(out, value ^ previous);
+        break;
+      }
+      previous = value;
+      previous_delta = delta;
+    }
+  }
+
+  put_be(block_buf, 2, out - block_buf - TS_HEADER_SIZE);
+  put_be(block_buf + 2, 2, count);
+  put_be(block_buf + 4, 4, (uint32_t)min);
+  put_be(block_buf + 8, 4, (uint32_t)max);
+  *out++ = TS_BLOCK_END;
+
+  return out - block_buf;
+}
+
+/* Decode the block in the block buffer into the block cache. */
+static db_result_t
+decode_block(relation_t *rel, tuple_id_t count, unsigned length)
+{
+  attribute_t *attr;
+  const unsigned char *in;
+  const unsigned char *end;
+  unsigned char *ptr;
+  unsigned offset;
+  uint32_t value;
+  uint32_t code;
+  uint32_t previous;
+  uint32_t delta;
+  uint32_t previous_delta;
+  tuple_id_t i;
+  int type;
+
+  if(count * rel->row_length > sizeof(block_cache.rows)) {
+    return DB_STORAGE_ERROR;
+  }
+
+  in = block_buf + TS_HEADER_SIZE;
+  end = in + length;
+
+  for(offset = 0, attr = list_head(rel->attributes);
+      attr != NULL;
+      offset += attr->element_size, attr = attr->next) {
+    type = column_type(rel, attr);
+    previous = previous_delta = 0;
+    for(i = 0; i < count; i++) {
+      ptr = block_cache.rows + i * rel->row_length + offset;
+      if(type == TS_COLUMN_RAW) {
+        if(in + attr->element_size > end) {
+          return DB_STORAGE_ERROR;
+        }
+        memcpy(ptr, in, attr->element_size);
+        in += attr->element_size;
+        continue;
+      }
+
+      in = get_varint(in, end, &code);
+      if(in == NULL) {
+        return DB_STORAGE_ERROR;
+      }
+
+      switch(type) {
+      case TS_COLUMN_DELTA2:
+        delta = previous_delta + unzigzag(code);
+        value = previous + delta;
+        break;
+      case TS_COLUMN_DELTA:
+        value = previous + unzigzag(code);
+        break;
+      default:
+        value = previous ^ code;
+        break;
+      }
+      put_be(ptr, attr->element_size, value);
+      previous_delta = value - previous;
+      previous = value;
+    }
+  }
+
+  return in == end ? DB_OK : DB_STORAGE_ERROR;
+}
+
+static db_result_t
+read_block_header(relation_t *rel)
+{
+  if(cfs_seek(rel->tuple_storage, cursor.offset, CFS_SEEK_SET) ==
+     (cfs_offset_t)-1 ||
+     cfs_read(rel->tuple_storage, block_buf, TS_HEADER_SIZE) !=
+     TS_HEADER_SIZE) {
+    return DB_STORAGE_ERROR;
+  }
+
+  cursor.length = get_be(block_buf, 2);
+  cursor.count = get_be(block_buf + 2, 2);
+  cursor.min = (long)get_be(block_buf + 4, 4);
+  cursor.max = (long)get_be(block_buf + 8, 4);
+
+  return cursor.count == 0 ? DB_STORAGE_ERROR : DB_OK;
+}
+
+/* Move the cursor to the block that holds a sealed tuple. */
+static db_result_t
+locate_block(relation_t *rel, tuple_id_t tuple_id)
+{
+  if(cursor.rel != rel || tuple_id < cursor.first) {
+    cursor.rel = rel;
+    cursor.first = 0;
+    cursor.offset = 0;
+    if(DB_ERROR(read_block_header(rel))) {
+      cursor.rel = NULL;
+      return DB_STORAGE_ERROR;
+    }
+  }
+
+  while(tuple_id >= cursor.first + cursor.count) {
+    cursor.first += cursor.count;
+    cursor.offset += TS_HEADER_SIZE + cursor.length + 1;
+    if(DB_ERROR(read_block_header(rel))) {
+      cursor.rel = NULL;
+      return DB_STORAGE_ERROR;
+    }
+  }
+
+  return DB_OK;
+}
+
+/* Count the tuples in the complete blocks of the tuple file. */
+static tuple_id_t
+count_sealed_rows(relation_t *rel)
+{
+  cfs_offset_t end;
+
+  end = cfs_seek(rel->tuple_storage, 0, CFS_SEEK_END);
+  cursor.rel = NULL;
+  cursor.first = 0;
+  for(cursor.offset = 0; cursor.offset < end;) {
+    if(DB_ERROR(read_block_header(rel)) ||
+       cursor.offset + TS_HEADER_SIZE + cursor.length + 1 > end) {
+      break;
+    }
+    cursor.first += cursor.count;
+    cursor.offset += TS_HEADER_SIZE + cursor.length + 1;
+  }
+
+  return cursor.first;
+}
+
+static tuple_id_t
+tail_rows(relation_t *rel)
+{
+  cfs_offset_t end;
+
+  end = cfs_seek(rel->tail_storage, 0, CFS_SEEK_END);
+  if(rel->row_length == 0 || end == (cfs_offset_t)-1 || end < TS_BASE_SIZE) {
+    return 0;
+  }
+  return (end - TS_BASE_SIZE) / rel->row_length;
+}
+
+static void
+tail_filename(relation_t *rel, char *filename)
+{
+  strcpy(filename, rel->tuple_filename);
+  filename[1] = TS_TAIL_MARK;
+}
+
+static db_result_t
+append(db_storage_id_t fd, unsigned char *ptr, unsigned length)
+{
+  int r;
+
+  if(cfs_seek(fd, 0, CFS_SEEK_END) == (cfs_offset_t)-1) {
+    return DB_STORAGE_ERROR;
+  }
+
+  while(length > 0) {
+    r = cfs_write(fd, ptr, length);
+    if(r <= 0) {
+      return DB_STORAGE_ERROR;
+    }
+    ptr += r;
+    length -= r;
+  }
+
+  return DB_OK;
+}
+
+/* Replace the tail with an empty one that follows the sealed blocks. */
+static db_result_t
+tail_reset(relation_t *rel)
+{
+  char filename[sizeof(rel->tuple_filename)];
+  unsigned char base[TS_BASE_SIZE];
+
+  if(rel->tail_storage >= 0) {
+    cfs_close(rel->tail_storage);
+  }
+
+  tail_filename(rel, filename);
+  cfs_remove(filename);
+#if DB_FEATURE_COFFEE
+  cfs_coffee_reserve(filename, TS_BASE_SIZE + DB_TIMESERIES_BLOCK_SIZE);
+#endif /* DB_FEATURE_COFFEE */
+
+  rel->tail_storage = cfs_open(filename, CFS_READ | CFS_WRITE | CFS_APPEND);
+  if(rel->tail_storage < 0) {
+    return DB_STORAGE_ERROR;
+  }
+
+  /* Invert the count, so that the file does not end with zeroes. */
+  put_be(base, sizeof(base), ~rel->sealed_rows);
+  return append(rel->tail_storage, base, sizeof(base));
+}
+
+/* Compress the tuples of a full tail into a block. */
+static db_result_t
+seal_block(relation_t *rel)
+{
+  tuple_id_t count;
+  unsigned length;
+
+  count = tuples_per_block(rel);
+  length = count * rel->row_length;
+
+  block_cache.rel = NULL;
+  if(cfs_seek(rel->tail_storage, TS_BASE_SIZE, CFS_SEEK_SET) ==
+     (cfs_offset_t)-1 ||
+     cfs_read(rel->tail_storage, block_cache.rows, length) != length) {
+    return DB_STORAGE_ERROR;
+  }
+  xor_last_bytes(rel, block_cache.rows, count);
+
+  length = encode_block(rel, count);
+  if(DB_ERROR(append(rel->tuple_storage, block_buf, length))) {
+    return DB_STORAGE_ERROR;
+  }
+
+  PRINTF("DB: Sealed %lu tuples of %s in %u bytes\n",
+         (unsigned long)count, rel->name, length);
+
+  block_cache.rel = rel;
+  block_cache.first = rel->sealed_rows;
+  block_cache.count = count;
+  rel->sealed_rows += count;
+
+  return tail_reset(rel);
+}
+
+static db_result_t
+tail_load(relation_t *rel)
+{
+  char filename[sizeof(rel->tuple_filename)];
+  unsigned char base[TS_BASE_SIZE];
+
+  tail_filename(rel, filename);
+  rel->tail_storage = cfs_open(filename, CFS_READ | CFS_WRITE | CFS_APPEND);
+  if(rel->tail_storage >= 0 &&
+     cfs_seek(rel->tail_storage, 0, CFS_SEEK_SET) == 0 &&
+     cfs_read(rel->tail_storage, base, sizeof(base)) == sizeof(base)) {
+    rel->sealed_rows = ~get_be(base, sizeof(base));
+    if(rel->row_length == 0 ||
+       tail_rows(rel) < tuples_per_block(rel)) {
+      return DB_OK;
+    }
+
+    /* A reset interrupted the sealing of a full tail. */
+    if(count_sealed_rows(rel) == rel->sealed_rows) {
+      return seal_block(rel);
+    }
+  }
+
+  /* The tail is missing, or its tuples are already in a block. */
+  rel->sealed_rows = count_sealed_rows(rel);
+  return tail_reset(rel);
+}
+
+static db_result_t
+get_timeseries_row(relation_t *rel, tuple_id_t tuple_id, storage_row_t row)
+{
+  if(tuple_id >= rel->sealed_rows) {
+    tuple_id -= rel->sealed_rows;
+    if(tuple_id >= tail_rows(rel)) {
+      return DB_FINISHED;
+    }
+    if(cfs_seek(rel->tail_storage,
+                TS_BASE_SIZE + tuple_id * rel->row_length, CFS_SEEK_SET) ==
+       (cfs_offset_t)-1 ||
+       cfs_read(rel->tail_storage, row, rel->row_length) != rel->row_length) {
+      return DB_STORAGE_ERROR;
+    }
+    row[rel->row_length - 1] ^= ROW_XOR;
+    return DB_OK;
+  }
+
+  if(block_cache.rel != rel || tuple_id < block_cache.first ||
+     tuple_id >= block_cache.first + block_cache.count) {
+    block_cache.rel = NULL;
+    if(DB_ERROR(locate_block(rel, tuple_id))) {
+      return DB_STORAGE_ERROR;
+    }
+    if(cfs_seek(rel->tuple_storage, cursor.offset + TS_HEADER_SIZE,
+                CFS_SEEK_SET) == (cfs_offset_t)-1 ||
+       cursor.length > 2 * DB_TIMESERIES_BLOCK_SIZE ||
+       cfs_read(rel->tuple_storage, block_buf + TS_HEADER_SIZE,
+                cursor.length + 1) != cursor.length + 1 ||
+       block_buf[TS_HEADER_SIZE + cursor.length] != TS_BLOCK_END ||
+       DB_ERROR(decode_block(rel, cursor.count, cursor.length))) {
+      PRINTF("DB: Corrupt block at offset %lu in %s\n",
+             cursor.offset, rel->name);
+      return DB_STORAGE_ERROR;
+    }
+    block_cache.rel = rel;
+    block_cache.first = cursor.first;
+    block_cache.count = cursor.count;
+  }
+
+  memcpy(row, block_cache.rows +
+         (tuple_id - block_cache.first) * rel->row_length, rel->row_length);
+
+  return DB_OK;
+}
+
+static db_result_t
+put_timeseries_rows(relation_t *rel, storage_row_t rows, tuple_id_t count)
+{
+  tuple_id_t block_rows;
+  tuple_id_t stored;
+  tuple_id_t n;
+  db_result_t result;
+
+  block_rows = tuples_per_block(rel);
+  if(block_rows == 0) {
+    return DB_LIMIT_ERROR;
+  }
+
+  while(count > 0) {
+    stored = tail_rows(rel);
+    n = block_rows - stored;
+    if(n > count) {
+      n = count;
+    }
+
+    xor_last_bytes(rel, rows, n);
+    result = append(rel->tail_storage, rows, n * rel->row_length);
+    xor_last_bytes(rel, rows, n);
+    if(DB_ERROR(result)) {
+      return result;
+    }
+
+    if(stored + n == block_rows && DB_ERROR(seal_block(rel))) {
+      return DB_STORAGE_ERROR;
+    }
+
+    rows += n * rel->row_length;
+    count -= n;
+  }
+
+  return DB_OK;
+}
+
+int
+storage_is_timeseries(relation_t *rel)
+{
+  return strncmp(rel->tuple_filename, TS_TUPLE_PREFIX ".",
+                 sizeof(TS_TUPLE_PREFIX)) == 0;
+}
+
+db_result_t
+storage_set_timeseries(relation_t *rel)
+{
+  attribute_t *attr;
+  char *filename;
+
+  if(storage_is_timeseries(rel)) {
+    return DB_OK;
+  }
+
+  filename = storage_generate_file(TS_TUPLE_PREFIX, DB_COFFEE_RESERVE_SIZE);
+  if(filename == NULL) {
+    return DB_STORAGE_ERROR;
+  }
+
+  storage_unload(rel);
+  cfs_remove(rel->tuple_filename);
+  strncpy(rel->tuple_filename, filename, sizeof(rel->tuple_filename) - 1);
+  rel->tuple_filename[sizeof(rel->tuple_filename) - 1] = '\0';
+
+  /* Rewrite the catalog with the new tuple file. */
+  if(DB_ERROR(storage_put_relation(rel))) {
+    return DB_STORAGE_ERROR;
+  }
+  for(attr = list_head(rel->attributes); attr != NULL; attr = attr->next) {
+    if(DB_ERROR(storage_put_attribute(rel, attr))) {
+      return DB_STORAGE_ERROR;
+    }
+  }
+
+  PRINTF("DB: Relation %s stores its tuples in %s\n",
+         rel->name, rel->tuple_filename);
+
+  return storage_load(rel);
+}
+
+db_result_t
+storage_skip_rows(relation_t *rel, tuple_id_t *tuple_id, long min, long max)
+{
+  if(!storage_is_timeseries(rel)) {
+    return DB_OK;
+  }
+
+  while(*tuple_id < rel->sealed_rows) {
+    if(DB_ERROR(locate_block(rel, *tuple_id))) {
+      return DB_STORAGE_ERROR;
+    }
+    if(cursor.max >= min && cursor.min <= max) {
+      break;
+    }
+    *tuple_id = cursor.first + cursor.count;
+  }
+
+  return DB_OK;
+}
+#endif /* DB_FEATURE_TIMESERIES */
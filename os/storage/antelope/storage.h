@@ -66,7 +66,13 @@ db_result_t storage_put_index(index_t *);
 
 db_result_t storage_get_row(relation_t *, tuple_id_t *, storage_row_t);
 db_result_t storage_put_row(relation_t *, storage_row_t);
+db_result_t storage_put_rows(relation_t *, storage_row_t, tuple_id_t);
 db_result_t storage_get_row_amount(relation_t *, tuple_id_t *);
+#if DB_FEATURE_TIMESERIES
+int storage_is_timeseries(relation_t *);
+db_result_t storage_set_timeseries(relation_t *);
+db_result_t storage_skip_rows(relation_t *, tuple_id_t *, long, long);
+#endif /* DB_FEATURE_TIMESERIES */
 
 db_storage_id_t storage_open(const char *);
 void storage_close(db_storage_id_t);
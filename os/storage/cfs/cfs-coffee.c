@@ -84,6 +84,81 @@
 #define COFFEE_EXTENDED_WEAR_LEVELLING  1
 #endif
 
+/*
+ * Keep a directory on the storage that maps the hashes of file names
+ * to the pages of the files, so that opening a file that is not cached
+ * takes a few header reads instead of a scan of the whole storage. The
+ * directory is a file with COFFEE_DIRECTORY_BUCKETS buckets of
+ * COFFEE_DIRECTORY_BUCKET_SIZE bytes. Entries are only appended to it,
+ * and it is rebuilt by a scan when a bucket is full.
+ */
+#ifndef COFFEE_DIRECTORY
+#define COFFEE_DIRECTORY 0
+#endif
+
+#ifndef COFFEE_DIRECTORY_BUCKETS
+#define COFFEE_DIRECTORY_BUCKETS 16
+#endif
+
+#ifndef COFFEE_DIRECTORY_BUCKET_SIZE
+#define COFFEE_DIRECTORY_BUCKET_SIZE COFFEE_PAGE_SIZE
+#endif
+
+/*
+ * Collect garbage in a background process after files have been removed,
+ * instead of in the operation that removes or reserves a file. Each
+ * step of the process erases sectors for at most COFFEE_GC_STEP_TIME
+ * rtimer ticks before it yields. The process erases sectors without
+ * active pages that have at least COFFEE_GC_OBSOLETE_THRESHOLD obsolete
+ * pages, the most obsolete and the least erased first.
+ */
+#ifndef COFFEE_GC_INCREMENTAL
+#define COFFEE_GC_INCREMENTAL 0
+#endif
+
+#ifndef COFFEE_GC_STEP_TIME
+#define COFFEE_GC_STEP_TIME (RTIMER_SECOND / 50)
+#endif
+
+#ifndef COFFEE_GC_OBSOLETE_THRESHOLD
+#define COFFEE_GC_OBSOLETE_THRESHOLD (COFFEE_PAGES_PER_SECTOR / 2)
+#endif
+
+/*
+ * Count the erasures of each sector in a file on the storage, so that
+ * the garbage collector can spare the most worn sectors. The file holds
+ * a table of the counts followed by a log of COFFEE_ERASE_LOG_ENTRIES
+ * erasures, and it is rewritten when the log is full.
+ */
+#ifndef COFFEE_ERASE_COUNTS
+#define COFFEE_ERASE_COUNTS 0
+#endif
+
+#ifndef COFFEE_ERASE_LOG_ENTRIES
+#define COFFEE_ERASE_LOG_ENTRIES 64
+#endif
+
+/*
+ * Cache appended data in RAM, so that small appends are written to the
+ * storage in blocks of COFFEE_WRITE_CACHE_SIZE bytes. Each of the
+ * COFFEE_WRITE_CACHES caches holds the appended data of one file. The
+ * data is written when a cache is full, when the file is closed, read
+ * from or written elsewhere, after COFFEE_WRITE_CACHE_INTERVAL clock
+ * ticks, and when cfs_coffee_sync() is called. A failure to write
+ * cached data is reported by the next call to cfs_coffee_sync().
+ */
+#ifndef COFFEE_WRITE_CACHES
+#define COFFEE_WRITE_CACHES 0
+#endif
+
+#ifndef COFFEE_WRITE_CACHE_SIZE
+#define COFFEE_WRITE_CACHE_SIZE COFFEE_PAGE_SIZE
+#endif
+
+#ifndef COFFEE_WRITE_CACHE_INTERVAL
+#define COFFEE_WRITE_CACHE_INTERVAL (5 * CLOCK_SECOND)
+#endif
+
 #if COFFEE_START & (COFFEE_SECTOR_SIZE - 1)
 #error COFFEE_START must point to the first byte in a sector.
 #endif
@@ -119,6 +194,14 @@
 #define FD_WRITABLE(fd)   (coffee_fd_set[(fd)].flags & CFS_WRITE)
 #define FD_APPENDABLE(fd) (coffee_fd_set[(fd)].flags & CFS_APPEND)
 
+#if COFFEE_WRITE_CACHES
+/* A descriptor after those of cfs_open() writes back the caches. */
+#define FLUSH_FD          COFFEE_FD_SET_SIZE
+#define FD_SET_SLOTS      (COFFEE_FD_SET_SIZE + 1)
+#else
+#define FD_SET_SLOTS      COFFEE_FD_SET_SIZE
+#endif
+
 /* File object macros. */
 #define FILE_MODIFIED(file)     ((file)->flags & COFFEE_FILE_MODIFIED)
 #define FILE_FREE(file)         ((file)->max_pages == 0)
@@ -131,6 +214,8 @@
 #define HDR_FLAG_MODIFIED  0x08 /* Modified file, log exists. */
 #define HDR_FLAG_LOG       0x10 /* Log file. */
 #define HDR_FLAG_ISOLATED  0x20 /* Isolated page. */
+#define HDR_FLAG_DIRECTORY 0x40 /* Directory file. */
+#define HDR_FLAG_ERASES    0x80 /* Erase count file. */
 
 /* File header macros. */
 #define CHECK_FLAG(hdr, flag) ((hdr).flags & (flag))
@@ -141,6 +226,11 @@
 #define HDR_MODIFIED(hdr)     CHECK_FLAG(hdr, HDR_FLAG_MODIFIED)
 #define HDR_ISOLATED(hdr)     CHECK_FLAG(hdr, HDR_FLAG_ISOLATED)
 #define HDR_OBSOLETE(hdr)     CHECK_FLAG(hdr, HDR_FLAG_OBSOLETE)
+#define HDR_DIRECTORY(hdr)    CHECK_FLAG(hdr, HDR_FLAG_DIRECTORY)
+#define HDR_ERASES(hdr)       CHECK_FLAG(hdr, HDR_FLAG_ERASES)
+/* Files that Coffee keeps for itself, and which have no name. */
+#define HDR_INTERNAL(hdr)     CHECK_FLAG(hdr, HDR_FLAG_DIRECTORY | \
+                                              HDR_FLAG_ERASES)
 #define HDR_ACTIVE(hdr)       (HDR_ALLOCATED(hdr) && \
                                !HDR_OBSOLETE(hdr) && \
                                !HDR_ISOLATED(hdr))
@@ -158,6 +248,10 @@ struct sector_status {
   coffee_page_t active;
   coffee_page_t obsolete;
   coffee_page_t free;
+  /* Pages at the start that belong to a file in a previous sector. */
+  coffee_page_t inherited;
+  /* Pages of the last file that continue in the following sectors. */
+  coffee_page_t spilled;
 };
 
 /* The structure of cached file objects. */
@@ -166,6 +260,9 @@ struct file {
   coffee_page_t page;
   coffee_page_t max_pages;
   int16_t record_count;
+#if COFFEE_DIRECTORY
+  uint16_t name_hash;
+#endif
   uint8_t references;
   uint8_t flags;
 };
@@ -190,6 +287,50 @@ struct file_header {
   char name[COFFEE_NAME_LENGTH];
 };
 
+#if COFFEE_DIRECTORY
+/* A directory entry. The page is stored plus one, so that erased
+   entries read as free. */
+struct dir_entry {
+  uint16_t name_hash;
+  uint16_t page;
+};
+
+#define DIR_ENTRIES_PER_BUCKET \
+  (COFFEE_DIRECTORY_BUCKET_SIZE / sizeof(struct dir_entry))
+#define DIR_SIZE (COFFEE_DIRECTORY_BUCKETS * COFFEE_DIRECTORY_BUCKET_SIZE)
+/* A byte after the buckets is set once the directory is complete. */
+#define DIR_COMPLETE_OFFSET DIR_SIZE
+
+/* Directory states. */
+#define DIR_UNKNOWN 0 /* Not looked for on the storage yet. */
+#define DIR_READY   1
+#define DIR_NONE    2 /* Could not be built, files are found by scans. */
+#endif /* COFFEE_DIRECTORY */
+
+#if COFFEE_ERASE_COUNTS
+#define ERASE_TABLE_SIZE (COFFEE_SECTOR_COUNT * sizeof(uint32_t))
+/* A byte after the table is set once the table is complete. */
+#define ERASE_COMPLETE_OFFSET ERASE_TABLE_SIZE
+/* Each log entry holds an erased sector plus one. */
+#define ERASE_LOG_OFFSET (ERASE_COMPLETE_OFFSET + 1)
+#define ERASE_FILE_SIZE \
+  (ERASE_LOG_OFFSET + COFFEE_ERASE_LOG_ENTRIES * sizeof(uint16_t))
+#define ERASE_COUNT(sector) erase_counts[sector]
+#else
+#define ERASE_COUNT(sector) 0
+#endif /* COFFEE_ERASE_COUNTS */
+
+#if COFFEE_WRITE_CACHES
+/* Data appended to a file but not written to the storage yet. */
+struct write_cache {
+  struct file *file;
+  cfs_offset_t offset;
+  uint16_t length;
+  uint8_t io_flags;
+  uint8_t data[COFFEE_WRITE_CACHE_SIZE];
+};
+#endif /* COFFEE_WRITE_CACHES */
+
 /* This is needed because of a buggy compiler. */
 struct log_param {
   cfs_offset_t offset;
@@ -202,10 +343,44 @@ struct log_param {
  * optimization information for Coffee.
  */
 static struct file coffee_files[COFFEE_MAX_OPEN_FILES];
-static struct file_desc coffee_fd_set[COFFEE_FD_SET_SIZE];
+static struct file_desc coffee_fd_set[FD_SET_SLOTS];
 static coffee_page_t next_free;
 static char gc_wait;
 
+#if COFFEE_DIRECTORY
+static uint8_t dir_state;
+static coffee_page_t dir_page;
+static uint16_t dir_fill[COFFEE_DIRECTORY_BUCKETS];
+
+static void dir_load(void);
+static struct file *dir_find(const char *name, uint16_t hash);
+#endif /* COFFEE_DIRECTORY */
+
+#if COFFEE_ERASE_COUNTS
+static uint8_t erase_counts_loaded;
+static coffee_page_t erase_page;
+static uint16_t erase_log_fill;
+static uint32_t erase_counts[COFFEE_SECTOR_COUNT];
+
+static void erase_counts_load(void);
+static void erase_counts_record(coffee_page_t sector);
+#endif /* COFFEE_ERASE_COUNTS */
+
+static struct cfs_coffee_gc_stats gc_stats;
+
+#if COFFEE_WRITE_CACHES
+static struct write_cache write_caches[COFFEE_WRITE_CACHES];
+static uint8_t next_write_cache;
+static struct ctimer write_cache_timer;
+static uint8_t write_cache_failed;
+
+static int flush_file(struct file *file);
+#endif /* COFFEE_WRITE_CACHES */
+
+#if COFFEE_GC_INCREMENTAL
+PROCESS(coffee_gc_process, "Coffee GC");
+#endif
+
 /*---------------------------------------------------------------------------*/
 static void
 write_header(struct file_header *hdr, coffee_page_t page)
@@ -254,6 +429,7 @@ get_sector_status(coffee_page_t sector, struct sector_status *stats)
 
   sector_start = sector * COFFEE_PAGES_PER_SECTOR;
   sector_end = sector_start + COFFEE_PAGES_PER_SECTOR;
+  stats->inherited = MIN(skip_pages, COFFEE_PAGES_PER_SECTOR);
 
   /*
    * Account for pages belonging to a file starting in a previous
@@ -264,6 +440,7 @@ get_sector_status(coffee_page_t sector, struct sector_status *stats)
     if(skip_pages >= COFFEE_PAGES_PER_SECTOR) {
       stats->active = COFFEE_PAGES_PER_SECTOR;
       skip_pages -= COFFEE_PAGES_PER_SECTOR;
+      stats->spilled = skip_pages;
       return 0;
     }
     active = skip_pages;
@@ -271,6 +448,7 @@ get_sector_status(coffee_page_t sector, struct sector_status *stats)
     if(skip_pages >= COFFEE_PAGES_PER_SECTOR) {
       stats->obsolete = COFFEE_PAGES_PER_SECTOR;
       skip_pages -= COFFEE_PAGES_PER_SECTOR;
+      stats->spilled = skip_pages;
       return skip_pages >= COFFEE_PAGES_PER_SECTOR ? 0 : skip_pages;
     }
     obsolete = skip_pages;
@@ -317,6 +495,7 @@ get_sector_status(coffee_page_t sector, struct sector_status *stats)
   stats->active = active;
   stats->obsolete = obsolete;
   stats->free = free;
+  stats->spilled = skip_pages;
 
   /*
    * To avoid unnecessary page isolation, we notify the caller that
@@ -349,25 +528,52 @@ isolate_pages(coffee_page_t start, coffee_page_t skip_pages)
 }
 /*---------------------------------------------------------------------------*/
 static void
+erase_sector(coffee_page_t sector)
+{
+  COFFEE_ERASE(sector);
+  PRINTF("Coffee: Erased sector %d!\n", sector);
+  gc_stats.erased++;
+#if COFFEE_ERASE_COUNTS
+  erase_counts_record(sector);
+#endif
+}
+/*---------------------------------------------------------------------------*/
+static void
 collect_garbage(int mode)
 {
   coffee_page_t sector;
   struct sector_status stats;
   coffee_page_t first_page, isolation_count;
+  int previous_erased, inherited;
 
   PRINTF("Coffee: Running the garbage collector in %s mode\n",
          mode == GC_RELUCTANT ? "reluctant" : "greedy");
+  gc_stats.collections++;
+#if COFFEE_ERASE_COUNTS
+  if(!erase_counts_loaded) {
+    erase_counts_load();
+  }
+#endif
   /*
    * The garbage collector erases as many sectors as possible. A sector is
    * erasable if there are only free or obsolete pages in it.
    */
+  previous_erased = 0;
   for(sector = 0; sector < COFFEE_SECTOR_COUNT; sector++) {
     isolation_count = get_sector_status(sector, &stats);
     PRINTF("Coffee: Sector %u has %u active, %u obsolete, and %u free pages.\n",
            (unsigned)sector, (unsigned)stats.active,
            (unsigned)stats.obsolete, (unsigned)stats.free);
 
-    if(stats.active > 0) {
+    /*
+     * If the header of a file that extends into this sector stays,
+     * the pages of the file in this sector must be isolated after the
+     * erasure. This is pointless if the file covers the whole sector.
+     */
+    inherited = previous_erased ? 0 : stats.inherited;
+    previous_erased = 0;
+
+    if(stats.active > 0 || inherited == COFFEE_PAGES_PER_SECTOR) {
       continue;
     }
 
@@ -382,8 +588,11 @@ collect_garbage(int mode)
         isolate_pages(first_page + COFFEE_PAGES_PER_SECTOR, isolation_count);
       }
 
-      COFFEE_ERASE(sector);
-      PRINTF("Coffee: Erased sector %d!\n", sector);
+      erase_sector(sector);
+      if(inherited > 0) {
+        isolate_pages(first_page, inherited);
+      }
+      previous_erased = 1;
 
       if(mode == GC_RELUCTANT && isolation_count > 0) {
         break;
@@ -413,6 +622,22 @@ next_file(coffee_page_t page, struct file_header *hdr)
   return page + hdr->max_pages;
 }
 /*---------------------------------------------------------------------------*/
+#if COFFEE_DIRECTORY
+static uint16_t
+name_hash(const char *name)
+{
+  uint32_t hash;
+  int i;
+
+  /* FNV-1a over the part of the name that is stored in the header. */
+  hash = 2166136261UL;
+  for(i = 0; i < COFFEE_NAME_LENGTH - 1 && name[i] != '\0'; i++) {
+    hash = (hash ^ (uint8_t)name[i]) * 16777619UL;
+  }
+  return (uint16_t)(hash ^ (hash >> 16));
+}
+#endif /* COFFEE_DIRECTORY */
+/*---------------------------------------------------------------------------*/
 static struct file *
 load_file(coffee_page_t start, struct file_header *hdr)
 {
@@ -448,6 +673,9 @@ load_file(coffee_page_t start, struct file_header *hdr)
   file->flags = HDR_MODIFIED(*hdr) ? COFFEE_FILE_MODIFIED : 0;
   /* We don't know the amount of records yet. */
   file->record_count = -1;
+#if COFFEE_DIRECTORY
+  file->name_hash = name_hash(hdr->name);
+#endif
 
   return file;
 }
@@ -458,12 +686,23 @@ find_file(const char *name)
   int i;
   struct file_header hdr;
   coffee_page_t page;
+#if COFFEE_DIRECTORY
+  uint16_t hash;
+
+  hash = name_hash(name);
+#endif
 
   /* First check if the file metadata is cached. */
   for(i = 0; i < COFFEE_MAX_OPEN_FILES; i++) {
     if(FILE_FREE(&coffee_files[i])) {
       continue;
     }
+#if COFFEE_DIRECTORY
+    /* Only read the headers of the files whose name hash matches. */
+    if(coffee_files[i].name_hash != hash) {
+      continue;
+    }
+#endif
 
     read_header(&hdr, coffee_files[i].page);
     if(HDR_ACTIVE(hdr) && !HDR_LOG(hdr) && strcmp(name, hdr.name) == 0) {
@@ -471,10 +710,21 @@ find_file(const char *name)
     }
   }
 
+#if COFFEE_DIRECTORY
+  if(dir_state == DIR_UNKNOWN) {
+    dir_load();
+  }
+  if(dir_state == DIR_READY) {
+    /* The directory has an entry for every file on the storage. */
+    return dir_find(name, hash);
+  }
+#endif
+
   /* Scan the flash memory sequentially otherwise. */
   for(page = 0; page < COFFEE_PAGE_COUNT; page = next_file(page, &hdr)) {
     read_header(&hdr, page);
-    if(HDR_ACTIVE(hdr) && !HDR_LOG(hdr) && strcmp(name, hdr.name) == 0) {
+    if(HDR_ACTIVE(hdr) && !HDR_LOG(hdr) && !HDR_INTERNAL(hdr) &&
+       strcmp(name, hdr.name) == 0) {
       return load_file(page, &hdr);
     }
   }
@@ -577,13 +827,22 @@ remove_by_page(coffee_page_t page, int remove_log,
 
   /* Close all file descriptors that reference the removed file. */
   if(close_fds) {
-    for(i = 0; i < COFFEE_FD_SET_SIZE; i++) {
+    for(i = 0; i < FD_SET_SLOTS; i++) {
       if(coffee_fd_set[i].file != NULL && coffee_fd_set[i].file->page == page) {
         coffee_fd_set[i].flags = COFFEE_FD_FREE;
       }
     }
   }
 
+#if COFFEE_WRITE_CACHES
+  /* The cached data of a removed file is dropped. */
+  for(i = 0; i < COFFEE_WRITE_CACHES; i++) {
+    if(write_caches[i].file != NULL && write_caches[i].file->page == page) {
+      write_caches[i].file = NULL;
+    }
+  }
+#endif
+
   for(i = 0; i < COFFEE_MAX_OPEN_FILES; i++) {
     if(coffee_files[i].page == page) {
       coffee_files[i].page = INVALID_PAGE;
@@ -592,9 +851,18 @@ remove_by_page(coffee_page_t page, int remove_log,
     }
   }
 
+#if COFFEE_GC_INCREMENTAL
+  if(gc_allowed) {
+    if(!process_is_running(&coffee_gc_process)) {
+      process_start(&coffee_gc_process, NULL);
+    }
+    process_poll(&coffee_gc_process);
+  }
+#else
   if(!COFFEE_EXTENDED_WEAR_LEVELLING && gc_allowed) {
     collect_garbage(GC_RELUCTANT);
   }
+#endif
 
   return 0;
 }
@@ -606,6 +874,450 @@ page_count(cfs_offset_t size)
          COFFEE_PAGE_SIZE;
 }
 /*---------------------------------------------------------------------------*/
+#if COFFEE_ERASE_COUNTS
+static uint32_t
+erase_counts_total(coffee_page_t page)
+{
+  coffee_page_t sector;
+  uint32_t count;
+  uint32_t total;
+  uint16_t entry;
+  uint16_t i;
+
+  total = 0;
+  for(sector = 0; sector < COFFEE_SECTOR_COUNT; sector++) {
+    COFFEE_READ(&count, sizeof(count),
+                absolute_offset(page, sector * sizeof(count)));
+    total += count;
+  }
+  for(i = 0; i < COFFEE_ERASE_LOG_ENTRIES; i++) {
+    COFFEE_READ(&entry, sizeof(entry),
+                absolute_offset(page, ERASE_LOG_OFFSET + i * sizeof(entry)));
+    if(entry == 0) {
+      break;
+    }
+    total++;
+  }
+  return total;
+}
+/*---------------------------------------------------------------------------*/
+static void
+erase_counts_load(void)
+{
+  struct file_header hdr;
+  coffee_page_t page;
+  uint32_t total;
+  uint32_t best_total;
+  uint16_t entry;
+  uint8_t complete;
+
+  erase_counts_loaded = 1;
+  erase_page = INVALID_PAGE;
+  erase_log_fill = 0;
+  memset(erase_counts, 0, sizeof(erase_counts));
+
+  /*
+   * An interrupted rewrite can leave an incomplete file, or two complete
+   * files. Keep the complete file with the most erasures.
+   */
+  best_total = 0;
+  for(page = 0; page < COFFEE_PAGE_COUNT; page = next_file(page, &hdr)) {
+    read_header(&hdr, page);
+    if(!HDR_ACTIVE(hdr) || !HDR_ERASES(hdr)) {
+      continue;
+    }
+    COFFEE_READ(&complete, sizeof(complete),
+                absolute_offset(page, ERASE_COMPLETE_OFFSET));
+    total = complete ? erase_counts_total(page) : 0;
+    if(complete && (erase_page == INVALID_PAGE || total > best_total)) {
+      if(erase_page != INVALID_PAGE) {
+        remove_by_page(erase_page, !REMOVE_LOG, !CLOSE_FDS, !ALLOW_GC);
+      }
+      erase_page = page;
+      best_total = total;
+    } else {
+      remove_by_page(page, !REMOVE_LOG, !CLOSE_FDS, !ALLOW_GC);
+    }
+  }
+
+  if(erase_page == INVALID_PAGE) {
+    return;
+  }
+
+  COFFEE_READ(erase_counts, sizeof(erase_counts),
+              absolute_offset(erase_page, 0));
+  for(; erase_log_fill < COFFEE_ERASE_LOG_ENTRIES; erase_log_fill++) {
+    COFFEE_READ(&entry, sizeof(entry),
+                absolute_offset(erase_page, ERASE_LOG_OFFSET +
+                                erase_log_fill * sizeof(entry)));
+    if(entry == 0 || entry > COFFEE_SECTOR_COUNT) {
+      break;
+    }
+    erase_counts[entry - 1]++;
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+erase_counts_write(void)
+{
+  struct file_header hdr;
+  coffee_page_t page;
+  coffee_page_t pages;
+  uint8_t complete;
+
+  /*
+   * This runs within the garbage collector, so it cannot collect garbage
+   * to make room. The counts stay in memory until there is room.
+   */
+  pages = page_count(ERASE_FILE_SIZE);
+  page = find_contiguous_pages(pages);
+  if(page == INVALID_PAGE) {
+    return;
+  }
+
+  memset(&hdr, 0, sizeof(hdr));
+  hdr.max_pages = pages;
+  hdr.flags = HDR_FLAG_ALLOCATED | HDR_FLAG_ERASES;
+  write_header(&hdr, page);
+  COFFEE_WRITE(erase_counts, sizeof(erase_counts), absolute_offset(page, 0));
+  complete = 1;
+  COFFEE_WRITE(&complete, sizeof(complete),
+               absolute_offset(page, ERASE_COMPLETE_OFFSET));
+
+  if(erase_page != INVALID_PAGE) {
+    remove_by_page(erase_page, !REMOVE_LOG, !CLOSE_FDS, !ALLOW_GC);
+  }
+  erase_page = page;
+  erase_log_fill = 0;
+}
+/*---------------------------------------------------------------------------*/
+static void
+erase_counts_record(coffee_page_t sector)
+{
+  uint16_t entry;
+
+  if(!erase_counts_loaded) {
+    erase_counts_load();
+  }
+
+  erase_counts[sector]++;
+  if(erase_page != INVALID_PAGE && erase_log_fill < COFFEE_ERASE_LOG_ENTRIES) {
+    entry = sector + 1;
+    COFFEE_WRITE(&entry, sizeof(entry),
+                 absolute_offset(erase_page, ERASE_LOG_OFFSET +
+                                 erase_log_fill * sizeof(entry)));
+    erase_log_fill++;
+  } else {
+    erase_counts_write();
+  }
+}
+#endif /* COFFEE_ERASE_COUNTS */
+/*---------------------------------------------------------------------------*/
+#if COFFEE_GC_INCREMENTAL
+static coffee_page_t
+select_victim(struct sector_status *victim)
+{
+  struct sector_status stats;
+  coffee_page_t sector;
+  coffee_page_t best;
+  coffee_page_t reclaimed;
+  coffee_page_t best_reclaimed;
+
+#if COFFEE_ERASE_COUNTS
+  if(!erase_counts_loaded) {
+    erase_counts_load();
+  }
+#endif
+
+  /*
+   * Sectors are erased one at a time, so the pages of files that extend
+   * into the sector from a previous sector must be isolated again after
+   * the erasure, and they are not reclaimed.
+   */
+  best = INVALID_PAGE;
+  best_reclaimed = 0;
+  for(sector = 0; sector < COFFEE_SECTOR_COUNT; sector++) {
+    get_sector_status(sector, &stats);
+    reclaimed = stats.obsolete - stats.inherited;
+    if(stats.active > 0 || reclaimed <= 0 ||
+       reclaimed < COFFEE_GC_OBSOLETE_THRESHOLD) {
+      continue;
+    }
+
+    /* Prefer the most obsolete sector, and then the least erased one. */
+    if(best == INVALID_PAGE || reclaimed > best_reclaimed ||
+       (reclaimed == best_reclaimed &&
+        ERASE_COUNT(sector) < ERASE_COUNT(best))) {
+      best = sector;
+      best_reclaimed = reclaimed;
+      *victim = stats;
+    }
+  }
+
+  return best;
+}
+/*---------------------------------------------------------------------------*/
+/* Erases sectors until the time budget is spent. Returns 1 if there may
+   be more sectors to erase. */
+static int
+gc_step(void)
+{
+  rtimer_clock_t start;
+  uint32_t elapsed;
+  struct sector_status stats;
+  coffee_page_t sector;
+  coffee_page_t first_page;
+  int more;
+
+  gc_stats.steps++;
+  start = RTIMER_NOW();
+
+  do {
+    sector = select_victim(&stats);
+    more = sector != INVALID_PAGE;
+    if(!more) {
+      break;
+    }
+
+    first_page = sector * COFFEE_PAGES_PER_SECTOR;
+    if(first_page < next_free) {
+      next_free = first_page;
+    }
+    /* The following sectors may keep pages of a file erased here. */
+    if(stats.spilled > 0) {
+      isolate_pages(first_page + COFFEE_PAGES_PER_SECTOR, stats.spilled);
+    }
+    erase_sector(sector);
+    if(stats.inherited > 0) {
+      isolate_pages(first_page, stats.inherited);
+    }
+  } while(RTIMER_CLOCK_DIFF(RTIMER_NOW(), start) < COFFEE_GC_STEP_TIME);
+
+  elapsed = RTIMER_CLOCK_DIFF(RTIMER_NOW(), start);
+  if(elapsed > gc_stats.longest_step) {
+    gc_stats.longest_step = elapsed;
+  }
+
+  return more;
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(coffee_gc_process, ev, data)
+{
+  PROCESS_BEGIN();
+
+  while(1) {
+    /* Files have been removed. */
+    PROCESS_WAIT_EVENT_UNTIL(ev == PROCESS_EVENT_POLL);
+
+    while(gc_step()) {
+      PROCESS_PAUSE();
+    }
+  }
+
+  PROCESS_END();
+}
+#endif /* COFFEE_GC_INCREMENTAL */
+/*---------------------------------------------------------------------------*/
+#if COFFEE_DIRECTORY
+static int
+dir_add(uint16_t hash, coffee_page_t page)
+{
+  struct dir_entry entry;
+  uint16_t bucket;
+
+  bucket = hash % COFFEE_DIRECTORY_BUCKETS;
+  if(dir_fill[bucket] >= DIR_ENTRIES_PER_BUCKET) {
+    return -1;
+  }
+
+  entry.name_hash = hash;
+  entry.page = page + 1;
+  COFFEE_WRITE(&entry, sizeof(entry),
+               absolute_offset(dir_page,
+                               bucket * COFFEE_DIRECTORY_BUCKET_SIZE +
+                               dir_fill[bucket] * sizeof(entry)));
+  dir_fill[bucket]++;
+  return 0;
+}
+/*---------------------------------------------------------------------------*/
+static void
+dir_drop(void)
+{
+  /*
+   * Files that are created while there is no directory would be missing
+   * from it, so the storage must never hold a stale directory.
+   */
+  if(dir_state == DIR_READY) {
+    remove_by_page(dir_page, !REMOVE_LOG, !CLOSE_FDS, !ALLOW_GC);
+  }
+  dir_state = DIR_NONE;
+}
+/*---------------------------------------------------------------------------*/
+static int
+dir_rebuild(void)
+{
+  struct file_header hdr;
+  coffee_page_t page;
+  coffee_page_t old_page;
+  coffee_page_t pages;
+  uint8_t complete;
+
+  old_page = dir_state == DIR_READY ? dir_page : INVALID_PAGE;
+  dir_state = DIR_NONE;
+
+  pages = page_count(DIR_SIZE + 1);
+  dir_page = find_contiguous_pages(pages);
+  if(dir_page == INVALID_PAGE) {
+    collect_garbage(GC_GREEDY);
+    dir_page = find_contiguous_pages(pages);
+  }
+  if(dir_page == INVALID_PAGE) {
+    if(old_page != INVALID_PAGE) {
+      remove_by_page(old_page, !REMOVE_LOG, !CLOSE_FDS, !ALLOW_GC);
+    }
+    return -1;
+  }
+
+  memset(&hdr, 0, sizeof(hdr));
+  hdr.max_pages = pages;
+  hdr.flags = HDR_FLAG_ALLOCATED | HDR_FLAG_DIRECTORY;
+  write_header(&hdr, dir_page);
+  dir_state = DIR_READY;
+  memset(dir_fill, 0, sizeof(dir_fill));
+
+  for(page = 0; page < COFFEE_PAGE_COUNT; page = next_file(page, &hdr)) {
+    read_header(&hdr, page);
+    if(HDR_ACTIVE(hdr) && !HDR_LOG(hdr) && !HDR_INTERNAL(hdr) &&
+       dir_add(name_hash(hdr.name), page) < 0) {
+      PRINTF("Coffee: Directory bucket overflow\n");
+      dir_drop();
+      if(old_page != INVALID_PAGE) {
+        remove_by_page(old_page, !REMOVE_LOG, !CLOSE_FDS, !ALLOW_GC);
+      }
+      return -1;
+    }
+  }
+
+  /* The directory is used after a reboot only if it was completed. */
+  complete = 1;
+  COFFEE_WRITE(&complete, sizeof(complete),
+               absolute_offset(dir_page, DIR_COMPLETE_OFFSET));
+
+  if(old_page != INVALID_PAGE) {
+    remove_by_page(old_page, !REMOVE_LOG, !CLOSE_FDS, !ALLOW_GC);
+  }
+
+  PRINTF("Coffee: Built directory at page %u\n", (unsigned)dir_page);
+
+  return 0;
+}
+/*---------------------------------------------------------------------------*/
+static void
+dir_load(void)
+{
+  struct file_header hdr;
+  struct dir_entry entries[8];
+  coffee_page_t page;
+  uint16_t bucket;
+  uint16_t i, j, n;
+  uint8_t complete;
+
+  dir_state = DIR_NONE;
+  dir_page = INVALID_PAGE;
+
+  for(page = 0; page < COFFEE_PAGE_COUNT; page = next_file(page, &hdr)) {
+    read_header(&hdr, page);
+    if(!HDR_ACTIVE(hdr) || !HDR_DIRECTORY(hdr)) {
+      continue;
+    }
+    COFFEE_READ(&complete, sizeof(complete),
+                absolute_offset(page, DIR_COMPLETE_OFFSET));
+    if(complete && dir_page == INVALID_PAGE) {
+      dir_page = page;
+    } else {
+      /* Remove directories whose rebuild was interrupted. */
+      remove_by_page(page, !REMOVE_LOG, !CLOSE_FDS, !ALLOW_GC);
+    }
+  }
+
+  if(dir_page == INVALID_PAGE) {
+    dir_rebuild();
+    return;
+  }
+
+  /* Count the entries of each bucket. */
+  for(bucket = 0; bucket < COFFEE_DIRECTORY_BUCKETS; bucket++) {
+    for(i = 0; i < DIR_ENTRIES_PER_BUCKET; i += n) {
+      n = MIN(sizeof(entries) / sizeof(entries[0]),
+              DIR_ENTRIES_PER_BUCKET - i);
+      COFFEE_READ(entries, n * sizeof(entries[0]),
+                  absolute_offset(dir_page,
+                                  bucket * COFFEE_DIRECTORY_BUCKET_SIZE +
+                                  i * sizeof(entries[0])));
+      for(j = 0; j < n && entries[j].page != 0; j++);
+      if(j < n) {
+        i += j;
+        break;
+      }
+    }
+    dir_fill[bucket] = i;
+  }
+  dir_state = DIR_READY;
+}
+/*---------------------------------------------------------------------------*/
+static struct file *
+dir_find(const char *name, uint16_t hash)
+{
+  struct file_header hdr;
+  struct dir_entry entries[8];
+  coffee_page_t page;
+  uint16_t bucket;
+  uint16_t i, j, n;
+
+  bucket = hash % COFFEE_DIRECTORY_BUCKETS;
+  for(i = 0; i < dir_fill[bucket]; i += n) {
+    n = MIN(sizeof(entries) / sizeof(entries[0]), dir_fill[bucket] - i);
+    COFFEE_READ(entries, n * sizeof(entries[0]),
+                absolute_offset(dir_page,
+                                bucket * COFFEE_DIRECTORY_BUCKET_SIZE +
+                                i * sizeof(entries[0])));
+    for(j = 0; j < n; j++) {
+      if(entries[j].name_hash != hash ||
+         entries[j].page > COFFEE_PAGE_COUNT) {
+        continue;
+      }
+      /* Entries of removed files are left in place, so verify the header. */
+      page = entries[j].page - 1;
+      read_header(&hdr, page);
+      if(HDR_ACTIVE(hdr) && !HDR_LOG(hdr) && !HDR_INTERNAL(hdr) &&
+         strcmp(name, hdr.name) == 0) {
+        return load_file(page, &hdr);
+      }
+    }
+  }
+
+  return NULL;
+}
+/*---------------------------------------------------------------------------*/
+static void
+dir_prepare(uint16_t hash)
+{
+  if(dir_state == DIR_UNKNOWN) {
+    dir_load();
+  }
+
+  /* Make room for a new entry by dropping the entries of removed files. */
+  if(dir_state == DIR_READY &&
+     dir_fill[hash % COFFEE_DIRECTORY_BUCKETS] >= DIR_ENTRIES_PER_BUCKET) {
+    dir_rebuild();
+    if(dir_state == DIR_READY &&
+       dir_fill[hash % COFFEE_DIRECTORY_BUCKETS] >= DIR_ENTRIES_PER_BUCKET) {
+      dir_drop();
+    }
+  }
+}
+#endif /* COFFEE_DIRECTORY */
+/*---------------------------------------------------------------------------*/
 static struct file *
 reserve(const char *name, coffee_page_t pages,
         int allow_duplicates, unsigned flags)
@@ -613,11 +1325,21 @@ reserve(const char *name, coffee_page_t pages,
   struct file_header hdr;
   coffee_page_t page;
   struct file *file;
+#if COFFEE_DIRECTORY
+  uint16_t hash;
+#endif
 
   if(!allow_duplicates && find_file(name) != NULL) {
     return NULL;
   }
 
+#if COFFEE_DIRECTORY
+  hash = name_hash(name);
+  if(!(flags & HDR_FLAG_LOG)) {
+    dir_prepare(hash);
+  }
+#endif
+
   page = find_contiguous_pages(pages);
   if(page == INVALID_PAGE) {
     if(gc_wait) {
@@ -631,6 +1353,13 @@ reserve(const char *name, coffee_page_t pages,
     }
   }
 
+#if COFFEE_DIRECTORY
+  /* Add the entry before the header, so that no file lacks an entry. */
+  if(!(flags & HDR_FLAG_LOG) && dir_state == DIR_READY) {
+    dir_add(hash, page);
+  }
+#endif
+
   memset(&hdr, 0, sizeof(hdr));
   strncpy(hdr.name, name, sizeof(hdr.name) - 1);
   hdr.max_pages = pages;
@@ -819,7 +1548,7 @@ merge_log(coffee_page_t file_page, int extend)
     }
   } while(n != 0);
 
-  for(i = 0; i < COFFEE_FD_SET_SIZE; i++) {
+  for(i = 0; i < FD_SET_SLOTS; i++) {
     if(coffee_fd_set[i].flags != COFFEE_FD_FREE &&
        coffee_fd_set[i].file->page == file_page) {
       coffee_fd_set[i].file = new_file;
@@ -1014,6 +1743,15 @@ void
 cfs_close(int fd)
 {
   if(FD_VALID(fd)) {
+#if COFFEE_WRITE_CACHES
+    /*
+     * The file object may hold another file once it has no references,
+     * so the cache of the file is written back when the last one goes.
+     */
+    if(FD_WRITABLE(fd) || coffee_fd_set[fd].file->references == 1) {
+      flush_file(coffee_fd_set[fd].file);
+    }
+#endif
     coffee_fd_set[fd].flags = COFFEE_FD_FREE;
     coffee_fd_set[fd].file->references--;
     coffee_fd_set[fd].file = NULL;
@@ -1093,6 +1831,12 @@ cfs_read(int fd, void *buf, unsigned size)
   }
 
   fdp = &coffee_fd_set[fd];
+#if COFFEE_WRITE_CACHES
+  /* The data to read may be cached. */
+  if(flush_file(fdp->file) < 0) {
+    return -1;
+  }
+#endif
   file = fdp->file;
 
   if(fdp->io_flags & CFS_COFFEE_IO_ENSURE_READ_LENGTH) {
@@ -1137,10 +1881,9 @@ cfs_read(int fd, void *buf, unsigned size)
   return size;
 }
 /*---------------------------------------------------------------------------*/
-int
-cfs_write(int fd, const void *buf, unsigned size)
+static int
+write_data(struct file_desc *fdp, const void *buf, unsigned size)
 {
-  struct file_desc *fdp;
   struct file *file;
 #if COFFEE_MICRO_LOGS
   int i;
@@ -1150,13 +1893,12 @@ cfs_write(int fd, const void *buf, unsigned size)
   const char dummy[1] = { 0xff };
 #endif
 
-  if(!(FD_VALID(fd) && FD_WRITABLE(fd))) {
+  file = fdp->file;
+
+  if((fdp->io_flags & CFS_COFFEE_IO_APPEND_ONLY) && fdp->offset < file->end) {
     return -1;
   }
 
-  fdp = &coffee_fd_set[fd];
-  file = fdp->file;
-
   /* Attempt to extend the file if we try to write past the end. */
   if(!(fdp->io_flags & CFS_COFFEE_IO_FIRM_SIZE)) {
     while(size + fdp->offset + sizeof(struct file_header) >
@@ -1230,6 +1972,189 @@ cfs_write(int fd, const void *buf, unsigned size)
   return size;
 }
 /*---------------------------------------------------------------------------*/
+#if COFFEE_WRITE_CACHES
+static struct write_cache *
+find_cache(struct file *file)
+{
+  int i;
+
+  for(i = 0; i < COFFEE_WRITE_CACHES; i++) {
+    if(write_caches[i].file == file) {
+      return &write_caches[i];
+    }
+  }
+  return NULL;
+}
+/*---------------------------------------------------------------------------*/
+static int
+flush_cache(struct write_cache *cache)
+{
+  struct file_desc *fdp;
+  struct file *file;
+  cfs_offset_t end;
+  int r;
+
+  file = cache->file;
+  if(file == NULL) {
+    return 0;
+  }
+
+  /*
+   * Write through the descriptor kept for this, so that it follows the
+   * file if the write merges the file with its log. Failed writes are
+   * not retried, so the cache is dropped in any case.
+   */
+  fdp = &coffee_fd_set[FLUSH_FD];
+  fdp->flags = CFS_WRITE;
+  fdp->io_flags = cache->io_flags;
+  fdp->offset = cache->offset;
+  fdp->file = file;
+  file->references++;
+
+  /* The cached data extends the file on the storage. */
+  cache->file = NULL;
+  end = file->end;
+  file->end = cache->offset;
+  r = write_data(fdp, cache->data, cache->length);
+
+  file = fdp->file;
+  if(file->end < end) {
+    file->end = end;
+  }
+  fdp->flags = COFFEE_FD_FREE;
+  fdp->file = NULL;
+  file->references--;
+
+  if(r != cache->length) {
+    write_cache_failed = 1;
+    return -1;
+  }
+  return 0;
+}
+/*---------------------------------------------------------------------------*/
+static int
+flush_file(struct file *file)
+{
+  struct write_cache *cache;
+
+  cache = find_cache(file);
+  return cache == NULL ? 0 : flush_cache(cache);
+}
+/*---------------------------------------------------------------------------*/
+static void
+flush_caches(void)
+{
+  int i;
+
+  for(i = 0; i < COFFEE_WRITE_CACHES; i++) {
+    flush_cache(&write_caches[i]);
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+write_cache_timeout(void *ptr)
+{
+  flush_caches();
+}
+/*---------------------------------------------------------------------------*/
+/* Caches an append to a file. Returns 0 if the data cannot be cached. */
+static int
+cache_append(struct file_desc *fdp, const char *buf, unsigned size)
+{
+  struct write_cache *cache;
+  struct file *file;
+  unsigned limit;
+  unsigned n;
+
+  file = fdp->file;
+  if(size == 0 || size > COFFEE_WRITE_CACHE_SIZE ||
+     fdp->offset != file->end ||
+     fdp->offset + size + sizeof(struct file_header) >
+     file->max_pages * COFFEE_PAGE_SIZE) {
+    return 0;
+  }
+
+  cache = find_cache(file);
+  if(cache != NULL && cache->io_flags != fdp->io_flags) {
+    if(flush_cache(cache) < 0) {
+      return 0;
+    }
+    cache = NULL;
+  }
+
+  while(size > 0) {
+    if(cache == NULL) {
+      cache = find_cache(NULL);
+      if(cache == NULL) {
+        /* Take the caches from the other files in turn. */
+        cache = &write_caches[next_write_cache];
+        next_write_cache = (next_write_cache + 1) % COFFEE_WRITE_CACHES;
+        if(flush_cache(cache) < 0) {
+          return 0;
+        }
+      }
+      cache->file = file;
+      cache->offset = fdp->offset;
+      cache->length = 0;
+      cache->io_flags = fdp->io_flags;
+      if(ctimer_expired(&write_cache_timer)) {
+        ctimer_set(&write_cache_timer, COFFEE_WRITE_CACHE_INTERVAL,
+                   write_cache_timeout, NULL);
+      }
+    }
+
+    /* Fill the cache up to an aligned block of the storage. */
+    limit = COFFEE_WRITE_CACHE_SIZE -
+      absolute_offset(file->page, cache->offset) % COFFEE_WRITE_CACHE_SIZE;
+    n = MIN(size, limit - cache->length);
+    memcpy(&cache->data[cache->length], buf, n);
+    cache->length += n;
+    buf += n;
+    size -= n;
+    fdp->offset += n;
+    file->end = fdp->offset;
+
+    if(cache->length == limit) {
+      if(flush_cache(cache) < 0) {
+        return -1;
+      }
+      /* The flush may have merged the file with its log. */
+      file = fdp->file;
+      cache = NULL;
+    }
+  }
+
+  return 1;
+}
+#endif /* COFFEE_WRITE_CACHES */
+/*---------------------------------------------------------------------------*/
+int
+cfs_write(int fd, const void *buf, unsigned size)
+{
+  struct file_desc *fdp;
+#if COFFEE_WRITE_CACHES
+  int r;
+#endif
+
+  if(!(FD_VALID(fd) && FD_WRITABLE(fd))) {
+    return -1;
+  }
+
+  fdp = &coffee_fd_set[fd];
+
+#if COFFEE_WRITE_CACHES
+  r = cache_append(fdp, buf, size);
+  if(r != 0) {
+    return r < 0 ? -1 : size;
+  }
+  if(flush_file(fdp->file) < 0) {
+    return -1;
+  }
+#endif
+
+  return write_data(fdp, buf, size);
+}
+/*---------------------------------------------------------------------------*/
 int
 cfs_opendir(struct cfs_dir *dir, const char *name)
 {
@@ -1237,6 +2162,10 @@ cfs_opendir(struct cfs_dir *dir, const char *name)
    * Coffee is only guaranteed to support the directory names "/" and ".",
    * but it does not enforce this currently.
    */
+#if COFFEE_WRITE_CACHES
+  /* The listed file sizes are read from the storage. */
+  flush_caches();
+#endif
   memset(dir->state, 0, sizeof(coffee_page_t));
   return 0;
 }
@@ -1252,7 +2181,7 @@ cfs_readdir(struct cfs_dir *dir, struct cfs_dirent *record)
 
   while(page < COFFEE_PAGE_COUNT) {
     read_header(&hdr, page);
-    if(HDR_ACTIVE(hdr) && !HDR_LOG(hdr)) {
+    if(HDR_ACTIVE(hdr) && !HDR_LOG(hdr) && !HDR_INTERNAL(hdr)) {
       memcpy(record->name,
              hdr.name,
              MIN(sizeof(record->name), sizeof(hdr.name)));
@@ -1330,6 +2259,13 @@ cfs_coffee_format(void)
 
   PRINTF("Coffee: Formatting %u sectors", (unsigned)COFFEE_SECTOR_COUNT);
 
+#if COFFEE_ERASE_COUNTS
+  /* Keep the erase counts across the format. */
+  if(!erase_counts_loaded) {
+    erase_counts_load();
+  }
+#endif
+
   for(i = 0; i < COFFEE_SECTOR_COUNT; i++) {
     COFFEE_ERASE(i);
     PRINTF(".");
@@ -1338,11 +2274,73 @@ cfs_coffee_format(void)
   /* Formatting invalidates the file information. */
   memset(&coffee_files, 0, sizeof(coffee_files));
   memset(&coffee_fd_set, 0, sizeof(coffee_fd_set));
+#if COFFEE_WRITE_CACHES
+  memset(&write_caches, 0, sizeof(write_caches));
+#endif
   next_free = 0;
   gc_wait = 1;
+#if COFFEE_DIRECTORY
+  dir_state = DIR_UNKNOWN;
+#endif
+#if COFFEE_ERASE_COUNTS
+  for(i = 0; i < COFFEE_SECTOR_COUNT; i++) {
+    erase_counts[i]++;
+  }
+  erase_page = INVALID_PAGE;
+  erase_counts_write();
+#endif
 
   PRINTF(" done!\n");
 
   return 0;
 }
 /*---------------------------------------------------------------------------*/
+int
+cfs_coffee_rebuild_directory(void)
+{
+#if COFFEE_DIRECTORY
+  if(dir_state == DIR_UNKNOWN) {
+    dir_load();
+  }
+  return dir_rebuild();
+#else
+  return -1;
+#endif
+}
+/*---------------------------------------------------------------------------*/
+void
+cfs_coffee_gc_stats(struct cfs_coffee_gc_stats *stats)
+{
+#if COFFEE_ERASE_COUNTS
+  coffee_page_t sector;
+#endif
+
+  *stats = gc_stats;
+
+#if COFFEE_ERASE_COUNTS
+  if(!erase_counts_loaded) {
+    erase_counts_load();
+  }
+  stats->min_erases = stats->max_erases = erase_counts[0];
+  for(sector = 1; sector < COFFEE_SECTOR_COUNT; sector++) {
+    stats->min_erases = MIN(stats->min_erases, erase_counts[sector]);
+    stats->max_erases = MAX(stats->max_erases, erase_counts[sector]);
+  }
+#endif
+}
+/*---------------------------------------------------------------------------*/
+int
+cfs_coffee_sync(void)
+{
+#if COFFEE_WRITE_CACHES
+  int r;
+
+  flush_caches();
+  r = write_cache_failed ? -1 : 0;
+  write_cache_failed = 0;
+  return r;
+#else
+  return 0;
+#endif
+}
+/*---------------------------------------------------------------------------*/
@@ -72,6 +72,16 @@
  */
 #define CFS_COFFEE_IO_ENSURE_READ_LENGTH		0x4
 
+/**
+ * Instruct Coffee to reject writes that do not append to the file.
+ * Coffee then never creates a micro log for the file, and never has to
+ * merge the file with a log. Appending beyond the reserved size still
+ * copies the file, so the size should be reserved in advance.
+ *
+ * \sa cfs_coffee_set_io_semantics()
+ */
+#define CFS_COFFEE_IO_APPEND_ONLY		0x8
+
 /**
  * \file
  *	Header for the Coffee file system.
@@ -140,6 +150,59 @@ int cfs_coffee_set_io_semantics(int fd, unsigned flags);
  */
 int cfs_coffee_format(void);
 
+/**
+ * \brief Rebuild the directory of the files on the storage.
+ * \return 0 on success, -1 on failure or if COFFEE_DIRECTORY is disabled.
+ *
+ * When COFFEE_DIRECTORY is enabled, Coffee finds files through a hashed
+ * directory that it keeps on the storage. The directory is rebuilt
+ * automatically when it is missing or when a bucket is full. Rebuilding
+ * it explicitly drops the entries of removed files, and makes Coffee
+ * use the directory again after a bucket overflow made it fall back to
+ * scanning the storage.
+ */
+int cfs_coffee_rebuild_directory(void);
+
+/**
+ * \brief Garbage collection statistics of Coffee.
+ */
+struct cfs_coffee_gc_stats {
+  /** Number of garbage collections run by file operations */
+  uint32_t collections;
+  /** Number of steps run by the background garbage collector */
+  uint32_t steps;
+  /** Number of erased sectors */
+  uint32_t erased;
+  /** Duration of the longest background step, in rtimer ticks */
+  uint32_t longest_step;
+  /** Fewest and most erasures of a sector, if COFFEE_ERASE_COUNTS is set */
+  uint32_t min_erases;
+  uint32_t max_erases;
+};
+
+/**
+ * \brief Get the garbage collection statistics.
+ * \param stats The structure to fill in.
+ *
+ * The statistics count from the start of the system, except for the
+ * erase counts, which Coffee keeps on the storage when
+ * COFFEE_ERASE_COUNTS is set.
+ */
+void cfs_coffee_gc_stats(struct cfs_coffee_gc_stats *stats);
+
+/**
+ * \brief Write cached data to the storage.
+ * \return 0 on success, -1 on failure.
+ *
+ * If COFFEE_WRITE_CACHES is set, Coffee keeps data appended to files
+ * in RAM until a page is filled, the file is closed, or
+ * COFFEE_WRITE_CACHE_INTERVAL clock ticks have passed. This function
+ * writes the cached data of all files immediately. It fails if any
+ * cached data could not be written since the previous call, including
+ * the data written when a file was closed.
+ */
+int cfs_coffee_sync(void);
+
 /** @} */
 /** @} */
 
@@ -0,0 +1 @@
+#define BUILD_WITH_COFFEE 1
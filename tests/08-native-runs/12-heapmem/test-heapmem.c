@@ -230,6 +230,84 @@ UNIT_TEST(reallocations)
   UNIT_TEST_END();
 }
 /*****************************************************************************/
+UNIT_TEST_REGISTER(zones, "Heapmem zones");
+UNIT_TEST(zones)
+{
+#define ZONE_SIZE 1000
+
+  UNIT_TEST_BEGIN();
+
+  heapmem_zone_stats_t general_before;
+  UNIT_TEST_ASSERT(heapmem_zone_stats(HEAPMEM_ZONE_GENERAL, &general_before));
+
+  heapmem_zone_t zone = heapmem_zone_register("test", ZONE_SIZE);
+  UNIT_TEST_ASSERT(zone != HEAPMEM_ZONE_INVALID);
+  UNIT_TEST_ASSERT(zone != HEAPMEM_ZONE_GENERAL);
+
+  /* Zone names must be unique, and the general zone cannot give away
+     more than its remaining capacity. */
+  UNIT_TEST_ASSERT(heapmem_zone_register("test", 1) == HEAPMEM_ZONE_INVALID);
+  UNIT_TEST_ASSERT(heapmem_zone_register("huge", HEAPMEM_CONF_ARENA_SIZE) ==
+                   HEAPMEM_ZONE_INVALID);
+
+  /* The capacity of the zone is reserved from the general zone. */
+  heapmem_zone_stats_t stats;
+  UNIT_TEST_ASSERT(heapmem_zone_stats(HEAPMEM_ZONE_GENERAL, &stats));
+  UNIT_TEST_ASSERT(stats.capacity == general_before.capacity - ZONE_SIZE);
+
+  /* Fill the zone until an allocation fails. */
+  char *ptrs[ZONE_SIZE / 100];
+  size_t count;
+  for(count = 0; count < ZONE_SIZE / 100; count++) {
+    ptrs[count] = heapmem_zone_alloc(zone, 100);
+    if(ptrs[count] == NULL) {
+      break;
+    }
+  }
+  UNIT_TEST_ASSERT(count > 0);
+  if(count == ZONE_SIZE / 100) {
+    UNIT_TEST_ASSERT(heapmem_zone_alloc(zone, 100) == NULL);
+  }
+
+  UNIT_TEST_ASSERT(heapmem_zone_stats(zone, &stats));
+  printf("* %s: capacity %zu allocated %zu high-water %zu failures %zu\n",
+         stats.name, stats.capacity, stats.allocated, stats.high_water,
+         stats.failures);
+  UNIT_TEST_ASSERT(stats.capacity == ZONE_SIZE);
+  UNIT_TEST_ASSERT(stats.allocated <= ZONE_SIZE);
+  UNIT_TEST_ASSERT(stats.high_water == stats.allocated);
+  UNIT_TEST_ASSERT(stats.failures >= 1);
+
+  /* The general zone is unaffected by the full zone. */
+  char *ptr = heapmem_alloc(100);
+  UNIT_TEST_ASSERT(ptr != NULL);
+  UNIT_TEST_ASSERT(heapmem_free(ptr) == true);
+
+  /* A reallocation keeps the object in its zone. */
+  UNIT_TEST_ASSERT(heapmem_realloc(ptrs[count - 1], ZONE_SIZE) == NULL);
+  ptrs[count - 1] = heapmem_realloc(ptrs[count - 1], 50);
+  UNIT_TEST_ASSERT(ptrs[count - 1] != NULL);
+
+  size_t high_water = stats.high_water;
+  UNIT_TEST_ASSERT(heapmem_zone_stats(zone, &stats));
+  UNIT_TEST_ASSERT(stats.allocated < high_water);
+
+  /* Free in reverse order to give the space back to the heap. */
+  while(count > 0) {
+    UNIT_TEST_ASSERT(heapmem_free(ptrs[--count]) == true);
+  }
+
+  UNIT_TEST_ASSERT(heapmem_zone_stats(zone, &stats));
+  UNIT_TEST_ASSERT(stats.allocated == 0);
+  UNIT_TEST_ASSERT(stats.high_water == high_water);
+
+  UNIT_TEST_ASSERT(heapmem_zone_stats(HEAPMEM_ZONE_GENERAL, &stats));
+  UNIT_TEST_ASSERT(stats.allocated == general_before.allocated);
+  UNIT_TEST_ASSERT(!heapmem_zone_stats(HEAPMEM_ZONE_INVALID, &stats));
+
+  UNIT_TEST_END();
+}
+/*****************************************************************************/
 UNIT_TEST_REGISTER(stats_check, "Heapmem statistics validation");
 UNIT_TEST(stats_check)
 {
@@ -267,11 +345,13 @@ PROCESS_THREAD(test_heapmem_process, ev, data)
   UNIT_TEST_RUN(max_alloc);
   UNIT_TEST_RUN(invalid_freeing);
   UNIT_TEST_RUN(reallocations);
+  UNIT_TEST_RUN(zones);
   UNIT_TEST_RUN(stats_check);
 
   if(!UNIT_TEST_PASSED(do_many_allocations) ||
      !UNIT_TEST_PASSED(max_alloc) ||
      !UNIT_TEST_PASSED(invalid_freeing) ||
+     !UNIT_TEST_PASSED(zones) ||
      !UNIT_TEST_PASSED(stats_check)) {
     printf("=check-me= FAILED\n");
     printf("---\n");
@@ -0,0 +1,258 @@
+/*
+ * Copyright (c) 2026, RISE Research Institutes of Sweden.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+/*
+ * \file
+ *      Unit tests for the slab front-end of the heap memory module.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "contiki.h"
+#include "lib/heapmem.h"
+#include "unit-test/unit-test.h"
+/*****************************************************************************/
+#define TEST_ALLOCATIONS  10000
+#define TEST_CONCURRENT     200
+#define TEST_MAX_SIZE       200
+/*****************************************************************************/
+PROCESS(test_heapmem_slab_process, "Heapmem slab test process");
+AUTOSTART_PROCESSES(&test_heapmem_slab_process);
+/*****************************************************************************/
+static size_t
+total_cached(void)
+{
+  heapmem_slab_stats_t stats;
+  size_t cached = 0;
+
+  for(unsigned i = 0; heapmem_slab_stats(i, &stats); i++) {
+    cached += stats.cached;
+  }
+  return cached;
+}
+/*****************************************************************************/
+UNIT_TEST_REGISTER(size_classes, "Slab size classes");
+UNIT_TEST(size_classes)
+{
+  heapmem_slab_stats_t stats;
+  size_t previous_size = 0;
+  unsigned classes = 0;
+
+  UNIT_TEST_BEGIN();
+
+  /* The class sizes must be increasing and aligned. */
+  while(heapmem_slab_stats(classes, &stats)) {
+    UNIT_TEST_ASSERT(stats.size > previous_size);
+    UNIT_TEST_ASSERT((stats.size & (heapmem_alignment() - 1)) == 0);
+    previous_size = stats.size;
+    classes++;
+  }
+  UNIT_TEST_ASSERT(classes == HEAPMEM_CONF_SLAB_CLASSES);
+
+  UNIT_TEST_END();
+}
+/*****************************************************************************/
+UNIT_TEST_REGISTER(chunk_reuse, "Slab chunk reuse");
+UNIT_TEST(chunk_reuse)
+{
+  heapmem_slab_stats_t before, after;
+
+  UNIT_TEST_BEGIN();
+
+  heapmem_slab_stats(0, &before);
+
+  char *ptr1 = heapmem_alloc(1);
+  UNIT_TEST_ASSERT(ptr1 != NULL);
+  UNIT_TEST_ASSERT(heapmem_free(ptr1) == true);
+
+  /* A chunk of the same class must be served from the class free list. */
+  char *ptr2 = heapmem_alloc(before.size);
+  UNIT_TEST_ASSERT(ptr2 == ptr1);
+
+  heapmem_slab_stats(0, &after);
+  UNIT_TEST_ASSERT(after.hits == before.hits + 1);
+  UNIT_TEST_ASSERT(after.cached == before.cached);
+
+  /* Cached chunks cannot be deallocated twice. */
+  UNIT_TEST_ASSERT(heapmem_free(ptr2) == true);
+  UNIT_TEST_ASSERT(heapmem_free(ptr2) == false);
+
+  UNIT_TEST_END();
+}
+/*****************************************************************************/
+UNIT_TEST_REGISTER(large_allocation, "Allocation larger than the classes");
+UNIT_TEST(large_allocation)
+{
+  heapmem_slab_stats_t stats;
+  size_t cached;
+
+  UNIT_TEST_BEGIN();
+
+  heapmem_slab_stats(HEAPMEM_CONF_SLAB_CLASSES - 1, &stats);
+  cached = total_cached();
+
+  char *ptr = heapmem_alloc(stats.size + 1);
+  UNIT_TEST_ASSERT(ptr != NULL);
+  UNIT_TEST_ASSERT(heapmem_free(ptr) == true);
+
+  /* Large chunks go back to the heap, not to a class free list. */
+  UNIT_TEST_ASSERT(total_cached() == cached);
+
+  UNIT_TEST_END();
+}
+/*****************************************************************************/
+UNIT_TEST_REGISTER(many_allocations, "Many slab allocations");
+UNIT_TEST(many_allocations)
+{
+  char *ptrs[TEST_CONCURRENT] = { NULL };
+  unsigned failed_allocations = 0;
+  unsigned failed_deallocations = 0;
+  unsigned misalignments = 0;
+  size_t min_alignment = heapmem_alignment();
+
+  UNIT_TEST_BEGIN();
+
+  for(unsigned count = 0; count < TEST_ALLOCATIONS; count++) {
+    unsigned alloc_index = rand() % TEST_CONCURRENT;
+
+    if(ptrs[alloc_index] != NULL) {
+      if(heapmem_free(ptrs[alloc_index]) == false) {
+        failed_deallocations++;
+      }
+    }
+
+    size_t alloc_size = 1 + (rand() % TEST_MAX_SIZE);
+    ptrs[alloc_index] = heapmem_alloc(alloc_size);
+    if(ptrs[alloc_index] == NULL) {
+      failed_allocations++;
+    } else {
+      if((uintptr_t)ptrs[alloc_index] & (min_alignment - 1)) {
+        misalignments++;
+      }
+      memset(ptrs[alloc_index], '!', alloc_size);
+    }
+  }
+
+  for(unsigned alloc_index = 0; alloc_index < TEST_CONCURRENT; alloc_index++) {
+    if(ptrs[alloc_index] != NULL) {
+      if(heapmem_free(ptrs[alloc_index]) == false) {
+        failed_deallocations++;
+      }
+    }
+  }
+
+  for(unsigned i = 0; i < HEAPMEM_CONF_SLAB_CLASSES; i++) {
+    heapmem_slab_stats_t stats;
+    heapmem_slab_stats(i, &stats);
+    printf("* class %u: size %zu cached %zu hits %zu misses %zu\n",
+           i, stats.size, stats.cached, stats.hits, stats.misses);
+  }
+
+  UNIT_TEST_ASSERT(failed_allocations == 0);
+  UNIT_TEST_ASSERT(failed_deallocations == 0);
+  UNIT_TEST_ASSERT(misalignments == 0);
+
+  heapmem_stats_t stats;
+  heapmem_stats(&stats);
+  /* Cached chunks are not reported as allocated. */
+  UNIT_TEST_ASSERT(stats.allocated == 0);
+  UNIT_TEST_ASSERT(stats.chunks == 0);
+
+  UNIT_TEST_END();
+}
+/*****************************************************************************/
+UNIT_TEST_REGISTER(exhaustion, "Release of cached chunks");
+UNIT_TEST(exhaustion)
+{
+  heapmem_stats_t stats;
+  void *list = NULL;
+  unsigned count = 0;
+
+  UNIT_TEST_BEGIN();
+
+  /* Fill the heap with small chunks, linked through their first bytes. */
+  for(void **ptr; (ptr = heapmem_alloc(sizeof(void *))) != NULL; count++) {
+    *ptr = list;
+    list = ptr;
+  }
+  printf("Allocated %u small chunks\n", count);
+  UNIT_TEST_ASSERT(count > 0);
+
+  /* Deallocate them all, which puts the chunks of a class size (that is,
+     most of them) in the cache. */
+  while(list != NULL) {
+    void *next = *(void **)list;
+    UNIT_TEST_ASSERT(heapmem_free(list) == true);
+    list = next;
+  }
+  printf("Cached %zu chunks\n", total_cached());
+  UNIT_TEST_ASSERT(total_cached() >= count / 2);
+
+  /* A large allocation must succeed by releasing the cached chunks. */
+  heapmem_stats(&stats);
+  char *ptr = heapmem_alloc(stats.available / 2);
+  UNIT_TEST_ASSERT(ptr != NULL);
+  UNIT_TEST_ASSERT(total_cached() == 0);
+  UNIT_TEST_ASSERT(heapmem_free(ptr) == true);
+
+  UNIT_TEST_END();
+}
+/*****************************************************************************/
+PROCESS_THREAD(test_heapmem_slab_process, ev, data)
+{
+  PROCESS_BEGIN();
+
+  printf("Run unit-test\n");
+  printf("---\n");
+
+  srand(500);
+
+  UNIT_TEST_RUN(size_classes);
+  UNIT_TEST_RUN(chunk_reuse);
+  UNIT_TEST_RUN(large_allocation);
+  UNIT_TEST_RUN(many_allocations);
+  UNIT_TEST_RUN(exhaustion);
+
+  if(!UNIT_TEST_PASSED(size_classes) ||
+     !UNIT_TEST_PASSED(chunk_reuse) ||
+     !UNIT_TEST_PASSED(large_allocation) ||
+     !UNIT_TEST_PASSED(many_allocations) ||
+     !UNIT_TEST_PASSED(exhaustion)) {
+    printf("=check-me= FAILED\n");
+    printf("---\n");
+  }
+
+  printf("=check-me= DONE\n");
+  printf("---\n");
+
+  PROCESS_END();
+}
@@ -0,0 +1,565 @@
+/*
+ * Copyright (c) 2026, RISE Research Institutes of Sweden.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+/*
+ * \file
+ *      Unit tests for DAO aggregation in RPL Lite non-storing mode.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "contiki.h"
+#include "net/routing/rpl-lite/rpl.h"
+#include "net/routing/routing.h"
+#include "net/ipv6/uip-icmp6.h"
+#include "net/ipv6/uip-ds6-nbr.h"
+#include "net/ipv6/uip-sr.h"
+#include "net/packetbuf.h"
+#include "net/link-stats.h"
+#include "net/mac/mac.h"
+#include "unit-test/unit-test.h"
+/*****************************************************************************/
+#define TEST_TREE_SIZE  30
+/*****************************************************************************/
+PROCESS(test_dao_aggregation_process, "DAO aggregation test process");
+AUTOSTART_PROCESSES(&test_dao_aggregation_process);
+/*****************************************************************************/
+/* The DAO-ACKs sent */
+static unsigned acks_sent;
+
+/* The last DAO sent */
+static struct {
+  unsigned count;
+  uint8_t sequence;
+  uint8_t flags;
+  uint16_t targets[RPL_DAO_AGGREGATION_MAX_TARGETS + 1];
+  int num_targets;
+} dao_sent;
+/*****************************************************************************/
+void __real_uip_icmp6_send(const uip_ipaddr_t *dest, int type, int code,
+                           int payload_len);
+
+void
+__wrap_uip_icmp6_send(const uip_ipaddr_t *dest, int type, int code,
+                      int payload_len)
+{
+  const uint8_t *buffer = UIP_ICMP_PAYLOAD;
+  int pos;
+
+  if(type == ICMP6_RPL && code == RPL_CODE_DAO) {
+    dao_sent.count++;
+    dao_sent.flags = buffer[1];
+    dao_sent.sequence = buffer[3];
+    dao_sent.num_targets = 0;
+    for(pos = 4; pos + 1 < payload_len; pos += 2 + buffer[pos + 1]) {
+      if(buffer[pos] == RPL_OPTION_TARGET
+         && dao_sent.num_targets < RPL_DAO_AGGREGATION_MAX_TARGETS + 1) {
+        /* The last 16 bits of the target */
+        dao_sent.targets[dao_sent.num_targets++] =
+          (buffer[pos + 18] << 8) | buffer[pos + 19];
+      }
+    }
+  } else if(type == ICMP6_RPL && code == RPL_CODE_DAO_ACK) {
+    acks_sent++;
+  }
+  __real_uip_icmp6_send(dest, type, code, payload_len);
+}
+/*****************************************************************************/
+/* Was the target id in the last DAO sent? */
+static int
+dao_sent_target(uint16_t id)
+{
+  int i;
+
+  for(i = 0; i < dao_sent.num_targets; i++) {
+    if(dao_sent.targets[i] == id) {
+      return 1;
+    }
+  }
+  return 0;
+}
+/*****************************************************************************/
+static void
+global_addr(uip_ipaddr_t *addr, uint16_t id)
+{
+  uip_ip6addr(addr, 0xfd00, 0, 0, 0, 0x0212, 0x7400, 0, id);
+}
+/*****************************************************************************/
+static void
+linklocal_addr(uip_ipaddr_t *addr, uint16_t id)
+{
+  uip_ip6addr(addr, 0xfe80, 0, 0, 0, 0x0212, 0x7400, 0, id);
+}
+/*****************************************************************************/
+/* Joins a DODAG as a non-root node, with neighbor 1 as root */
+static void
+join_dodag(void)
+{
+  static rpl_dio_t dio;
+  linkaddr_t lladdr = { { 0x02, 0x12, 0x74, 0x00, 0, 0, 0, 1 } };
+  uip_ipaddr_t from;
+
+  uip_ip6addr(&dio.dag_id, 0xfd00, 0, 0, 0, 0x0212, 0x7400, 0, 1);
+  dio.ocp = RPL_OCP_MRHOF;
+  dio.mop = RPL_MOP_NON_STORING;
+  dio.version = RPL_LOLLIPOP_INIT;
+  dio.instance_id = RPL_DEFAULT_INSTANCE;
+  dio.dtsn = RPL_LOLLIPOP_INIT;
+  dio.dag_intdoubl = RPL_DIO_INTERVAL_DOUBLINGS;
+  dio.dag_intmin = RPL_DIO_INTERVAL_MIN;
+  dio.dag_redund = RPL_DIO_REDUNDANCY;
+  dio.default_lifetime = RPL_DEFAULT_LIFETIME;
+  dio.lifetime_unit = RPL_DEFAULT_LIFETIME_UNIT;
+  dio.dag_max_rankinc = RPL_MAX_RANKINC;
+  dio.dag_min_hoprankinc = RPL_MIN_HOPRANKINC;
+  dio.rank = RPL_MIN_HOPRANKINC;
+  uip_ip6addr(&dio.prefix_info.prefix, 0xfd00, 0, 0, 0, 0, 0, 0, 0);
+  dio.prefix_info.length = 64;
+  dio.prefix_info.flags = UIP_ND6_RA_FLAG_AUTONOMOUS;
+  dio.prefix_info.lifetime = RPL_ROUTE_INFINITE_LIFETIME;
+
+  linklocal_addr(&from, 1);
+  packetbuf_set_addr(PACKETBUF_ADDR_SENDER, &lladdr);
+  rpl_process_dio(&from, &dio);
+}
+/*****************************************************************************/
+/* Passes a DAO from a child, with a given list of targets, to the aggregation
+ * module as dao_input would */
+static void
+child_dao(uint16_t child, uint8_t sequence, int ack,
+          const uint16_t *targets, const uint16_t *parents, int count)
+{
+  static rpl_dao_target_t dao_targets[RPL_DAO_AGGREGATION_MAX_TARGETS + 2];
+  rpl_dao_t dao;
+  uip_ipaddr_t from;
+  int i;
+
+  memset(&dao, 0, sizeof(dao));
+  dao.sequence = sequence;
+  dao.flags = ack ? RPL_DAO_K_FLAG : 0;
+  dao.targets = dao_targets;
+  dao.num_targets = count;
+  for(i = 0; i < count; i++) {
+    global_addr(&dao_targets[i].target, targets[i]);
+    global_addr(&dao_targets[i].parent, parents[i]);
+    dao_targets[i].lifetime = 30;
+  }
+  linklocal_addr(&from, child);
+  rpl_process_dao(&from, &dao);
+}
+/*****************************************************************************/
+static int
+drain_pending(uint8_t sequence, int *ack_requested)
+{
+  int index = 0;
+  int count = 0;
+
+  *ack_requested = 0;
+  while(rpl_dao_aggregation_next_target(&index, sequence,
+                                        ack_requested) != NULL) {
+    count++;
+  }
+  return count;
+}
+/*****************************************************************************/
+UNIT_TEST_REGISTER(aggregation, "Targets held and forwarded by a node");
+UNIT_TEST(aggregation)
+{
+  static const uint16_t a_targets[] = { 0x10, 0x11 };
+  static const uint16_t a_parents[] = { 0x02, 0x10 };
+  static const uint16_t c_targets[] = { 0x12 };
+  static const uint16_t c_parents[] = { 0x02 };
+  int ack_requested;
+
+  UNIT_TEST_BEGIN();
+
+  join_dodag();
+  UNIT_TEST_ASSERT(curr_instance.used && !rpl_dag_root_is_root());
+
+  /* Child 0x10 advertises itself and its own child, 0x12 itself */
+  child_dao(0x10, 10, 1, a_targets, a_parents, 2);
+  child_dao(0x12, 20, 1, c_targets, c_parents, 1);
+  UNIT_TEST_ASSERT(drain_pending(50, &ack_requested) == 3);
+  UNIT_TEST_ASSERT(ack_requested);
+
+  /* A retransmission replaces the held target; the targets of the DAO
+   * that was not ACKed are forwarded again */
+  child_dao(0x10, 11, 0, a_targets, a_parents, 1);
+  child_dao(0x10, 11, 0, a_targets, a_parents, 1);
+  UNIT_TEST_ASSERT(drain_pending(51, &ack_requested) == 3);
+  UNIT_TEST_ASSERT(ack_requested);
+
+  /* A late ACK of the first DAO is ignored */
+  acks_sent = 0;
+  rpl_dao_aggregation_ack(50, RPL_DAO_ACK_UNCONDITIONAL_ACCEPT);
+  UNIT_TEST_ASSERT(drain_pending(52, &ack_requested) == 3);
+
+  /* ACK the last DAO: 0x10 and 0x12 get a single DAO-ACK each, for their
+   * DAOs that requested one */
+  rpl_dao_aggregation_ack(52, RPL_DAO_ACK_UNCONDITIONAL_ACCEPT);
+  UNIT_TEST_ASSERT(drain_pending(53, &ack_requested) == 0);
+
+  UNIT_TEST_END();
+}
+/*****************************************************************************/
+UNIT_TEST_REGISTER(ack_fan_out, "DAO-ACKs fanned out to the children");
+UNIT_TEST(ack_fan_out)
+{
+  UNIT_TEST_BEGIN();
+
+  UNIT_TEST_ASSERT(acks_sent == 2);
+
+  UNIT_TEST_END();
+}
+/*****************************************************************************/
+UNIT_TEST_REGISTER(forward, "Targets forwarded in a new DAO");
+UNIT_TEST(forward)
+{
+  static const uint16_t targets[] = { 0x30 };
+  static const uint16_t parents[] = { 0x02 };
+  linkaddr_t root = { { 0x02, 0x12, 0x74, 0x00, 0, 0, 0, 1 } };
+  uip_ipaddr_t root_ipaddr;
+  int i;
+
+  UNIT_TEST_BEGIN();
+
+  /* The root is selected as parent once it is a reachable neighbor with
+     fresh link statistics */
+  linklocal_addr(&root_ipaddr, 1);
+  uip_ds6_nbr_add(&root_ipaddr, (uip_lladdr_t *)&root, 1, NBR_REACHABLE,
+                  NBR_TABLE_REASON_RPL_DIO, NULL);
+  for(i = 0; i < 4; i++) {
+    link_stats_packet_sent(&root, MAC_TX_OK, 1);
+  }
+  rpl_dag_update_state();
+  UNIT_TEST_ASSERT(curr_instance.dag.preferred_parent != NULL);
+
+  dao_sent.count = 0;
+  child_dao(0x30, 7, 1, targets, parents, 1);
+
+  UNIT_TEST_END();
+}
+/*****************************************************************************/
+UNIT_TEST_REGISTER(forwarded, "A new DAO sent after the hold time");
+UNIT_TEST(forwarded)
+{
+  UNIT_TEST_BEGIN();
+
+  /* A new DAO, to be retransmitted until it is ACKed */
+  UNIT_TEST_ASSERT(dao_sent.count == 1);
+  UNIT_TEST_ASSERT(dao_sent.sequence == curr_instance.dag.dao_last_seqno);
+  UNIT_TEST_ASSERT(dao_sent.flags & RPL_DAO_K_FLAG);
+  UNIT_TEST_ASSERT(dao_sent.num_targets == 2 && dao_sent_target(0x30));
+  UNIT_TEST_ASSERT(curr_instance.dag.dao_transmissions == 1);
+  UNIT_TEST_ASSERT(!ctimer_expired(&curr_instance.dag.dao_timer));
+
+  UNIT_TEST_END();
+}
+/*****************************************************************************/
+UNIT_TEST_REGISTER(retransmitted, "Retransmission of the new DAO");
+UNIT_TEST(retransmitted)
+{
+  UNIT_TEST_BEGIN();
+
+  /* The same DAO, with the same targets */
+  UNIT_TEST_ASSERT(dao_sent.count >= 2);
+  UNIT_TEST_ASSERT(dao_sent.count == curr_instance.dag.dao_transmissions);
+  UNIT_TEST_ASSERT(dao_sent.sequence == curr_instance.dag.dao_last_seqno);
+  UNIT_TEST_ASSERT(dao_sent.num_targets == 2 && dao_sent_target(0x30));
+
+  /* The DAO-ACK stops the retransmissions and is passed on */
+  acks_sent = 0;
+  rpl_process_dao_ack(dao_sent.sequence, RPL_DAO_ACK_UNCONDITIONAL_ACCEPT);
+  rpl_dao_aggregation_ack(dao_sent.sequence, RPL_DAO_ACK_UNCONDITIONAL_ACCEPT);
+
+  UNIT_TEST_END();
+}
+/*****************************************************************************/
+UNIT_TEST_REGISTER(acked, "DAO-ACK of the new DAO");
+UNIT_TEST(acked)
+{
+  UNIT_TEST_BEGIN();
+
+  UNIT_TEST_ASSERT(acks_sent == 1);
+  UNIT_TEST_ASSERT(dao_sent.count == curr_instance.dag.dao_transmissions);
+
+  UNIT_TEST_END();
+}
+/*****************************************************************************/
+UNIT_TEST_REGISTER(capacity, "Targets beyond capacity");
+UNIT_TEST(capacity)
+{
+  static const uint16_t many[] = { 0x20, 0x21, 0x22, 0x23, 0x24, 0x25 };
+  static const uint16_t parents[] = { 0x02, 0x02, 0x02, 0x02, 0x02, 0x02 };
+  int ack_requested;
+
+  UNIT_TEST_BEGIN();
+
+  rpl_dao_aggregation_reset();
+  child_dao(0x20, 1, 0, many, parents, RPL_DAO_AGGREGATION_MAX_TARGETS + 2);
+  UNIT_TEST_ASSERT(drain_pending(52, &ack_requested)
+                   == RPL_DAO_AGGREGATION_MAX_TARGETS);
+
+  UNIT_TEST_END();
+}
+/*****************************************************************************/
+UNIT_TEST_REGISTER(leave, "No-Path DAO when leaving the DAG");
+UNIT_TEST(leave)
+{
+  int ack_requested;
+
+  UNIT_TEST_BEGIN();
+
+  /* The targets held from the previous test are not advertised again */
+  dao_sent.count = 0;
+  rpl_dag_leave();
+  UNIT_TEST_ASSERT(dao_sent.count == 1);
+  UNIT_TEST_ASSERT(dao_sent.num_targets == 1 && !dao_sent_target(0x20));
+  UNIT_TEST_ASSERT(!(dao_sent.flags & RPL_DAO_K_FLAG));
+  UNIT_TEST_ASSERT(drain_pending(53, &ack_requested) == 0);
+
+  UNIT_TEST_END();
+}
+/*****************************************************************************/
+/* Delivers a multi-target DAO from a child as if received over the air.
+ * A parent of 0 stands for the root. */
+static void
+dao_input(uint16_t child, const uint16_t *targets, const uint16_t *parents,
+          const uint8_t *lifetimes, int count)
+{
+  uint8_t *buffer;
+  int pos = 0;
+  int i;
+
+  uipbuf_clear();
+  linklocal_addr(&UIP_IP_BUF->srcipaddr, child);
+  uip_ipaddr_copy(&UIP_IP_BUF->destipaddr, &curr_instance.dag.dag_id);
+
+  buffer = UIP_ICMP_PAYLOAD;
+  buffer[pos++] = curr_instance.instance_id;
+  buffer[pos++] = 0; /* flags */
+  buffer[pos++] = 0; /* reserved */
+  buffer[pos++] = 42; /* sequence */
+  for(i = 0; i < count; i++) {
+    buffer[pos++] = RPL_OPTION_TARGET;
+    buffer[pos++] = 18;
+    buffer[pos++] = 0;
+    buffer[pos++] = 128;
+    global_addr((uip_ipaddr_t *)&buffer[pos], targets[i]);
+    pos += 16;
+    /* Consecutive targets with the same transit form a single group */
+    if(i + 1 < count && parents[i + 1] == parents[i]
+       && lifetimes[i + 1] == lifetimes[i]) {
+      continue;
+    }
+    buffer[pos++] = RPL_OPTION_TRANSIT;
+    buffer[pos++] = 20;
+    buffer[pos++] = 0;
+    buffer[pos++] = 0;
+    buffer[pos++] = 0;
+    buffer[pos++] = lifetimes[i];
+    if(parents[i] == 0) {
+      uip_ipaddr_copy((uip_ipaddr_t *)&buffer[pos], &curr_instance.dag.dag_id);
+    } else {
+      global_addr((uip_ipaddr_t *)&buffer[pos], parents[i]);
+    }
+    pos += 16;
+  }
+  uip_len = UIP_IPH_LEN + UIP_ICMPH_LEN + pos;
+  uip_icmp6_input(ICMP6_RPL, RPL_CODE_DAO);
+}
+/*****************************************************************************/
+static int
+is_reachable(uint16_t id)
+{
+  uip_ipaddr_t addr;
+  global_addr(&addr, id);
+  return uip_sr_is_addr_reachable(NULL, &addr);
+}
+/*****************************************************************************/
+UNIT_TEST_REGISTER(root_input, "Multi-target DAO at the root");
+UNIT_TEST(root_input)
+{
+  /* 0x10 and 0x11 are children of the root (0), 0x12 is a child of 0x10 */
+  static const uint16_t targets[] = { 0x10, 0x11, 0x12 };
+  static const uint16_t parents[] = { 0, 0, 0x10 };
+  static const uint8_t lifetimes[] = { 30, 30, 30 };
+  static const uint16_t expired[] = { 0x12 };
+  static const uint16_t expired_parents[] = { 0x10 };
+  static const uint8_t no_path[] = { 0 };
+  uip_ipaddr_t addr;
+  uip_sr_node_t *node;
+
+  UNIT_TEST_BEGIN();
+
+  UNIT_TEST_ASSERT(rpl_dag_root_start() == 0);
+  UNIT_TEST_ASSERT(rpl_dag_root_is_root());
+
+  dao_input(0x10, targets, parents, lifetimes, 3);
+  UNIT_TEST_ASSERT(uip_sr_num_nodes() == 4);
+  UNIT_TEST_ASSERT(is_reachable(0x10));
+  UNIT_TEST_ASSERT(is_reachable(0x11));
+  UNIT_TEST_ASSERT(is_reachable(0x12));
+
+  /* A No-path group expires the link */
+  dao_input(0x10, expired, expired_parents, no_path, 1);
+  global_addr(&addr, 0x12);
+  node = uip_sr_get_node(NULL, &addr);
+  UNIT_TEST_ASSERT(node != NULL && node->lifetime <= UIP_SR_REMOVAL_DELAY);
+
+  UNIT_TEST_END();
+}
+/*****************************************************************************/
+/* Records the parent of every node of the tree */
+static void
+snapshot(uip_ipaddr_t *addrs, uip_sr_node_t **parents)
+{
+  int i;
+  for(i = 0; i <= TEST_TREE_SIZE; i++) {
+    uip_sr_node_t *node = uip_sr_get_node(NULL, &addrs[i]);
+    parents[i] = node != NULL ? node->parent : NULL;
+  }
+}
+/*****************************************************************************/
+UNIT_TEST_REGISTER(batch, "Batched source routing updates");
+UNIT_TEST(batch)
+{
+  static uip_ipaddr_t addrs[TEST_TREE_SIZE + 1];
+  static uip_sr_update_t updates[TEST_TREE_SIZE + 1];
+  static uip_sr_node_t *single[TEST_TREE_SIZE + 1];
+  static uip_sr_node_t *batched[TEST_TREE_SIZE + 1];
+  int i;
+
+  UNIT_TEST_BEGIN();
+
+  /* addrs[0] is the root, the others form a random tree, shuffled, followed
+   * by an update that would create a loop */
+  uip_ipaddr_copy(&addrs[0], &curr_instance.dag.dag_id);
+  for(i = 1; i <= TEST_TREE_SIZE; i++) {
+    global_addr(&addrs[i], 0x100 + i);
+  }
+  for(i = 0; i < TEST_TREE_SIZE; i++) {
+    int child = 1 + i;
+    updates[i].child = &addrs[child];
+    updates[i].parent = &addrs[rand() % child];
+    updates[i].lifetime = 300;
+  }
+  for(i = TEST_TREE_SIZE - 1; i > 0; i--) {
+    int j = rand() % (i + 1);
+    uip_sr_update_t tmp = updates[i];
+    updates[i] = updates[j];
+    updates[j] = tmp;
+  }
+  updates[TEST_TREE_SIZE].child = &addrs[1];
+  updates[TEST_TREE_SIZE].parent = &addrs[TEST_TREE_SIZE];
+  updates[TEST_TREE_SIZE].lifetime = 300;
+
+  uip_sr_free_all();
+  for(i = 0; i <= TEST_TREE_SIZE; i++) {
+    uip_sr_update_node(NULL, updates[i].child, updates[i].parent,
+                       updates[i].lifetime);
+  }
+  snapshot(addrs, single);
+
+  uip_sr_free_all();
+  UNIT_TEST_ASSERT(uip_sr_update_nodes(NULL, updates, TEST_TREE_SIZE + 1)
+                   == TEST_TREE_SIZE + 1);
+  snapshot(addrs, batched);
+
+  UNIT_TEST_ASSERT(uip_sr_num_nodes() == TEST_TREE_SIZE + 1);
+  for(i = 1; i <= TEST_TREE_SIZE; i++) {
+    /* Nodes are allocated in the same order, compare their addresses */
+    uip_ipaddr_t single_parent;
+    uip_ipaddr_t batched_parent;
+    UNIT_TEST_ASSERT(single[i] != NULL && batched[i] != NULL);
+    NETSTACK_ROUTING.get_sr_node_ipaddr(&single_parent, single[i]);
+    NETSTACK_ROUTING.get_sr_node_ipaddr(&batched_parent, batched[i]);
+    UNIT_TEST_ASSERT(uip_ipaddr_cmp(&single_parent, &batched_parent));
+    UNIT_TEST_ASSERT(uip_sr_is_addr_reachable(NULL, &addrs[i]));
+  }
+
+  UNIT_TEST_END();
+}
+/*****************************************************************************/
+PROCESS_THREAD(test_dao_aggregation_process, ev, data)
+{
+  static struct etimer et;
+
+  PROCESS_BEGIN();
+
+  printf("Run unit-test\n");
+  printf("---\n");
+
+  srand(500);
+
+  UNIT_TEST_RUN(aggregation);
+  /* Let the DAO-ACKs be sent */
+  etimer_set(&et, 1);
+  PROCESS_WAIT_EVENT_UNTIL(etimer_expired(&et));
+  UNIT_TEST_RUN(ack_fan_out);
+  UNIT_TEST_RUN(forward);
+  /* Let the hold timer expire */
+  etimer_set(&et, RPL_DAO_AGGREGATION_DELAY + 1);
+  PROCESS_WAIT_EVENT_UNTIL(etimer_expired(&et));
+  UNIT_TEST_RUN(forwarded);
+  /* Let the DAO be retransmitted */
+  etimer_set(&et, RPL_DAO_RETRANSMISSION_TIMEOUT * 3 / 2 + 1);
+  PROCESS_WAIT_EVENT_UNTIL(etimer_expired(&et));
+  UNIT_TEST_RUN(retransmitted);
+  /* Let the DAO-ACK be sent, and check that the DAO is not sent again */
+  etimer_set(&et, RPL_DAO_RETRANSMISSION_TIMEOUT * 3 / 2 + 1);
+  PROCESS_WAIT_EVENT_UNTIL(etimer_expired(&et));
+  UNIT_TEST_RUN(acked);
+  UNIT_TEST_RUN(capacity);
+  UNIT_TEST_RUN(leave);
+  UNIT_TEST_RUN(root_input);
+  UNIT_TEST_RUN(batch);
+
+  if(!UNIT_TEST_PASSED(aggregation) ||
+     !UNIT_TEST_PASSED(ack_fan_out) ||
+     !UNIT_TEST_PASSED(forward) ||
+     !UNIT_TEST_PASSED(forwarded) ||
+     !UNIT_TEST_PASSED(retransmitted) ||
+     !UNIT_TEST_PASSED(acked) ||
+     !UNIT_TEST_PASSED(capacity) ||
+     !UNIT_TEST_PASSED(leave) ||
+     !UNIT_TEST_PASSED(root_input) ||
+     !UNIT_TEST_PASSED(batch)) {
+    printf("=check-me= FAILED\n");
+    printf("---\n");
+  }
+
+  printf("=check-me= DONE\n");
+  printf("---\n");
+
+  PROCESS_END();
+}
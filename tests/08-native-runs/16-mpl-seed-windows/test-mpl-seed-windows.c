@@ -0,0 +1,166 @@
+/*
+ * Copyright (c) 2026, RISE Research Institutes of Sweden.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+/*
+ * \file
+ *      Unit tests for MPL seed windows.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "contiki.h"
+#include "net/ipv6/uip.h"
+#include "net/ipv6/multicast/uip-mcast6.h"
+#include "net/ipv6/multicast/mpl.h"
+#include "unit-test/unit-test.h"
+/*****************************************************************************/
+PROCESS(test_mpl_process, "MPL seed windows test process");
+AUTOSTART_PROCESSES(&test_mpl_process);
+/*****************************************************************************/
+/* Passes an MPL data message with a 16-bit seed id to the engine, and
+ * returns whether it was accepted */
+static uint8_t
+mpl_input(uint16_t seed, uint8_t seq)
+{
+  uint8_t *hbho;
+  uint8_t *udp;
+
+  uipbuf_clear();
+  UIP_IP_BUF->vtc = 0x60;
+  UIP_IP_BUF->tcflow = 0;
+  UIP_IP_BUF->flow = 0;
+  UIP_IP_BUF->proto = UIP_PROTO_HBHO;
+  UIP_IP_BUF->ttl = 64;
+  uip_ip6addr(&UIP_IP_BUF->srcipaddr, 0xfd00, 0, 0, 0, 0, 0, 0, seed);
+  ALL_MPL_FORWARDERS(&UIP_IP_BUF->destipaddr, UIP_MCAST6_SCOPE_REALM_LOCAL);
+
+  hbho = UIP_IP_PAYLOAD(0);
+  memset(hbho, 0, HBHO_BASE_LEN);
+  hbho[0] = UIP_PROTO_UDP;
+  hbho[2] = HBHO_OPT_TYPE_MPL;
+  hbho[3] = MPL_OPT_LEN_S1;
+  hbho[4] = 1 << 6; /* S=1, M=0 */
+  hbho[5] = seq;
+  hbho[6] = seed >> 8;
+  hbho[7] = seed & 0xff;
+  uip_ext_len = HBHO_BASE_LEN;
+
+  udp = UIP_IP_PAYLOAD(HBHO_BASE_LEN);
+  memset(udp, 0, UIP_UDPH_LEN + 4);
+  udp[UIP_UDPH_LEN] = seq;
+
+  uip_len = UIP_IPH_LEN + HBHO_BASE_LEN + UIP_UDPH_LEN + 4;
+  uipbuf_set_len_field(UIP_IP_BUF, uip_len - UIP_IPH_LEN);
+
+  return UIP_MCAST6.in();
+}
+/*****************************************************************************/
+UNIT_TEST_REGISTER(duplicates, "Duplicate detection");
+UNIT_TEST(duplicates)
+{
+  UNIT_TEST_BEGIN();
+
+  UNIT_TEST_ASSERT(mpl_input(1, 10) == UIP_MCAST6_ACCEPT);
+  UNIT_TEST_ASSERT(mpl_input(1, 10) == UIP_MCAST6_DROP);
+  UNIT_TEST_ASSERT(mpl_input(1, 12) == UIP_MCAST6_ACCEPT);
+  /* Out of order, but within the window */
+  UNIT_TEST_ASSERT(mpl_input(1, 11) == UIP_MCAST6_ACCEPT);
+  UNIT_TEST_ASSERT(mpl_input(1, 11) == UIP_MCAST6_DROP);
+  UNIT_TEST_ASSERT(mpl_input(1, 12) == UIP_MCAST6_DROP);
+  /* Older than the window */
+  UNIT_TEST_ASSERT(mpl_input(1, 9) == UIP_MCAST6_DROP);
+
+  UNIT_TEST_END();
+}
+/*****************************************************************************/
+UNIT_TEST_REGISTER(window, "Window sliding");
+UNIT_TEST(window)
+{
+  UNIT_TEST_BEGIN();
+
+  /* 10 to 12 are released to make room for 50 */
+  UNIT_TEST_ASSERT(mpl_input(1, 50) == UIP_MCAST6_ACCEPT);
+  UNIT_TEST_ASSERT(mpl_input(1, 12) == UIP_MCAST6_DROP);
+  UNIT_TEST_ASSERT(mpl_input(1, 49) == UIP_MCAST6_DROP);
+  UNIT_TEST_ASSERT(mpl_input(1, 51) == UIP_MCAST6_ACCEPT);
+  UNIT_TEST_ASSERT(mpl_input(1, 50) == UIP_MCAST6_DROP);
+
+  UNIT_TEST_END();
+}
+/*****************************************************************************/
+UNIT_TEST_REGISTER(reclaim, "Least recently active seed reclaimed first");
+UNIT_TEST(reclaim)
+{
+  UNIT_TEST_BEGIN();
+
+  /* Seed 1 holds 50 and 51, seed 2 gets 1 and 3 */
+  UNIT_TEST_ASSERT(mpl_input(2, 1) == UIP_MCAST6_ACCEPT);
+  UNIT_TEST_ASSERT(mpl_input(2, 3) == UIP_MCAST6_ACCEPT);
+  /* Seed 1 becomes the largest, and most recently active, seed */
+  UNIT_TEST_ASSERT(mpl_input(1, 52) == UIP_MCAST6_ACCEPT);
+  UNIT_TEST_ASSERT(mpl_input(1, 53) == UIP_MCAST6_ACCEPT);
+
+  /* All buffers are in use: seed 2 gives up its oldest message */
+  UNIT_TEST_ASSERT(mpl_input(3, 1) == UIP_MCAST6_ACCEPT);
+  UNIT_TEST_ASSERT(mpl_input(2, 2) == UIP_MCAST6_DROP);
+  UNIT_TEST_ASSERT(mpl_input(1, 50) == UIP_MCAST6_DROP);
+
+  /* Seed 2 still is the least recently active one */
+  UNIT_TEST_ASSERT(mpl_input(1, 54) == UIP_MCAST6_ACCEPT);
+  UNIT_TEST_ASSERT(mpl_input(2, 3) == UIP_MCAST6_DROP);
+  UNIT_TEST_ASSERT(mpl_input(2, 4) == UIP_MCAST6_ACCEPT);
+
+  UNIT_TEST_END();
+}
+/*****************************************************************************/
+PROCESS_THREAD(test_mpl_process, ev, data)
+{
+  PROCESS_BEGIN();
+
+  printf("Run unit-test\n");
+  printf("---\n");
+
+  UNIT_TEST_RUN(duplicates);
+  UNIT_TEST_RUN(window);
+  UNIT_TEST_RUN(reclaim);
+
+  if(!UNIT_TEST_PASSED(duplicates) ||
+     !UNIT_TEST_PASSED(window) ||
+     !UNIT_TEST_PASSED(reclaim)) {
+    printf("=check-me= FAILED\n");
+    printf("---\n");
+  }
+
+  printf("=check-me= DONE\n");
+  printf("---\n");
+
+  PROCESS_END();
+}
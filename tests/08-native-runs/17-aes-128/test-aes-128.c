@@ -0,0 +1,263 @@
+/*
+ * Copyright (c) 2026, RISE Research Institutes of Sweden.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+/*
+ * \file
+ *      Known-answer tests for the software AES-128 drivers, with their
+ *      key cache, and for CCM* on top of the table-driven driver.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "contiki.h"
+#include "lib/aes-128.h"
+#include "lib/ccm-star.h"
+#include "unit-test/unit-test.h"
+/*****************************************************************************/
+PROCESS(test_aes_process, "AES-128 test process");
+AUTOSTART_PROCESSES(&test_aes_process);
+/*****************************************************************************/
+/* FIPS-197, appendix C.1 */
+static const uint8_t fips_key[AES_128_KEY_LENGTH] = {
+  0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07,
+  0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f
+};
+static const uint8_t fips_plaintext[AES_128_BLOCK_SIZE] = {
+  0x00, 0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77,
+  0x88, 0x99, 0xaa, 0xbb, 0xcc, 0xdd, 0xee, 0xff
+};
+static const uint8_t fips_ciphertext[AES_128_BLOCK_SIZE] = {
+  0x69, 0xc4, 0xe0, 0xd8, 0x6a, 0x7b, 0x04, 0x30,
+  0xd8, 0xcd, 0xb7, 0x80, 0x70, 0xb4, 0xc5, 0x5a
+};
+
+/* NIST SP 800-38A, F.1.1 ECB-AES128.Encrypt */
+static const uint8_t sp800_key[AES_128_KEY_LENGTH] = {
+  0x2b, 0x7e, 0x15, 0x16, 0x28, 0xae, 0xd2, 0xa6,
+  0xab, 0xf7, 0x15, 0x88, 0x09, 0xcf, 0x4f, 0x3c
+};
+static const uint8_t sp800_plaintext[4][AES_128_BLOCK_SIZE] = {
+  { 0x6b, 0xc1, 0xbe, 0xe2, 0x2e, 0x40, 0x9f, 0x96,
+    0xe9, 0x3d, 0x7e, 0x11, 0x73, 0x93, 0x17, 0x2a },
+  { 0xae, 0x2d, 0x8a, 0x57, 0x1e, 0x03, 0xac, 0x9c,
+    0x9e, 0xb7, 0x6f, 0xac, 0x45, 0xaf, 0x8e, 0x51 },
+  { 0x30, 0xc8, 0x1c, 0x46, 0xa3, 0x5c, 0xe4, 0x11,
+    0xe5, 0xfb, 0xc1, 0x19, 0x1a, 0x0a, 0x52, 0xef },
+  { 0xf6, 0x9f, 0x24, 0x45, 0xdf, 0x4f, 0x9b, 0x17,
+    0xad, 0x2b, 0x41, 0x7b, 0xe6, 0x6c, 0x37, 0x10 }
+};
+static const uint8_t sp800_ciphertext[4][AES_128_BLOCK_SIZE] = {
+  { 0x3a, 0xd7, 0x7b, 0xb4, 0x0d, 0x7a, 0x36, 0x60,
+    0xa8, 0x9e, 0xca, 0xf3, 0x24, 0x66, 0xef, 0x97 },
+  { 0xf5, 0xd3, 0xd5, 0x85, 0x03, 0xb9, 0x69, 0x9d,
+    0xe7, 0x85, 0x89, 0x5a, 0x96, 0xfd, 0xba, 0xaf },
+  { 0x43, 0xb1, 0xcd, 0x7f, 0x59, 0x8e, 0xce, 0x23,
+    0x88, 0x1b, 0x00, 0xe3, 0xed, 0x03, 0x06, 0x88 },
+  { 0x7b, 0x0c, 0x78, 0x5e, 0x27, 0xe8, 0xad, 0x3f,
+    0x82, 0x23, 0x20, 0x71, 0x04, 0x72, 0x5d, 0xd4 }
+};
+
+/* RFC 3610, packet vectors #1 and #2: 8-byte header, 8-byte MIC. The
+   results are the encrypted message followed by the encrypted MIC */
+static const uint8_t rfc3610_key[AES_128_KEY_LENGTH] = {
+  0xc0, 0xc1, 0xc2, 0xc3, 0xc4, 0xc5, 0xc6, 0xc7,
+  0xc8, 0xc9, 0xca, 0xcb, 0xcc, 0xcd, 0xce, 0xcf
+};
+static const uint8_t rfc3610_nonce[2][CCM_STAR_NONCE_LENGTH] = {
+  { 0x00, 0x00, 0x00, 0x03, 0x02, 0x01, 0x00,
+    0xa0, 0xa1, 0xa2, 0xa3, 0xa4, 0xa5 },
+  { 0x00, 0x00, 0x00, 0x04, 0x03, 0x02, 0x01,
+    0xa0, 0xa1, 0xa2, 0xa3, 0xa4, 0xa5 }
+};
+static const uint8_t rfc3610_m_len[2] = { 23, 24 };
+static const uint8_t rfc3610_result[2][32] = {
+  { 0x58, 0x8c, 0x97, 0x9a, 0x61, 0xc6, 0x63, 0xd2,
+    0xf0, 0x66, 0xd0, 0xc2, 0xc0, 0xf9, 0x89, 0x80,
+    0x6d, 0x5f, 0x6b, 0x61, 0xda, 0xc3, 0x84, 0x17,
+    0xe8, 0xd1, 0x2c, 0xfd, 0xf9, 0x26, 0xe0 },
+  { 0x72, 0xc9, 0x1a, 0x36, 0xe1, 0x35, 0xf8, 0xcf,
+    0x29, 0x1c, 0xa8, 0x94, 0x08, 0x5c, 0x87, 0xe3,
+    0xcc, 0x15, 0xc4, 0x39, 0xc9, 0xe4, 0x3a, 0x3b,
+    0xa0, 0x91, 0xd5, 0x6e, 0x10, 0x40, 0x09, 0x16 }
+};
+#define RFC3610_HDR_LEN 8
+#define RFC3610_MIC_LEN 8
+/*****************************************************************************/
+static int
+check_driver(const struct aes_128_driver *driver)
+{
+  uint8_t block[AES_128_BLOCK_SIZE];
+  int i;
+
+  driver->set_key(fips_key);
+  memcpy(block, fips_plaintext, sizeof(block));
+  driver->encrypt(block);
+  if(memcmp(block, fips_ciphertext, sizeof(block))) {
+    return 0;
+  }
+
+  driver->set_key(sp800_key);
+  for(i = 0; i < 4; i++) {
+    memcpy(block, sp800_plaintext[i], sizeof(block));
+    driver->encrypt(block);
+    if(memcmp(block, sp800_ciphertext[i], sizeof(block))) {
+      return 0;
+    }
+  }
+  return 1;
+}
+/*****************************************************************************/
+UNIT_TEST_REGISTER(aes_128_driver_kat, "AES-128 byte-oriented driver");
+UNIT_TEST(aes_128_driver_kat)
+{
+  UNIT_TEST_BEGIN();
+
+  UNIT_TEST_ASSERT(check_driver(&aes_128_driver));
+
+  UNIT_TEST_END();
+}
+/*****************************************************************************/
+UNIT_TEST_REGISTER(aes_128_ttable_kat, "AES-128 table-driven driver");
+UNIT_TEST(aes_128_ttable_kat)
+{
+  UNIT_TEST_BEGIN();
+
+  UNIT_TEST_ASSERT(check_driver(&aes_128_ttable_driver));
+
+  UNIT_TEST_END();
+}
+/*****************************************************************************/
+/* Switches between three keys, more than the key cache holds */
+static int
+check_key_cache(const struct aes_128_driver *driver)
+{
+  static const uint8_t *const keys[] = {
+    fips_key, sp800_key, fips_key, rfc3610_key, sp800_key, fips_key
+  };
+  uint8_t block[AES_128_BLOCK_SIZE];
+  int i;
+
+  for(i = 0; i < sizeof(keys) / sizeof(keys[0]); i++) {
+    driver->set_key(keys[i]);
+    if(keys[i] == fips_key) {
+      memcpy(block, fips_plaintext, sizeof(block));
+      driver->encrypt(block);
+      if(memcmp(block, fips_ciphertext, sizeof(block))) {
+        return 0;
+      }
+    } else if(keys[i] == sp800_key) {
+      memcpy(block, sp800_plaintext[0], sizeof(block));
+      driver->encrypt(block);
+      if(memcmp(block, sp800_ciphertext[0], sizeof(block))) {
+        return 0;
+      }
+    }
+  }
+  return 1;
+}
+/*****************************************************************************/
+UNIT_TEST_REGISTER(aes_128_key_cache, "AES-128 key cache");
+UNIT_TEST(aes_128_key_cache)
+{
+  UNIT_TEST_BEGIN();
+
+  UNIT_TEST_ASSERT(check_key_cache(&aes_128_driver));
+  UNIT_TEST_ASSERT(check_key_cache(&aes_128_ttable_driver));
+
+  UNIT_TEST_END();
+}
+/*****************************************************************************/
+UNIT_TEST_REGISTER(ccm_star_kat, "CCM* packet vectors");
+UNIT_TEST(ccm_star_kat)
+{
+  uint8_t frame[RFC3610_HDR_LEN + 24 + RFC3610_MIC_LEN];
+  uint8_t mic[RFC3610_MIC_LEN];
+  uint8_t m_len;
+  int v;
+  int i;
+
+  UNIT_TEST_BEGIN();
+
+  CCM_STAR.set_key(rfc3610_key);
+  for(v = 0; v < 2; v++) {
+    m_len = rfc3610_m_len[v];
+    for(i = 0; i < RFC3610_HDR_LEN + m_len; i++) {
+      frame[i] = i;
+    }
+
+    /* Encrypt and authenticate */
+    CCM_STAR.aead(rfc3610_nonce[v],
+                  frame + RFC3610_HDR_LEN, m_len,
+                  frame, RFC3610_HDR_LEN,
+                  frame + RFC3610_HDR_LEN + m_len, RFC3610_MIC_LEN, 1);
+    UNIT_TEST_ASSERT(!memcmp(frame + RFC3610_HDR_LEN, rfc3610_result[v],
+                             m_len + RFC3610_MIC_LEN));
+
+    /* Decrypt and check the MIC */
+    CCM_STAR.aead(rfc3610_nonce[v],
+                  frame + RFC3610_HDR_LEN, m_len,
+                  frame, RFC3610_HDR_LEN,
+                  mic, RFC3610_MIC_LEN, 0);
+    UNIT_TEST_ASSERT(!memcmp(mic, frame + RFC3610_HDR_LEN + m_len,
+                             RFC3610_MIC_LEN));
+    for(i = 0; i < RFC3610_HDR_LEN + m_len; i++) {
+      UNIT_TEST_ASSERT(frame[i] == i);
+    }
+  }
+
+  UNIT_TEST_END();
+}
+/*****************************************************************************/
+PROCESS_THREAD(test_aes_process, ev, data)
+{
+  PROCESS_BEGIN();
+
+  printf("Run unit-test\n");
+  printf("---\n");
+
+  UNIT_TEST_RUN(aes_128_driver_kat);
+  UNIT_TEST_RUN(aes_128_ttable_kat);
+  UNIT_TEST_RUN(aes_128_key_cache);
+  UNIT_TEST_RUN(ccm_star_kat);
+
+  if(!UNIT_TEST_PASSED(aes_128_driver_kat) ||
+     !UNIT_TEST_PASSED(aes_128_ttable_kat) ||
+     !UNIT_TEST_PASSED(aes_128_key_cache) ||
+     !UNIT_TEST_PASSED(ccm_star_kat)) {
+    printf("=check-me= FAILED\n");
+    printf("---\n");
+  }
+
+  printf("=check-me= DONE\n");
+  printf("---\n");
+
+  PROCESS_END();
+}
@@ -0,0 +1,252 @@
+/*
+ * Copyright (c) 2026, RISE Research Institutes of Sweden.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+/*
+ * \file
+ *      Tests for the hashed directory of the Coffee file system.
+ */
+
+#include "contiki.h"
+#include "cfs/cfs.h"
+#include "cfs/cfs-coffee.h"
+
+#include "unit-test/unit-test.h"
+
+#include <stdio.h>
+#include <string.h>
+/*---------------------------------------------------------------------------*/
+PROCESS(test_coffee_directory_process, "Coffee directory test");
+AUTOSTART_PROCESSES(&test_coffee_directory_process);
+/*---------------------------------------------------------------------------*/
+/* Fewer files than directory entries, more than cached files */
+#define FILE_COUNT 24
+/* More files than directory entries */
+#define MANY_FILE_COUNT 80
+/*
+ * Coffee finds the end of a file by its last non-zero byte, so the
+ * files end with a marker.
+ */
+#define MARKER 0x5a5a5a5a
+struct record {
+  int value;
+  int marker;
+};
+/*---------------------------------------------------------------------------*/
+static void
+file_name(char *name, int i)
+{
+  snprintf(name, 16, "file-%d", i);
+}
+/*---------------------------------------------------------------------------*/
+static int
+create_file(int i, int value)
+{
+  char name[16];
+  struct record record;
+  int fd;
+  int r;
+
+  file_name(name, i);
+  if(cfs_coffee_reserve(name, sizeof(record)) < 0) {
+    return -1;
+  }
+  fd = cfs_open(name, CFS_WRITE);
+  if(fd < 0) {
+    return -1;
+  }
+  memset(&record, 0, sizeof(record));
+  record.value = value;
+  record.marker = MARKER;
+  r = cfs_write(fd, &record, sizeof(record));
+  cfs_close(fd);
+  return r == sizeof(record) ? 0 : -1;
+}
+/*---------------------------------------------------------------------------*/
+static int
+read_file(int i)
+{
+  char name[16];
+  struct record record;
+  int fd;
+  int r;
+
+  file_name(name, i);
+  fd = cfs_open(name, CFS_READ);
+  if(fd < 0) {
+    return -1;
+  }
+  r = cfs_read(fd, &record, sizeof(record));
+  cfs_close(fd);
+  return r == sizeof(record) && record.marker == MARKER ? record.value : -1;
+}
+/*---------------------------------------------------------------------------*/
+static int
+remove_file(int i)
+{
+  char name[16];
+
+  file_name(name, i);
+  return cfs_remove(name);
+}
+/*---------------------------------------------------------------------------*/
+static int
+count_files(void)
+{
+  struct cfs_dir dir;
+  struct cfs_dirent dirent;
+  int count;
+
+  count = 0;
+  if(cfs_opendir(&dir, "/") == 0) {
+    while(cfs_readdir(&dir, &dirent) == 0) {
+      count++;
+    }
+    cfs_closedir(&dir);
+  }
+  return count;
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(coffee_directory_lookup, "Directory lookups");
+UNIT_TEST(coffee_directory_lookup)
+{
+  int i;
+
+  UNIT_TEST_BEGIN();
+
+  UNIT_TEST_ASSERT(cfs_coffee_format() == 0);
+
+  for(i = 0; i < FILE_COUNT; i++) {
+    UNIT_TEST_ASSERT(create_file(i, i) == 0);
+  }
+
+  /* Read in two rounds, so that most files are not cached. */
+  for(i = 0; i < 2 * FILE_COUNT; i++) {
+    UNIT_TEST_ASSERT(read_file(i % FILE_COUNT) == i % FILE_COUNT);
+  }
+
+  UNIT_TEST_ASSERT(read_file(FILE_COUNT) < 0);
+  UNIT_TEST_ASSERT(cfs_open("", CFS_READ) < 0);
+
+  /* The directory file is not listed. */
+  UNIT_TEST_ASSERT(count_files() == FILE_COUNT);
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(coffee_directory_churn, "Directory after removals");
+UNIT_TEST(coffee_directory_churn)
+{
+  int i;
+  int round;
+
+  UNIT_TEST_BEGIN();
+
+  /*
+   * Every removal leaves a stale entry, so the buckets fill up and the
+   * directory is rebuilt several times.
+   */
+  for(round = 1; round <= 10; round++) {
+    for(i = 0; i < FILE_COUNT; i += 2) {
+      UNIT_TEST_ASSERT(remove_file(i) == 0);
+      UNIT_TEST_ASSERT(read_file(i) < 0);
+      UNIT_TEST_ASSERT(create_file(i, i + round) == 0);
+    }
+    for(i = 0; i < FILE_COUNT; i++) {
+      UNIT_TEST_ASSERT(read_file(i) == ((i & 1) ? i : i + round));
+    }
+  }
+
+  UNIT_TEST_ASSERT(count_files() == FILE_COUNT);
+  UNIT_TEST_ASSERT(cfs_coffee_rebuild_directory() == 0);
+  for(i = 0; i < FILE_COUNT; i++) {
+    UNIT_TEST_ASSERT(read_file(i) == ((i & 1) ? i : i + 10));
+  }
+  UNIT_TEST_ASSERT(count_files() == FILE_COUNT);
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(coffee_directory_overflow, "Directory overflow");
+UNIT_TEST(coffee_directory_overflow)
+{
+  int i;
+
+  UNIT_TEST_BEGIN();
+
+  UNIT_TEST_ASSERT(cfs_coffee_format() == 0);
+
+  /* Files are found by scanning once the directory cannot hold them. */
+  for(i = 0; i < MANY_FILE_COUNT; i++) {
+    UNIT_TEST_ASSERT(create_file(i, i) == 0);
+  }
+  UNIT_TEST_ASSERT(cfs_coffee_rebuild_directory() < 0);
+  for(i = 0; i < MANY_FILE_COUNT; i++) {
+    UNIT_TEST_ASSERT(read_file(i) == i);
+  }
+  UNIT_TEST_ASSERT(count_files() == MANY_FILE_COUNT);
+
+  /* The directory is used again after it has been rebuilt. */
+  for(i = FILE_COUNT; i < MANY_FILE_COUNT; i++) {
+    UNIT_TEST_ASSERT(remove_file(i) == 0);
+  }
+  UNIT_TEST_ASSERT(cfs_coffee_rebuild_directory() == 0);
+  for(i = 0; i < MANY_FILE_COUNT; i++) {
+    UNIT_TEST_ASSERT(read_file(i) == (i < FILE_COUNT ? i : -1));
+  }
+  UNIT_TEST_ASSERT(create_file(FILE_COUNT, 1000) == 0);
+  UNIT_TEST_ASSERT(read_file(FILE_COUNT) == 1000);
+  UNIT_TEST_ASSERT(count_files() == FILE_COUNT + 1);
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(test_coffee_directory_process, ev, data)
+{
+  PROCESS_BEGIN();
+
+  printf("Run unit-test\n");
+  printf("---\n");
+
+  UNIT_TEST_RUN(coffee_directory_lookup);
+  UNIT_TEST_RUN(coffee_directory_churn);
+  UNIT_TEST_RUN(coffee_directory_overflow);
+
+  if(!UNIT_TEST_PASSED(coffee_directory_lookup) ||
+     !UNIT_TEST_PASSED(coffee_directory_churn) ||
+     !UNIT_TEST_PASSED(coffee_directory_overflow)) {
+    printf("=check-me= FAILED\n");
+    printf("---\n");
+  }
+
+  printf("=check-me= DONE\n");
+  printf("---\n");
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
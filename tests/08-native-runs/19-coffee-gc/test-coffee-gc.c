@@ -0,0 +1,174 @@
+/*
+ * Copyright (c) 2026, RISE Research Institutes of Sweden.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+/*
+ * \file
+ *      Tests for the background garbage collector of the Coffee file
+ *      system, and for its erase counts.
+ */
+
+#include "contiki.h"
+#include "cfs/cfs.h"
+#include "cfs/cfs-coffee.h"
+#include "cfs-coffee-arch.h"
+
+#include "unit-test/unit-test.h"
+
+#include <stdio.h>
+#include <string.h>
+/*---------------------------------------------------------------------------*/
+PROCESS(test_coffee_gc_process, "Coffee GC test");
+AUTOSTART_PROCESSES(&test_coffee_gc_process);
+/*---------------------------------------------------------------------------*/
+/* Files of a quarter sector, filling this many sectors */
+#define FILE_PAGES (COFFEE_SECTOR_SIZE / COFFEE_PAGE_SIZE / 4)
+#define SECTORS    8
+#define FILE_COUNT (4 * SECTORS)
+/*---------------------------------------------------------------------------*/
+static struct cfs_coffee_gc_stats before;
+/*---------------------------------------------------------------------------*/
+static void
+file_name(char *name, int i)
+{
+  snprintf(name, 16, "file-%d", i);
+}
+/*---------------------------------------------------------------------------*/
+static int
+count_files(void)
+{
+  struct cfs_dir dir;
+  struct cfs_dirent dirent;
+  int count;
+
+  count = 0;
+  if(cfs_opendir(&dir, "/") == 0) {
+    while(cfs_readdir(&dir, &dirent) == 0) {
+      count++;
+    }
+    cfs_closedir(&dir);
+  }
+  return count;
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(coffee_gc_remove, "Remove files");
+UNIT_TEST(coffee_gc_remove)
+{
+  char name[16];
+  int i;
+
+  UNIT_TEST_BEGIN();
+
+  UNIT_TEST_ASSERT(cfs_coffee_format() == 0);
+  cfs_coffee_gc_stats(&before);
+  UNIT_TEST_ASSERT(before.min_erases >= 1);
+
+  for(i = 0; i < FILE_COUNT; i++) {
+    file_name(name, i);
+    UNIT_TEST_ASSERT(cfs_coffee_reserve(name,
+                                        FILE_PAGES * COFFEE_PAGE_SIZE - 64) == 0);
+  }
+  UNIT_TEST_ASSERT(count_files() == FILE_COUNT);
+
+  /* The background collector erases the sectors later. */
+  for(i = 0; i < FILE_COUNT; i++) {
+    file_name(name, i);
+    UNIT_TEST_ASSERT(cfs_remove(name) == 0);
+  }
+  UNIT_TEST_ASSERT(count_files() == 0);
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(coffee_gc_background, "Background collection");
+UNIT_TEST(coffee_gc_background)
+{
+  struct cfs_coffee_gc_stats after;
+
+  UNIT_TEST_BEGIN();
+
+  cfs_coffee_gc_stats(&after);
+
+  /*
+   * The internal files take the first pages, so the files fill all but
+   * the last of their sectors.
+   */
+  UNIT_TEST_ASSERT(after.collections == before.collections);
+  UNIT_TEST_ASSERT(after.steps > before.steps);
+  UNIT_TEST_ASSERT(after.erased - before.erased >= SECTORS - 1);
+  UNIT_TEST_ASSERT(after.max_erases >= before.min_erases + 1);
+
+  /*
+   * The erased sectors can be reserved without collecting garbage. The
+   * rewritten erase count file takes the first pages of one of them.
+   */
+  UNIT_TEST_ASSERT(cfs_coffee_reserve("big",
+                                      (SECTORS - 3) * COFFEE_SECTOR_SIZE) == 0);
+  cfs_coffee_gc_stats(&after);
+  UNIT_TEST_ASSERT(after.collections == before.collections);
+  UNIT_TEST_ASSERT(count_files() == 1);
+
+  /* Formatting erases every sector once more. */
+  UNIT_TEST_ASSERT(cfs_coffee_format() == 0);
+  cfs_coffee_gc_stats(&before);
+  UNIT_TEST_ASSERT(before.min_erases == after.min_erases + 1);
+  UNIT_TEST_ASSERT(before.max_erases == after.max_erases + 1);
+  UNIT_TEST_ASSERT(count_files() == 0);
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(test_coffee_gc_process, ev, data)
+{
+  static struct etimer et;
+
+  PROCESS_BEGIN();
+
+  printf("Run unit-test\n");
+  printf("---\n");
+
+  UNIT_TEST_RUN(coffee_gc_remove);
+
+  /* Let the background collector run. */
+  etimer_set(&et, CLOCK_SECOND / 2);
+  PROCESS_WAIT_EVENT_UNTIL(etimer_expired(&et));
+
+  UNIT_TEST_RUN(coffee_gc_background);
+
+  if(!UNIT_TEST_PASSED(coffee_gc_remove) ||
+     !UNIT_TEST_PASSED(coffee_gc_background)) {
+    printf("=check-me= FAILED\n");
+    printf("---\n");
+  }
+
+  printf("=check-me= DONE\n");
+  printf("---\n");
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
@@ -0,0 +1,297 @@
+/*
+ * Copyright (c) 2026, RISE Research Institutes of Sweden.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+/*
+ * \file
+ *      Tests for the write cache and the append-only mode of the Coffee
+ *      file system.
+ */
+
+#include "contiki.h"
+#include "cfs/cfs.h"
+#include "cfs/cfs-coffee.h"
+#include "cfs-coffee-arch.h"
+#include "dev/xmem.h"
+
+#include "unit-test/unit-test.h"
+
+#include <stdio.h>
+#include <string.h>
+/*---------------------------------------------------------------------------*/
+PROCESS(test_coffee_write_cache_process, "Coffee write cache test");
+AUTOSTART_PROCESSES(&test_coffee_write_cache_process);
+/*---------------------------------------------------------------------------*/
+#define RECORDS 256
+#define MARKER  0x5a5a5a5a
+
+/* Coffee finds the end of a file by its last nonzero byte. */
+struct record {
+  int value;
+  int marker;
+};
+/*---------------------------------------------------------------------------*/
+static unsigned long writes;
+static unsigned long writes_before_timer;
+static int series_fd;
+/*---------------------------------------------------------------------------*/
+int __real_xmem_pwrite(const void *buf, int nbytes, unsigned long offset);
+
+int
+__wrap_xmem_pwrite(const void *buf, int nbytes, unsigned long offset)
+{
+  writes++;
+  return __real_xmem_pwrite(buf, nbytes, offset);
+}
+/*---------------------------------------------------------------------------*/
+static int
+append(int fd, int value)
+{
+  struct record record;
+
+  record.value = value;
+  record.marker = MARKER;
+  return cfs_write(fd, &record, sizeof(record)) == sizeof(record);
+}
+/*---------------------------------------------------------------------------*/
+static int
+verify(const char *name, int count)
+{
+  struct record record;
+  int fd;
+  int i;
+
+  fd = cfs_open(name, CFS_READ);
+  if(fd < 0) {
+    return 0;
+  }
+  for(i = 0; i < count; i++) {
+    if(cfs_read(fd, &record, sizeof(record)) != sizeof(record) ||
+       record.value != i || record.marker != MARKER) {
+      break;
+    }
+  }
+  if(i == count && cfs_read(fd, &record, sizeof(record)) != 0) {
+    i = -1;
+  }
+  cfs_close(fd);
+  return i == count;
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(coffee_cache_append, "Append through the cache");
+UNIT_TEST(coffee_cache_append)
+{
+  unsigned long before;
+  int fd;
+  int i;
+
+  UNIT_TEST_BEGIN();
+
+  UNIT_TEST_ASSERT(cfs_coffee_format() == 0);
+  UNIT_TEST_ASSERT(cfs_coffee_reserve("log",
+                                      RECORDS * sizeof(struct record)) == 0);
+
+  fd = cfs_open("log", CFS_WRITE | CFS_APPEND);
+  UNIT_TEST_ASSERT(fd >= 0);
+  before = writes;
+  for(i = 0; i < RECORDS; i++) {
+    UNIT_TEST_ASSERT(append(fd, i));
+  }
+  /* The records are written a page at a time. */
+  UNIT_TEST_ASSERT(writes - before <=
+                   RECORDS * sizeof(struct record) / COFFEE_PAGE_SIZE + 1);
+  UNIT_TEST_ASSERT(cfs_seek(fd, 0, CFS_SEEK_END) ==
+                   RECORDS * sizeof(struct record));
+  cfs_close(fd);
+
+  UNIT_TEST_ASSERT(verify("log", RECORDS));
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(coffee_cache_sync, "Read, overwrite and sync");
+UNIT_TEST(coffee_cache_sync)
+{
+  struct record record;
+  unsigned long before;
+  int fd;
+
+  UNIT_TEST_BEGIN();
+
+  fd = cfs_open("log", CFS_WRITE | CFS_APPEND);
+  UNIT_TEST_ASSERT(fd >= 0);
+  before = writes;
+  UNIT_TEST_ASSERT(append(fd, RECORDS));
+  UNIT_TEST_ASSERT(writes == before);
+
+  /* Reading the cached record writes it first. */
+  UNIT_TEST_ASSERT(verify("log", RECORDS + 1));
+  UNIT_TEST_ASSERT(writes > before);
+
+  before = writes;
+  UNIT_TEST_ASSERT(append(fd, RECORDS + 1));
+  UNIT_TEST_ASSERT(writes == before);
+  UNIT_TEST_ASSERT(cfs_coffee_sync() == 0);
+  UNIT_TEST_ASSERT(writes > before);
+  UNIT_TEST_ASSERT(cfs_coffee_sync() == 0);
+
+  /* Overwriting the first record goes through the micro log. */
+  UNIT_TEST_ASSERT(append(fd, RECORDS + 2));
+  UNIT_TEST_ASSERT(cfs_seek(fd, 0, CFS_SEEK_SET) == 0);
+  record.value = 0;
+  record.marker = MARKER;
+  UNIT_TEST_ASSERT(cfs_write(fd, &record, sizeof(record)) == sizeof(record));
+  cfs_close(fd);
+
+  UNIT_TEST_ASSERT(verify("log", RECORDS + 3));
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(coffee_cache_append_only, "Append-only mode");
+UNIT_TEST(coffee_cache_append_only)
+{
+  struct record record;
+
+  UNIT_TEST_BEGIN();
+
+  UNIT_TEST_ASSERT(cfs_coffee_reserve("series",
+                                      RECORDS * sizeof(struct record)) == 0);
+  series_fd = cfs_open("series", CFS_WRITE);
+  UNIT_TEST_ASSERT(series_fd >= 0);
+  UNIT_TEST_ASSERT(cfs_coffee_set_io_semantics(series_fd,
+                                               CFS_COFFEE_IO_APPEND_ONLY) == 0);
+  UNIT_TEST_ASSERT(append(series_fd, 0));
+  UNIT_TEST_ASSERT(append(series_fd, 1));
+
+  /* Writes before the end of the file are rejected. */
+  UNIT_TEST_ASSERT(cfs_seek(series_fd, 0, CFS_SEEK_SET) == 0);
+  record.value = 0;
+  record.marker = MARKER;
+  UNIT_TEST_ASSERT(cfs_write(series_fd, &record, sizeof(record)) == -1);
+
+  UNIT_TEST_ASSERT(cfs_seek(series_fd, 0, CFS_SEEK_END) == 2 * sizeof(record));
+  UNIT_TEST_ASSERT(append(series_fd, 2));
+  writes_before_timer = writes;
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(coffee_cache_timer, "Write the cache on a timer");
+UNIT_TEST(coffee_cache_timer)
+{
+  UNIT_TEST_BEGIN();
+
+  /* The cache was written while the test process waited. */
+  UNIT_TEST_ASSERT(writes > writes_before_timer);
+  writes_before_timer = writes;
+  cfs_close(series_fd);
+  UNIT_TEST_ASSERT(writes == writes_before_timer);
+  UNIT_TEST_ASSERT(verify("series", 3));
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(coffee_cache_full_fds, "Write the cache without free fds");
+UNIT_TEST(coffee_cache_full_fds)
+{
+  struct record record;
+  unsigned long before;
+  int fds[COFFEE_FD_SET_SIZE];
+  int n;
+  int fd;
+  int i;
+
+  UNIT_TEST_BEGIN();
+
+  fd = cfs_open("log", CFS_WRITE | CFS_APPEND);
+  UNIT_TEST_ASSERT(fd >= 0);
+  n = 0;
+  while(n < COFFEE_FD_SET_SIZE && (fds[n] = cfs_open("log", CFS_READ)) >= 0) {
+    n++;
+  }
+  UNIT_TEST_ASSERT(n == COFFEE_FD_SET_SIZE - 1);
+
+  /* Reading the cached record writes it through the kept descriptor. */
+  UNIT_TEST_ASSERT(append(fd, RECORDS + 3));
+  UNIT_TEST_ASSERT(cfs_seek(fds[0], (RECORDS + 3) * sizeof(record),
+                            CFS_SEEK_SET) == (RECORDS + 3) * sizeof(record));
+  UNIT_TEST_ASSERT(cfs_read(fds[0], &record, sizeof(record)) == sizeof(record));
+  UNIT_TEST_ASSERT(record.value == RECORDS + 3 && record.marker == MARKER);
+
+  /* So is the cached record of a file that is closed. */
+  UNIT_TEST_ASSERT(append(fd, RECORDS + 4));
+  cfs_close(fd);
+  for(i = 0; i < n; i++) {
+    cfs_close(fds[i]);
+  }
+
+  /* No cache is left for the closed file. */
+  before = writes;
+  UNIT_TEST_ASSERT(cfs_coffee_sync() == 0);
+  UNIT_TEST_ASSERT(writes == before);
+  UNIT_TEST_ASSERT(verify("log", RECORDS + 5));
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(test_coffee_write_cache_process, ev, data)
+{
+  static struct etimer et;
+
+  PROCESS_BEGIN();
+
+  printf("Run unit-test\n");
+  printf("---\n");
+
+  UNIT_TEST_RUN(coffee_cache_append);
+  UNIT_TEST_RUN(coffee_cache_sync);
+  UNIT_TEST_RUN(coffee_cache_append_only);
+
+  /* Let the write cache timer expire. */
+  etimer_set(&et, COFFEE_WRITE_CACHE_INTERVAL * 2);
+  PROCESS_WAIT_EVENT_UNTIL(etimer_expired(&et));
+
+  UNIT_TEST_RUN(coffee_cache_timer);
+  UNIT_TEST_RUN(coffee_cache_full_fds);
+
+  if(!UNIT_TEST_PASSED(coffee_cache_append) ||
+     !UNIT_TEST_PASSED(coffee_cache_sync) ||
+     !UNIT_TEST_PASSED(coffee_cache_append_only) ||
+     !UNIT_TEST_PASSED(coffee_cache_timer) ||
+     !UNIT_TEST_PASSED(coffee_cache_full_fds)) {
+    printf("=check-me= FAILED\n");
+    printf("---\n");
+  }
+
+  printf("=check-me= DONE\n");
+  printf("---\n");
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
@@ -0,0 +1,344 @@
+/*
+ * Copyright (c) 2026, RISE Research Institutes of Sweden.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+/*
+ * \file
+ *      Tests for the B+-tree index of the Antelope database system.
+ */
+
+#include "contiki.h"
+#include "antelope.h"
+#include "cfs/cfs-coffee.h"
+
+#include "unit-test/unit-test.h"
+
+#include <limits.h>
+#include <stdio.h>
+#include <string.h>
+/*---------------------------------------------------------------------------*/
+PROCESS(test_antelope_btree_process, "Antelope B+-tree test");
+AUTOSTART_PROCESSES(&test_antelope_btree_process);
+/*---------------------------------------------------------------------------*/
+#define ROWS      600
+#define KEY_RANGE 1000
+/*---------------------------------------------------------------------------*/
+static long keys[ROWS];
+static db_handle_t handle;
+/*---------------------------------------------------------------------------*/
+static long
+random_key(void)
+{
+  static unsigned long state = 12345;
+
+  state = state * 1103515245 + 12345;
+  return (state >> 16) % KEY_RANGE;
+}
+/*---------------------------------------------------------------------------*/
+static int
+run(const char *query)
+{
+  return DB_SUCCESS(db_query(NULL, query));
+}
+/*---------------------------------------------------------------------------*/
+static int
+expected_count(long min, long max)
+{
+  int count;
+  int i;
+
+  for(i = count = 0; i < ROWS; i++) {
+    if(keys[i] >= min && keys[i] <= max) {
+      count++;
+    }
+  }
+  return count;
+}
+/*---------------------------------------------------------------------------*/
+/*
+ * Iterates over a key range in the index, and returns the number of
+ * tuples found, or -1 if a tuple is out of order or outside the range.
+ */
+static int
+index_count(const char *relation, const char *attribute, long min, long max)
+{
+  relation_t *rel;
+  attribute_t *attr;
+  index_iterator_t iterator;
+  attribute_value_t min_value;
+  attribute_value_t max_value;
+  tuple_id_t tuple_id;
+  long previous;
+  int count;
+
+  rel = relation_load((char *)relation);
+  if(rel == NULL) {
+    return -1;
+  }
+  attr = relation_attribute_get(rel, (char *)attribute);
+  if(attr == NULL || attr->index == NULL) {
+    relation_release(rel);
+    return -1;
+  }
+
+  min_value.domain = max_value.domain = DOMAIN_LONG;
+  VALUE_LONG(&min_value) = min;
+  VALUE_LONG(&max_value) = max;
+  if(DB_ERROR(index_get_iterator(&iterator, attr->index,
+                                 &min_value, &max_value))) {
+    relation_release(rel);
+    return -1;
+  }
+
+  previous = min;
+  for(count = 0;; count++) {
+    tuple_id = index_get_next(&iterator);
+    if(tuple_id == INVALID_TUPLE) {
+      break;
+    }
+    if(tuple_id >= ROWS || keys[tuple_id] < previous ||
+       keys[tuple_id] > max) {
+      count = -1;
+      break;
+    }
+    previous = keys[tuple_id];
+  }
+  relation_release(rel);
+  return count;
+}
+/*---------------------------------------------------------------------------*/
+static int
+process_count(db_result_t result)
+{
+  int count;
+
+  if(DB_ERROR(result)) {
+    return -1;
+  }
+
+  count = 0;
+  while(db_processing(&handle)) {
+    result = db_process(&handle);
+    if(result == DB_GOT_ROW) {
+      count++;
+    } else if(result == DB_FINISHED) {
+      break;
+    } else if(DB_ERROR(result)) {
+      count = -1;
+      break;
+    }
+  }
+  db_free(&handle);
+  return count;
+}
+/*---------------------------------------------------------------------------*/
+static int
+select_count(long min, long max)
+{
+  return process_count(db_query(&handle,
+                                "SELECT id FROM samples WHERE time >= %ld AND "
+                                "time <= %ld;", min, max));
+}
+/*---------------------------------------------------------------------------*/
+static int
+reload_index(const char *relation, const char *attribute)
+{
+  relation_t *rel;
+  attribute_t *attr;
+  int r;
+
+  rel = relation_load((char *)relation);
+  if(rel == NULL) {
+    return 0;
+  }
+  attr = relation_attribute_get(rel, (char *)attribute);
+  r = attr != NULL && attr->index != NULL &&
+    DB_SUCCESS(index_release(attr->index)) &&
+    DB_SUCCESS(index_load(rel, attr));
+  relation_release(rel);
+  return r;
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(btree_random, "Insert keys in random order");
+UNIT_TEST(btree_random)
+{
+  int i;
+
+  UNIT_TEST_BEGIN();
+
+  UNIT_TEST_ASSERT(run("CREATE RELATION samples;"));
+  UNIT_TEST_ASSERT(run("CREATE ATTRIBUTE id DOMAIN INT IN samples;"));
+  UNIT_TEST_ASSERT(run("CREATE ATTRIBUTE time DOMAIN LONG IN samples;"));
+  UNIT_TEST_ASSERT(run("CREATE INDEX samples.time TYPE BTREE;"));
+
+  for(i = 0; i < ROWS; i++) {
+    keys[i] = random_key();
+    UNIT_TEST_ASSERT(DB_SUCCESS(db_query(NULL,
+                                         "INSERT (%d, %ld) INTO samples;",
+                                         i, keys[i])));
+  }
+
+  UNIT_TEST_ASSERT(index_count("samples", "time", 0, KEY_RANGE) == ROWS);
+  UNIT_TEST_ASSERT(index_count("samples", "time", 100, 199) ==
+                   expected_count(100, 199));
+  UNIT_TEST_ASSERT(index_count("samples", "time", keys[7], keys[7]) ==
+                   expected_count(keys[7], keys[7]));
+  UNIT_TEST_ASSERT(select_count(250, 400) == expected_count(250, 400));
+  /* An open range is bounded by LONG_MAX in the derivation. */
+  UNIT_TEST_ASSERT(process_count(db_query(&handle,
+                                          "SELECT id FROM samples "
+                                          "WHERE time > 900;")) ==
+                   expected_count(901, KEY_RANGE));
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(btree_reload, "Reload and delete");
+UNIT_TEST(btree_reload)
+{
+  relation_t *rel;
+  attribute_t *attr;
+  attribute_value_t value;
+  int count;
+  int i;
+
+  UNIT_TEST_BEGIN();
+
+  /* The index is written to the storage when it is released. */
+  UNIT_TEST_ASSERT(reload_index("samples", "time"));
+  UNIT_TEST_ASSERT(index_count("samples", "time", 0, KEY_RANGE) == ROWS);
+  UNIT_TEST_ASSERT(index_count("samples", "time", 500, 899) ==
+                   expected_count(500, 899));
+
+  /* Delete all entries of a key. */
+  rel = relation_load("samples");
+  UNIT_TEST_ASSERT(rel != NULL);
+  attr = relation_attribute_get(rel, "time");
+  UNIT_TEST_ASSERT(attr != NULL);
+  value.domain = DOMAIN_LONG;
+  VALUE_LONG(&value) = keys[3];
+  count = expected_count(keys[3], keys[3]);
+  UNIT_TEST_ASSERT(DB_SUCCESS(index_delete(attr->index, &value)));
+  relation_release(rel);
+  for(i = 0; i < ROWS; i++) {
+    if(keys[i] == VALUE_LONG(&value)) {
+      keys[i] = -1;
+    }
+  }
+  UNIT_TEST_ASSERT(index_count("samples", "time", 0, KEY_RANGE) ==
+                   ROWS - count);
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(btree_series, "Insert increasing keys");
+UNIT_TEST(btree_series)
+{
+  int i;
+
+  UNIT_TEST_BEGIN();
+
+  UNIT_TEST_ASSERT(run("CREATE RELATION series;"));
+  UNIT_TEST_ASSERT(run("CREATE ATTRIBUTE time DOMAIN LONG IN series;"));
+  UNIT_TEST_ASSERT(run("CREATE INDEX series.time TYPE BTREE;"));
+
+  /* Each time stamp appears twice. */
+  for(i = 0; i < ROWS; i++) {
+    keys[i] = 100000 + i / 2;
+    UNIT_TEST_ASSERT(DB_SUCCESS(db_query(NULL, "INSERT (%ld) INTO series;",
+                                         keys[i])));
+  }
+
+  UNIT_TEST_ASSERT(index_count("series", "time", 0, 200000) == ROWS);
+  UNIT_TEST_ASSERT(index_count("series", "time", 100010, 100020) == 22);
+  UNIT_TEST_ASSERT(reload_index("series", "time"));
+  UNIT_TEST_ASSERT(index_count("series", "time", 100100, 100299) == 400);
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(btree_range, "Keys out of the key range");
+UNIT_TEST(btree_range)
+{
+  relation_t *rel;
+  attribute_t *attr;
+  attribute_value_t value;
+
+  UNIT_TEST_BEGIN();
+
+#if LONG_MAX > INT32_MAX
+  rel = relation_load("series");
+  UNIT_TEST_ASSERT(rel != NULL);
+  attr = relation_attribute_get(rel, "time");
+  UNIT_TEST_ASSERT(attr != NULL);
+
+  /* The key would be truncated to that of existing entries. */
+  value.domain = DOMAIN_LONG;
+  VALUE_LONG(&value) = (1L << 32) + 100005;
+  UNIT_TEST_ASSERT(index_insert(attr->index, &value, 0) == DB_INDEX_ERROR);
+  UNIT_TEST_ASSERT(index_delete(attr->index, &value) == DB_INDEX_ERROR);
+  VALUE_LONG(&value) = (long)INT32_MIN - 1;
+  UNIT_TEST_ASSERT(index_insert(attr->index, &value, 0) == DB_INDEX_ERROR);
+  relation_release(rel);
+
+  UNIT_TEST_ASSERT(index_count("series", "time", 100005, 100005) == 2);
+  UNIT_TEST_ASSERT(index_count("series", "time", 0, 200000) == ROWS);
+#endif
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(test_antelope_btree_process, ev, data)
+{
+  PROCESS_BEGIN();
+
+  cfs_coffee_format();
+  db_init();
+
+  printf("Run unit-test\n");
+  printf("---\n");
+
+  UNIT_TEST_RUN(btree_random);
+  UNIT_TEST_RUN(btree_reload);
+  UNIT_TEST_RUN(btree_series);
+  UNIT_TEST_RUN(btree_range);
+
+  if(!UNIT_TEST_PASSED(btree_random) ||
+     !UNIT_TEST_PASSED(btree_reload) ||
+     !UNIT_TEST_PASSED(btree_series) ||
+     !UNIT_TEST_PASSED(btree_range)) {
+    printf("=check-me= FAILED\n");
+    printf("---\n");
+  }
+
+  printf("=check-me= DONE\n");
+  printf("---\n");
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
@@ -0,0 +1,293 @@
+/*
+ * Copyright (c) 2026, RISE Research Institutes of Sweden.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+/*
+ * \file
+ *      Tests for prepared statements in the Antelope database system.
+ */
+
+#include "contiki.h"
+#include "antelope.h"
+#include "cfs/cfs-coffee.h"
+
+#include "unit-test/unit-test.h"
+
+#include <stdio.h>
+#include <string.h>
+/*---------------------------------------------------------------------------*/
+PROCESS(test_antelope_prepared_process, "Antelope prepared statement test");
+AUTOSTART_PROCESSES(&test_antelope_prepared_process);
+/*---------------------------------------------------------------------------*/
+#define ROWS      200
+#define KEY_RANGE 500
+/* A string of the longest length that a value can have */
+#define LONG_STRING "abcdefghijklmno"
+/*---------------------------------------------------------------------------*/
+static long keys[ROWS];
+static db_handle_t handle;
+static db_statement_t insert;
+static db_statement_t select_range;
+static db_statement_t count_above;
+/*---------------------------------------------------------------------------*/
+static long
+random_key(void)
+{
+  static unsigned long state = 4711;
+
+  state = state * 1103515245 + 12345;
+  return (state >> 16) % KEY_RANGE;
+}
+/*---------------------------------------------------------------------------*/
+static int
+run(const char *query)
+{
+  return DB_SUCCESS(db_query(NULL, query));
+}
+/*---------------------------------------------------------------------------*/
+static int
+expected_count(long min, long max)
+{
+  int count;
+  int i;
+
+  for(i = count = 0; i < ROWS; i++) {
+    if(keys[i] >= min && keys[i] <= max) {
+      count++;
+    }
+  }
+  return count;
+}
+/*---------------------------------------------------------------------------*/
+/*
+ * Processes the result of a query or a statement, and returns the
+ * number of rows, or -1 if an error occurred. The first column of
+ * the last row is stored in *last.
+ */
+static int
+process_count(db_result_t result, long *last)
+{
+  attribute_value_t value;
+  int count;
+
+  if(DB_ERROR(result)) {
+    return -1;
+  }
+
+  count = 0;
+  while(db_processing(&handle)) {
+    result = db_process(&handle);
+    if(result == DB_GOT_ROW) {
+      count++;
+      if(last != NULL) {
+        if(DB_ERROR(db_get_value(&value, &handle, 0))) {
+          count = -1;
+          break;
+        }
+        *last = db_value_to_long(&value);
+      }
+    } else if(result == DB_FINISHED) {
+      break;
+    } else if(DB_ERROR(result)) {
+      count = -1;
+      break;
+    }
+  }
+  db_free(&handle);
+  return count;
+}
+/*---------------------------------------------------------------------------*/
+static int
+select_count(long min, long max)
+{
+  if(DB_ERROR(db_bind(&select_range, 0, min)) ||
+     DB_ERROR(db_bind(&select_range, 1, max))) {
+    return -1;
+  }
+  return process_count(db_execute(&handle, &select_range), NULL);
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(prepared_insert, "Insert with a prepared statement");
+UNIT_TEST(prepared_insert)
+{
+  char name[8];
+  long last;
+  int i;
+
+  UNIT_TEST_BEGIN();
+
+  UNIT_TEST_ASSERT(run("CREATE RELATION samples;"));
+  UNIT_TEST_ASSERT(run("CREATE ATTRIBUTE id DOMAIN INT IN samples;"));
+  UNIT_TEST_ASSERT(run("CREATE ATTRIBUTE time DOMAIN LONG IN samples;"));
+  UNIT_TEST_ASSERT(run("CREATE ATTRIBUTE node DOMAIN STRING(8) IN samples;"));
+  UNIT_TEST_ASSERT(run("CREATE INDEX samples.time TYPE BTREE;"));
+
+  UNIT_TEST_ASSERT(db_prepare(&insert,
+                              "INSERT (?, ?, 'a') INTO %s;",
+                              "samples") == DB_OK);
+  UNIT_TEST_ASSERT(insert.adt.parameter_count == 2);
+
+  for(i = 0; i < ROWS; i++) {
+    keys[i] = random_key();
+    UNIT_TEST_ASSERT(db_bind(&insert, 0, i) == DB_OK);
+    UNIT_TEST_ASSERT(db_bind(&insert, 1, keys[i]) == DB_OK);
+    UNIT_TEST_ASSERT(db_execute(NULL, &insert) == DB_OK);
+    if(i == ROWS / 2) {
+      /* Parsing another query must not affect the statement. */
+      UNIT_TEST_ASSERT(process_count(db_query(&handle,
+                                              "SELECT time FROM samples "
+                                              "WHERE id = 3;"), &last) == 1);
+      UNIT_TEST_ASSERT(last == keys[3]);
+    }
+  }
+
+  UNIT_TEST_ASSERT(process_count(db_query(&handle,
+                                          "SELECT id FROM samples;"),
+                                 &last) == ROWS);
+  UNIT_TEST_ASSERT(last == ROWS - 1);
+
+  /* Bind a string to a string value. */
+  UNIT_TEST_ASSERT(db_prepare(&insert, "INSERT (?, ?, ?) INTO samples;") ==
+                   DB_OK);
+  strcpy(name, "node");
+  UNIT_TEST_ASSERT(db_bind(&insert, 0, ROWS) == DB_OK);
+  UNIT_TEST_ASSERT(db_bind(&insert, 1, KEY_RANGE + 10) == DB_OK);
+  UNIT_TEST_ASSERT(db_bind_string(&insert, 2, name) == DB_OK);
+  UNIT_TEST_ASSERT(db_execute(NULL, &insert) == DB_OK);
+  UNIT_TEST_ASSERT(process_count(db_query(&handle,
+                                          "SELECT id FROM samples "
+                                          "WHERE time > %d;", KEY_RANGE),
+                                 &last) == 1);
+  UNIT_TEST_ASSERT(last == ROWS);
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(prepared_select, "Select with bound parameters");
+UNIT_TEST(prepared_select)
+{
+  long count;
+
+  UNIT_TEST_BEGIN();
+
+  UNIT_TEST_ASSERT(db_prepare(&select_range,
+                              "SELECT id FROM samples WHERE time >= ? AND "
+                              "time <= ?;") == DB_OK);
+  UNIT_TEST_ASSERT(db_prepare(&count_above,
+                              "SELECT COUNT(id) FROM samples "
+                              "WHERE time > ? AND id < ?;") == DB_OK);
+
+  UNIT_TEST_ASSERT(select_count(100, 199) == expected_count(100, 199));
+  UNIT_TEST_ASSERT(select_count(keys[5], keys[5]) ==
+                   expected_count(keys[5], keys[5]));
+
+  /* A query with other variables in between. */
+  UNIT_TEST_ASSERT(process_count(db_query(&handle,
+                                          "SELECT time FROM samples "
+                                          "WHERE id < 10;"), NULL) == 10);
+  UNIT_TEST_ASSERT(select_count(0, KEY_RANGE - 1) == ROWS);
+
+  /* Aggregates can be executed repeatedly. */
+  UNIT_TEST_ASSERT(db_bind(&count_above, 0, 250) == DB_OK);
+  UNIT_TEST_ASSERT(db_bind(&count_above, 1, ROWS) == DB_OK);
+  UNIT_TEST_ASSERT(process_count(db_execute(&handle, &count_above),
+                                 &count) == 1);
+  UNIT_TEST_ASSERT(count == expected_count(251, KEY_RANGE));
+  UNIT_TEST_ASSERT(db_bind(&count_above, 0, -1) == DB_OK);
+  UNIT_TEST_ASSERT(process_count(db_execute(&handle, &count_above),
+                                 &count) == 1);
+  UNIT_TEST_ASSERT(count == ROWS);
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(prepared_errors, "Invalid parameters");
+UNIT_TEST(prepared_errors)
+{
+  db_statement_t stmt;
+
+  UNIT_TEST_BEGIN();
+
+  UNIT_TEST_ASSERT(db_bind(&select_range, 2, 0) == DB_ARGUMENT_ERROR);
+  UNIT_TEST_ASSERT(db_bind_string(&select_range, 0, "a") == DB_TYPE_ERROR);
+  UNIT_TEST_ASSERT(db_prepare(&stmt, "CREATE RELATION ?;") ==
+                   DB_PARSING_ERROR);
+  UNIT_TEST_ASSERT(db_prepare(&stmt, "SELECT ? FROM samples;") ==
+                   DB_PARSING_ERROR);
+  UNIT_TEST_ASSERT(db_prepare(&stmt, "INSERT (?, ?, ?, ?, ?) INTO samples;")
+                   == DB_PARSING_ERROR);
+
+  /* The strings of a statement are limited to DB_MAX_CHAR_SIZE_PER_ROW. */
+  UNIT_TEST_ASSERT(db_prepare(&stmt, "INSERT ('%s', '%s', '%s', '%s', '%s') "
+                              "INTO samples;", LONG_STRING, LONG_STRING,
+                              LONG_STRING, LONG_STRING, LONG_STRING) ==
+                   DB_PARSING_ERROR);
+  UNIT_TEST_ASSERT(db_query(NULL, "INSERT ('%s', '%s', '%s', '%s', '%s') "
+                            "INTO samples;", LONG_STRING, LONG_STRING,
+                            LONG_STRING, LONG_STRING, LONG_STRING) ==
+                   DB_PARSING_ERROR);
+  UNIT_TEST_ASSERT(db_prepare(&stmt, "INSERT ('%s', '%s', '%s', '%s') "
+                              "INTO samples;", LONG_STRING, LONG_STRING,
+                              LONG_STRING, LONG_STRING) == DB_OK);
+  UNIT_TEST_ASSERT(strcmp((char *)VALUE_STRING(&stmt.adt.values[3]),
+                          LONG_STRING) == 0);
+
+  /* Parameters cannot be bound in ordinary queries. */
+  UNIT_TEST_ASSERT(db_query(NULL, "INSERT (?, 1, 'a') INTO samples;") ==
+                   DB_ARGUMENT_ERROR);
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(test_antelope_prepared_process, ev, data)
+{
+  PROCESS_BEGIN();
+
+  cfs_coffee_format();
+  db_init();
+
+  printf("Run unit-test\n");
+  printf("---\n");
+
+  UNIT_TEST_RUN(prepared_insert);
+  UNIT_TEST_RUN(prepared_select);
+  UNIT_TEST_RUN(prepared_errors);
+
+  if(!UNIT_TEST_PASSED(prepared_insert) ||
+     !UNIT_TEST_PASSED(prepared_select) ||
+     !UNIT_TEST_PASSED(prepared_errors)) {
+    printf("=check-me= FAILED\n");
+    printf("---\n");
+  }
+
+  printf("=check-me= DONE\n");
+  printf("---\n");
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
@@ -0,0 +1,282 @@
+/*
+ * Copyright (c) 2026, RISE Research Institutes of Sweden.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+/*
+ * \file
+ *      Tests for batched inserts in the Antelope database system.
+ */
+
+#include "contiki.h"
+#include "antelope.h"
+#include "index.h"
+#include "storage.h"
+#include "cfs/cfs-coffee.h"
+
+#include "unit-test/unit-test.h"
+
+#include <stdio.h>
+#include <string.h>
+/*---------------------------------------------------------------------------*/
+PROCESS(test_antelope_batch_process, "Antelope batch test");
+AUTOSTART_PROCESSES(&test_antelope_batch_process);
+/*---------------------------------------------------------------------------*/
+/* The tuples of the relation "log" occupy 6 bytes, so a batch buffer
+   holds ten of them. */
+#define BATCH_ROWS 10
+#define ROWS       95
+/*---------------------------------------------------------------------------*/
+static db_handle_t handle;
+static int fail_storage;
+static int fail_index;
+/*---------------------------------------------------------------------------*/
+db_result_t __real_storage_put_rows(relation_t *, storage_row_t, tuple_id_t);
+db_result_t __real_index_insert(index_t *, attribute_value_t *, tuple_id_t);
+/*---------------------------------------------------------------------------*/
+db_result_t
+__wrap_storage_put_rows(relation_t *rel, storage_row_t rows, tuple_id_t count)
+{
+  if(fail_storage) {
+    return DB_STORAGE_ERROR;
+  }
+  return __real_storage_put_rows(rel, rows, count);
+}
+/*---------------------------------------------------------------------------*/
+db_result_t
+__wrap_index_insert(index_t *index, attribute_value_t *value,
+                    tuple_id_t tuple_id)
+{
+  if(fail_index) {
+    return DB_INDEX_ERROR;
+  }
+  return __real_index_insert(index, value, tuple_id);
+}
+/*---------------------------------------------------------------------------*/
+static int
+run(const char *query)
+{
+  return DB_SUCCESS(db_query(NULL, query));
+}
+/*---------------------------------------------------------------------------*/
+static int
+insert_rows(int first, int count)
+{
+  int i;
+
+  for(i = first; i < first + count; i++) {
+    if(DB_ERROR(db_query(NULL, "INSERT (%d, %ld) INTO log;",
+                         i % 7, 1000L + i * 10))) {
+      return 0;
+    }
+  }
+  return 1;
+}
+/*---------------------------------------------------------------------------*/
+static tuple_id_t
+stored_rows(void)
+{
+  relation_t *rel;
+  tuple_id_t count;
+
+  rel = relation_load("log");
+  if(rel == NULL) {
+    return INVALID_TUPLE;
+  }
+  count = relation_cardinality(rel);
+  relation_release(rel);
+  return count;
+}
+/*---------------------------------------------------------------------------*/
+static int
+count_rows(const char *query)
+{
+  db_result_t result;
+  int count;
+
+  if(DB_ERROR(db_query(&handle, query))) {
+    return -1;
+  }
+
+  count = 0;
+  while(db_processing(&handle)) {
+    result = db_process(&handle);
+    if(result == DB_GOT_ROW) {
+      count++;
+    } else if(result == DB_FINISHED) {
+      break;
+    } else if(DB_ERROR(result)) {
+      count = -1;
+      break;
+    }
+  }
+  db_free(&handle);
+  return count;
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(batch_insert, "Insert tuples in a batch");
+UNIT_TEST(batch_insert)
+{
+  UNIT_TEST_BEGIN();
+
+  UNIT_TEST_ASSERT(run("CREATE RELATION log;"));
+  UNIT_TEST_ASSERT(run("CREATE ATTRIBUTE id DOMAIN INT IN log;"));
+  UNIT_TEST_ASSERT(run("CREATE ATTRIBUTE time DOMAIN LONG IN log;"));
+  UNIT_TEST_ASSERT(run("CREATE INDEX log.id TYPE MAXHEAP;"));
+  UNIT_TEST_ASSERT(run("CREATE INDEX log.time TYPE INLINE;"));
+
+  UNIT_TEST_ASSERT(db_batch_begin("log") == DB_OK);
+  UNIT_TEST_ASSERT(db_batch_begin("log") == DB_BUSY_ERROR);
+
+  /* Full buffers are written to the storage. */
+  UNIT_TEST_ASSERT(insert_rows(0, ROWS));
+  UNIT_TEST_ASSERT(stored_rows() == ROWS / BATCH_ROWS * BATCH_ROWS);
+
+  /* A selection writes the rest of the batch first. */
+  UNIT_TEST_ASSERT(count_rows("SELECT id FROM log WHERE time >= 1000;") ==
+                   ROWS);
+  UNIT_TEST_ASSERT(stored_rows() == ROWS);
+
+  UNIT_TEST_ASSERT(insert_rows(ROWS, 3));
+  UNIT_TEST_ASSERT(stored_rows() == ROWS);
+  UNIT_TEST_ASSERT(db_batch_commit() == DB_OK);
+  UNIT_TEST_ASSERT(stored_rows() == ROWS + 3);
+
+  UNIT_TEST_ASSERT(insert_rows(ROWS + 3, 2));
+  UNIT_TEST_ASSERT(db_batch_end() == DB_OK);
+  UNIT_TEST_ASSERT(stored_rows() == ROWS + 5);
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(batch_index, "Index keys of batched tuples");
+UNIT_TEST(batch_index)
+{
+  UNIT_TEST_BEGIN();
+
+  /* 100 tuples have been inserted, with id = i % 7. */
+  UNIT_TEST_ASSERT(count_rows("SELECT time FROM log WHERE id = 3;") == 14);
+  UNIT_TEST_ASSERT(count_rows("SELECT id FROM log WHERE time >= 1500 AND "
+                              "time < 1600;") == 10);
+  UNIT_TEST_ASSERT(count_rows("SELECT id FROM log WHERE time = 1990;") == 1);
+
+  /* Inserts outside of a batch are not affected. */
+  UNIT_TEST_ASSERT(insert_rows(ROWS + 5, 1));
+  UNIT_TEST_ASSERT(stored_rows() == ROWS + 6);
+  UNIT_TEST_ASSERT(count_rows("SELECT id FROM log WHERE time = 2000;") == 1);
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(batch_failure, "Failed batch commits");
+UNIT_TEST(batch_failure)
+{
+  UNIT_TEST_BEGIN();
+
+  UNIT_TEST_ASSERT(db_batch_begin("log") == DB_OK);
+
+  /* A batch that cannot be stored is kept, and the relation is
+     unchanged. */
+  UNIT_TEST_ASSERT(insert_rows(ROWS + 6, 3));
+  fail_storage = 1;
+  UNIT_TEST_ASSERT(db_batch_commit() == DB_STORAGE_ERROR);
+  fail_storage = 0;
+  UNIT_TEST_ASSERT(stored_rows() == ROWS + 6);
+  UNIT_TEST_ASSERT(db_batch_commit() == DB_OK);
+  UNIT_TEST_ASSERT(stored_rows() == ROWS + 9);
+  UNIT_TEST_ASSERT(count_rows("SELECT id FROM log WHERE time >= 2010 AND "
+                              "time < 2040;") == 3);
+
+  /* A full batch that cannot be stored does not take more tuples. */
+  fail_storage = 1;
+  UNIT_TEST_ASSERT(insert_rows(ROWS + 9, BATCH_ROWS));
+  UNIT_TEST_ASSERT(!insert_rows(ROWS + 9 + BATCH_ROWS, 1));
+  fail_storage = 0;
+  UNIT_TEST_ASSERT(stored_rows() == ROWS + 9);
+  UNIT_TEST_ASSERT(db_batch_commit() == DB_OK);
+  UNIT_TEST_ASSERT(stored_rows() == ROWS + 9 + BATCH_ROWS);
+
+  /* Stored tuples are kept if their keys cannot be indexed. */
+  UNIT_TEST_ASSERT(insert_rows(ROWS + 9 + BATCH_ROWS, 1));
+  fail_index = 1;
+  UNIT_TEST_ASSERT(db_batch_commit() == DB_INDEX_ERROR);
+  fail_index = 0;
+  UNIT_TEST_ASSERT(stored_rows() == ROWS + 10 + BATCH_ROWS);
+  UNIT_TEST_ASSERT(count_rows("SELECT id FROM log WHERE time = 2140;") == 1);
+
+  UNIT_TEST_ASSERT(db_batch_end() == DB_OK);
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(batch_errors, "Invalid batch operations");
+UNIT_TEST(batch_errors)
+{
+  UNIT_TEST_BEGIN();
+
+  UNIT_TEST_ASSERT(db_batch_end() == DB_ARGUMENT_ERROR);
+  UNIT_TEST_ASSERT(db_batch_commit() == DB_OK);
+  UNIT_TEST_ASSERT(db_batch_begin("missing") == DB_NAME_ERROR);
+
+  /* The relation of a batch cannot be removed. */
+  UNIT_TEST_ASSERT(db_batch_begin("log") == DB_OK);
+  UNIT_TEST_ASSERT(db_query(NULL, "REMOVE RELATION log;") == DB_BUSY_ERROR);
+  UNIT_TEST_ASSERT(db_batch_end() == DB_OK);
+  UNIT_TEST_ASSERT(run("REMOVE RELATION log;"));
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(test_antelope_batch_process, ev, data)
+{
+  PROCESS_BEGIN();
+
+  cfs_coffee_format();
+  db_init();
+
+  printf("Run unit-test\n");
+  printf("---\n");
+
+  UNIT_TEST_RUN(batch_insert);
+  UNIT_TEST_RUN(batch_index);
+  UNIT_TEST_RUN(batch_failure);
+  UNIT_TEST_RUN(batch_errors);
+
+  if(!UNIT_TEST_PASSED(batch_insert) ||
+     !UNIT_TEST_PASSED(batch_index) ||
+     !UNIT_TEST_PASSED(batch_failure) ||
+     !UNIT_TEST_PASSED(batch_errors)) {
+    printf("=check-me= FAILED\n");
+    printf("---\n");
+  }
+
+  printf("=check-me= DONE\n");
+  printf("---\n");
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
@@ -0,0 +1,268 @@
+/*
+ * Copyright (c) 2026, RISE Research Institutes of Sweden.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+/*
+ * \file
+ *      Tests for aggregate queries in the Antelope database system.
+ */
+
+#include "contiki.h"
+#include "antelope.h"
+#include "index.h"
+#include "cfs/cfs-coffee.h"
+#include "storage.h"
+
+#include "unit-test/unit-test.h"
+
+#include <stdio.h>
+#include <string.h>
+/*---------------------------------------------------------------------------*/
+PROCESS(test_antelope_aggregate_process, "Antelope aggregate test");
+AUTOSTART_PROCESSES(&test_antelope_aggregate_process);
+/*---------------------------------------------------------------------------*/
+/* The keys of "id" are a permutation of 0..199. */
+#define ROWS       200
+#define BASE_VALUE 100000L
+/*---------------------------------------------------------------------------*/
+static db_handle_t handle;
+static unsigned long rows_read;
+
+/* The external index types that can be created on the unsorted "id". */
+static const struct {
+  const char *name;
+  const index_api_t *api;
+} index_types[] = {
+  { "MAXHEAP", &index_maxheap },
+  { "BTREE", &index_btree },
+};
+/*---------------------------------------------------------------------------*/
+db_result_t __real_storage_get_row(relation_t *, tuple_id_t *, storage_row_t);
+
+db_result_t
+__wrap_storage_get_row(relation_t *rel, tuple_id_t *tuple_id,
+                       storage_row_t row)
+{
+  rows_read++;
+  return __real_storage_get_row(rel, tuple_id, row);
+}
+/*---------------------------------------------------------------------------*/
+static int
+run(const char *query)
+{
+  return DB_SUCCESS(db_query(NULL, query));
+}
+/*---------------------------------------------------------------------------*/
+static int
+run_insert(int i)
+{
+  return DB_SUCCESS(db_query(NULL, "INSERT (%d, %ld) INTO samples;",
+                             (i * 37) % ROWS, BASE_VALUE + i));
+}
+/*---------------------------------------------------------------------------*/
+/* Execute an aggregate query and store the values of its single row. */
+static int
+aggregate(const char *query, long *values, unsigned count)
+{
+  attribute_value_t value;
+  db_result_t result;
+  unsigned rows;
+  unsigned i;
+
+  rows_read = 0;
+  if(DB_ERROR(db_query(&handle, query))) {
+    return 0;
+  }
+
+  rows = 0;
+  while(db_processing(&handle)) {
+    result = db_process(&handle);
+    if(result == DB_GOT_ROW) {
+      if(rows++ > 0 || handle.ncolumns != count) {
+        break;
+      }
+      for(i = 0; i < count; i++) {
+        if(DB_ERROR(db_get_value(&value, &handle, i)) ||
+           value.domain != DOMAIN_LONG) {
+          rows = 0;
+          break;
+        }
+        values[i] = VALUE_LONG(&value);
+      }
+    } else if(result == DB_FINISHED) {
+      break;
+    } else if(DB_ERROR(result)) {
+      rows = 0;
+      break;
+    }
+  }
+  db_free(&handle);
+  return rows == 1;
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(aggregate_scan, "Aggregate tuples in a scan");
+UNIT_TEST(aggregate_scan)
+{
+  long values[3];
+  int i;
+
+  UNIT_TEST_BEGIN();
+
+  UNIT_TEST_ASSERT(run("CREATE RELATION samples;"));
+  UNIT_TEST_ASSERT(run("CREATE ATTRIBUTE id DOMAIN INT IN samples;"));
+  UNIT_TEST_ASSERT(run("CREATE ATTRIBUTE value DOMAIN LONG IN samples;"));
+  UNIT_TEST_ASSERT(run("CREATE INDEX samples.id TYPE BTREE;"));
+
+  for(i = 0; i < ROWS; i++) {
+    UNIT_TEST_ASSERT(run_insert(i));
+  }
+
+  /* The sum does not fit in an integer. */
+  UNIT_TEST_ASSERT(aggregate("SELECT SUM(value) FROM samples;", values, 1));
+  UNIT_TEST_ASSERT(values[0] == ROWS * BASE_VALUE + (ROWS - 1) * ROWS / 2);
+  UNIT_TEST_ASSERT(rows_read > ROWS);
+
+  UNIT_TEST_ASSERT(aggregate("SELECT MEAN(value) FROM samples WHERE id < 50;",
+                             values, 1));
+  UNIT_TEST_ASSERT(values[0] > BASE_VALUE && values[0] < BASE_VALUE + ROWS);
+
+  UNIT_TEST_ASSERT(aggregate("SELECT MIN(value), MAX(value), COUNT(value) "
+                             "FROM samples WHERE id >= 0 AND id < 10;",
+                             values, 3));
+  UNIT_TEST_ASSERT(values[2] == 10);
+  UNIT_TEST_ASSERT(values[0] >= BASE_VALUE && values[1] < BASE_VALUE + ROWS);
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(aggregate_index, "Aggregate the keys of an index");
+UNIT_TEST(aggregate_index)
+{
+  long values[3];
+
+  UNIT_TEST_BEGIN();
+
+  UNIT_TEST_ASSERT(aggregate("SELECT MIN(id), MAX(id), COUNT(id) "
+                             "FROM samples;", values, 3));
+  UNIT_TEST_ASSERT(values[0] == 0 && values[1] == ROWS - 1 && values[2] == ROWS);
+  UNIT_TEST_ASSERT(rows_read == 0);
+
+  UNIT_TEST_ASSERT(aggregate("SELECT COUNT(id), SUM(id) FROM samples "
+                             "WHERE id >= 0 AND id < 10;", values, 2));
+  UNIT_TEST_ASSERT(values[0] == 10 && values[1] == 45);
+  UNIT_TEST_ASSERT(rows_read == 0);
+
+  UNIT_TEST_ASSERT(aggregate("SELECT MEAN(id) FROM samples "
+                             "WHERE id > 180 OR id < 10;", values, 1));
+  UNIT_TEST_ASSERT(values[0] == (9 * 10 / 2 + (181 + 199) * 19 / 2) / 29);
+  UNIT_TEST_ASSERT(rows_read == 0);
+
+  UNIT_TEST_ASSERT(aggregate("SELECT MIN(id) FROM samples WHERE id > 20;",
+                             values, 1));
+  UNIT_TEST_ASSERT(values[0] == 21);
+  UNIT_TEST_ASSERT(rows_read == 0);
+
+  /* An empty range still yields the aggregated row. */
+  UNIT_TEST_ASSERT(aggregate("SELECT COUNT(id) FROM samples WHERE id > 1000;",
+                             values, 1));
+  UNIT_TEST_ASSERT(values[0] == 0);
+
+  UNIT_TEST_ASSERT(run("REMOVE RELATION samples;"));
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(aggregate_index_types, "Aggregate with each index type");
+UNIT_TEST(aggregate_index_types)
+{
+  long values[3];
+  unsigned t;
+  int keys;
+  int i;
+
+  UNIT_TEST_BEGIN();
+
+  /* Only index types that return their keys in ascending order may
+     answer aggregates without reading the tuples. */
+  for(t = 0; t < sizeof(index_types) / sizeof(index_types[0]); t++) {
+    keys = (index_types[t].api->flags & INDEX_API_KEYS) != 0;
+
+    UNIT_TEST_ASSERT(run("CREATE RELATION samples;"));
+    UNIT_TEST_ASSERT(run("CREATE ATTRIBUTE id DOMAIN INT IN samples;"));
+    UNIT_TEST_ASSERT(run("CREATE ATTRIBUTE value DOMAIN LONG IN samples;"));
+    UNIT_TEST_ASSERT(DB_SUCCESS(db_query(NULL,
+                                         "CREATE INDEX samples.id TYPE %s;",
+                                         index_types[t].name)));
+    for(i = 0; i < ROWS; i++) {
+      UNIT_TEST_ASSERT(run_insert(i));
+    }
+
+    UNIT_TEST_ASSERT(aggregate("SELECT MIN(id) FROM samples WHERE id > 20;",
+                               values, 1));
+    UNIT_TEST_ASSERT(values[0] == 21);
+    UNIT_TEST_ASSERT((rows_read == 0) == keys);
+
+    UNIT_TEST_ASSERT(aggregate("SELECT MIN(id), MAX(id), COUNT(id) "
+                               "FROM samples WHERE id >= 50;", values, 3));
+    UNIT_TEST_ASSERT(values[0] == 50 && values[1] == ROWS - 1 &&
+                     values[2] == ROWS - 50);
+    UNIT_TEST_ASSERT((rows_read == 0) == keys);
+
+    UNIT_TEST_ASSERT(run("REMOVE RELATION samples;"));
+  }
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(test_antelope_aggregate_process, ev, data)
+{
+  PROCESS_BEGIN();
+
+  cfs_coffee_format();
+  db_init();
+
+  printf("Run unit-test\n");
+  printf("---\n");
+
+  UNIT_TEST_RUN(aggregate_scan);
+  UNIT_TEST_RUN(aggregate_index);
+  UNIT_TEST_RUN(aggregate_index_types);
+
+  if(!UNIT_TEST_PASSED(aggregate_scan) ||
+     !UNIT_TEST_PASSED(aggregate_index) ||
+     !UNIT_TEST_PASSED(aggregate_index_types)) {
+    printf("=check-me= FAILED\n");
+    printf("---\n");
+  }
+
+  printf("=check-me= DONE\n");
+  printf("---\n");
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
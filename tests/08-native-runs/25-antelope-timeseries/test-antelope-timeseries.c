@@ -0,0 +1,274 @@
+/*
+ * Copyright (c) 2026, RISE Research Institutes of Sweden.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+/*
+ * \file
+ *      Tests for time-series relations in the Antelope database system.
+ */
+
+#include "contiki.h"
+#include "antelope.h"
+#include "cfs/cfs.h"
+#include "cfs/cfs-coffee.h"
+#include "storage.h"
+
+#include "unit-test/unit-test.h"
+
+#include <stdio.h>
+#include <string.h>
+/*---------------------------------------------------------------------------*/
+PROCESS(test_antelope_timeseries_process, "Antelope time-series test");
+AUTOSTART_PROCESSES(&test_antelope_timeseries_process);
+/*---------------------------------------------------------------------------*/
+/* The tuples of "series" occupy 8 bytes, so a block holds 32 of them. */
+#define BLOCK_ROWS 32
+#define ROWS       500
+#define ROW_SIZE   8
+/*---------------------------------------------------------------------------*/
+static db_handle_t handle;
+static unsigned long rows_read;
+/*---------------------------------------------------------------------------*/
+db_result_t __real_storage_get_row(relation_t *, tuple_id_t *, storage_row_t);
+
+db_result_t
+__wrap_storage_get_row(relation_t *rel, tuple_id_t *tuple_id,
+                       storage_row_t row)
+{
+  rows_read++;
+  return __real_storage_get_row(rel, tuple_id, row);
+}
+/*---------------------------------------------------------------------------*/
+static int
+run(const char *query)
+{
+  return DB_SUCCESS(db_query(NULL, query));
+}
+/*---------------------------------------------------------------------------*/
+static long
+sample_value(int i)
+{
+  return 200 + (i * 7) % 50;
+}
+/*---------------------------------------------------------------------------*/
+/* Execute a selection, and return the number of tuples and the sum
+   of the values in the last column. */
+static int
+select_rows(const char *query, long *sum)
+{
+  attribute_value_t value;
+  db_result_t result;
+  int count;
+
+  rows_read = 0;
+  if(DB_ERROR(db_query(&handle, query))) {
+    return -1;
+  }
+
+  count = 0;
+  *sum = 0;
+  while(db_processing(&handle)) {
+    result = db_process(&handle);
+    if(result == DB_GOT_ROW) {
+      count++;
+      if(DB_SUCCESS(db_get_value(&value, &handle, handle.ncolumns - 1))) {
+        *sum += db_value_to_long(&value);
+      }
+    } else if(result == DB_FINISHED) {
+      break;
+    } else if(DB_ERROR(result)) {
+      count = -1;
+      break;
+    }
+  }
+  db_free(&handle);
+  return count;
+}
+/*---------------------------------------------------------------------------*/
+static long
+file_size(const char *filename)
+{
+  int fd;
+  long size;
+
+  fd = cfs_open(filename, CFS_READ);
+  if(fd < 0) {
+    return 0;
+  }
+  size = cfs_seek(fd, 0, CFS_SEEK_END);
+  cfs_close(fd);
+  return size;
+}
+/*---------------------------------------------------------------------------*/
+/* The size of the tuple file and the tail file of a relation. */
+static long
+relation_size(const char *name)
+{
+  relation_t *rel;
+  char filename[RELATION_NAME_LENGTH + 1];
+  long size;
+
+  rel = relation_load((char *)name);
+  if(rel == NULL) {
+    return -1;
+  }
+  size = -1;
+  if(storage_is_timeseries(rel)) {
+    strcpy(filename, rel->tuple_filename);
+    size = file_size(filename);
+    filename[1] = 'l';
+    size += file_size(filename);
+  }
+  relation_release(rel);
+  return size;
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(timeseries_insert, "Insert tuples into a time series");
+UNIT_TEST(timeseries_insert)
+{
+  long sum;
+  long expected;
+  long size;
+  int i;
+
+  UNIT_TEST_BEGIN();
+
+  UNIT_TEST_ASSERT(run("CREATE RELATION series;"));
+  UNIT_TEST_ASSERT(run("CREATE ATTRIBUTE time DOMAIN LONG IN series;"));
+  UNIT_TEST_ASSERT(run("CREATE ATTRIBUTE sensor DOMAIN INT IN series;"));
+  UNIT_TEST_ASSERT(run("CREATE ATTRIBUTE value DOMAIN INT IN series;"));
+  UNIT_TEST_ASSERT(db_set_timeseries("series") == DB_OK);
+  UNIT_TEST_ASSERT(db_set_timeseries("missing") == DB_NAME_ERROR);
+  UNIT_TEST_ASSERT(run("CREATE INDEX series.sensor TYPE MAXHEAP;"));
+
+  expected = 0;
+  for(i = 0; i < ROWS; i++) {
+    UNIT_TEST_ASSERT(DB_SUCCESS(db_query(NULL,
+                                         "INSERT (%ld, %d, %ld) INTO series;",
+                                         1000L + i * 10, i % 100,
+                                         sample_value(i))));
+    expected += sample_value(i);
+  }
+
+  /* The relation can no longer change its storage. */
+  UNIT_TEST_ASSERT(db_set_timeseries("series") == DB_OK);
+
+  /* The tuples are read back from the blocks and from the tail. */
+  UNIT_TEST_ASSERT(select_rows("SELECT time, value FROM series;", &sum) ==
+                   ROWS);
+  UNIT_TEST_ASSERT(sum == expected);
+
+  size = relation_size("series");
+  printf("%d tuples of %d bytes are stored in %ld bytes\n",
+         ROWS, ROW_SIZE, size);
+  UNIT_TEST_ASSERT(size > 0 && size < ROWS * ROW_SIZE / 2);
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(timeseries_select, "Select tuples from a time series");
+UNIT_TEST(timeseries_select)
+{
+  long sum;
+  long expected;
+  int count;
+  int i;
+
+  UNIT_TEST_BEGIN();
+
+  /* A range of the first attribute skips the blocks outside of it. */
+  for(expected = 0, i = 100; i < 200; i++) {
+    expected += sample_value(i);
+  }
+  UNIT_TEST_ASSERT(select_rows("SELECT value FROM series WHERE "
+                               "time >= 2000 AND time < 3000;", &sum) == 100);
+  UNIT_TEST_ASSERT(sum == expected);
+  UNIT_TEST_ASSERT(rows_read <= 100 + 2 * BLOCK_ROWS);
+
+  UNIT_TEST_ASSERT(select_rows("SELECT sensor, value FROM series WHERE "
+                               "time = 4990;", &sum) == 1);
+  UNIT_TEST_ASSERT(sum == sample_value(399));
+
+  /* Tuples in the tail are found as well. */
+  UNIT_TEST_ASSERT(select_rows("SELECT value FROM series WHERE "
+                               "time > 5900;", &sum) == 9);
+
+  /* An index reads single tuples from the blocks. */
+  count = select_rows("SELECT time, value FROM series WHERE sensor = 7;",
+                      &sum);
+  UNIT_TEST_ASSERT(count > 0 && count <= ROWS / 100);
+  UNIT_TEST_ASSERT(rows_read == count);
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(timeseries_remove, "Remove tuples from a time series");
+UNIT_TEST(timeseries_remove)
+{
+  long sum;
+
+  UNIT_TEST_BEGIN();
+
+  UNIT_TEST_ASSERT(select_rows("REMOVE FROM series WHERE time < 2000;",
+                               &sum) >= 0);
+  UNIT_TEST_ASSERT(select_rows("SELECT time FROM series;", &sum) ==
+                   ROWS - 100);
+  UNIT_TEST_ASSERT(relation_size("series") > 0);
+
+  UNIT_TEST_ASSERT(run("REMOVE RELATION series;"));
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(test_antelope_timeseries_process, ev, data)
+{
+  PROCESS_BEGIN();
+
+  cfs_coffee_format();
+  db_init();
+
+  printf("Run unit-test\n");
+  printf("---\n");
+
+  UNIT_TEST_RUN(timeseries_insert);
+  UNIT_TEST_RUN(timeseries_select);
+  UNIT_TEST_RUN(timeseries_remove);
+
+  if(!UNIT_TEST_PASSED(timeseries_insert) ||
+     !UNIT_TEST_PASSED(timeseries_select) ||
+     !UNIT_TEST_PASSED(timeseries_remove)) {
+    printf("=check-me= FAILED\n");
+    printf("---\n");
+  }
+
+  printf("=check-me= DONE\n");
+  printf("---\n");
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
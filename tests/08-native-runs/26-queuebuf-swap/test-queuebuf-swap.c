@@ -0,0 +1,224 @@
+/*
+ * Copyright (c) 2026, RISE Research Institutes of Sweden.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+/*
+ * \file
+ *      Tests for the queuebufs whose payloads are swapped to CFS.
+ */
+
+#include "contiki.h"
+#include "cfs/cfs-coffee.h"
+#include "net/packetbuf.h"
+#include "net/queuebuf.h"
+
+#include "unit-test/unit-test.h"
+
+#include <stdio.h>
+#include <string.h>
+/*---------------------------------------------------------------------------*/
+PROCESS(test_queuebuf_swap_process, "Queuebuf swap test");
+AUTOSTART_PROCESSES(&test_queuebuf_swap_process);
+/*---------------------------------------------------------------------------*/
+static struct queuebuf *bufs[QUEUEBUF_NUM];
+/*---------------------------------------------------------------------------*/
+static struct queuebuf *
+new_queuebuf(int i)
+{
+  uint8_t *data;
+  int k;
+
+  packetbuf_clear();
+  data = packetbuf_dataptr();
+  for(k = 0; k < 20 + i; k++) {
+    data[k] = i * 7 + k;
+  }
+  packetbuf_set_datalen(20 + i);
+  packetbuf_set_attr(PACKETBUF_ATTR_MAC_SEQNO, i);
+  return queuebuf_new_from_packetbuf();
+}
+/*---------------------------------------------------------------------------*/
+/* Is the content of the queuebuf the one created by new_queuebuf(i)? */
+static int
+check_queuebuf(struct queuebuf *b, int i)
+{
+  uint8_t *data;
+  int k;
+
+  if(queuebuf_datalen(b) != 20 + i ||
+     queuebuf_attr(b, PACKETBUF_ATTR_MAC_SEQNO) != i) {
+    return 0;
+  }
+  data = queuebuf_dataptr(b);
+  for(k = 0; k < 20 + i; k++) {
+    if(data[k] != (uint8_t)(i * 7 + k)) {
+      return 0;
+    }
+  }
+  return 1;
+}
+/*---------------------------------------------------------------------------*/
+static int
+count_in_ram(void)
+{
+  int count;
+  int i;
+
+  count = 0;
+  for(i = 0; i < QUEUEBUF_NUM; i++) {
+    if(bufs[i] != NULL && queuebuf_in_ram(bufs[i])) {
+      count++;
+    }
+  }
+  return count;
+}
+/*---------------------------------------------------------------------------*/
+static int
+check_all(void)
+{
+  int i;
+
+  for(i = 0; i < QUEUEBUF_NUM; i++) {
+    if(bufs[i] != NULL && !check_queuebuf(bufs[i], i)) {
+      return 0;
+    }
+  }
+  return 1;
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(swap_store, "Store payloads beyond RAM");
+UNIT_TEST(swap_store)
+{
+  int i;
+
+  UNIT_TEST_BEGIN();
+
+  UNIT_TEST_ASSERT(cfs_coffee_format() == 0);
+  queuebuf_init();
+
+  for(i = 0; i < QUEUEBUF_NUM; i++) {
+    bufs[i] = new_queuebuf(i);
+    UNIT_TEST_ASSERT(bufs[i] != NULL);
+  }
+  UNIT_TEST_ASSERT(queuebuf_numfree() == 0);
+  UNIT_TEST_ASSERT(count_in_ram() == QUEUEBUFRAM_NUM);
+  UNIT_TEST_ASSERT(!queuebuf_in_ram(bufs[QUEUEBUF_NUM - 1]));
+
+  /* Payloads in CFS are read on access. */
+  UNIT_TEST_ASSERT(check_all());
+
+  /* Request a payload to be brought to RAM. */
+  queuebuf_prefetch(bufs[10]);
+  UNIT_TEST_ASSERT(!queuebuf_in_ram(bufs[10]));
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(swap_prefetch, "Prefetch a payload from CFS");
+UNIT_TEST(swap_prefetch)
+{
+  UNIT_TEST_BEGIN();
+
+  /* The swap process has exchanged the payload with another one. */
+  UNIT_TEST_ASSERT(queuebuf_in_ram(bufs[10]));
+  UNIT_TEST_ASSERT(count_in_ram() == QUEUEBUFRAM_NUM);
+  UNIT_TEST_ASSERT(check_all());
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(swap_policy, "Keep payloads in RAM by policy");
+UNIT_TEST(swap_policy)
+{
+  struct queuebuf *b;
+  int i;
+
+  UNIT_TEST_BEGIN();
+
+  /* A payload that may not be swapped takes the RAM of another one. */
+  queuebuf_free(bufs[15]);
+  queuebuf_set_swap_policy(QUEUEBUF_SWAP_NEVER);
+  bufs[15] = new_queuebuf(15);
+  UNIT_TEST_ASSERT(bufs[15] != NULL);
+  UNIT_TEST_ASSERT(queuebuf_in_ram(bufs[15]));
+  UNIT_TEST_ASSERT(count_in_ram() == QUEUEBUFRAM_NUM);
+  UNIT_TEST_ASSERT(check_all());
+
+  /* Payloads about to be sent are not swapped out. */
+  for(i = 0; i < QUEUEBUF_NUM - 1; i++) {
+    if(queuebuf_in_ram(bufs[i])) {
+      queuebuf_prefetch(bufs[i]);
+    }
+  }
+  queuebuf_free(bufs[14]);
+  bufs[14] = NULL;
+  b = new_queuebuf(14);
+  UNIT_TEST_ASSERT(b == NULL);
+
+  /* Payloads that may be swapped can still be stored. */
+  queuebuf_set_swap_policy(QUEUEBUF_SWAP_ALLOWED);
+  bufs[14] = new_queuebuf(14);
+  UNIT_TEST_ASSERT(bufs[14] != NULL);
+  UNIT_TEST_ASSERT(!queuebuf_in_ram(bufs[14]));
+  UNIT_TEST_ASSERT(check_all());
+
+  for(i = 0; i < QUEUEBUF_NUM; i++) {
+    queuebuf_free(bufs[i]);
+    bufs[i] = NULL;
+  }
+  UNIT_TEST_ASSERT(queuebuf_numfree() == QUEUEBUF_NUM);
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(test_queuebuf_swap_process, ev, data)
+{
+  PROCESS_BEGIN();
+
+  printf("Run unit-test\n");
+  printf("---\n");
+
+  UNIT_TEST_RUN(swap_store);
+  /* Let the swap process handle the prefetch request. */
+  PROCESS_PAUSE();
+  UNIT_TEST_RUN(swap_prefetch);
+  UNIT_TEST_RUN(swap_policy);
+
+  if(!UNIT_TEST_PASSED(swap_store) ||
+     !UNIT_TEST_PASSED(swap_prefetch) ||
+     !UNIT_TEST_PASSED(swap_policy)) {
+    printf("=check-me= FAILED\n");
+    printf("---\n");
+  }
+
+  printf("=check-me= DONE\n");
+  printf("---\n");
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
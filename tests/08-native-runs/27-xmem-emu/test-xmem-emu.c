@@ -0,0 +1,170 @@
+/*
+ * Copyright (c) 2026, RISE Research Institutes of Sweden.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+/*
+ * \file
+ *      Tests for the flash emulator of the native platform.
+ */
+
+#include "contiki.h"
+#include "dev/xmem.h"
+#include "dev/xmem-emu.h"
+
+#include "unit-test/unit-test.h"
+
+#include <stdio.h>
+#include <string.h>
+/*---------------------------------------------------------------------------*/
+PROCESS(test_xmem_emu_process, "XMem emulator test");
+AUTOSTART_PROCESSES(&test_xmem_emu_process);
+/*---------------------------------------------------------------------------*/
+static unsigned char buf[300];
+static unsigned char check[300];
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(xmem_pages, "Program and read pages");
+UNIT_TEST(xmem_pages)
+{
+  struct xmem_stats stats;
+  int i;
+
+  UNIT_TEST_BEGIN();
+
+  for(i = 0; i < sizeof(buf); i++) {
+    buf[i] = i * 3;
+  }
+
+  xmem_emu_reset_stats();
+  /* The write covers the ends of two pages. */
+  UNIT_TEST_ASSERT(xmem_pwrite(buf, sizeof(buf), 200) == sizeof(buf));
+  xmem_emu_get_stats(&stats);
+  UNIT_TEST_ASSERT(stats.programs == 2);
+  UNIT_TEST_ASSERT(stats.program_bytes == sizeof(buf));
+  UNIT_TEST_ASSERT(stats.busy_ns == 2 * 1000 + 2 * sizeof(buf));
+
+  xmem_emu_reset_stats();
+  UNIT_TEST_ASSERT(xmem_pread(check, sizeof(check), 200) == sizeof(check));
+  UNIT_TEST_ASSERT(memcmp(buf, check, sizeof(buf)) == 0);
+  xmem_emu_get_stats(&stats);
+  UNIT_TEST_ASSERT(stats.reads == 1);
+  UNIT_TEST_ASSERT(stats.read_bytes == sizeof(check));
+  UNIT_TEST_ASSERT(stats.busy_ns == 2 * 100 + sizeof(check));
+
+  /* Operations beyond the end of the flash fail. */
+  UNIT_TEST_ASSERT(xmem_pwrite(buf, sizeof(buf), XMEM_SIZE - 1) < 0);
+  UNIT_TEST_ASSERT(xmem_pread(check, sizeof(check), XMEM_SIZE - 1) < 0);
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(xmem_bits, "Program only sets bits");
+UNIT_TEST(xmem_bits)
+{
+  struct xmem_stats stats;
+  unsigned char byte;
+
+  UNIT_TEST_BEGIN();
+
+  xmem_emu_reset_stats();
+  UNIT_TEST_ASSERT(xmem_erase(XMEM_SECTOR_SIZE, 0) == XMEM_SECTOR_SIZE);
+  xmem_emu_get_stats(&stats);
+  UNIT_TEST_ASSERT(stats.erases == 1);
+  UNIT_TEST_ASSERT(stats.busy_ns == 50000);
+  UNIT_TEST_ASSERT(xmem_emu_erase_count(0) == 1);
+  UNIT_TEST_ASSERT(xmem_emu_erase_count(1) == 0);
+
+  byte = 0x0f;
+  xmem_pwrite(&byte, 1, 0);
+  byte = 0xf0;
+  xmem_pwrite(&byte, 1, 0);
+  xmem_pread(&byte, 1, 0);
+  xmem_emu_get_stats(&stats);
+  UNIT_TEST_ASSERT(byte == 0xff);
+  UNIT_TEST_ASSERT(stats.clear_attempts == 1);
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(xmem_wear, "Count partial programs and erases");
+UNIT_TEST(xmem_wear)
+{
+  struct xmem_stats stats;
+  unsigned char byte;
+  int i;
+
+  UNIT_TEST_BEGIN();
+
+  xmem_emu_reset_stats();
+  /* The erase covers the ends of two sectors. */
+  xmem_erase(2 * XMEM_PAGE_SIZE, XMEM_SECTOR_SIZE - XMEM_PAGE_SIZE);
+  xmem_emu_get_stats(&stats);
+  UNIT_TEST_ASSERT(stats.erases == 2);
+  UNIT_TEST_ASSERT(xmem_emu_erase_count(0) == 1);
+  UNIT_TEST_ASSERT(xmem_emu_erase_count(1) == 1);
+
+  byte = 1;
+  for(i = 0; i < 3; i++) {
+    xmem_pwrite(&byte, 1, XMEM_SECTOR_SIZE + i);
+  }
+  xmem_emu_get_stats(&stats);
+  UNIT_TEST_ASSERT(stats.nop_exceeded == 1);
+
+  /* An erase allows new programs of the page. */
+  xmem_erase(XMEM_SECTOR_SIZE, XMEM_SECTOR_SIZE);
+  xmem_pwrite(&byte, 1, XMEM_SECTOR_SIZE);
+  xmem_emu_get_stats(&stats);
+  UNIT_TEST_ASSERT(stats.nop_exceeded == 1);
+  UNIT_TEST_ASSERT(xmem_emu_erase_count(1) == 2);
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(test_xmem_emu_process, ev, data)
+{
+  PROCESS_BEGIN();
+
+  printf("Run unit-test\n");
+  printf("---\n");
+
+  UNIT_TEST_RUN(xmem_pages);
+  UNIT_TEST_RUN(xmem_bits);
+  UNIT_TEST_RUN(xmem_wear);
+
+  if(!UNIT_TEST_PASSED(xmem_pages) ||
+     !UNIT_TEST_PASSED(xmem_bits) ||
+     !UNIT_TEST_PASSED(xmem_wear)) {
+    printf("=check-me= FAILED\n");
+    printf("---\n");
+  }
+
+  printf("=check-me= DONE\n");
+  printf("---\n");
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
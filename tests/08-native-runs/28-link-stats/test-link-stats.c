@@ -0,0 +1,161 @@
+/*
+ * Copyright (c) 2026, RISE Research Institutes of Sweden.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+/*
+ * \file
+ *      Tests that deferred link-stats updates are applied by the
+ *      link-stats process and give the same statistics as updates
+ *      applied one callback at a time.
+ */
+
+#include "contiki.h"
+#include "net/link-stats.h"
+#include "net/mac/mac.h"
+#include "net/packetbuf.h"
+
+#include "unit-test/unit-test.h"
+
+#include <stdio.h>
+#include <string.h>
+/*---------------------------------------------------------------------------*/
+PROCESS(test_link_stats_process, "Link stats test");
+AUTOSTART_PROCESSES(&test_link_stats_process);
+/*---------------------------------------------------------------------------*/
+/* A MAC callback: a packet sent with numtx transmissions, or received */
+struct event {
+  uint8_t is_tx;
+  uint8_t status;
+  uint8_t numtx;
+  int16_t rssi;
+};
+
+static const struct event events[] = {
+  { 0, 0, 0, -70 }, { 0, 0, 0, -70 }, { 0, 0, 0, -71 },
+  { 1, MAC_TX_OK, 1, 0 }, { 1, MAC_TX_OK, 1, 0 }, { 1, MAC_TX_OK, 1, 0 },
+  /* Different Tx counts, whose average is not an integer */
+  { 1, MAC_TX_OK, 2, 0 }, { 1, MAC_TX_OK, 3, 0 }, { 1, MAC_TX_OK, 2, 0 },
+  { 1, MAC_TX_NOACK, 4, 0 }, { 1, MAC_TX_NOACK, 4, 0 },
+  { 1, MAC_TX_QUEUE_FULL, 0, 0 },
+  { 0, 0, 0, -85 }, { 0, 0, 0, -60 }, { 0, 0, 0, -60 }, { 0, 0, 0, -93 },
+  { 1, MAC_TX_OK, 1, 0 }, { 1, MAC_TX_OK, 2, 0 }, { 1, MAC_TX_OK, 1, 0 },
+  { 0, 0, 0, -75 }, { 0, 0, 0, -75 }, { 0, 0, 0, -75 }, { 0, 0, 0, -75 },
+};
+
+static const linkaddr_t addr_single = { { 1, 1, 1, 1, 1, 1, 1, 1 } };
+static const linkaddr_t addr_batch = { { 2, 2, 2, 2, 2, 2, 2, 2 } };
+/*---------------------------------------------------------------------------*/
+static void
+apply(const linkaddr_t *lladdr, const struct event *e)
+{
+  if(e->is_tx) {
+    link_stats_packet_sent(lladdr, e->status, e->numtx);
+  } else {
+    packetbuf_clear();
+    packetbuf_set_attr(PACKETBUF_ATTR_RSSI, e->rssi);
+    link_stats_input_callback(lladdr);
+  }
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(batch_deferred, "Batched updates wait for the process");
+UNIT_TEST(batch_deferred)
+{
+  int i;
+
+  UNIT_TEST_BEGIN();
+
+  link_stats_init();
+
+  for(i = 0; i < sizeof(events) / sizeof(events[0]); i++) {
+    apply(&addr_single, &events[i]);
+    link_stats_flush();
+  }
+  for(i = 0; i < sizeof(events) / sizeof(events[0]); i++) {
+    apply(&addr_batch, &events[i]);
+  }
+
+  /* Reading the statistics does not apply the buffered updates */
+  UNIT_TEST_ASSERT(link_stats_from_lladdr(&addr_single) != NULL);
+  UNIT_TEST_ASSERT(link_stats_from_lladdr(&addr_batch) == NULL);
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(batch_agrees, "Batched updates agree with single ones");
+UNIT_TEST(batch_agrees)
+{
+  const struct link_stats *single;
+  const struct link_stats *batch;
+
+  UNIT_TEST_BEGIN();
+
+  single = link_stats_from_lladdr(&addr_single);
+  batch = link_stats_from_lladdr(&addr_batch);
+  UNIT_TEST_ASSERT(single != NULL && batch != NULL);
+
+  UNIT_TEST_ASSERT(batch->etx == single->etx);
+  UNIT_TEST_ASSERT(batch->rssi == single->rssi);
+  UNIT_TEST_ASSERT(batch->freshness == single->freshness);
+  UNIT_TEST_ASSERT(batch->rssi_window_len == single->rssi_window_len);
+  UNIT_TEST_ASSERT(memcmp(batch->rssi_window, single->rssi_window,
+                          sizeof(batch->rssi_window)) == 0);
+  UNIT_TEST_ASSERT(memcmp(&batch->cnt_current, &single->cnt_current,
+                          sizeof(batch->cnt_current)) == 0);
+  UNIT_TEST_ASSERT(link_stats_get_rssi_percentile(batch, 50) ==
+                   link_stats_get_rssi_percentile(single, 50));
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(test_link_stats_process, ev, data)
+{
+  static struct etimer et;
+
+  PROCESS_BEGIN();
+
+  printf("Run unit-test\n");
+  printf("---\n");
+
+  UNIT_TEST_RUN(batch_deferred);
+  /* Let the link-stats process apply the buffered updates */
+  etimer_set(&et, 1);
+  PROCESS_WAIT_EVENT_UNTIL(etimer_expired(&et));
+  UNIT_TEST_RUN(batch_agrees);
+
+  if(!UNIT_TEST_PASSED(batch_deferred) ||
+     !UNIT_TEST_PASSED(batch_agrees)) {
+    printf("=check-me= FAILED\n");
+    printf("---\n");
+  }
+
+  printf("=check-me= DONE\n");
+  printf("---\n");
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
@@ -0,0 +1,184 @@
+/*
+ * Copyright (c) 2026, RISE Research Institutes of Sweden.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+/*
+ * \file
+ *      Tests for the queuebufs that share reference-counted payloads.
+ */
+
+#include "contiki.h"
+#include "net/packetbuf.h"
+#include "net/queuebuf.h"
+
+#include "unit-test/unit-test.h"
+
+#include <stdio.h>
+#include <string.h>
+/*---------------------------------------------------------------------------*/
+PROCESS(test_queuebuf_shared_process, "Queuebuf shared test");
+AUTOSTART_PROCESSES(&test_queuebuf_shared_process);
+/*---------------------------------------------------------------------------*/
+/* Fills the packetbuf with frame i, for the neighbor nbr */
+static void
+make_frame(int i, int nbr)
+{
+  uint8_t *data;
+  int k;
+
+  packetbuf_clear();
+  data = packetbuf_dataptr();
+  for(k = 0; k < 30 + i; k++) {
+    data[k] = i * 11 + k;
+  }
+  packetbuf_set_datalen(30 + i);
+  packetbuf_set_attr(PACKETBUF_ATTR_MAC_SEQNO, nbr);
+}
+/*---------------------------------------------------------------------------*/
+/* Does the queuebuf hold frame i for the neighbor nbr? */
+static int
+check_frame(struct queuebuf *b, int i, int nbr)
+{
+  uint8_t *data;
+  int k;
+
+  if(queuebuf_datalen(b) != 30 + i ||
+     queuebuf_attr(b, PACKETBUF_ATTR_MAC_SEQNO) != nbr) {
+    return 0;
+  }
+  data = queuebuf_dataptr(b);
+  for(k = 0; k < 30 + i; k++) {
+    if(data[k] != (uint8_t)(i * 11 + k)) {
+      return 0;
+    }
+  }
+  return 1;
+}
+/*---------------------------------------------------------------------------*/
+static struct queuebuf *
+new_queuebuf(int i, int nbr)
+{
+  make_frame(i, nbr);
+  return queuebuf_new_from_packetbuf();
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(shared_lookup, "Share the payloads of interleaved frames");
+UNIT_TEST(shared_lookup)
+{
+  struct queuebuf *a1, *b1, *a2, *b2;
+
+  UNIT_TEST_BEGIN();
+
+  queuebuf_init();
+
+  /* Two frames, each queued for two neighbors in turn */
+  a1 = new_queuebuf(1, 1);
+  b1 = new_queuebuf(2, 1);
+  a2 = new_queuebuf(1, 2);
+  b2 = new_queuebuf(2, 2);
+  UNIT_TEST_ASSERT(a1 != NULL && b1 != NULL && a2 != NULL && b2 != NULL);
+
+  /* Only two payloads are allocated */
+  UNIT_TEST_ASSERT(queuebuf_numfree() == QUEUEBUF_NUM - 2);
+  UNIT_TEST_ASSERT(queuebuf_is_shared(a1) && queuebuf_is_shared(a2));
+  UNIT_TEST_ASSERT(queuebuf_dataptr(a1) == queuebuf_dataptr(a2));
+  UNIT_TEST_ASSERT(check_frame(a1, 1, 1) && check_frame(a2, 1, 2));
+  UNIT_TEST_ASSERT(check_frame(b1, 2, 1) && check_frame(b2, 2, 2));
+
+  /* Releasing a reference keeps the payload of the other queuebuf */
+  queuebuf_free(a1);
+  UNIT_TEST_ASSERT(!queuebuf_is_shared(a2));
+  UNIT_TEST_ASSERT(check_frame(a2, 1, 2));
+  UNIT_TEST_ASSERT(queuebuf_numfree() == QUEUEBUF_NUM - 2);
+
+  queuebuf_free(a2);
+  UNIT_TEST_ASSERT(queuebuf_numfree() == QUEUEBUF_NUM - 1);
+  queuebuf_free(b1);
+  queuebuf_free(b2);
+  UNIT_TEST_ASSERT(queuebuf_numfree() == QUEUEBUF_NUM);
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(shared_update, "Copy a shared payload on update");
+UNIT_TEST(shared_update)
+{
+  struct queuebuf *a1, *a2;
+
+  UNIT_TEST_BEGIN();
+
+  queuebuf_init();
+
+  a1 = new_queuebuf(3, 1);
+  a2 = new_queuebuf(3, 2);
+  UNIT_TEST_ASSERT(a1 != NULL && a2 != NULL);
+  UNIT_TEST_ASSERT(queuebuf_is_shared(a1));
+
+  /* The update of a2 leaves the payload of a1 intact */
+  make_frame(4, 2);
+  queuebuf_update_from_packetbuf(a2);
+  UNIT_TEST_ASSERT(!queuebuf_is_shared(a1) && !queuebuf_is_shared(a2));
+  UNIT_TEST_ASSERT(check_frame(a1, 3, 1));
+  UNIT_TEST_ASSERT(check_frame(a2, 4, 2));
+  UNIT_TEST_ASSERT(queuebuf_numfree() == QUEUEBUF_NUM - 2);
+
+  /* A new frame finds the updated payload */
+  queuebuf_free(a1);
+  a1 = new_queuebuf(4, 1);
+  UNIT_TEST_ASSERT(a1 != NULL && queuebuf_is_shared(a1));
+  UNIT_TEST_ASSERT(queuebuf_numfree() == QUEUEBUF_NUM - 1);
+
+  queuebuf_free(a1);
+  queuebuf_free(a2);
+  UNIT_TEST_ASSERT(queuebuf_numfree() == QUEUEBUF_NUM);
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(test_queuebuf_shared_process, ev, data)
+{
+  PROCESS_BEGIN();
+
+  printf("Run unit-test\n");
+  printf("---\n");
+
+  UNIT_TEST_RUN(shared_lookup);
+  UNIT_TEST_RUN(shared_update);
+
+  if(!UNIT_TEST_PASSED(shared_lookup) ||
+     !UNIT_TEST_PASSED(shared_update)) {
+    printf("=check-me= FAILED\n");
+    printf("---\n");
+  }
+
+  printf("=check-me= DONE\n");
+  printf("---\n");
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
@@ -0,0 +1,380 @@
+/*
+ * Copyright (c) 2026, RISE Research Institutes of Sweden.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+/*
+ * \file
+ *      Round-trip tests for the SDN IP header compression.
+ */
+
+#include "contiki.h"
+#include "net/netstack.h"
+#include "net/packetbuf.h"
+#include "net/sdn-net/sd-wsn.h"
+#include "net/sdn-net/sdn-net.h"
+
+#include "unit-test/unit-test.h"
+
+#include <stdio.h>
+#include <string.h>
+/*---------------------------------------------------------------------------*/
+PROCESS(test_sdn_compression_process, "SDN compression test");
+AUTOSTART_PROCESSES(&test_sdn_compression_process);
+/*---------------------------------------------------------------------------*/
+#define CHKSUM_NONE    0 /* Leave the checksums as they are */
+#define CHKSUM_VALID   1 /* Set the checksums the receiver regenerates */
+#define CHKSUM_INVALID 2 /* Set wrong checksums */
+
+static uint8_t original[SDN_BUFSIZE];
+static uint16_t original_len;
+static uint8_t received[SDN_BUFSIZE];
+static uint16_t received_len;
+static uint16_t sent_len;
+
+static linkaddr_t node_addr = { { 0x01, 0x02 } };
+static linkaddr_t other_addr = { { 0x03, 0x04 } };
+static linkaddr_t zero_addr = { { 0x00, 0x00 } };
+static linkaddr_t ones_addr = { { 0xff, 0xff } };
+/*---------------------------------------------------------------------------*/
+void
+__wrap_sdn_ip_input(void)
+{
+  memcpy(received, sdn_buf, sdn_len);
+  received_len = sdn_len;
+}
+/*---------------------------------------------------------------------------*/
+static void
+set_hdr_addr(linkaddr_t *hdr_addr, const linkaddr_t *lladdr)
+{
+  hdr_addr->u16 = sdnip_htons(lladdr->u16);
+}
+/*---------------------------------------------------------------------------*/
+/* Store the checksum that the receiver of a compressed packet would
+   regenerate, or a wrong one. */
+static void
+set_chksum(void *field, uint16_t (*chksum_fn)(uint8_t), uint8_t len,
+           int mode)
+{
+  uint16_t chksum = 0;
+
+  memcpy(field, &chksum, sizeof(chksum));
+  chksum = ~chksum_fn(len);
+  if(mode == CHKSUM_INVALID) {
+    chksum ^= 0x5a5a;
+  }
+  memcpy(field, &chksum, sizeof(chksum));
+}
+/*---------------------------------------------------------------------------*/
+static uint16_t
+ipchksum(uint8_t len)
+{
+  return sdn_ipchksum();
+}
+/*---------------------------------------------------------------------------*/
+static uint16_t
+ndchksum(uint8_t len)
+{
+  return sdn_ndchksum();
+}
+/*---------------------------------------------------------------------------*/
+/* Fill sdn_buf with a packet of the given protocol and payload length;
+   the protocol header, if any, is part of the payload */
+static void
+make_packet(uint8_t proto, uint16_t payload_len, const linkaddr_t *scr,
+            const linkaddr_t *dest, int chksums)
+{
+  uint16_t i;
+
+  memset(sdn_buf, 0, SDN_BUFSIZE);
+  sdn_len = SDN_IPH_LEN + payload_len;
+  SDN_IP_BUF->vap = (0x01 << 5) | proto;
+  SDN_IP_BUF->tlen = sdn_len;
+  SDN_IP_BUF->ttl = 64;
+  set_hdr_addr(&SDN_IP_BUF->scr, scr);
+  set_hdr_addr(&SDN_IP_BUF->dest, dest);
+  for(i = 0; i < payload_len; i++) {
+    *SDN_IP_PAYLOAD(i) = 0x30 + i;
+  }
+
+  if(chksums == CHKSUM_NONE) {
+    return;
+  }
+
+  switch(proto) {
+  case SDN_PROTO_ND:
+    if(payload_len >= SDN_NDH_LEN) {
+      set_chksum(&SDN_ND_BUF->ndchksum, ndchksum, 0, chksums);
+    }
+    break;
+  case SDN_PROTO_NA:
+    if(payload_len >= SDN_NAH_LEN) {
+      SDN_NA_BUF->payload_len = payload_len - SDN_NAH_LEN;
+      set_chksum(&SDN_NA_BUF->pkt_chksum, sdn_nachksum,
+                 SDN_NA_BUF->payload_len, chksums);
+    }
+    break;
+  case SDN_PROTO_RA:
+    if(payload_len >= SDN_RAH_LEN) {
+      SDN_RA_BUF->payload_len = payload_len - SDN_RAH_LEN;
+      set_chksum(&SDN_RA_BUF->pkt_chksum, sdn_rachksum,
+                 SDN_RA_BUF->payload_len, chksums);
+    }
+    break;
+  case SDN_PROTO_SA:
+    if(payload_len >= SDN_SAH_LEN) {
+      SDN_SA_BUF->payload_len = payload_len - SDN_SAH_LEN;
+      set_chksum(&SDN_SA_BUF->pkt_chksum, sdn_sachksum,
+                 SDN_SA_BUF->payload_len, chksums);
+    }
+    break;
+  }
+  set_chksum(&SDN_IP_BUF->hdr_chksum, ipchksum, 0, chksums);
+}
+/*---------------------------------------------------------------------------*/
+/* Send the packet in sdn_buf to the link-layer address dest (NULL for
+   broadcast), and receive the frame back. Returns 1 if the received
+   packet is identical to the one sent. */
+static int
+round_trip(const linkaddr_t *dest)
+{
+  memcpy(original, sdn_buf, sdn_len);
+  original_len = sdn_len;
+  received_len = 0;
+
+  NETSTACK_NETWORK.output(dest);
+  sent_len = packetbuf_datalen();
+
+  /* The frame arrives from this node */
+  NETSTACK_NETWORK.input();
+
+  return received_len == original_len &&
+    memcmp(received, original, original_len) == 0;
+}
+/*---------------------------------------------------------------------------*/
+/* Length of the compressed header with the given fields elided */
+static uint16_t
+hc_len(uint8_t proto, int tlen, int scr, int dest, int chksums)
+{
+  uint16_t len = 3;
+
+  len += tlen ? 0 : 1;
+  len += scr ? 0 : sizeof(linkaddr_t);
+  len += dest ? 0 : sizeof(linkaddr_t);
+  len += chksums ? 0 : sizeof(uint16_t);
+  if(chksums && proto >= SDN_PROTO_ND && proto <= SDN_PROTO_SA) {
+    /* The protocol checksum is not part of the payload either */
+    len -= sizeof(uint16_t);
+  }
+  return len;
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(hc_protocols, "Round trip of every protocol");
+UNIT_TEST(hc_protocols)
+{
+  static const uint8_t protos[] = {
+    SDN_PROTO_ND, SDN_PROTO_NA, SDN_PROTO_RA, SDN_PROTO_SA, SDN_PROTO_DATA
+  };
+  int i;
+  int chksums;
+
+  UNIT_TEST_BEGIN();
+
+  for(i = 0; i < sizeof(protos); i++) {
+    for(chksums = CHKSUM_VALID; chksums <= CHKSUM_INVALID; chksums++) {
+      int valid = chksums == CHKSUM_VALID;
+
+      make_packet(protos[i], 24, &node_addr, &other_addr, chksums);
+      UNIT_TEST_ASSERT(round_trip(&other_addr));
+      UNIT_TEST_ASSERT(sent_len ==
+                       hc_len(protos[i], 1, 1, 1, valid) + 24);
+    }
+  }
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(hc_addresses, "Round trip of every address variant");
+UNIT_TEST(hc_addresses)
+{
+  static const linkaddr_t *addrs[] = {
+    &node_addr, &other_addr, &zero_addr, &ones_addr
+  };
+  int s, d, l;
+
+  UNIT_TEST_BEGIN();
+
+  for(s = 0; s < 4; s++) {
+    int scr = addrs[s] == &node_addr;
+
+    for(d = 0; d < 4; d++) {
+      for(l = 0; l < 4; l++) {
+        int dest = addrs[d] == addrs[l];
+
+        make_packet(SDN_PROTO_DATA, 8, addrs[s], addrs[d], CHKSUM_VALID);
+        UNIT_TEST_ASSERT(round_trip(addrs[l]));
+        UNIT_TEST_ASSERT(sent_len == hc_len(0, 1, scr, dest, 1) + 8);
+      }
+
+      /* Broadcast, the link-layer receiver is the null address */
+      make_packet(SDN_PROTO_DATA, 8, addrs[s], addrs[d], CHKSUM_VALID);
+      UNIT_TEST_ASSERT(round_trip(NULL));
+      UNIT_TEST_ASSERT(sent_len ==
+                       hc_len(0, 1, scr, addrs[d] == &zero_addr, 1) + 8);
+    }
+  }
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(hc_fields, "Round trip of edge field values");
+UNIT_TEST(hc_fields)
+{
+  UNIT_TEST_BEGIN();
+
+  /* Edge values of ttl */
+  make_packet(SDN_PROTO_DATA, 4, &node_addr, &other_addr, CHKSUM_NONE);
+  SDN_IP_BUF->ttl = 0;
+  set_chksum(&SDN_IP_BUF->hdr_chksum, ipchksum, 0, CHKSUM_VALID);
+  UNIT_TEST_ASSERT(round_trip(&other_addr));
+  UNIT_TEST_ASSERT(sent_len == hc_len(0, 1, 1, 1, 1) + 4);
+  SDN_IP_BUF->ttl = 255;
+  set_chksum(&SDN_IP_BUF->hdr_chksum, ipchksum, 0, CHKSUM_VALID);
+  UNIT_TEST_ASSERT(round_trip(&other_addr));
+
+  /* A total length that differs from the packet length is carried */
+  make_packet(SDN_PROTO_DATA, 4, &node_addr, &other_addr, CHKSUM_NONE);
+  SDN_IP_BUF->tlen = 0;
+  set_chksum(&SDN_IP_BUF->hdr_chksum, ipchksum, 0, CHKSUM_VALID);
+  UNIT_TEST_ASSERT(round_trip(&other_addr));
+  UNIT_TEST_ASSERT(sent_len == hc_len(0, 0, 1, 1, 1) + 4);
+  SDN_IP_BUF->tlen = 255;
+  set_chksum(&SDN_IP_BUF->hdr_chksum, ipchksum, 0, CHKSUM_VALID);
+  UNIT_TEST_ASSERT(round_trip(&other_addr));
+  UNIT_TEST_ASSERT(sent_len == hc_len(0, 0, 1, 1, 1) + 4);
+
+  /* A packet without payload */
+  make_packet(SDN_PROTO_DATA, 0, &node_addr, &other_addr, CHKSUM_VALID);
+  UNIT_TEST_ASSERT(round_trip(&other_addr));
+  UNIT_TEST_ASSERT(sent_len == hc_len(0, 1, 1, 1, 1));
+
+  /* A large packet */
+  make_packet(SDN_PROTO_DATA, PACKETBUF_SIZE - hc_len(0, 1, 1, 1, 1),
+              &node_addr, &other_addr, CHKSUM_VALID);
+  UNIT_TEST_ASSERT(round_trip(&other_addr));
+  UNIT_TEST_ASSERT(sent_len == PACKETBUF_SIZE);
+
+  /* A nonzero padding byte is sent uncompressed */
+  make_packet(SDN_PROTO_DATA, 4, &node_addr, &other_addr, CHKSUM_NONE);
+  sdn_buf[offsetof(struct sdn_ip_hdr, ttl) + 1] = 0xaa;
+  set_chksum(&SDN_IP_BUF->hdr_chksum, ipchksum, 0, CHKSUM_VALID);
+  UNIT_TEST_ASSERT(round_trip(&other_addr));
+  UNIT_TEST_ASSERT(sent_len == SDN_IPH_LEN + 4);
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(hc_chksums, "Round trip of edge checksum values");
+UNIT_TEST(hc_chksums)
+{
+  UNIT_TEST_BEGIN();
+
+  /* Payloads too short to hold the protocol checksum */
+  make_packet(SDN_PROTO_ND, 3, &node_addr, &other_addr, CHKSUM_VALID);
+  UNIT_TEST_ASSERT(round_trip(&other_addr));
+  UNIT_TEST_ASSERT(sent_len == hc_len(0, 1, 1, 1, 0) + 3);
+  make_packet(SDN_PROTO_NA, SDN_NAH_LEN - 1, &node_addr, &other_addr,
+              CHKSUM_VALID);
+  UNIT_TEST_ASSERT(round_trip(&other_addr));
+  UNIT_TEST_ASSERT(sent_len == hc_len(0, 1, 1, 1, 0) + SDN_NAH_LEN - 1);
+
+  /* A protocol checksum that covers more than the packet */
+  make_packet(SDN_PROTO_NA, 20, &node_addr, &other_addr, CHKSUM_VALID);
+  SDN_NA_BUF->payload_len = 40;
+  set_chksum(&SDN_NA_BUF->pkt_chksum, sdn_nachksum, 40, CHKSUM_VALID);
+  set_chksum(&SDN_IP_BUF->hdr_chksum, ipchksum, 0, CHKSUM_VALID);
+  UNIT_TEST_ASSERT(round_trip(&other_addr));
+  UNIT_TEST_ASSERT(sent_len == hc_len(0, 1, 1, 1, 0) + 20);
+
+  /* Data after the checksummed part of the packet */
+  make_packet(SDN_PROTO_NA, 20, &node_addr, &other_addr, CHKSUM_VALID);
+  SDN_NA_BUF->payload_len = 2;
+  set_chksum(&SDN_NA_BUF->pkt_chksum, sdn_nachksum, 2, CHKSUM_VALID);
+  set_chksum(&SDN_IP_BUF->hdr_chksum, ipchksum, 0, CHKSUM_VALID);
+  UNIT_TEST_ASSERT(round_trip(&other_addr));
+  UNIT_TEST_ASSERT(sent_len == hc_len(SDN_PROTO_NA, 1, 1, 1, 1) + 20);
+
+  /* Both encodings of a valid checksum: the sum of the other ND header
+     fields is 0xffff, so 0x0000 and 0xffff are valid, and the receiver
+     regenerates 0x0000 */
+  make_packet(SDN_PROTO_ND, SDN_NDH_LEN, &node_addr, &other_addr,
+              CHKSUM_NONE);
+  SDN_ND_BUF->rank = (int16_t)0xffff;
+  SDN_ND_BUF->rssi = 0;
+  SDN_ND_BUF->ndchksum = 0;
+  set_chksum(&SDN_IP_BUF->hdr_chksum, ipchksum, 0, CHKSUM_VALID);
+  UNIT_TEST_ASSERT(sdn_ndchksum() == 0xffff);
+  UNIT_TEST_ASSERT(round_trip(&other_addr));
+  UNIT_TEST_ASSERT(sent_len == hc_len(SDN_PROTO_ND, 1, 1, 1, 1) +
+                   SDN_NDH_LEN);
+  SDN_ND_BUF->ndchksum = (int16_t)0xffff;
+  set_chksum(&SDN_IP_BUF->hdr_chksum, ipchksum, 0, CHKSUM_VALID);
+  UNIT_TEST_ASSERT(sdn_ndchksum() == 0xffff);
+  UNIT_TEST_ASSERT(round_trip(&other_addr));
+  UNIT_TEST_ASSERT(sent_len == hc_len(0, 1, 1, 1, 0) + SDN_NDH_LEN);
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(test_sdn_compression_process, ev, data)
+{
+  PROCESS_BEGIN();
+
+  linkaddr_set_node_addr(&node_addr);
+
+  printf("Run unit-test\n");
+  printf("---\n");
+
+  UNIT_TEST_RUN(hc_protocols);
+  UNIT_TEST_RUN(hc_addresses);
+  UNIT_TEST_RUN(hc_fields);
+  UNIT_TEST_RUN(hc_chksums);
+
+  if(!UNIT_TEST_PASSED(hc_protocols) ||
+     !UNIT_TEST_PASSED(hc_addresses) ||
+     !UNIT_TEST_PASSED(hc_fields) ||
+     !UNIT_TEST_PASSED(hc_chksums)) {
+    printf("=check-me= FAILED\n");
+    printf("---\n");
+  }
+
+  printf("=check-me= DONE\n");
+  printf("---\n");
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
@@ -0,0 +1,381 @@
+/*
+ * Copyright (c) 2026, RISE Research Institutes of Sweden.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+/*
+ * \file
+ *      Tests for the CoCoA retransmission timeout estimator.
+ */
+
+#include "contiki.h"
+#include "coap.h"
+#include "coap-transactions.h"
+#include "coap-timer.h"
+
+#include "unit-test/unit-test.h"
+
+#include <stdio.h>
+#include <string.h>
+/*---------------------------------------------------------------------------*/
+PROCESS(test_coap_cocoa_process, "CoAP CoCoA test");
+AUTOSTART_PROCESSES(&test_coap_cocoa_process);
+/*---------------------------------------------------------------------------*/
+static uint64_t now;
+static unsigned transmissions;
+static uint16_t next_mid;
+/*---------------------------------------------------------------------------*/
+static void
+test_timer_init(void)
+{
+}
+/*---------------------------------------------------------------------------*/
+static uint64_t
+test_timer_uptime(void)
+{
+  return now;
+}
+/*---------------------------------------------------------------------------*/
+static void
+test_timer_update(void)
+{
+}
+/*---------------------------------------------------------------------------*/
+const coap_timer_driver_t test_timer_driver = {
+  .init = test_timer_init,
+  .uptime = test_timer_uptime,
+  .update = test_timer_update,
+};
+/*---------------------------------------------------------------------------*/
+int
+__wrap_coap_sendto(const coap_endpoint_t *ep, const uint8_t *data,
+                   uint16_t len)
+{
+  transmissions++;
+  return len;
+}
+/*---------------------------------------------------------------------------*/
+static void
+make_endpoint(coap_endpoint_t *ep, uint16_t host)
+{
+  memset(ep, 0, sizeof(*ep));
+  uip_ip6addr(&ep->ipaddr, 0xfd00, 0, 0, 0, 0, 0, 0, host);
+  ep->port = UIP_HTONS(COAP_DEFAULT_PORT);
+}
+/*---------------------------------------------------------------------------*/
+static int
+get_stats(const coap_endpoint_t *ep, coap_rto_stats_t *stats)
+{
+  unsigned i;
+
+  for(i = 0; coap_transactions_rto_stats(i, stats); i++) {
+    if(coap_endpoint_cmp(&stats->endpoint, ep)) {
+      return 1;
+    }
+  }
+  return 0;
+}
+/*---------------------------------------------------------------------------*/
+static uint32_t
+get_rto(const coap_endpoint_t *ep)
+{
+  coap_rto_stats_t stats;
+
+  return get_stats(ep, &stats) ? stats.rto : 0;
+}
+/*---------------------------------------------------------------------------*/
+/* Send a confirmable message to ep */
+static coap_transaction_t *
+send_con(const coap_endpoint_t *ep)
+{
+  coap_transaction_t *t = coap_new_transaction(next_mid++, ep);
+
+  if(t != NULL) {
+    t->message[0] = (1 << COAP_HEADER_VERSION_POSITION) |
+      (COAP_TYPE_CON << COAP_HEADER_TYPE_POSITION);
+    t->message_len = 4;
+    coap_send_transaction(t);
+  }
+  return t;
+}
+/*---------------------------------------------------------------------------*/
+/* Let the retransmission timer of t expire */
+static void
+retransmit(coap_transaction_t *t)
+{
+  now = t->retrans_timer.expiration_time;
+  while(coap_timer_run());
+}
+/*---------------------------------------------------------------------------*/
+/* Acknowledge t after rtt milliseconds since it was first sent */
+static void
+acknowledge(coap_transaction_t *t, uint32_t rtt)
+{
+  now = t->start_time + rtt;
+  coap_transaction_acknowledged(t);
+  coap_clear_transaction(t);
+}
+/*---------------------------------------------------------------------------*/
+/* A round trip of a message to ep with the given number of retransmissions */
+static void
+exchange(const coap_endpoint_t *ep, int retransmissions, uint32_t rtt)
+{
+  coap_transaction_t *t = send_con(ep);
+  int i;
+
+  for(i = 0; i < retransmissions; i++) {
+    retransmit(t);
+  }
+  acknowledge(t, rtt);
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(strong_rtt, "Strong RTT updates");
+UNIT_TEST(strong_rtt)
+{
+  coap_endpoint_t ep;
+  coap_transaction_t *t;
+  coap_rto_stats_t stats;
+
+  UNIT_TEST_BEGIN();
+
+  make_endpoint(&ep, 1);
+
+  /* A new endpoint starts from the default RTO of 2 s */
+  t = send_con(&ep);
+  UNIT_TEST_ASSERT(t != NULL);
+  UNIT_TEST_ASSERT(get_rto(&ep) == 2000);
+  UNIT_TEST_ASSERT(t->retrans_interval >= 2000 && t->retrans_interval <= 3000);
+
+  /* SRTT = 400, RTTVAR = 200, RTO = (400 + 4 * 200 + 2000) / 2 */
+  acknowledge(t, 400);
+  UNIT_TEST_ASSERT(get_stats(&ep, &stats));
+  UNIT_TEST_ASSERT(stats.strong_samples == 1 && stats.weak_samples == 0);
+  UNIT_TEST_ASSERT(stats.strong_srtt == 400 && stats.strong_rttvar == 200);
+  UNIT_TEST_ASSERT(stats.rto == 1600);
+
+  /* SRTT = (7 * 400 + 800) / 8 = 450, RTTVAR = (3 * 200 + 400) / 4 = 250,
+     RTO = (450 + 4 * 250 + 1600) / 2 */
+  exchange(&ep, 0, 800);
+  UNIT_TEST_ASSERT(get_stats(&ep, &stats));
+  UNIT_TEST_ASSERT(stats.strong_samples == 2);
+  UNIT_TEST_ASSERT(stats.strong_srtt == 450 && stats.strong_rttvar == 250);
+  UNIT_TEST_ASSERT(stats.rto == 1525);
+
+  /* Short RTTs take the RTO down to its lower bound */
+  for(int i = 0; i < 50; i++) {
+    exchange(&ep, 0, 1);
+  }
+  UNIT_TEST_ASSERT(get_rto(&ep) == 100);
+
+  /* Long RTTs take it up to its upper bound */
+  for(int i = 0; i < 50; i++) {
+    exchange(&ep, 0, 100000);
+  }
+  UNIT_TEST_ASSERT(get_rto(&ep) == 60000);
+  UNIT_TEST_ASSERT(get_stats(&ep, &stats));
+  UNIT_TEST_ASSERT(stats.retransmissions == 0 && stats.timeouts == 0);
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(weak_rtt, "Weak RTT updates");
+UNIT_TEST(weak_rtt)
+{
+  coap_endpoint_t ep;
+  coap_rto_stats_t stats;
+  coap_transaction_t *t;
+  uint32_t first;
+
+  UNIT_TEST_BEGIN();
+
+  make_endpoint(&ep, 2);
+
+  /* A weak RTT is measured from the first transmission */
+  transmissions = 0;
+  t = send_con(&ep);
+  first = t->retrans_interval;
+  retransmit(t);
+  UNIT_TEST_ASSERT(transmissions == 2 && t->retrans_counter == 1);
+  acknowledge(t, first + 600);
+
+  /* SRTT = RTT, RTTVAR = RTT / 2, RTO = (RTT + RTT / 2 + 3 * 2000) / 4 */
+  UNIT_TEST_ASSERT(get_stats(&ep, &stats));
+  UNIT_TEST_ASSERT(stats.strong_samples == 0 && stats.weak_samples == 1);
+  UNIT_TEST_ASSERT(stats.weak_srtt == first + 600);
+  UNIT_TEST_ASSERT(stats.weak_rttvar == (first + 600) / 2);
+  UNIT_TEST_ASSERT(stats.rto ==
+                   ((first + 600) + (first + 600) / 2 + 3 * 2000) / 4);
+  UNIT_TEST_ASSERT(stats.retransmissions == 1);
+
+  /* Two retransmissions still give a weak RTT */
+  exchange(&ep, 2, 9000);
+  UNIT_TEST_ASSERT(get_stats(&ep, &stats));
+  UNIT_TEST_ASSERT(stats.weak_samples == 2 && stats.retransmissions == 3);
+
+  /* More retransmissions make the RTT too ambiguous to use */
+  first = stats.rto;
+  exchange(&ep, 3, 20000);
+  UNIT_TEST_ASSERT(get_stats(&ep, &stats));
+  UNIT_TEST_ASSERT(stats.weak_samples == 2 && stats.retransmissions == 6);
+  UNIT_TEST_ASSERT(stats.rto == first);
+  UNIT_TEST_ASSERT(stats.strong_samples == 0);
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+/* Does a new exchange with ep start with an interval between RTO and
+   1.5 RTO, that the first retransmission multiplies by factor_halves / 2? */
+static int
+check_backoff(const coap_endpoint_t *ep, unsigned factor_halves)
+{
+  coap_transaction_t *t = send_con(ep);
+  uint32_t rto = get_rto(ep);
+  uint32_t first = t->retrans_interval;
+  int ok;
+
+  ok = first >= rto && first <= rto + rto / 2;
+  retransmit(t);
+  ok = ok && t->retrans_interval == MIN(first * factor_halves / 2, 60000);
+  coap_clear_transaction(t);
+  return ok;
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(backoff, "Variable backoff factor");
+UNIT_TEST(backoff)
+{
+  coap_endpoint_t ep;
+
+  UNIT_TEST_BEGIN();
+
+  make_endpoint(&ep, 3);
+
+  /* The default RTO of 2 s doubles */
+  UNIT_TEST_ASSERT(check_backoff(&ep, 4));
+
+  /* RTOs below 1 s triple */
+  while(get_rto(&ep) >= 1000) {
+    exchange(&ep, 0, 100);
+  }
+  UNIT_TEST_ASSERT(check_backoff(&ep, 6));
+
+  /* RTOs above 3 s grow by half */
+  while(get_rto(&ep) <= 3000) {
+    exchange(&ep, 0, 3000);
+  }
+  UNIT_TEST_ASSERT(check_backoff(&ep, 3));
+
+  /* The retransmission interval is capped at 60 s */
+  while(get_rto(&ep) < 60000) {
+    exchange(&ep, 0, 60000);
+  }
+  UNIT_TEST_ASSERT(check_backoff(&ep, 3));
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(aging, "RTO aging");
+UNIT_TEST(aging)
+{
+  coap_endpoint_t ep;
+  coap_transaction_t *t;
+  uint32_t rto;
+
+  UNIT_TEST_BEGIN();
+
+  make_endpoint(&ep, 4);
+
+  /* A small RTO doubles after being idle for 16 RTOs */
+  do {
+    exchange(&ep, 0, 50);
+  } while(get_rto(&ep) >= 500);
+  rto = get_rto(&ep);
+  now += 16 * rto;
+  t = send_con(&ep);
+  UNIT_TEST_ASSERT(get_rto(&ep) == rto);
+  coap_clear_transaction(t);
+  now += 1;
+  t = send_con(&ep);
+  UNIT_TEST_ASSERT(get_rto(&ep) == 2 * rto);
+  coap_clear_transaction(t);
+
+  /* A large RTO halves its distance to the default after being idle
+     for 4 RTOs */
+  while(get_rto(&ep) <= 3000) {
+    exchange(&ep, 0, 5000);
+  }
+  rto = get_rto(&ep);
+  now += 4 * rto;
+  t = send_con(&ep);
+  UNIT_TEST_ASSERT(get_rto(&ep) == rto);
+  coap_clear_transaction(t);
+  now += 1;
+  t = send_con(&ep);
+  UNIT_TEST_ASSERT(get_rto(&ep) == (2000 + rto) / 2);
+  coap_clear_transaction(t);
+
+  /* An RTO between 1 and 3 s does not age */
+  while(get_rto(&ep) > 3000) {
+    now += 4 * get_rto(&ep) + 1;
+    t = send_con(&ep);
+    coap_clear_transaction(t);
+  }
+  rto = get_rto(&ep);
+  UNIT_TEST_ASSERT(rto >= 1000);
+  now += 1000000;
+  t = send_con(&ep);
+  UNIT_TEST_ASSERT(get_rto(&ep) == rto);
+  coap_clear_transaction(t);
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(test_coap_cocoa_process, ev, data)
+{
+  PROCESS_BEGIN();
+
+  printf("Run unit-test\n");
+  printf("---\n");
+
+  UNIT_TEST_RUN(strong_rtt);
+  UNIT_TEST_RUN(weak_rtt);
+  UNIT_TEST_RUN(backoff);
+  UNIT_TEST_RUN(aging);
+
+  if(!UNIT_TEST_PASSED(strong_rtt) ||
+     !UNIT_TEST_PASSED(weak_rtt) ||
+     !UNIT_TEST_PASSED(backoff) ||
+     !UNIT_TEST_PASSED(aging)) {
+    printf("=check-me= FAILED\n");
+    printf("---\n");
+  }
+
+  printf("=check-me= DONE\n");
+  printf("---\n");
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
@@ -0,0 +1,431 @@
+/*
+ * Copyright (c) 2026, RISE Research Institutes of Sweden.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+/*
+ * \file
+ *      Tests for the Q-Block1 and Q-Block2 block-wise transfers.
+ */
+
+#include "contiki.h"
+#include "coap.h"
+#include "coap-qblock.h"
+#include "coap-timer.h"
+
+#include "unit-test/unit-test.h"
+
+#include <stdio.h>
+#include <string.h>
+/*---------------------------------------------------------------------------*/
+PROCESS(test_coap_qblock_process, "CoAP Q-Block test");
+AUTOSTART_PROCESSES(&test_coap_qblock_process);
+/*---------------------------------------------------------------------------*/
+#define BLOCK_SIZE 64
+#define BODY_LEN   1000 /* blocks 0-15, two sets */
+#define MAX_SENT   64
+
+/* A block sent by a burst */
+typedef struct {
+  uint16_t host;
+  uint8_t token;
+  uint32_t num;
+  uint8_t more;
+  uint8_t valid;
+} sent_block_t;
+
+static uint64_t now;
+static sent_block_t sent[MAX_SENT];
+static unsigned sent_count;
+
+static uint8_t body[BODY_LEN];
+static uint8_t received_body[BODY_LEN];
+static uint8_t buffer[COAP_MAX_CHUNK_SIZE];
+
+static int read_body(void *user, uint32_t offset, uint8_t *data,
+                     uint16_t len);
+
+static coap_qblock2_source_t source = {
+  .read = read_body,
+  .length = BODY_LEN,
+  .content_format = APPLICATION_OCTET_STREAM
+};
+/*---------------------------------------------------------------------------*/
+static void
+test_timer_init(void)
+{
+}
+/*---------------------------------------------------------------------------*/
+static uint64_t
+test_timer_uptime(void)
+{
+  return now;
+}
+/*---------------------------------------------------------------------------*/
+static void
+test_timer_update(void)
+{
+}
+/*---------------------------------------------------------------------------*/
+const coap_timer_driver_t test_timer_driver = {
+  .init = test_timer_init,
+  .uptime = test_timer_uptime,
+  .update = test_timer_update,
+};
+/*---------------------------------------------------------------------------*/
+int
+__wrap_coap_sendto(const coap_endpoint_t *ep, const uint8_t *data,
+                   uint16_t len)
+{
+  static uint8_t copy[COAP_MAX_PACKET_SIZE];
+  coap_message_t message[1];
+  sent_block_t *s;
+  const uint8_t *payload;
+  int payload_len;
+
+  if(sent_count == MAX_SENT) {
+    return -1;
+  }
+  s = &sent[sent_count++];
+  memset(s, 0, sizeof(*s));
+
+  memcpy(copy, data, len);
+  if(coap_parse_message(message, copy, len) != NO_ERROR
+     || message->token_len != 1
+     || !coap_get_header_q_block2(message, &s->num, &s->more, NULL, NULL)) {
+    return len;
+  }
+  s->host = uip_ntohs(ep->ipaddr.u16[7]);
+  s->token = message->token[0];
+
+  payload_len = coap_get_payload(message, &payload);
+  s->valid = s->num * BLOCK_SIZE + payload_len <= BODY_LEN
+    && memcmp(payload, body + s->num * BLOCK_SIZE, payload_len) == 0
+    && s->more == (s->num * BLOCK_SIZE + payload_len < BODY_LEN);
+  return len;
+}
+/*---------------------------------------------------------------------------*/
+static int
+read_body(void *user, uint32_t offset, uint8_t *data, uint16_t len)
+{
+  memcpy(data, body + offset, len);
+  return len;
+}
+/*---------------------------------------------------------------------------*/
+static int
+write_body(void *user, uint32_t offset, const uint8_t *data, uint16_t len)
+{
+  memcpy(received_body + offset, data, len);
+  return 0;
+}
+/*---------------------------------------------------------------------------*/
+static void
+make_endpoint(coap_endpoint_t *ep, uint16_t host)
+{
+  memset(ep, 0, sizeof(*ep));
+  uip_ip6addr(&ep->ipaddr, 0xfd00, 0, 0, 0, 0, 0, 0, host);
+  ep->port = UIP_HTONS(COAP_DEFAULT_PORT);
+}
+/*---------------------------------------------------------------------------*/
+/* Request block num of the body with Q-Block2; returns 1 if the
+   response carries that block */
+static int
+get_block(const coap_endpoint_t *ep, uint8_t token, uint32_t num)
+{
+  coap_message_t request[1];
+  coap_message_t response[1];
+  int32_t offset = num * BLOCK_SIZE;
+  const uint8_t *payload;
+  int len;
+
+  coap_init_message(request, COAP_TYPE_CON, COAP_GET, coap_get_mid());
+  coap_set_token(request, &token, 1);
+  coap_set_header_q_block2(request, num, 0, BLOCK_SIZE);
+  coap_set_src_endpoint(request, ep);
+  coap_init_message(response, COAP_TYPE_ACK, CONTENT_2_05, request->mid);
+
+  coap_qblock2_handler(&source, request, response, buffer, BLOCK_SIZE,
+                       &offset);
+
+  len = coap_get_payload(response, &payload);
+  return len == MIN(BLOCK_SIZE, BODY_LEN - num * BLOCK_SIZE)
+    && memcmp(payload, body + num * BLOCK_SIZE, len) == 0;
+}
+/*---------------------------------------------------------------------------*/
+/* Let n burst intervals pass */
+static void
+run_bursts(int n)
+{
+  while(n-- > 0) {
+    now += COAP_QBLOCK_INTERVAL;
+    while(coap_timer_run());
+  }
+}
+/*---------------------------------------------------------------------------*/
+/* Were blocks first to last, and nothing else, sent to the transfer of
+   host and token, in order, starting from the sent block at index
+   from? */
+static int
+check_sent(unsigned from, uint16_t host, uint8_t token, uint32_t first,
+           uint32_t last)
+{
+  uint32_t num = first;
+  unsigned i;
+
+  for(i = from; i < sent_count; i++) {
+    if(sent[i].host != host || sent[i].token != token) {
+      continue;
+    }
+    if(!sent[i].valid || sent[i].num != num++) {
+      return 0;
+    }
+  }
+  return num == last + 1;
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(qblock2_set, "Q-Block2 sends a set");
+UNIT_TEST(qblock2_set)
+{
+  coap_endpoint_t a;
+
+  UNIT_TEST_BEGIN();
+
+  make_endpoint(&a, 1);
+  sent_count = 0;
+
+  /* The first block of each set is followed by the rest of the set */
+  UNIT_TEST_ASSERT(get_block(&a, 0xa1, 0));
+  run_bursts(20);
+  UNIT_TEST_ASSERT(sent_count == 9);
+  UNIT_TEST_ASSERT(check_sent(0, 1, 0xa1, 1, 9));
+
+  UNIT_TEST_ASSERT(get_block(&a, 0xa1, 10));
+  run_bursts(20);
+  UNIT_TEST_ASSERT(sent_count == 14);
+  UNIT_TEST_ASSERT(check_sent(9, 1, 0xa1, 11, 15));
+
+  /* Other blocks are sent alone */
+  UNIT_TEST_ASSERT(get_block(&a, 0xa1, 4));
+  UNIT_TEST_ASSERT(get_block(&a, 0xa1, 15));
+  run_bursts(20);
+  UNIT_TEST_ASSERT(sent_count == 14);
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(qblock2_concurrent, "Concurrent Q-Block2 transfers");
+UNIT_TEST(qblock2_concurrent)
+{
+  coap_endpoint_t a, b, c;
+
+  UNIT_TEST_BEGIN();
+
+  make_endpoint(&a, 1);
+  make_endpoint(&b, 2);
+  make_endpoint(&c, 3);
+  sent_count = 0;
+
+  /* Two endpoints, and two tokens of the same endpoint */
+  UNIT_TEST_ASSERT(get_block(&a, 0xa1, 0));
+  run_bursts(2);
+  UNIT_TEST_ASSERT(get_block(&b, 0xb1, 0));
+  run_bursts(2);
+  UNIT_TEST_ASSERT(get_block(&a, 0xa2, 10));
+
+  /* No burst is left for a fourth transfer, which is not disturbed */
+  UNIT_TEST_ASSERT(get_block(&c, 0xc1, 0));
+
+  run_bursts(20);
+  UNIT_TEST_ASSERT(sent_count == 9 + 9 + 5);
+  UNIT_TEST_ASSERT(check_sent(0, 1, 0xa1, 1, 9));
+  UNIT_TEST_ASSERT(check_sent(0, 2, 0xb1, 1, 9));
+  UNIT_TEST_ASSERT(check_sent(0, 1, 0xa2, 11, 15));
+  UNIT_TEST_ASSERT(check_sent(0, 3, 0xc1, 1, 0));
+
+  /* The bursts are free again */
+  UNIT_TEST_ASSERT(get_block(&c, 0xc1, 0));
+  run_bursts(20);
+  UNIT_TEST_ASSERT(check_sent(23, 3, 0xc1, 1, 9));
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(qblock2_restart, "A repeated Q-Block2 request");
+UNIT_TEST(qblock2_restart)
+{
+  coap_endpoint_t a;
+  coap_endpoint_t a2;
+
+  UNIT_TEST_BEGIN();
+
+  make_endpoint(&a, 1);
+  make_endpoint(&a2, 1);
+  a2.port = UIP_HTONS(COAP_DEFAULT_PORT + 1);
+  sent_count = 0;
+
+  /* The same endpoint and token restart the set */
+  UNIT_TEST_ASSERT(get_block(&a, 0xa1, 0));
+  run_bursts(3);
+  UNIT_TEST_ASSERT(check_sent(0, 1, 0xa1, 1, 3));
+  UNIT_TEST_ASSERT(get_block(&a, 0xa1, 0));
+  run_bursts(20);
+  UNIT_TEST_ASSERT(check_sent(3, 1, 0xa1, 1, 9));
+
+  /* ... or move on to the next set */
+  UNIT_TEST_ASSERT(get_block(&a, 0xa1, 0));
+  run_bursts(3);
+  UNIT_TEST_ASSERT(check_sent(12, 1, 0xa1, 1, 3));
+  UNIT_TEST_ASSERT(get_block(&a, 0xa1, 10));
+  run_bursts(20);
+  UNIT_TEST_ASSERT(sent_count == 12 + 3 + 5);
+  UNIT_TEST_ASSERT(check_sent(15, 1, 0xa1, 11, 15));
+
+  /* Another port of the same host is another endpoint */
+  sent_count = 0;
+  UNIT_TEST_ASSERT(get_block(&a, 0xa1, 0));
+  UNIT_TEST_ASSERT(get_block(&a2, 0xa1, 0));
+  run_bursts(20);
+  UNIT_TEST_ASSERT(sent_count == 18);
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+/* Send block num of the body with Q-Block1; returns the result of the
+   handler, and the response code in *code */
+static int
+put_block(coap_qblock1_receiver_t *receiver, const coap_endpoint_t *ep,
+          uint32_t num, unsigned int *code)
+{
+  static uint8_t message[COAP_MAX_PACKET_SIZE];
+  coap_message_t request[1];
+  coap_message_t response[1];
+  uint32_t offset = num * BLOCK_SIZE;
+  uint16_t len = MIN(BLOCK_SIZE, BODY_LEN - offset);
+  int ret;
+
+  /* The request is parsed as the engine does, to get the offset */
+  coap_init_message(request, COAP_TYPE_NON, COAP_PUT, coap_get_mid());
+  coap_set_header_q_block1(request, num, offset + len < BODY_LEN,
+                           BLOCK_SIZE);
+  coap_set_payload(request, body + offset, len);
+  len = coap_serialize_message(request, message);
+  if(coap_parse_message(request, message, len) != NO_ERROR) {
+    return -2;
+  }
+  coap_set_src_endpoint(request, ep);
+  coap_init_message(response, COAP_TYPE_NON, CHANGED_2_04, request->mid);
+
+  coap_status_code = NO_ERROR;
+  ret = coap_qblock1_handler(receiver, request, response, write_body, NULL);
+  if(ret < 0 || coap_status_code != NO_ERROR) {
+    *code = coap_status_code;
+  } else {
+    *code = response->code;
+  }
+  return ret;
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(qblock1_body, "Q-Block1 receives a body");
+UNIT_TEST(qblock1_body)
+{
+  static coap_qblock1_receiver_t receiver;
+  coap_endpoint_t a, b;
+  unsigned int code;
+  uint32_t num;
+
+  UNIT_TEST_BEGIN();
+
+  make_endpoint(&a, 1);
+  make_endpoint(&b, 2);
+  memset(received_body, 0, sizeof(received_body));
+
+  /* The first set, without block 4: no responses within the set, and
+     the list of missing blocks after its last block */
+  for(num = 0; num < 9; num++) {
+    if(num != 4) {
+      UNIT_TEST_ASSERT(put_block(&receiver, &a, num, &code) == 1);
+      UNIT_TEST_ASSERT(code == MANUAL_RESPONSE);
+    }
+  }
+  UNIT_TEST_ASSERT(put_block(&receiver, &a, 9, &code) == 1);
+  UNIT_TEST_ASSERT(code == REQUEST_ENTITY_INCOMPLETE_4_08);
+
+  /* Another endpoint cannot join the body */
+  UNIT_TEST_ASSERT(put_block(&receiver, &b, 4, &code) == -1);
+  UNIT_TEST_ASSERT(code == REQUEST_ENTITY_INCOMPLETE_4_08);
+
+  /* The missing block completes the set */
+  UNIT_TEST_ASSERT(put_block(&receiver, &a, 4, &code) == 1);
+  UNIT_TEST_ASSERT(code == CONTINUE_2_31);
+
+  /* The second set completes the body */
+  for(num = 10; num < 15; num++) {
+    UNIT_TEST_ASSERT(put_block(&receiver, &a, num, &code) == 1);
+  }
+  UNIT_TEST_ASSERT(put_block(&receiver, &a, 15, &code) == 0);
+  UNIT_TEST_ASSERT(code == CHANGED_2_04);
+  UNIT_TEST_ASSERT(receiver.length == BODY_LEN);
+  UNIT_TEST_ASSERT(memcmp(received_body, body, BODY_LEN) == 0);
+
+  /* A repeated last block repeats the final response */
+  UNIT_TEST_ASSERT(put_block(&receiver, &a, 15, &code) == 0);
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(test_coap_qblock_process, ev, data)
+{
+  int i;
+
+  PROCESS_BEGIN();
+
+  for(i = 0; i < BODY_LEN; i++) {
+    body[i] = i * 7 + (i >> 8);
+  }
+
+  printf("Run unit-test\n");
+  printf("---\n");
+
+  UNIT_TEST_RUN(qblock2_set);
+  UNIT_TEST_RUN(qblock2_concurrent);
+  UNIT_TEST_RUN(qblock2_restart);
+  UNIT_TEST_RUN(qblock1_body);
+
+  if(!UNIT_TEST_PASSED(qblock2_set) ||
+     !UNIT_TEST_PASSED(qblock2_concurrent) ||
+     !UNIT_TEST_PASSED(qblock2_restart) ||
+     !UNIT_TEST_PASSED(qblock1_body)) {
+    printf("=check-me= FAILED\n");
+    printf("---\n");
+  }
+
+  printf("=check-me= DONE\n");
+  printf("---\n");
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
@@ -0,0 +1,156 @@
+/*
+ * Copyright (c) 2026, RISE Research Institutes of Sweden.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+/*
+ * \file
+ *      Tests that the files and the erase counts of the Coffee file
+ *      system survive a reboot.
+ */
+
+#include "contiki.h"
+#include "cfs/cfs.h"
+#include "cfs/cfs-coffee.h"
+
+#include "unit-test/unit-test.h"
+
+#include <stdio.h>
+#include <string.h>
+
+/* Coffee is part of the test, so that its state can be reset. */
+#include "cfs-coffee.c"
+/*---------------------------------------------------------------------------*/
+PROCESS(test_coffee_remount_process, "Coffee remount test");
+AUTOSTART_PROCESSES(&test_coffee_remount_process);
+/*---------------------------------------------------------------------------*/
+/* Coffee ends a file at its last non-zero byte, so the NUL is not written */
+static const char content[] = "Kept across reboots";
+#define CONTENT_LEN (sizeof(content) - 1)
+static struct cfs_coffee_gc_stats before;
+/*---------------------------------------------------------------------------*/
+/* Forgets what Coffee knows about the storage, as a reboot does. */
+static void
+remount(void)
+{
+  memset(coffee_files, 0, sizeof(coffee_files));
+  memset(coffee_fd_set, 0, sizeof(coffee_fd_set));
+  next_free = 0;
+  gc_wait = 0;
+  dir_state = DIR_UNKNOWN;
+  erase_counts_loaded = 0;
+}
+/*---------------------------------------------------------------------------*/
+static int
+file_is_intact(const char *name)
+{
+  char buf[sizeof(content)];
+  int fd;
+  int r;
+
+  fd = cfs_open(name, CFS_READ);
+  if(fd < 0) {
+    return 0;
+  }
+  r = cfs_read(fd, buf, sizeof(buf));
+  cfs_close(fd);
+  return r == CONTENT_LEN && memcmp(buf, content, CONTENT_LEN) == 0;
+}
+/*---------------------------------------------------------------------------*/
+static int
+same_erase_counts(void)
+{
+  struct cfs_coffee_gc_stats stats;
+
+  cfs_coffee_gc_stats(&stats);
+  return stats.min_erases == before.min_erases &&
+         stats.max_erases == before.max_erases;
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(coffee_remount_files, "Files first after a remount");
+UNIT_TEST(coffee_remount_files)
+{
+  int fd;
+
+  UNIT_TEST_BEGIN();
+
+  UNIT_TEST_ASSERT(cfs_coffee_format() == 0);
+  fd = cfs_open("file", CFS_WRITE);
+  UNIT_TEST_ASSERT(fd >= 0);
+  UNIT_TEST_ASSERT(cfs_write(fd, content, CONTENT_LEN) == CONTENT_LEN);
+  cfs_close(fd);
+  cfs_coffee_gc_stats(&before);
+  UNIT_TEST_ASSERT(before.min_erases == 1 && before.max_erases == 1);
+
+  /* The directory is loaded before the erase counts. */
+  remount();
+  UNIT_TEST_ASSERT(file_is_intact("file"));
+  UNIT_TEST_ASSERT(same_erase_counts());
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(coffee_remount_counts, "Erase counts first after a remount");
+UNIT_TEST(coffee_remount_counts)
+{
+  UNIT_TEST_BEGIN();
+
+  /* The erase counts are loaded before the directory. */
+  remount();
+  UNIT_TEST_ASSERT(same_erase_counts());
+  UNIT_TEST_ASSERT(file_is_intact("file"));
+
+  /* And again, now that both were loaded after a remount. */
+  remount();
+  UNIT_TEST_ASSERT(file_is_intact("file"));
+  UNIT_TEST_ASSERT(same_erase_counts());
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(test_coffee_remount_process, ev, data)
+{
+  PROCESS_BEGIN();
+
+  printf("Run unit-test\n");
+  printf("---\n");
+
+  UNIT_TEST_RUN(coffee_remount_files);
+  UNIT_TEST_RUN(coffee_remount_counts);
+
+  if(!UNIT_TEST_PASSED(coffee_remount_files) ||
+     !UNIT_TEST_PASSED(coffee_remount_counts)) {
+    printf("=check-me= FAILED\n");
+    printf("---\n");
+  }
+
+  printf("=check-me= DONE\n");
+  printf("---\n");
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
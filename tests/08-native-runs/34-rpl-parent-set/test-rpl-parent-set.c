@@ -0,0 +1,155 @@
+/*
+ * Copyright (c) 2026, RISE Research Institutes of Sweden.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+/*
+ * \file
+ *      Unit tests for the incremental parent set of RPL Lite.
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "contiki.h"
+#include "net/routing/rpl-lite/rpl.h"
+#include "net/ipv6/uip-ds6-nbr.h"
+#include "net/packetbuf.h"
+#include "net/link-stats.h"
+#include "net/mac/mac.h"
+#include "unit-test/unit-test.h"
+/*****************************************************************************/
+PROCESS(test_rpl_parent_set_process, "RPL parent set test process");
+AUTOSTART_PROCESSES(&test_rpl_parent_set_process);
+/*****************************************************************************/
+static void
+lladdr_of(linkaddr_t *lladdr, uint8_t id)
+{
+  static const linkaddr_t prefix = { { 0x02, 0x12, 0x74, 0x00, 0, 0, 0, 0 } };
+
+  linkaddr_copy(lladdr, &prefix);
+  lladdr->u8[LINKADDR_SIZE - 1] = id;
+}
+/*****************************************************************************/
+static void
+linklocal_addr(uip_ipaddr_t *addr, uint8_t id)
+{
+  uip_ip6addr(addr, 0xfe80, 0, 0, 0, 0x0212, 0x7400, 0, id);
+}
+/*****************************************************************************/
+/* Receives a DIO of the DODAG rooted at neighbor 1 from a neighbor that
+ * is reachable and has fresh link statistics */
+static void
+dio_from(uint8_t id, rpl_rank_t rank)
+{
+  static rpl_dio_t dio;
+  linkaddr_t lladdr;
+  uip_ipaddr_t from;
+  int i;
+
+  memset(&dio, 0, sizeof(dio));
+  uip_ip6addr(&dio.dag_id, 0xfd00, 0, 0, 0, 0x0212, 0x7400, 0, 1);
+  dio.ocp = RPL_OCP_MRHOF;
+  dio.mop = RPL_MOP_NON_STORING;
+  dio.version = RPL_LOLLIPOP_INIT;
+  dio.instance_id = RPL_DEFAULT_INSTANCE;
+  dio.dtsn = RPL_LOLLIPOP_INIT;
+  dio.dag_intdoubl = RPL_DIO_INTERVAL_DOUBLINGS;
+  dio.dag_intmin = RPL_DIO_INTERVAL_MIN;
+  dio.dag_redund = RPL_DIO_REDUNDANCY;
+  dio.default_lifetime = RPL_DEFAULT_LIFETIME;
+  dio.lifetime_unit = RPL_DEFAULT_LIFETIME_UNIT;
+  dio.dag_max_rankinc = RPL_MAX_RANKINC;
+  dio.dag_min_hoprankinc = RPL_MIN_HOPRANKINC;
+  dio.rank = rank;
+  uip_ip6addr(&dio.prefix_info.prefix, 0xfd00, 0, 0, 0, 0, 0, 0, 0);
+  dio.prefix_info.length = 64;
+  dio.prefix_info.flags = UIP_ND6_RA_FLAG_AUTONOMOUS;
+  dio.prefix_info.lifetime = RPL_ROUTE_INFINITE_LIFETIME;
+
+  lladdr_of(&lladdr, id);
+  linklocal_addr(&from, id);
+  uip_ds6_nbr_add(&from, (uip_lladdr_t *)&lladdr, 1, NBR_REACHABLE,
+                  NBR_TABLE_REASON_RPL_DIO, NULL);
+  for(i = 0; i < 4; i++) {
+    link_stats_packet_sent(&lladdr, MAC_TX_OK, 1);
+  }
+
+  packetbuf_set_addr(PACKETBUF_ADDR_SENDER, &lladdr);
+  rpl_process_dio(&from, &dio);
+}
+/*****************************************************************************/
+static rpl_nbr_t *
+nbr_of(uint8_t id)
+{
+  linkaddr_t lladdr;
+
+  lladdr_of(&lladdr, id);
+  return rpl_neighbor_get_from_lladdr((uip_lladdr_t *)&lladdr);
+}
+/*****************************************************************************/
+UNIT_TEST_REGISTER(rank_error, "Rank error reported by the preferred parent");
+UNIT_TEST(rank_error)
+{
+  UNIT_TEST_BEGIN();
+
+  /* The root and a neighbor one hop further down */
+  dio_from(1, RPL_MIN_HOPRANKINC);
+  dio_from(2, 2 * RPL_MIN_HOPRANKINC);
+  rpl_dag_update_state();
+  UNIT_TEST_ASSERT(curr_instance.used);
+  UNIT_TEST_ASSERT(nbr_of(1) != NULL && nbr_of(2) != NULL);
+  UNIT_TEST_ASSERT(curr_instance.dag.preferred_parent == nbr_of(1));
+
+  /* A packet from the parent shows that its rank has grown; the parent
+   * is evaluated again with the new rank */
+  rpl_process_hbh(nbr_of(1), 5 * RPL_MIN_HOPRANKINC, 0, 1);
+  UNIT_TEST_ASSERT(nbr_of(1)->rank == 5 * RPL_MIN_HOPRANKINC);
+  UNIT_TEST_ASSERT(curr_instance.dag.preferred_parent == nbr_of(2));
+
+  UNIT_TEST_END();
+}
+/*****************************************************************************/
+PROCESS_THREAD(test_rpl_parent_set_process, ev, data)
+{
+  PROCESS_BEGIN();
+
+  printf("Run unit-test\n");
+  printf("---\n");
+
+  UNIT_TEST_RUN(rank_error);
+
+  if(!UNIT_TEST_PASSED(rank_error)) {
+    printf("=check-me= FAILED\n");
+    printf("---\n");
+  }
+
+  printf("=check-me= DONE\n");
+  printf("---\n");
+
+  PROCESS_END();
+}